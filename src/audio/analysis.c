@@ -0,0 +1,198 @@
+/*
+ * Analysis Thread Implementation
+ */
+
+#include "analysis.h"
+#include "../dancer/dancer.h"   /* calculate_bands */
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* middle slot index lives in the low bits; FRESH marks an unread publish */
+#define SLOT_MASK 3
+#define FRESH_FLAG 4
+
+#define MIN_WAIT_NS 200000L     /* Don't spin on tiny shortfalls */
+#define MAX_WAIT_NS 20000000L   /* Re-check running/terminate at least this often */
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+AnalysisThread* analysis_create(struct audio_data *audio, struct cava_plan *plan,
+                                int num_bars, int hop_frames, double sensitivity) {
+    if (!audio || !plan || num_bars < 1 || num_bars > ANALYSIS_MAX_BARS) return NULL;
+    if (audio->channels < 1 || audio->rate == 0) return NULL;
+
+    AnalysisThread *an = calloc(1, sizeof(AnalysisThread));
+    if (!an) return NULL;
+
+    an->audio = audio;
+    an->plan = plan;
+    an->sensitivity = sensitivity;
+    an->num_bars = num_bars;
+    an->hop_frames = hop_frames > 0 ? hop_frames : ANALYSIS_DEFAULT_HOP;
+
+    an->rhythm = rhythm_init();
+    an->bpm_tracker = bpm_tracker_create();
+    an->energy = energy_analyzer_create();
+    an->hop_buffer = calloc((size_t)an->hop_frames * audio->channels, sizeof(double));
+    if (!an->rhythm || !an->bpm_tracker || !an->energy || !an->hop_buffer) {
+        analysis_destroy(an);
+        return NULL;
+    }
+
+    /* Readers may look before the first hop is published */
+    for (int i = 0; i < 3; i++) {
+        an->slots[i].num_bars = num_bars;
+        an->slots[i].rhythm_bpm = rhythm_get_bpm(an->rhythm);
+        an->slots[i].bpm = bpm_tracker_get_bpm(an->bpm_tracker);
+        an->slots[i].energy_zone = energy_analyzer_get_zone_name(an->energy);
+    }
+    an->back = 0;
+    an->front = 1;
+    atomic_init(&an->middle, 2);
+    atomic_init(&an->running, false);
+
+    return an;
+}
+
+void analysis_stop(AnalysisThread *an) {
+    if (!an || !an->started) return;
+    atomic_store(&an->running, false);
+    pthread_join(an->thread, NULL);
+    an->started = false;
+}
+
+void analysis_destroy(AnalysisThread *an) {
+    if (!an) return;
+    analysis_stop(an);
+    rhythm_destroy(an->rhythm);
+    bpm_tracker_destroy(an->bpm_tracker);
+    energy_analyzer_destroy(an->energy);
+    free(an->hop_buffer);
+    free(an);
+}
+
+void analysis_process(AnalysisThread *an, const double *samples, int count) {
+    if (!an || count <= 0) return;
+
+    double start = now_seconds();
+    AnalysisSnapshot *snap = &an->slots[an->back];
+    unsigned int channels = an->audio->channels;
+    double dt = (double)count / channels / an->audio->rate;
+
+    /* Spectrum */
+    cava_execute(samples, count, snap->bars, an->plan);
+
+    float spectrum[ANALYSIS_MAX_BARS];
+    for (int i = 0; i < an->num_bars; i++) {
+        snap->bars[i] *= an->sensitivity;
+        if (snap->bars[i] > 1.0) snap->bars[i] = 1.0;
+        spectrum[i] = (float)snap->bars[i];
+    }
+
+    /* Rhythm, on the audio clock rather than the frame clock */
+    rhythm_update(an->rhythm, spectrum, an->num_bars, dt);
+    calculate_bands(snap->bars, an->num_bars, &snap->bass, &snap->mid, &snap->treble);
+
+    an->frames_analyzed += (uint64_t)count / channels;
+    double audio_time = (double)an->frames_analyzed / an->audio->rate;
+
+    bool onset = rhythm_onset_detected(an->rhythm);
+    if (onset) {
+        an->onset_count++;
+        an->last_onset_strength = rhythm_get_onset_strength(an->rhythm);
+        bpm_tracker_tap(an->bpm_tracker, audio_time);
+    }
+    bpm_tracker_update(an->bpm_tracker, dt);
+
+    float bass = (float)snap->bass;
+    float mid = (float)snap->mid;
+    float treble = (float)snap->treble;
+    energy_analyzer_update_bands(an->energy,
+        bass * 0.5f, bass,
+        (bass + mid) * 0.5f, mid,
+        (mid + treble) * 0.5f, treble);
+    energy_analyzer_update_pace(an->energy,
+        bpm_tracker_get_bpm(an->bpm_tracker),
+        rhythm_get_onset_strength(an->rhythm),
+        onset ? 1.0f : 0.0f);
+
+    /* Fill the rest of the snapshot */
+    snap->num_bars = an->num_bars;
+    snap->audio_time = audio_time;
+    snap->beat_phase = rhythm_get_phase(an->rhythm);
+    snap->rhythm_bpm = rhythm_get_bpm(an->rhythm);
+    snap->onset_count = an->onset_count;
+    snap->onset_strength = an->last_onset_strength;
+    snap->bpm = bpm_tracker_get_bpm(an->bpm_tracker);
+    snap->bpm_confidence = bpm_tracker_get_confidence(an->bpm_tracker);
+    snap->energy = energy_analyzer_get_smoothed(an->energy);
+    snap->energy_zone = energy_analyzer_get_zone_name(an->energy);
+    snap->seq = ++an->published;
+    snap->timestamp = now_seconds();
+    snap->process_ms = (snap->timestamp - start) * 1000.0;
+
+    /* Publish: swap our finished slot into the middle, take the old middle */
+    int prev = atomic_exchange_explicit(&an->middle, an->back | FRESH_FLAG,
+                                        memory_order_acq_rel);
+    an->back = prev & SLOT_MASK;
+}
+
+static void *analysis_thread_main(void *data) {
+    AnalysisThread *an = (AnalysisThread *)data;
+    struct audio_data *audio = an->audio;
+    size_t hop_samples = (size_t)an->hop_frames * audio->channels;
+
+    while (atomic_load(&an->running) && !audio->terminate) {
+        size_t available = audio_ring_available(&audio->ring);
+        if (available >= hop_samples) {
+            size_t got = audio_ring_read(&audio->ring, an->hop_buffer, hop_samples);
+            analysis_process(an, an->hop_buffer, (int)got);
+            continue;
+        }
+
+        /* Sleep for about as long as the rest of the hop takes to arrive */
+        long wait_ns = (long)((double)(hop_samples - available) / audio->channels *
+                              1e9 / audio->rate);
+        if (wait_ns < MIN_WAIT_NS) wait_ns = MIN_WAIT_NS;
+        if (wait_ns > MAX_WAIT_NS) wait_ns = MAX_WAIT_NS;
+        struct timespec ts = { .tv_sec = 0, .tv_nsec = wait_ns };
+        nanosleep(&ts, NULL);
+    }
+
+    return NULL;
+}
+
+int analysis_start(AnalysisThread *an) {
+    if (!an || an->started) return -1;
+
+    atomic_store(&an->running, true);
+    if (pthread_create(&an->thread, NULL, analysis_thread_main, an) != 0) {
+        atomic_store(&an->running, false);
+        return -1;
+    }
+    an->started = true;
+    return 0;
+}
+
+const AnalysisSnapshot* analysis_latest(AnalysisThread *an) {
+    if (atomic_load_explicit(&an->middle, memory_order_relaxed) & FRESH_FLAG) {
+        int prev = atomic_exchange_explicit(&an->middle, an->front, memory_order_acq_rel);
+        an->front = prev & SLOT_MASK;
+    }
+    return &an->slots[an->front];
+}
+
+float analysis_phase_at(const AnalysisSnapshot *snap, double now) {
+    if (snap->seq == 0 || snap->rhythm_bpm <= 0.0f) return snap->beat_phase;
+
+    double ahead = now - snap->timestamp;
+    if (ahead < 0.0) ahead = 0.0;
+
+    double phase = snap->beat_phase + ahead * snap->rhythm_bpm / 60.0;
+    return (float)(phase - (long)phase);
+}
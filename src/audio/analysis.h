@@ -0,0 +1,113 @@
+/*
+ * Analysis Thread - ASCII Dancer v3.2+
+ *
+ * Runs cava, rhythm, BPM and energy analysis on a dedicated thread at a
+ * fixed audio hop (default 512 frames) instead of once per rendered frame.
+ * Each hop publishes a timestamped snapshot through a lock-free triple
+ * buffer; the render loop only ever reads the most recent one, so a slow
+ * terminal can no longer delay or blur beat detection.
+ */
+
+#ifndef ANALYSIS_H
+#define ANALYSIS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include "audio.h"
+#include "rhythm.h"
+#include "bpm_tracker.h"
+#include "energy_analyzer.h"
+#include "../fft/cavacore.h"
+
+#define ANALYSIS_MAX_BARS 64
+#define ANALYSIS_DEFAULT_HOP 512    /* Frames per analysis step (~11.6 ms at 44.1 kHz) */
+
+/* Everything the render loop needs from one analysis step */
+typedef struct {
+    uint64_t seq;               /* 0 until the first hop is published */
+    double timestamp;           /* CLOCK_MONOTONIC seconds at publish */
+    double audio_time;          /* Seconds of audio analyzed so far */
+
+    /* Spectrum (sensitivity applied, clamped to 0-1) */
+    int num_bars;
+    double bars[ANALYSIS_MAX_BARS];
+    double bass, mid, treble;
+
+    /* Rhythm */
+    float beat_phase;           /* Phase at timestamp, see analysis_phase_at() */
+    float rhythm_bpm;
+    unsigned long onset_count;  /* Total onsets; a change means new onsets */
+    float onset_strength;       /* Strength of the most recent onset */
+
+    /* BPM tracker and energy analyzer */
+    float bpm;
+    float bpm_confidence;
+    float energy;               /* Smoothed energy */
+    const char *energy_zone;
+
+    double process_ms;          /* Analysis cost of the last hop */
+} AnalysisSnapshot;
+
+typedef struct {
+    /* Inputs (owned by the caller) */
+    struct audio_data *audio;
+    struct cava_plan *plan;
+    double sensitivity;
+    int num_bars;
+    int hop_frames;
+
+    /* Analysis state (owned by the analysis thread once started) */
+    RhythmState *rhythm;
+    BPMTracker *bpm_tracker;
+    EnergyAnalyzer *energy;
+    double *hop_buffer;
+    unsigned long onset_count;
+    float last_onset_strength;
+    uint64_t frames_analyzed;
+    uint64_t published;
+
+    /* Triple buffer: writer fills slots[back], reader holds slots[front],
+     * 'middle' holds the latest published slot plus a fresh flag */
+    AnalysisSnapshot slots[3];
+    int back;
+    int front;
+    _Atomic int middle;
+
+    pthread_t thread;
+    _Atomic bool running;
+    bool started;
+} AnalysisThread;
+
+/* ============ Lifecycle ============ */
+
+/* Create analysis state for a plan made with cava_init(num_bars, ...) */
+AnalysisThread* analysis_create(struct audio_data *audio, struct cava_plan *plan,
+                                int num_bars, int hop_frames, double sensitivity);
+
+/* Start consuming audio->ring on a dedicated thread. Returns 0 on success. */
+int analysis_start(AnalysisThread *an);
+
+/* Stop and join the thread */
+void analysis_stop(AnalysisThread *an);
+
+/* Stop if running and free (does not destroy the cava plan) */
+void analysis_destroy(AnalysisThread *an);
+
+/* ============ Processing ============ */
+
+/* Analyze one hop of interleaved samples and publish a snapshot.
+ * Called by the thread; usable directly when no thread is running. */
+void analysis_process(AnalysisThread *an, const double *samples, int count);
+
+/* ============ Reader side (one reader thread) ============ */
+
+/* Latest published snapshot; valid until the next call */
+const AnalysisSnapshot* analysis_latest(AnalysisThread *an);
+
+/* Beat phase extrapolated from the snapshot to 'now' (CLOCK_MONOTONIC seconds) */
+float analysis_phase_at(const AnalysisSnapshot *snap, double now);
+
+#endif /* ANALYSIS_H */
@@ -12,6 +12,8 @@
 #include <string.h>
 #include <unistd.h>
 
+#include "ring_buffer.h"
+
 // Number of samples to read from audio source per channel
 #define BUFFER_SIZE 512
 
@@ -19,12 +21,13 @@
 enum input_method {
     INPUT_PIPEWIRE,
     INPUT_PULSE,
-    INPUT_COREAUDIO
+    INPUT_COREAUDIO,
+    INPUT_FILE
 };
 
 // Shared audio data structure between input thread and main thread
 struct audio_data {
-    double *cava_in;           // Input buffer for FFT processing
+    struct audio_ring ring;    // Lock-free sample ring (capture -> analysis)
 
     int input_buffer_size;     // Size of input buffer
     int cava_buffer_size;      // Size of cava processing buffer
@@ -39,7 +42,6 @@ struct audio_data {
 
     int terminate;             // Flag to terminate audio thread
     char error_message[1024];  // Error message buffer
-    int samples_counter;       // Number of samples in buffer
     int IEEE_FLOAT;            // 32-bit format type (0=int, 1=float)
 
     // PipeWire specific
@@ -47,7 +49,10 @@ struct audio_data {
     int remix;                 // Remix channels
     int virtual_node;          // Virtual node flag
 
-    pthread_mutex_t lock;      // Thread synchronization
+    // File input specific
+    int file_loop;             // Restart at end of file instead of terminating
+
+    pthread_mutex_t lock;      // Guards source/threadparams/terminate (not samples)
 };
 
 // Common functions
@@ -56,7 +61,33 @@ void signal_threadparams(struct audio_data *data);
 void signal_terminate(struct audio_data *data);
 int write_to_cava_input_buffers(int16_t size, unsigned char *buf, void *data);
 
+// File input (WAV or raw PCM, memory-mapped)
+// Raw PCM uses the rate/channels/format already set on audio_data
+struct audio_file {
+    const unsigned char *map;  // Whole file mapping
+    size_t map_size;
+    const unsigned char *data; // Start of sample data
+    size_t data_size;
+    size_t pos;                // Byte offset of next frame
+    int bytes_per_sample;      // On disk (3 = packed 24-bit)
+    int frame_bytes;
+};
+
+// Open and parse; sets rate/channels/format/IEEE_FLOAT on audio
+// Returns 0 on success, -1 with audio->error_message set
+int audio_file_open(struct audio_file *file, const char *path, struct audio_data *audio);
+void audio_file_close(struct audio_file *file);
+void audio_file_rewind(struct audio_file *file);
+
+// Push up to frames frames into the sample ring; returns frames pushed (0 at EOF)
+int audio_file_feed(struct audio_file *file, struct audio_data *audio, int frames);
+
+// Length of the sample data in seconds
+double audio_file_duration(const struct audio_file *file, const struct audio_data *audio);
+
 // Audio input thread functions
+void *input_file(void *data);  // Realtime-paced file playback
+
 #ifdef PIPEWIRE
 void *input_pipewire(void *data);
 #endif
@@ -4,68 +4,61 @@
 #include "audio.h"
 #include <limits.h>
 
-// Write samples to the cava input buffer
-// Handles different bit depths and converts to double
+// Samples converted per chunk before being pushed into the ring
+#define CONVERT_CHUNK 1024
+
+// Convert one raw sample to the double scale cavacore expects
+static inline double convert_sample(const struct audio_data *audio, const unsigned char *p,
+                                    int bytes_per_sample) {
+    switch (bytes_per_sample) {
+    case 1:
+        return *(const uint8_t *)p * UCHAR_MAX;
+    case 3:
+    case 4:
+        if (audio->IEEE_FLOAT)
+            return *(const float *)p * USHRT_MAX;
+        return (double)*(const int32_t *)p / USHRT_MAX;
+    default:
+        return *(const int16_t *)p;
+    }
+}
+
+// Write samples to the cava input ring
+// Handles different bit depths and converts to double. Called from the
+// realtime capture thread: never blocks and never shifts old samples.
 int write_to_cava_input_buffers(int16_t size, unsigned char *buf, void *data) {
     struct audio_data *audio = (struct audio_data *)data;
-
-    pthread_mutex_lock(&audio->lock);
+    double chunk[CONVERT_CHUNK];
 
     int bytes_per_sample = audio->format / 8;
-    int samples = size / audio->channels;
-
-    // Shift existing samples
-    if (audio->samples_counter + samples > audio->cava_buffer_size) {
-        int overflow = audio->samples_counter + samples - audio->cava_buffer_size;
-        for (int i = 0; i < audio->cava_buffer_size - overflow; i++) {
-            audio->cava_in[i] = audio->cava_in[i + overflow];
-        }
-        audio->samples_counter = audio->cava_buffer_size - samples;
-    }
+    int total = (size / audio->channels) * audio->channels;
 
-    // Convert and store new samples
     int n = 0;
-    for (int i = 0; i < (int)(samples * audio->channels); i++) {
-        switch (bytes_per_sample) {
-        case 1: {
-            const uint8_t *buf8 = (const uint8_t *)&buf[n];
-            audio->cava_in[i + audio->samples_counter] = *buf8 * UCHAR_MAX;
-            break;
-        }
-        case 3:
-        case 4:
-            if (audio->IEEE_FLOAT) {
-                const float *ieee_float = (const float *)&buf[n];
-                audio->cava_in[i + audio->samples_counter] = *ieee_float * USHRT_MAX;
-            } else {
-                const int32_t *buf32 = (const int32_t *)&buf[n];
-                audio->cava_in[i + audio->samples_counter] = (double)*buf32 / USHRT_MAX;
-            }
-            break;
-        default: {
-            const int16_t *buf16 = (const int16_t *)&buf[n];
-            audio->cava_in[i + audio->samples_counter] = *buf16;
-            break;
-        }
+    while (total > 0) {
+        int count = total < CONVERT_CHUNK ? total : CONVERT_CHUNK;
+        for (int i = 0; i < count; i++) {
+            chunk[i] = convert_sample(audio, &buf[n], bytes_per_sample);
+            n += bytes_per_sample;
         }
-        n += bytes_per_sample;
+        audio_ring_write(&audio->ring, chunk, count);
+        total -= count;
     }
-    audio->samples_counter += samples;
 
-    pthread_mutex_unlock(&audio->lock);
     return 0;
 }
 
 // Reset output buffers to zero (silence)
+// Must be called from the producer (capture) thread
 void reset_output_buffers(struct audio_data *data) {
     struct audio_data *audio = (struct audio_data *)data;
+    static const double zeros[CONVERT_CHUNK];
 
-    pthread_mutex_lock(&audio->lock);
-    for (uint16_t n = 0; n < audio->cava_buffer_size; n++) {
-        audio->cava_in[n] = 0;
+    int remaining = audio->cava_buffer_size;
+    while (remaining > 0) {
+        int count = remaining < CONVERT_CHUNK ? remaining : CONVERT_CHUNK;
+        audio_ring_write(&audio->ring, zeros, count);
+        remaining -= count;
     }
-    audio->samples_counter = audio->cava_buffer_size;
-    pthread_mutex_unlock(&audio->lock);
 }
 
 // Signal that thread parameters are ready
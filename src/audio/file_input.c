@@ -0,0 +1,248 @@
+// File audio input (WAV or raw PCM)
+// Memory-maps the file and streams it through write_to_cava_input_buffers,
+// either paced to realtime (input thread) or as fast as the caller pulls
+
+#include "audio.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#define WAV_FORMAT_PCM 1
+#define WAV_FORMAT_IEEE_FLOAT 3
+#define WAV_FORMAT_EXTENSIBLE 0xFFFE
+
+// Frames converted per write when expanding packed 24-bit samples
+#define EXPAND_FRAMES 512
+
+static uint16_t read_le16(const unsigned char *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t read_le32(const unsigned char *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+           ((uint32_t)p[3] << 24);
+}
+
+// Parse RIFF/WAVE chunks; fills format fields on success
+static int parse_wav(struct audio_file *file, struct audio_data *audio) {
+    const unsigned char *p = file->map;
+    size_t size = file->map_size;
+    int have_fmt = 0;
+
+    size_t off = 12;
+    while (off + 8 <= size) {
+        uint32_t chunk_size = read_le32(p + off + 4);
+        const unsigned char *body = p + off + 8;
+        size_t avail = size - off - 8;
+
+        if (!memcmp(p + off, "fmt ", 4) && chunk_size >= 16 && avail >= 16) {
+            uint16_t tag = read_le16(body);
+            if (tag == WAV_FORMAT_EXTENSIBLE && chunk_size >= 26 && avail >= 26)
+                tag = read_le16(body + 24);  // First two bytes of SubFormat GUID
+
+            if (tag != WAV_FORMAT_PCM && tag != WAV_FORMAT_IEEE_FLOAT) {
+                snprintf(audio->error_message, sizeof(audio->error_message),
+                         "Unsupported WAV encoding %u (PCM or float only)", tag);
+                return -1;
+            }
+
+            audio->channels = read_le16(body + 2);
+            audio->rate = read_le32(body + 4);
+            file->bytes_per_sample = read_le16(body + 14) / 8;
+            audio->IEEE_FLOAT = tag == WAV_FORMAT_IEEE_FLOAT;
+            have_fmt = 1;
+        } else if (!memcmp(p + off, "data", 4)) {
+            if (!have_fmt)
+                break;
+            file->data = body;
+            file->data_size = chunk_size < avail ? chunk_size : avail;
+            return 0;
+        }
+
+        off += 8 + chunk_size + (chunk_size & 1);  // Chunks are word aligned
+    }
+
+    snprintf(audio->error_message, sizeof(audio->error_message),
+             "Malformed WAV file: missing fmt or data chunk");
+    return -1;
+}
+
+int audio_file_open(struct audio_file *file, const char *path, struct audio_data *audio) {
+    memset(file, 0, sizeof(*file));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        snprintf(audio->error_message, sizeof(audio->error_message),
+                 "Could not open audio file %s: %s", path, strerror(errno));
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        snprintf(audio->error_message, sizeof(audio->error_message),
+                 "Audio file %s is empty or unreadable", path);
+        close(fd);
+        return -1;
+    }
+
+    file->map_size = (size_t)st.st_size;
+    file->map = mmap(NULL, file->map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (file->map == MAP_FAILED) {
+        file->map = NULL;
+        snprintf(audio->error_message, sizeof(audio->error_message),
+                 "Could not map audio file %s: %s", path, strerror(errno));
+        return -1;
+    }
+    madvise((void *)file->map, file->map_size, MADV_SEQUENTIAL);
+
+    if (file->map_size >= 12 && !memcmp(file->map, "RIFF", 4) &&
+        !memcmp(file->map + 8, "WAVE", 4)) {
+        if (parse_wav(file, audio) != 0) {
+            audio_file_close(file);
+            return -1;
+        }
+    } else {
+        // Raw PCM: interleaved, little endian, in the format already set on audio
+        file->data = file->map;
+        file->data_size = file->map_size;
+        file->bytes_per_sample = audio->format / 8;
+    }
+
+    if (audio->channels < 1 || audio->channels > 2) {
+        snprintf(audio->error_message, sizeof(audio->error_message),
+                 "Audio file must be mono or stereo (got %u channels)", audio->channels);
+        audio_file_close(file);
+        return -1;
+    }
+    if (file->bytes_per_sample < 1 || file->bytes_per_sample > 4 || audio->rate == 0) {
+        snprintf(audio->error_message, sizeof(audio->error_message),
+                 "Unsupported audio file sample format");
+        audio_file_close(file);
+        return -1;
+    }
+
+    // Packed 24-bit is widened to 32-bit before conversion
+    audio->format = file->bytes_per_sample == 3 ? 32 : file->bytes_per_sample * 8;
+    file->frame_bytes = file->bytes_per_sample * audio->channels;
+    file->pos = 0;
+    return 0;
+}
+
+void audio_file_close(struct audio_file *file) {
+    if (file->map)
+        munmap((void *)file->map, file->map_size);
+    memset(file, 0, sizeof(*file));
+}
+
+void audio_file_rewind(struct audio_file *file) {
+    file->pos = 0;
+}
+
+// Push packed 24-bit frames as left-justified 32-bit samples
+static void feed_packed24(const unsigned char *src, int frames, struct audio_data *audio) {
+    int32_t wide[EXPAND_FRAMES * 2];
+
+    while (frames > 0) {
+        int count = frames < EXPAND_FRAMES ? frames : EXPAND_FRAMES;
+        int samples = count * (int)audio->channels;
+        for (int i = 0; i < samples; i++, src += 3)
+            wide[i] = (int32_t)((uint32_t)src[0] << 8 | (uint32_t)src[1] << 16 |
+                                (uint32_t)src[2] << 24);
+        write_to_cava_input_buffers(samples, (unsigned char *)wide, audio);
+        frames -= count;
+    }
+}
+
+int audio_file_feed(struct audio_file *file, struct audio_data *audio, int frames) {
+    size_t remaining = (file->data_size - file->pos) / file->frame_bytes;
+    if ((size_t)frames > remaining)
+        frames = (int)remaining;
+    if (frames <= 0)
+        return 0;
+
+    const unsigned char *src = file->data + file->pos;
+    if (file->bytes_per_sample == 3) {
+        feed_packed24(src, frames, audio);
+    } else {
+        // write_to_cava_input_buffers takes an int16_t sample count
+        int max_frames = INT16_MAX / (int)audio->channels;
+        int left = frames;
+        while (left > 0) {
+            int count = left < max_frames ? left : max_frames;
+            write_to_cava_input_buffers(count * audio->channels, (unsigned char *)src, audio);
+            src += (size_t)count * file->frame_bytes;
+            left -= count;
+        }
+    }
+
+    file->pos += (size_t)frames * file->frame_bytes;
+    return frames;
+}
+
+double audio_file_duration(const struct audio_file *file, const struct audio_data *audio) {
+    if (!file->frame_bytes || !audio->rate)
+        return 0.0;
+    return (double)(file->data_size / file->frame_bytes) / audio->rate;
+}
+
+static void timespec_add_ns(struct timespec *ts, long ns) {
+    ts->tv_nsec += ns;
+    while (ts->tv_nsec >= 1000000000L) {
+        ts->tv_nsec -= 1000000000L;
+        ts->tv_sec++;
+    }
+}
+
+// Sleep until an absolute CLOCK_MONOTONIC deadline
+static void sleep_until(const struct timespec *deadline) {
+#ifdef __APPLE__
+    struct timespec now, rel;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    rel.tv_sec = deadline->tv_sec - now.tv_sec;
+    rel.tv_nsec = deadline->tv_nsec - now.tv_nsec;
+    if (rel.tv_nsec < 0) {
+        rel.tv_nsec += 1000000000L;
+        rel.tv_sec--;
+    }
+    if (rel.tv_sec >= 0)
+        nanosleep(&rel, NULL);
+#else
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, deadline, NULL) == EINTR)
+        ;
+#endif
+}
+
+// Realtime-paced file playback thread: same contract as the live backends
+void *input_file(void *data) {
+    struct audio_data *audio = (struct audio_data *)data;
+    struct audio_file file;
+
+    if (audio_file_open(&file, audio->source, audio) != 0) {
+        audio->terminate = 1;
+        return 0;
+    }
+    signal_threadparams(audio);
+
+    // Absolute deadlines keep long playback from drifting
+    long period_ns = (long)(1000000000.0 * BUFFER_SIZE / audio->rate);
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+
+    while (!audio->terminate) {
+        if (audio_file_feed(&file, audio, BUFFER_SIZE) == 0) {
+            if (!audio->file_loop) {
+                audio->terminate = 1;
+                break;
+            }
+            audio_file_rewind(&file);
+            continue;
+        }
+        timespec_add_ns(&deadline, period_ns);
+        sleep_until(&deadline);
+    }
+
+    audio_file_close(&file);
+    return 0;
+}
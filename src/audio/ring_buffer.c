@@ -0,0 +1,123 @@
+// Lock-free single-producer/single-consumer sample ring
+
+#include "ring_buffer.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+int audio_ring_init(struct audio_ring *ring, size_t capacity) {
+    size_t cap = 1;
+    while (cap < capacity)
+        cap <<= 1;
+
+    ring->data = (double *)calloc(cap, sizeof(double));
+    if (!ring->data)
+        return -1;
+
+    ring->capacity = cap;
+    ring->mask = cap - 1;
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->write_claim, 0);
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->dropped, 0);
+    return 0;
+}
+
+void audio_ring_free(struct audio_ring *ring) {
+    free(ring->data);
+    ring->data = NULL;
+    ring->capacity = 0;
+    ring->mask = 0;
+}
+
+// Copy count samples starting at absolute position pos into the ring slots
+static void ring_store(struct audio_ring *ring, uint64_t pos, const double *src, size_t count) {
+    size_t start = (size_t)(pos & ring->mask);
+    size_t first = ring->capacity - start;
+    if (first > count)
+        first = count;
+
+    memcpy(ring->data + start, src, first * sizeof(double));
+    if (count > first)
+        memcpy(ring->data, src + first, (count - first) * sizeof(double));
+}
+
+static void ring_load(const struct audio_ring *ring, uint64_t pos, double *dst, size_t count) {
+    size_t start = (size_t)(pos & ring->mask);
+    size_t first = ring->capacity - start;
+    if (first > count)
+        first = count;
+
+    memcpy(dst, ring->data + start, first * sizeof(double));
+    if (count > first)
+        memcpy(dst + first, ring->data, (count - first) * sizeof(double));
+}
+
+void audio_ring_write(struct audio_ring *ring, const double *src, size_t count) {
+    if (count == 0)
+        return;
+
+    // Only the producer writes head, so a relaxed load sees our own last store
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint64_t end = head + count;
+
+    // Anything beyond one ring's worth would be overwritten immediately
+    if (count > ring->capacity) {
+        src += count - ring->capacity;
+        head = end - ring->capacity;
+        count = ring->capacity;
+    }
+
+    // Announce the slots we are about to overwrite before touching them
+    atomic_store_explicit(&ring->write_claim, end, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    ring_store(ring, head, src, count);
+
+    atomic_store_explicit(&ring->head, end, memory_order_release);
+}
+
+size_t audio_ring_read(struct audio_ring *ring, double *dst, size_t max_count) {
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+
+    // Producer lapped us: skip to the oldest sample still in the ring
+    if (head - tail > ring->capacity) {
+        uint64_t lost = head - ring->capacity - tail;
+        atomic_fetch_add_explicit(&ring->dropped, lost, memory_order_relaxed);
+        tail = head - ring->capacity;
+    }
+
+    size_t count = (size_t)(head - tail);
+    if (count > max_count)
+        count = max_count;
+    if (count == 0)
+        return 0;
+
+    ring_load(ring, tail, dst, count);
+
+    // Any slot the producer claimed while we copied may be torn; discard those
+    atomic_thread_fence(memory_order_acquire);
+    uint64_t claim = atomic_load_explicit(&ring->write_claim, memory_order_relaxed);
+    if (claim > tail + ring->capacity) {
+        uint64_t torn = claim - ring->capacity - tail;
+        if (torn >= count) {
+            atomic_fetch_add_explicit(&ring->dropped, count, memory_order_relaxed);
+            atomic_store_explicit(&ring->tail, tail + count, memory_order_release);
+            return 0;
+        }
+        memmove(dst, dst + torn, (count - torn) * sizeof(double));
+        atomic_fetch_add_explicit(&ring->dropped, torn, memory_order_relaxed);
+        tail += torn;
+        count -= (size_t)torn;
+    }
+
+    atomic_store_explicit(&ring->tail, tail + count, memory_order_release);
+    return count;
+}
+
+size_t audio_ring_available(struct audio_ring *ring) {
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    return (size_t)(head - tail);
+}
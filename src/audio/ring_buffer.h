@@ -0,0 +1,43 @@
+// Lock-free single-producer/single-consumer sample ring
+// Carries interleaved samples from the audio capture thread to the analysis side
+
+#pragma once
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Ring of doubles with drop-oldest overflow policy.
+//
+// The producer never waits: when the consumer falls behind, the oldest samples
+// are overwritten and the consumer skips past them on its next read. Positions
+// are free-running 64-bit counters, so head - tail is always the fill level.
+//
+// write_claim is advanced before the producer touches any slot and head after
+// the slots are written, seqlock style. The consumer re-checks write_claim
+// after copying so it can discard samples that were overwritten mid-read.
+struct audio_ring {
+    double *data;
+    size_t capacity;            // Power of two
+    size_t mask;
+
+    _Atomic uint64_t head;      // Samples published by producer
+    _Atomic uint64_t write_claim; // Samples producer may be writing
+    _Atomic uint64_t tail;      // Samples consumed
+    _Atomic uint64_t dropped;   // Samples lost to overflow (statistics)
+};
+
+// Allocate ring storage, rounding capacity up to a power of two
+// Returns 0 on success, -1 on allocation failure
+int audio_ring_init(struct audio_ring *ring, size_t capacity);
+void audio_ring_free(struct audio_ring *ring);
+
+// Producer side: append samples, overwriting the oldest on overflow
+void audio_ring_write(struct audio_ring *ring, const double *src, size_t count);
+
+// Consumer side: copy up to max_count of the oldest unread samples into dst
+// Returns number of samples copied
+size_t audio_ring_read(struct audio_ring *ring, double *dst, size_t max_count);
+
+// Number of unread samples (may exceed capacity after an overrun)
+size_t audio_ring_available(struct audio_ring *ring);
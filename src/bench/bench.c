@@ -0,0 +1,1598 @@
+/*
+ * Headless Frame Benchmark - ASCII Dancer v3.2+
+ *
+ * Drives the braille dancer update/compose pipeline without ncurses so the
+ * hot path can be measured in isolation and on CI. Spectra come from a
+ * deterministic synthetic track or from a WAV/raw file run through cavacore.
+ * Every combination of canvas size and effect setup is run for N frames and
+ * per-stage ns/frame percentiles are written as CSV or JSON.
+ *
+ * Stages nest: particles_update is part of dancer_update, and
+ * braille_canvas_finalize is part of dancer_compose_frame.
+ *
+ * --canvas instead times the BrailleCanvas primitives alone on large
+ * canvases (default 200x60 and 400x120 cells): a figure per 50x26 cells
+ * ("canvas") or a single figure in the middle ("canvas-single", a small
+ * dancer in a big terminal) is begun, drawn and finalized each frame.
+ *
+ * --check-encoders compares every braille encoder available on this CPU
+ * with the scalar reference on random rows and reports their speed.
+ *
+ * --pose-index checks nearest-pose queries against a linear scan on random
+ * libraries of 1k, 10k and 100k poses and reports both query times.
+ *
+ * --particles runs 1k to MAX_PARTICLES live particles under body repulsion
+ * with every particle step kernel available on this CPU, checks each
+ * against the scalar kernel and reports update throughput.
+ *
+ * --ring streams numbered samples from a producer thread through the audio
+ * sample ring while the consumer reads at random sizes and pauses, and
+ * checks nothing arrives reordered or torn and that received plus dropped
+ * equals produced.
+ *
+ * --ingest times cavacore's mirrored-history ingest and windowing against
+ * the old shift-the-whole-buffer path at a few hop sizes, mono and stereo,
+ * and checks both hand the FFT the same windowed input.
+ *
+ * --check-spectrum compares every spectrum kernel available on this CPU with
+ * the hypot()/plain-loop reference on audio samples (--file, or a synthetic
+ * mix), then runs cava_execute with each kernel set next to a plan on the
+ * reference kernels; both must agree within the spectrum_kernels.h
+ * tolerance.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <getopt.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "audio/audio.h"
+#include "fft/cavacore.h"
+#include "effects/particles.h"
+#include "dancer/dancer.h"
+#include "audio/rhythm.h"
+#include "audio/bpm_tracker.h"
+#include "audio/energy_analyzer.h"
+#include "effects/background_fx.h"
+#include "braille/braille_canvas.h"
+#include "braille/braille_encode.h"
+#include "braille/pose_index.h"
+#include "bench/bench_stages.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define NUM_BARS 24            /* Same bar count as the interactive build */
+#define DEFAULT_FRAMES 2000
+#define DEFAULT_WARMUP 120
+#define DEFAULT_FPS 60
+#define DEFAULT_SEED 1
+#define SYNTH_SECONDS 8        /* 16 beats at 120 BPM, then loops */
+#define MAX_SIZES 16
+#define CANVAS_SIZES "200x60,400x120"
+#define CANVAS_TILE_W 50       /* Cells per figure tile in --canvas mode */
+#define CANVAS_TILE_H 26
+#define CHECK_CASES 20000      /* Random rows per encoder in --check-encoders */
+#define CHECK_MAX_CELLS 300
+#define CHECK_GUARD 64         /* Sentinel bytes/cells that must stay untouched */
+#define CHECK_TIMED_ROWS 200000
+#define INDEX_QUERIES 20000    /* Random targets per library in --pose-index */
+#define PARTICLE_STEPS 600     /* Updates per run in --particles */
+#define PARTICLE_FIELD_W 800   /* Pixels; particles spread over the field */
+#define PARTICLE_FIELD_H 480
+#define RING_CAPACITY 4096     /* Samples in the ring in --ring */
+#define RING_SAMPLES 20000000  /* Samples the producer writes */
+#define RING_PAUSE_NS 200000   /* Longest random stall on either side */
+#define INGEST_RATE 44100
+#define INGEST_FRAMES 3000     /* cava_execute calls per hop size in --ingest */
+#define INGEST_POOL 65536      /* Random samples the hops are taken from */
+#define SPECTRUM_SAMPLES 352800 /* 4 s of 44.1 kHz stereo in --check-spectrum */
+#define SPECTRUM_CASES 2000    /* Random lengths and offsets per kernel */
+#define SPECTRUM_MAX_LEN 4096
+#define SPECTRUM_TIMED 2000
+
+/* Largest difference allowed against a reference, per spectrum_kernels.h */
+#ifdef CAVA_SINGLE_PRECISION
+#define SPECTRUM_TOLERANCE 1e-6
+#else
+#define SPECTRUM_TOLERANCE 1e-12
+#endif
+
+uint64_t bench_stage_ns[BENCH_STAGE_COUNT];
+
+typedef enum {
+    STAGE_ANALYSIS,            /* rhythm, bands, BPM, energy */
+    STAGE_BGFX_UPDATE,         /* background_fx_update + audio/band feeds */
+    STAGE_DANCER_UPDATE,       /* dancer_update_with_rhythm */
+    STAGE_PARTICLES_UPDATE,    /* hook: inside dancer_update */
+    STAGE_COMPOSE,             /* dancer_compose_frame */
+    STAGE_CANVAS_FINALIZE,     /* hook: inside dancer_compose_frame */
+    STAGE_FRAME,               /* everything above */
+    STAGE_COUNT
+} Stage;
+
+static const char *stage_names[STAGE_COUNT] = {
+    "analysis", "background_fx_update", "dancer_update", "particles_update",
+    "dancer_compose_frame", "braille_canvas_finalize", "frame"
+};
+
+/* --canvas mode stages */
+typedef enum {
+    CANVAS_STAGE_BEGIN,        /* braille_canvas_begin */
+    CANVAS_STAGE_DRAW,         /* lines, curves and circles for every tile */
+    CANVAS_STAGE_FINALIZE,     /* braille_canvas_finalize */
+    CANVAS_STAGE_FRAME,        /* everything above */
+    CANVAS_STAGE_COUNT
+} CanvasStage;
+
+static const char *canvas_stage_names[CANVAS_STAGE_COUNT] = {
+    "canvas_begin", "canvas_draw", "canvas_finalize", "canvas_frame"
+};
+
+/* One effect setup; each toggles a single effect except "none" and "all" */
+typedef struct {
+    const char *name;
+    bool particles;
+    bool trails;
+    bool breathing;
+    bool ground;
+    bool shadow;
+    BackgroundFXType background;   /* BG_NONE = background effects off */
+} EffectSetup;
+
+static const EffectSetup effect_setups[] = {
+    { "none",       false, false, false, false, false, BG_NONE },
+    { "particles",  true,  false, false, false, false, BG_NONE },
+    { "trails",     false, true,  false, false, false, BG_NONE },
+    { "breathing",  false, false, true,  false, false, BG_NONE },
+    { "ground",     false, false, false, true,  false, BG_NONE },
+    { "shadow",     false, false, false, false, true,  BG_NONE },
+    /* Background effects emit into the dancer's particle system */
+    { "bg-ambient", true,  false, false, false, false, BG_AMBIENT_FIELD },
+    { "bg-waves",   true,  false, false, false, false, BG_SPECTRAL_WAVES },
+    { "bg-aura",    true,  false, false, false, false, BG_ENERGY_AURA },
+    { "bg-burst",   true,  false, false, false, false, BG_BEAT_BURST },
+    { "bg-ribbons", true,  false, false, false, false, BG_FREQUENCY_RIBBONS },
+    { "bg-rain",    true,  false, false, false, false, BG_PARTICLE_RAIN },
+    { "bg-vortex",  true,  false, false, false, false, BG_SPIRAL_VORTEX },
+    { "all",        true,  true,  true,  true,  true,  BG_AMBIENT_FIELD },
+};
+#define NUM_EFFECT_SETUPS ((int)(sizeof(effect_setups) / sizeof(effect_setups[0])))
+
+typedef struct {
+    int frames;
+    int warmup;
+    int fps;
+    unsigned int seed;
+    int num_sizes;
+    int sizes[MAX_SIZES][2];
+    const char *effects;       /* Comma-separated filter, NULL = all */
+    const char *file;          /* NULL = synthetic spectra */
+    bool json;
+    bool canvas;               /* Canvas primitives only */
+} BenchOptions;
+
+/* Precomputed spectrum frames, replayed in a loop */
+typedef struct {
+    double *bars;              /* frames * NUM_BARS */
+    int frames;
+} SpectrumTrack;
+
+static uint64_t now_ns(void) {
+    return bench_clock_ns();
+}
+
+/* ============ Spectrum sources ============ */
+
+/* Kick on the beat, hats on the off-beat, slowly drifting mids, light noise */
+static int track_synthetic(SpectrumTrack *track, int fps, unsigned int seed) {
+    track->frames = SYNTH_SECONDS * fps;
+    track->bars = malloc(sizeof(double) * track->frames * NUM_BARS);
+    if (!track->bars) return -1;
+
+    uint32_t lcg = seed * 2654435761u + 1;
+    for (int f = 0; f < track->frames; f++) {
+        double t = (double)f / fps;
+        double beat = fmod(t * 2.0, 1.0);              /* 120 BPM */
+        double offbeat = fmod(t * 2.0 + 0.5, 1.0);
+        double kick = exp(-beat * 12.0);
+        double hat = exp(-offbeat * 20.0);
+
+        for (int i = 0; i < NUM_BARS; i++) {
+            double x = (double)i / (NUM_BARS - 1);
+            lcg = lcg * 1664525u + 1013904223u;
+            double noise = (lcg >> 8) / 16777216.0;
+
+            double v = (1.0 - x) * (1.0 - x) * kick * 0.9
+                     + (0.25 + 0.15 * sin(2.0 * M_PI * t * 0.25 + i)) * x * (1.0 - x) * 2.0
+                     + x * x * hat * 0.7
+                     + noise * 0.05;
+            track->bars[f * NUM_BARS + i] = v > 1.0 ? 1.0 : v;
+        }
+    }
+    return 0;
+}
+
+/* Run a file through cavacore once, one hop of rate/fps frames per spectrum */
+static int track_from_file(SpectrumTrack *track, const char *path, int fps) {
+    struct audio_data audio;
+    struct audio_file file;
+
+    memset(&audio, 0, sizeof(audio));
+    audio.rate = 44100;
+    audio.channels = 2;
+    audio.format = 16;
+    audio.cava_buffer_size = 16384;
+
+    if (audio_file_open(&file, path, &audio) != 0) {
+        fprintf(stderr, "%s\n", audio.error_message);
+        return -1;
+    }
+
+    /* A whole hop has to fit in the ring, as in --analyze */
+    int hop = (int)(audio.rate / fps);
+    if (hop * (int)audio.channels > audio.cava_buffer_size) {
+        audio.cava_buffer_size = hop * (int)audio.channels;
+    }
+    if (audio_ring_init(&audio.ring, audio.cava_buffer_size) != 0) {
+        audio_file_close(&file);
+        return -1;
+    }
+
+    struct cava_plan *plan = cava_init(NUM_BARS, audio.rate, audio.channels, 1,
+                                       0.77, 50, 10000);
+    if (!plan || plan->status != 0) {
+        fprintf(stderr, "FFT init error: %s\n", plan ? plan->error_message : "out of memory");
+        free(plan);
+        audio_ring_free(&audio.ring);
+        audio_file_close(&file);
+        return -1;
+    }
+
+    int capacity = (int)(audio_file_duration(&file, &audio) * fps) + 1;
+    double *cava_in = calloc(audio.cava_buffer_size, sizeof(double));
+    track->bars = malloc(sizeof(double) * capacity * NUM_BARS);
+    track->frames = 0;
+
+    if (cava_in && track->bars) {
+        while (track->frames < capacity && audio_file_feed(&file, &audio, hop) > 0) {
+            double *out = track->bars + track->frames * NUM_BARS;
+            int samples = (int)audio_ring_read(&audio.ring, cava_in, audio.cava_buffer_size);
+            cava_execute(cava_in, samples, out, plan);
+            for (int i = 0; i < NUM_BARS; i++) {
+                if (out[i] > 1.0) out[i] = 1.0;
+            }
+            track->frames++;
+        }
+    }
+
+    free(cava_in);
+    cava_destroy(plan);
+    audio_ring_free(&audio.ring);
+    audio_file_close(&file);
+
+    if (track->frames == 0) {
+        fprintf(stderr, "No audio frames in %s\n", path);
+        free(track->bars);
+        track->bars = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+/* ============ Statistics ============ */
+
+static int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/* Nearest-rank percentile of a sorted array */
+static uint64_t percentile(const uint64_t *sorted, int n, double p) {
+    int rank = (int)ceil(p / 100.0 * n);
+    if (rank < 1) rank = 1;
+    if (rank > n) rank = n;
+    return sorted[rank - 1];
+}
+
+static void report_stage(FILE *out, bool json, bool *first, int w, int h,
+                         const char *effects, const char *stage, uint64_t *samples, int n) {
+    qsort(samples, n, sizeof(uint64_t), compare_u64);
+
+    double sum = 0;
+    for (int i = 0; i < n; i++) sum += (double)samples[i];
+    double mean = sum / n;
+
+    if (json) {
+        fprintf(out, "%s\n    {\"canvas\": \"%dx%d\", \"effects\": \"%s\", \"stage\": \"%s\", "
+                "\"frames\": %d, \"mean_ns\": %.0f, \"p50_ns\": %llu, \"p90_ns\": %llu, "
+                "\"p99_ns\": %llu, \"max_ns\": %llu}",
+                *first ? "" : ",", w, h, effects, stage, n, mean,
+                (unsigned long long)percentile(samples, n, 50),
+                (unsigned long long)percentile(samples, n, 90),
+                (unsigned long long)percentile(samples, n, 99),
+                (unsigned long long)samples[n - 1]);
+    } else {
+        fprintf(out, "%dx%d,%s,%s,%d,%.0f,%llu,%llu,%llu,%llu\n",
+                w, h, effects, stage, n, mean,
+                (unsigned long long)percentile(samples, n, 50),
+                (unsigned long long)percentile(samples, n, 90),
+                (unsigned long long)percentile(samples, n, 99),
+                (unsigned long long)samples[n - 1]);
+    }
+    *first = false;
+}
+
+/* ============ Driver ============ */
+
+static bool effect_selected(const char *filter, const char *name) {
+    if (!filter) return true;
+
+    size_t len = strlen(name);
+    const char *p = filter;
+    while (*p) {
+        const char *end = strchr(p, ',');
+        size_t n = end ? (size_t)(end - p) : strlen(p);
+        if (n == len && strncmp(p, name, len) == 0) return true;
+        if (!end) break;
+        p = end + 1;
+    }
+    return false;
+}
+
+static int run_case(const BenchOptions *opt, const SpectrumTrack *track, int w, int h,
+                    const EffectSetup *setup, uint64_t *samples[STAGE_COUNT],
+                    FILE *out, bool *first) {
+    /* Identical input for every case: same effects seed, fresh dancer state */
+    dancer_set_seed(opt->seed);
+    if (dancer_set_canvas_size(w, h) != 0) return -1;
+
+    struct dancer_state dancer;
+    dancer_init(&dancer);
+
+    dancer_set_particles(setup->particles);
+    dancer_set_trails(setup->trails);
+    dancer_set_breathing(setup->breathing);
+    dancer_set_ground(setup->ground);
+    dancer_set_shadow(setup->shadow);
+
+    RhythmState *rhythm = rhythm_init();
+    BPMTracker *bpm_tracker = bpm_tracker_create();
+    EnergyAnalyzer *energy = energy_analyzer_create();
+    BackgroundFX *bg_fx = NULL;
+    if (setup->background != BG_NONE) {
+        bg_fx = background_fx_create(dancer_get_particle_system());
+        if (bg_fx) {
+            background_fx_seed(bg_fx, opt->seed);
+            background_fx_enable(bg_fx, true);
+            background_fx_set_type(bg_fx, setup->background);
+        }
+    }
+
+    /* UTF-8 frame: 3 bytes per cell plus newline per row */
+    char *frame = malloc((size_t)h * (w * 3 + 1) + 1);
+    if (!rhythm || !bpm_tracker || !energy || !frame ||
+        (setup->background != BG_NONE && !bg_fx)) {
+        free(frame);
+        background_fx_destroy(bg_fx);
+        energy_analyzer_destroy(energy);
+        bpm_tracker_destroy(bpm_tracker);
+        rhythm_destroy(rhythm);
+        dancer_cleanup();
+        return -1;
+    }
+
+    float dt = 1.0f / opt->fps;
+    dancer_set_frame_dt(dt);
+    double elapsed = 0.0;
+    float spectrum[NUM_BARS];
+
+    for (int f = 0; f < opt->warmup + opt->frames; f++) {
+        const double *bars = track->bars + (f % track->frames) * NUM_BARS;
+        uint64_t t[STAGE_COUNT] = { 0 };
+
+        uint64_t start = now_ns();
+
+        /* Analysis, as in the main loop */
+        for (int i = 0; i < NUM_BARS; i++) spectrum[i] = (float)bars[i];
+        rhythm_update(rhythm, spectrum, NUM_BARS, dt);
+
+        double bass, mid, treble;
+        calculate_bands(bars, NUM_BARS, &bass, &mid, &treble);
+
+        elapsed += dt;
+        if (rhythm_onset_detected(rhythm)) {
+            bpm_tracker_tap(bpm_tracker, elapsed);
+        }
+        bpm_tracker_update(bpm_tracker, dt);
+
+        energy_analyzer_update_bands(energy,
+            (float)bass * 0.5f, (float)bass,
+            (float)(bass + mid) * 0.5f, (float)mid,
+            (float)(mid + treble) * 0.5f, (float)treble);
+        energy_analyzer_update_pace(energy,
+            bpm_tracker_get_bpm(bpm_tracker),
+            rhythm_get_onset_strength(rhythm),
+            rhythm_onset_detected(rhythm) ? 1.0f : 0.0f);
+
+        uint64_t mark = now_ns();
+        t[STAGE_ANALYSIS] = mark - start;
+
+        if (bg_fx) {
+            background_fx_update(bg_fx, dt);
+            background_fx_update_audio(bg_fx,
+                energy_analyzer_get_smoothed(energy),
+                (float)bass, (float)mid, (float)treble,
+                rhythm_onset_detected(rhythm));
+            background_fx_update_bands(bg_fx,
+                (float)bass * 0.5f, (float)bass,
+                (float)(bass + mid) * 0.5f, (float)mid,
+                (float)(mid + treble) * 0.5f, (float)treble);
+        }
+        uint64_t next = now_ns();
+        t[STAGE_BGFX_UPDATE] = next - mark;
+        mark = next;
+
+        memset(bench_stage_ns, 0, sizeof(bench_stage_ns));
+
+        dancer_update_with_rhythm(&dancer, bass, mid, treble,
+                                  rhythm_get_phase(rhythm),
+                                  rhythm_get_bpm(rhythm),
+                                  rhythm_onset_detected(rhythm),
+                                  rhythm_get_onset_strength(rhythm));
+        next = now_ns();
+        t[STAGE_DANCER_UPDATE] = next - mark;
+        mark = next;
+
+        dancer_compose_frame(&dancer, frame);
+        next = now_ns();
+        t[STAGE_COMPOSE] = next - mark;
+
+        t[STAGE_PARTICLES_UPDATE] = bench_stage_ns[BENCH_STAGE_PARTICLES_UPDATE];
+        t[STAGE_CANVAS_FINALIZE] = bench_stage_ns[BENCH_STAGE_CANVAS_FINALIZE];
+        t[STAGE_FRAME] = next - start;
+
+        if (f >= opt->warmup) {
+            for (int s = 0; s < STAGE_COUNT; s++) {
+                samples[s][f - opt->warmup] = t[s];
+            }
+        }
+    }
+
+    for (int s = 0; s < STAGE_COUNT; s++) {
+        report_stage(out, opt->json, first, w, h, setup->name, stage_names[s],
+                     samples[s], opt->frames);
+    }
+
+    free(frame);
+    background_fx_destroy(bg_fx);
+    energy_analyzer_destroy(energy);
+    bpm_tracker_destroy(bpm_tracker);
+    rhythm_destroy(rhythm);
+    dancer_cleanup();
+    return 0;
+}
+
+/* One stick figure per tile, swaying with the frame number */
+static void draw_canvas_tile(BrailleCanvas *canvas, int ox, int oy, int f) {
+    int pw = CANVAS_TILE_W * BRAILLE_CELL_W;
+    int ph = CANVAS_TILE_H * BRAILLE_CELL_H;
+    double sway = sin(f * 0.1 + ox * 0.01 + oy * 0.02);
+
+    int cx = ox + pw / 2 + (int)(sway * pw * 0.1);
+    int head_y = oy + ph / 8;
+    int hip_y = oy + ph / 2;
+    int foot_y = oy + ph - ph / 8;
+    int reach = pw / 3;
+
+    braille_draw_circle(canvas, cx, head_y, ph / 12);
+    braille_draw_thick_line(canvas, cx, head_y + ph / 12, cx, hip_y, 3);
+    braille_draw_bezier_quad(canvas, cx, oy + ph / 4,
+                             cx - reach / 2, oy + ph / 4 - (int)(sway * ph / 8),
+                             cx - reach, oy + ph / 5);
+    braille_draw_bezier_quad(canvas, cx, oy + ph / 4,
+                             cx + reach / 2, oy + ph / 4 + (int)(sway * ph / 8),
+                             cx + reach, oy + ph / 5);
+    braille_draw_line(canvas, cx, hip_y, cx - reach / 2 + (int)(sway * 6), foot_y);
+    braille_draw_line(canvas, cx, hip_y, cx + reach / 2 + (int)(sway * 6), foot_y);
+    braille_fill_circle(canvas, cx - reach, oy + ph / 5, 3);
+    braille_fill_circle(canvas, cx + reach, oy + ph / 5, 3);
+    braille_draw_line(canvas, ox, foot_y + 2, ox + pw - 1, foot_y + 2);
+}
+
+static int run_canvas_case(const BenchOptions *opt, int w, int h, bool tiled,
+                           uint64_t *samples[STAGE_COUNT], FILE *out, bool *first) {
+    BrailleCanvas *canvas = braille_canvas_create(w, h);
+    if (!canvas) return -1;
+
+    int pw = CANVAS_TILE_W * BRAILLE_CELL_W;
+    int ph = CANVAS_TILE_H * BRAILLE_CELL_H;
+
+    for (int f = 0; f < opt->warmup + opt->frames; f++) {
+        uint64_t t[CANVAS_STAGE_COUNT];
+        uint64_t start = now_ns();
+
+        braille_canvas_begin(canvas);
+        uint64_t mark = now_ns();
+        t[CANVAS_STAGE_BEGIN] = mark - start;
+
+        if (tiled) {
+            for (int oy = 0; oy < canvas->pixel_height; oy += ph) {
+                for (int ox = 0; ox < canvas->pixel_width; ox += pw) {
+                    draw_canvas_tile(canvas, ox, oy, f);
+                }
+            }
+        } else {
+            draw_canvas_tile(canvas, (canvas->pixel_width - pw) / 2,
+                             (canvas->pixel_height - ph) / 2, f);
+        }
+        uint64_t next = now_ns();
+        t[CANVAS_STAGE_DRAW] = next - mark;
+        mark = next;
+
+        braille_canvas_finalize(canvas);
+        next = now_ns();
+        t[CANVAS_STAGE_FINALIZE] = next - mark;
+        t[CANVAS_STAGE_FRAME] = next - start;
+
+        if (f >= opt->warmup) {
+            for (int s = 0; s < CANVAS_STAGE_COUNT; s++) {
+                samples[s][f - opt->warmup] = t[s];
+            }
+        }
+    }
+
+    for (int s = 0; s < CANVAS_STAGE_COUNT; s++) {
+        report_stage(out, opt->json, first, w, h, tiled ? "canvas" : "canvas-single",
+                     canvas_stage_names[s],
+                     samples[s], opt->frames);
+    }
+
+    braille_canvas_destroy(canvas);
+    return 0;
+}
+
+/* ============ Encoder check ============ */
+
+static uint32_t check_rand(uint32_t *state) {
+    *state = *state * 1664525u + 1013904223u;
+    return *state >> 8;
+}
+
+/* Same output, same changed flag and no writes past count, for random
+ * lengths, offsets and partly unchanged cells */
+static int check_encoder(const BrailleEncoder *enc, const BrailleEncoder *ref,
+                         unsigned int seed) {
+    static uint8_t masks[CHECK_MAX_CELLS + 16];
+    static wchar_t want_cells[CHECK_MAX_CELLS + CHECK_GUARD];
+    static wchar_t got_cells[CHECK_MAX_CELLS + CHECK_GUARD];
+    static char want[CHECK_MAX_CELLS * 3 + CHECK_GUARD];
+    static char got[CHECK_MAX_CELLS * 3 + CHECK_GUARD];
+    uint32_t state = seed;
+    int mismatches = 0;
+
+    for (int c = 0; c < CHECK_CASES; c++) {
+        int count = (int)(check_rand(&state) % (CHECK_MAX_CELLS + 1));
+        int offset = (int)(check_rand(&state) % 16);
+        int density = (int)(check_rand(&state) % 4);    /* 0: empty .. 3: random */
+        uint8_t *m = masks + offset;
+
+        for (int i = 0; i < count; i++) {
+            m[i] = density == 0 ? 0 : density == 1 ? 0xFF : (uint8_t)check_rand(&state);
+        }
+        for (int i = 0; i < count + CHECK_GUARD; i++) {
+            bool same = i < count && (check_rand(&state) & 3) != 0;
+            want_cells[i] = same ? BRAILLE_BASE + m[i] : (wchar_t)(check_rand(&state) & 0x3FFF);
+            got_cells[i] = want_cells[i];
+        }
+        memset(want, 0x55, sizeof(want));
+        memset(got, 0x55, sizeof(got));
+
+        int want_changed = ref->expand_cells(m, count, want_cells) != 0;
+        int got_changed = enc->expand_cells(m, count, got_cells) != 0;
+        ref->encode_utf8(m, count, want);
+        enc->encode_utf8(m, count, got);
+
+        if (want_changed != got_changed ||
+            memcmp(want_cells, got_cells, sizeof(wchar_t) * (count + CHECK_GUARD)) != 0 ||
+            memcmp(want, got, sizeof(want)) != 0) {
+            if (mismatches == 0) {
+                fprintf(stderr, "%s: mismatch at case %d (count %d, offset %d)\n",
+                        enc->name, c, count, offset);
+            }
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+static int check_encoders(unsigned int seed) {
+    const BrailleEncoder *ref = braille_encoder_get(BRAILLE_ISA_SCALAR);
+    static uint8_t masks[CANVAS_TILE_W * 4];
+    static wchar_t cells[CANVAS_TILE_W * 4];
+    static char utf8[CANVAS_TILE_W * 4 * 3];
+    int row = CANVAS_TILE_W * 4;
+    int failed = 0;
+
+    uint32_t state = seed;
+    for (int i = 0; i < row; i++) masks[i] = (uint8_t)check_rand(&state);
+
+    printf("encoder,cases,mismatches,cells_per_row,encode_ns_per_row,expand_ns_per_row\n");
+    for (int isa = 0; isa < BRAILLE_ISA_COUNT; isa++) {
+        const BrailleEncoder *enc = braille_encoder_get((BrailleISA)isa);
+        if (!enc) continue;
+
+        int mismatches = check_encoder(enc, ref, seed);
+        if (mismatches) failed = 1;
+
+        uint64_t start = now_ns();
+        for (int r = 0; r < CHECK_TIMED_ROWS; r++) {
+            masks[r % row] ^= 1;    /* Keep each pass live */
+            enc->encode_utf8(masks, row, utf8);
+        }
+        uint64_t mid = now_ns();
+        for (int r = 0; r < CHECK_TIMED_ROWS; r++) {
+            masks[r % row] ^= 1;
+            enc->expand_cells(masks, row, cells);
+        }
+        uint64_t end = now_ns();
+
+        printf("%s,%d,%d,%d,%.1f,%.1f%s\n", enc->name, CHECK_CASES, mismatches, row,
+               (double)(mid - start) / CHECK_TIMED_ROWS,
+               (double)(end - mid) / CHECK_TIMED_ROWS,
+               enc == braille_encoder_select() ? ",selected" : "");
+    }
+    return failed;
+}
+
+/* ============ Pose index check ============ */
+
+static float check_randf(uint32_t *state) {
+    return (float)(check_rand(state) & 0xFFFF) / 65536.0f;
+}
+
+typedef struct {
+    int recent[POSE_HISTORY];
+} IndexHistory;
+
+static bool index_not_recent(int pose_idx, void *user) {
+    const IndexHistory *h = user;
+    for (int i = 0; i < POSE_HISTORY; i++) {
+        if (h->recent[i] == pose_idx) return false;
+    }
+    return true;
+}
+
+static float feature_dist2(const PoseFeatures *a, const PoseFeatures *b) {
+    float d2 = 0.0f;
+    for (int k = 0; k < POSE_FEATURES; k++) {
+        float d = a->v[k] - b->v[k];
+        d2 += d * d;
+    }
+    return d2;
+}
+
+/* What selection did before the index: look at every pose in the category */
+static int linear_nearest(const PoseLibrary *lib, PoseCategory cat,
+                          const PoseFeatures *target, IndexHistory *h) {
+    int best = -1;
+    float best_d2 = INFINITY;
+    for (int i = 0; i < pose_library_count(lib, cat); i++) {
+        int idx = pose_library_at(lib, cat, i);
+        PoseFeatures f = pose_features(&lib->poses[idx]);
+        float d2 = feature_dist2(&f, target);
+        if (d2 < best_d2 && index_not_recent(idx, h)) {
+            best = idx;
+            best_d2 = d2;
+        }
+    }
+    return best;
+}
+
+typedef struct {
+    PoseCategory cat;
+    PoseFeatures target;
+} IndexQuery;
+
+/* Run every query with history fed by the picks, like the dancer does */
+static uint64_t run_queries(const PoseLibrary *lib, const IndexQuery *queries,
+                            int *picks, bool linear) {
+    IndexHistory h;
+    for (int i = 0; i < POSE_HISTORY; i++) h.recent[i] = -1;
+
+    uint64_t start = now_ns();
+    for (int q = 0; q < INDEX_QUERIES; q++) {
+        int idx = linear ? linear_nearest(lib, queries[q].cat, &queries[q].target, &h)
+                         : pose_index_nearest(lib, queries[q].cat, &queries[q].target,
+                                              index_not_recent, &h);
+        h.recent[q % POSE_HISTORY] = idx;
+        picks[q] = idx;
+    }
+    return now_ns() - start;
+}
+
+static int check_pose_index(unsigned int seed) {
+    static const int sizes[] = { 1000, 10000, 100000 };
+    IndexQuery *queries = malloc(sizeof(IndexQuery) * INDEX_QUERIES);
+    int *tree_picks = malloc(sizeof(int) * INDEX_QUERIES);
+    int *linear_picks = malloc(sizeof(int) * INDEX_QUERIES);
+    if (!queries || !tree_picks || !linear_picks) {
+        free(queries);
+        free(tree_picks);
+        free(linear_picks);
+        return 1;
+    }
+    int failed = 0;
+
+    printf("poses,queries,mismatches,kdtree_ns_per_query,linear_ns_per_query\n");
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        int count = sizes[s];
+        Pose *poses = calloc((size_t)count, sizeof(Pose));
+        uint32_t *by_category = malloc(sizeof(uint32_t) * count);
+        PoseFeatures *features = malloc(sizeof(PoseFeatures) * count);
+        if (!poses || !by_category || !features) {
+            free(poses);
+            free(by_category);
+            free(features);
+            failed = 1;
+            break;
+        }
+
+        uint32_t state = seed;
+        for (int i = 0; i < count; i++) {
+            Pose *p = &poses[i];
+            float a = check_randf(&state), b = check_randf(&state);
+            p->category = (PoseCategory)(check_rand(&state) % POSE_CAT_COUNT);
+            p->energy_min = fminf(a, b);
+            p->energy_max = fmaxf(a, b);
+            p->bass_affinity = check_randf(&state);
+            p->treble_affinity = check_randf(&state);
+            p->dip_amount = check_randf(&state);
+            p->facing = (check_randf(&state) * 2.0f - 1.0f) * (float)M_PI;
+        }
+        PoseLibrary lib = {
+            .poses = poses, .num_poses = count,
+            .by_category = by_category, .features = features,
+        };
+        pose_index_build(poses, count, by_category, features, lib.category_start);
+
+        for (int q = 0; q < INDEX_QUERIES; q++) {
+            queries[q].cat = (PoseCategory)(check_rand(&state) % POSE_CAT_COUNT);
+            queries[q].target = pose_features_target(
+                check_randf(&state), check_randf(&state), check_randf(&state),
+                check_randf(&state), (check_randf(&state) * 2.0f - 1.0f) * (float)M_PI);
+        }
+
+        uint64_t tree_ns = run_queries(&lib, queries, tree_picks, false);
+        uint64_t linear_ns = run_queries(&lib, queries, linear_picks, true);
+
+        /* Replay with the index's own history, so one tie resolved the other
+         * way cannot send the runs apart. Ties may pick different poses;
+         * the distance must match */
+        int mismatches = 0;
+        for (int q = 0; q < INDEX_QUERIES; q++) {
+            IndexHistory h;
+            for (int i = 0; i < POSE_HISTORY; i++) {
+                h.recent[i] = q > i ? tree_picks[q - 1 - i] : -1;
+            }
+            int t = tree_picks[q];
+            int l = linear_nearest(&lib, queries[q].cat, &queries[q].target, &h);
+            if (t == l) continue;
+            if (t >= 0 && l >= 0) {
+                PoseFeatures ft = pose_features(&poses[t]);
+                PoseFeatures fl = pose_features(&poses[l]);
+                if (feature_dist2(&ft, &queries[q].target) ==
+                    feature_dist2(&fl, &queries[q].target)) {
+                    continue;
+                }
+            }
+            if (mismatches == 0) {
+                fprintf(stderr, "%d poses: query %d picked %d, linear scan %d\n",
+                        count, q, t, l);
+            }
+            mismatches++;
+        }
+        if (mismatches) failed = 1;
+
+        printf("%d,%d,%d,%.1f,%.1f\n", count, INDEX_QUERIES, mismatches,
+               (double)tree_ns / INDEX_QUERIES, (double)linear_ns / INDEX_QUERIES);
+        free(poses);
+        free(by_category);
+        free(features);
+    }
+
+    free(queries);
+    free(tree_picks);
+    free(linear_picks);
+    return failed;
+}
+
+/* ============ Particle kernels ============ */
+
+/* Keep target particles alive: top up with slow bursts at random points,
+ * then step. Returns the time spent in particles_update. */
+static uint64_t run_particles(ParticleSystem *ps, int target, unsigned int seed,
+                              long *particle_steps) {
+    EmitterConfig config = {
+        .spread_angle = 2.0f * (float)M_PI,
+        .min_speed = 5.0f,
+        .max_speed = 30.0f,
+        .min_life = 2.0f,
+        .max_life = 6.0f,
+        .gravity = 20.0f,
+        .size_min = 1.0f,
+        .size_max = 1.0f,
+        .pattern = SPAWN_BURST,
+        .type = PARTICLE_SPARK,
+        .owner = PARTICLE_OWNER_BACKGROUND,
+    };
+    uint64_t total = 0;
+    *particle_steps = 0;
+
+    srand(seed);
+    for (int step = 0; step < PARTICLE_STEPS; step++) {
+        while (particles_get_active_count(ps) < target) {
+            config.x = (float)rand() / RAND_MAX * PARTICLE_FIELD_W;
+            config.y = (float)rand() / RAND_MAX * PARTICLE_FIELD_H;
+            int n = target - particles_get_active_count(ps);
+            particles_spawn(ps, &config, n < 64 ? n : 64);
+        }
+        *particle_steps += particles_get_active_count(ps);
+
+        uint64_t start = now_ns();
+        particles_update(ps, 1.0f / DEFAULT_FPS);
+        total += now_ns() - start;
+    }
+    return total;
+}
+
+static ParticleSystem* bench_particle_system(const ParticleStepper *stepper) {
+    ParticleSystem *ps = particles_create(PARTICLE_FIELD_W, PARTICLE_FIELD_H);
+    if (!ps) return NULL;
+    ps->stepper = stepper;
+    particles_set_pool(ps, MAX_PARTICLES);
+    
+    /* The whole pool to the one emitter with no LOD thinning, so every
+     * kernel steps exactly the target count */
+    ParticleBudget *budget = &ps->budgets[PARTICLE_OWNER_BACKGROUND];
+    budget->budget = budget->soft_limit = ps->pool_size;
+    particles_set_body_mask(ps, PARTICLE_FIELD_W / 2.0f, 0, PARTICLE_FIELD_H * 0.2f,
+                            PARTICLE_FIELD_H * 0.8f, PARTICLE_FIELD_H * 0.3f);
+    return ps;
+}
+
+/* Live particles of a and b hold the same values */
+static int particles_differ(const ParticleSystem *a, const ParticleSystem *b) {
+    const ParticleArrays *p = &a->live, *q = &b->live;
+    if (p->count != q->count) return 1;
+    for (int i = 0; i < p->count; i++) {
+        if (p->x[i] != q->x[i] || p->y[i] != q->y[i] ||
+            p->vx[i] != q->vx[i] || p->vy[i] != q->vy[i] ||
+            p->lifetime[i] != q->lifetime[i] || p->type[i] != q->type[i]) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int check_particles(unsigned int seed) {
+    static const int counts[] = { 1000, 10000, MAX_PARTICLES };
+    const ParticleStepper *ref = particle_stepper_get(PARTICLE_ISA_SCALAR);
+    int failed = 0;
+
+    printf("kernel,particles,steps,mismatch,ns_per_step,ns_per_particle\n");
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        ParticleSystem *want = bench_particle_system(ref);
+        if (!want) return 1;
+        long want_steps;
+        run_particles(want, counts[c], seed, &want_steps);
+
+        for (int isa = 0; isa < PARTICLE_ISA_COUNT; isa++) {
+            const ParticleStepper *st = particle_stepper_get((ParticleISA)isa);
+            if (!st) continue;
+            ParticleSystem *ps = bench_particle_system(st);
+            if (!ps) {
+                failed = 1;
+                continue;
+            }
+
+            long steps;
+            uint64_t ns = run_particles(ps, counts[c], seed, &steps);
+            int mismatch = particles_differ(ps, want);
+            if (mismatch) {
+                fprintf(stderr, "%s: %d particles differ from scalar\n", st->name, counts[c]);
+                failed = 1;
+            }
+            printf("%s,%d,%d,%d,%.0f,%.2f%s\n", st->name, counts[c], PARTICLE_STEPS, mismatch,
+                   (double)ns / PARTICLE_STEPS, (double)ns / steps,
+                   st == particle_stepper_select() ? ",selected" : "");
+            particles_destroy(ps);
+        }
+        particles_destroy(want);
+    }
+    return failed;
+}
+
+/* ============ Sample ring ============ */
+
+/* Every sample is its own absolute position, so the consumer can tell a
+ * dropped run (a gap), a reordered one (going back) and a torn read (a slot
+ * overwritten mid-copy: a value from a later lap inside one read) apart */
+typedef struct {
+    struct audio_ring ring;
+    uint64_t produced;
+    unsigned int seed;
+    _Atomic bool done;
+} RingStress;
+
+static void ring_pause(uint32_t *state) {
+    struct timespec ts = { 0, (long)(check_rand(state) % RING_PAUSE_NS) };
+    nanosleep(&ts, NULL);
+}
+
+static void* ring_producer(void *arg) {
+    RingStress *rs = arg;
+    double *block = malloc(sizeof(double) * rs->ring.capacity * 2);
+    uint32_t state = rs->seed ^ 0x9E3779B9u;
+    uint64_t pos = 0;
+
+    if (block) {
+        while (pos < rs->produced) {
+            /* Mostly small blocks, sometimes more than the whole ring */
+            size_t count = check_rand(&state) % 8 == 0
+                         ? rs->ring.capacity + check_rand(&state) % rs->ring.capacity
+                         : 1 + check_rand(&state) % (rs->ring.capacity / 4);
+            if (count > rs->produced - pos) count = (size_t)(rs->produced - pos);
+            for (size_t i = 0; i < count; i++) block[i] = (double)(pos + i);
+            audio_ring_write(&rs->ring, block, count);
+            pos += count;
+            if (check_rand(&state) % 64 == 0) ring_pause(&state);
+        }
+    }
+    rs->produced = pos;
+    free(block);
+    atomic_store(&rs->done, true);
+    return NULL;
+}
+
+static int check_ring(unsigned int seed) {
+    RingStress rs = { .produced = RING_SAMPLES, .seed = seed };
+    if (audio_ring_init(&rs.ring, RING_CAPACITY) != 0) return 1;
+    double *dst = malloc(sizeof(double) * rs.ring.capacity * 2);
+    if (!dst) {
+        audio_ring_free(&rs.ring);
+        return 1;
+    }
+    atomic_init(&rs.done, false);
+
+    pthread_t producer;
+    uint64_t start = now_ns();
+    if (pthread_create(&producer, NULL, ring_producer, &rs) != 0) {
+        free(dst);
+        audio_ring_free(&rs.ring);
+        return 1;
+    }
+
+    uint32_t state = seed;
+    uint64_t received = 0, gaps = 0, reads = 0;
+    long reordered = 0, torn = 0;
+    double last = -1.0;
+    for (;;) {
+        /* Check done before reading, so the last read drains the ring */
+        bool done = atomic_load(&rs.done);
+        size_t max = 1 + check_rand(&state) % (rs.ring.capacity * 2);
+        size_t n = audio_ring_read(&rs.ring, dst, max);
+        if (n > 0) {
+            reads++;
+            if (dst[0] <= last) reordered++;
+            else gaps += (uint64_t)(dst[0] - last - 1.0);
+            for (size_t i = 1; i < n; i++) {
+                if (dst[i] != dst[0] + (double)i) {
+                    torn++;
+                    break;
+                }
+            }
+            last = dst[n - 1];
+            received += n;
+        }
+        if (done && n == 0 && audio_ring_available(&rs.ring) == 0) break;
+        if (check_rand(&state) % 16 == 0) ring_pause(&state);
+    }
+    pthread_join(producer, NULL);
+    uint64_t elapsed = now_ns() - start;
+
+    uint64_t dropped = atomic_load(&rs.ring.dropped);
+    bool balanced = received + dropped == rs.produced && gaps == dropped;
+    int failed = reordered || torn || !balanced;
+
+    printf("capacity,produced,received,dropped,gaps,reads,reordered,torn,balanced,ns_per_sample\n");
+    printf("%zu,%llu,%llu,%llu,%llu,%llu,%ld,%ld,%d,%.2f\n", rs.ring.capacity,
+           (unsigned long long)rs.produced, (unsigned long long)received,
+           (unsigned long long)dropped, (unsigned long long)gaps,
+           (unsigned long long)reads, reordered, torn, balanced,
+           (double)elapsed / (double)rs.produced);
+    if (failed) fprintf(stderr, "sample ring: reordered, torn or lost samples\n");
+
+    free(dst);
+    audio_ring_free(&rs.ring);
+    return failed;
+}
+
+/* ============ Sample ingest ============ */
+
+/* cava_execute's ingest before the mirrored history: shift the whole buffer
+ * back, write the new samples newest-first, de-interleave the newest FFT
+ * lengths into raw arrays, then window them. Windows come from the plan. */
+typedef struct {
+    int size;
+    double *buffer;
+    double *raw[4];            /* bass l/r, treble l/r */
+    double *out[4];
+} LegacyIngest;
+
+static int legacy_ingest_init(LegacyIngest *lg, const struct cava_plan *p) {
+    memset(lg, 0, sizeof(*lg));
+    lg->size = p->input_buffer_size;
+    lg->buffer = calloc(lg->size, sizeof(double));
+    bool ok = lg->buffer != NULL;
+    for (int i = 0; i < 4; i++) {
+        int len = i < 2 ? p->FFTbassbufferSize : p->FFTbufferSize;
+        lg->raw[i] = calloc(len, sizeof(double));
+        lg->out[i] = calloc(len, sizeof(double));
+        ok = ok && lg->raw[i] && lg->out[i];
+    }
+    return ok ? 0 : -1;
+}
+
+static void legacy_ingest_free(LegacyIngest *lg) {
+    free(lg->buffer);
+    for (int i = 0; i < 4; i++) {
+        free(lg->raw[i]);
+        free(lg->out[i]);
+    }
+}
+
+static int legacy_ingest(LegacyIngest *lg, const struct cava_plan *p,
+                         const double *in, int new_samples) {
+    int silence = 1;
+    if (new_samples > lg->size) new_samples = lg->size;
+
+    for (int n = lg->size - 1; n >= new_samples; n--) {
+        lg->buffer[n] = lg->buffer[n - new_samples];
+    }
+    for (int n = 0; n < new_samples; n++) {
+        lg->buffer[new_samples - n - 1] = in[n];
+        if (in[n]) silence = 0;
+    }
+
+    for (int b = 0; b < 2; b++) {
+        int len = b == 0 ? p->FFTbassbufferSize : p->FFTbufferSize;
+        const cava_real *window = b == 0 ? p->bass_multiplier : p->multiplier;
+        double *raw_l = lg->raw[b * 2], *raw_r = lg->raw[b * 2 + 1];
+        for (int n = 0; n < len; n++) {
+            if (p->audio_channels == 2) {
+                raw_r[n] = lg->buffer[n * 2];
+                raw_l[n] = lg->buffer[n * 2 + 1];
+            } else {
+                raw_l[n] = lg->buffer[n];
+            }
+        }
+        for (int n = 0; n < len; n++) {
+            lg->out[b * 2][n] = window[n] * raw_l[n];
+            if (p->audio_channels == 2) lg->out[b * 2 + 1][n] = window[n] * raw_r[n];
+        }
+    }
+    return silence;
+}
+
+/* The legacy buffers are newest-first and the plan's chronological, so one
+ * is the other reversed (the Hann window is symmetric) */
+static double ingest_max_diff(const LegacyIngest *lg, const struct cava_plan *p) {
+    const cava_real *plan_out[4] = { p->in_bass_l, p->in_bass_r, p->in_l, p->in_r };
+    double max_diff = 0.0;
+    for (int i = 0; i < 2 * p->audio_channels; i++) {
+        int b = p->audio_channels == 2 ? i : i * 2;
+        int len = b < 2 ? p->FFTbassbufferSize : p->FFTbufferSize;
+        for (int n = 0; n < len; n++) {
+            double d = fabs(lg->out[b][n] - (double)plan_out[b][len - 1 - n]);
+            if (d > max_diff) max_diff = d;
+        }
+    }
+    return max_diff;
+}
+
+static int check_ingest(unsigned int seed) {
+    static const int hops_fps[] = { 60, 30, 10 };
+    uint32_t state = seed;
+    double *pool = malloc(sizeof(double) * INGEST_POOL);
+    if (!pool) return 1;
+    for (int i = 0; i < INGEST_POOL; i++) {
+        pool[i] = (double)(check_rand(&state) & 0xFFFF) / 32768.0 - 1.0;
+    }
+
+    int failed = 0;
+    printf("channels,new_samples,frames,legacy_ns,ring_ns,speedup,max_diff\n");
+    for (int channels = 1; channels <= 2 && !failed; channels++) {
+        for (size_t h = 0; h < sizeof(hops_fps) / sizeof(hops_fps[0]); h++) {
+            struct cava_plan *plan = cava_init(NUM_BARS, INGEST_RATE, channels, 1,
+                                               0.77, 50, 10000);
+            if (!plan || plan->status != 0) {
+                fprintf(stderr, "FFT init error: %s\n",
+                        plan ? plan->error_message : "out of memory");
+                free(plan);
+                failed = 1;
+                break;
+            }
+            LegacyIngest lg;
+            double out[NUM_BARS];
+            if (legacy_ingest_init(&lg, plan) != 0) {
+                legacy_ingest_free(&lg);
+                cava_destroy(plan);
+                failed = 1;
+                break;
+            }
+
+            /* Past one history length the two paths keep different samples
+             * (the legacy one the oldest), so stay within it */
+            int hop = INGEST_RATE / hops_fps[h] * channels;
+            if (hop > plan->input_buffer_size) hop = plan->input_buffer_size;
+            uint64_t legacy_ns = 0, ring_ns = 0;
+            for (int f = 0; f < INGEST_FRAMES; f++) {
+                const double *in = pool + (size_t)f * hop % (INGEST_POOL - hop);
+
+                uint64_t start = now_ns();
+                legacy_ingest(&lg, plan, in, hop);
+                legacy_ns += now_ns() - start;
+
+                memset(bench_stage_ns, 0, sizeof(bench_stage_ns));
+                cava_execute(in, hop, out, plan);
+                ring_ns += bench_stage_ns[BENCH_STAGE_CAVA_INGEST];
+            }
+
+            double max_diff = ingest_max_diff(&lg, plan);
+            if (max_diff > SPECTRUM_TOLERANCE) failed = 1;
+            printf("%d,%d,%d,%.0f,%.0f,%.2f,%.3g\n", channels, hop, INGEST_FRAMES,
+                   (double)legacy_ns / INGEST_FRAMES, (double)ring_ns / INGEST_FRAMES,
+                   ring_ns ? (double)legacy_ns / (double)ring_ns : 0.0, max_diff);
+
+            legacy_ingest_free(&lg);
+            cava_destroy(plan);
+        }
+    }
+    if (failed) fprintf(stderr, "sample ingest: windowed input differs from the legacy path\n");
+
+    free(pool);
+    return failed;
+}
+
+/* ============ Spectrum kernel check ============ */
+
+/* cavacore before the kernels: hypot() per bin, plain windowing loops */
+static void magnitude_reference(const cava_complex *in, cava_real *mag, int count) {
+    for (int i = 0; i < count; i++) mag[i] = (cava_real)hypot(in[i][0], in[i][1]);
+}
+
+static void window_stereo_reference(const cava_real *src, const cava_real *window,
+                                    cava_real *out_l, cava_real *out_r, int count) {
+    for (int n = 0; n < count; n++) {
+        out_l[n] = window[n] * src[n * 2];
+        out_r[n] = window[n] * src[n * 2 + 1];
+    }
+}
+
+static void window_mono_reference(const cava_real *src, const cava_real *window,
+                                  cava_real *out, int count) {
+    for (int n = 0; n < count; n++) out[n] = window[n] * src[n];
+}
+
+static const struct spectrum_kernels kernels_reference = {
+    .name = "reference",
+    .magnitude = magnitude_reference,
+    .window_stereo = window_stereo_reference,
+    .window_mono = window_mono_reference,
+};
+
+/* Interleaved samples from --file, or a synthetic stereo mix at 16-bit
+ * scale: two drifting tones, a kick every half second and noise */
+typedef struct {
+    double *data;
+    int count;
+    int channels;
+    int rate;
+} SampleVector;
+
+static int sample_vector_load(SampleVector *sv, const char *path, unsigned int seed) {
+    sv->data = calloc(SPECTRUM_SAMPLES, sizeof(double));
+    if (!sv->data) return -1;
+
+    if (!path) {
+        uint32_t state = seed;
+        sv->channels = 2;
+        sv->rate = 44100;
+        sv->count = SPECTRUM_SAMPLES;
+        for (int i = 0; i < sv->count / 2; i++) {
+            double t = (double)i / sv->rate;
+            double kick = exp(-fmod(t, 0.5) * 30.0) * sin(2 * M_PI * 55.0 * t);
+            double noise = (double)(check_rand(&state) & 0xFFFF) / 32768.0 - 1.0;
+            double tone = sin(2 * M_PI * (440.0 + 40.0 * t) * t);
+            sv->data[i * 2] = 12000.0 * kick + 6000.0 * tone + 800.0 * noise;
+            sv->data[i * 2 + 1] = 12000.0 * kick + 5000.0 * sin(2 * M_PI * 1250.0 * t)
+                                + 800.0 * noise;
+        }
+        return 0;
+    }
+
+    struct audio_data audio;
+    struct audio_file file;
+    memset(&audio, 0, sizeof(audio));
+    audio.rate = 44100;
+    audio.channels = 2;
+    audio.format = 16;
+    if (audio_file_open(&file, path, &audio) != 0) {
+        fprintf(stderr, "%s\n", audio.error_message);
+        return -1;
+    }
+    if (audio_ring_init(&audio.ring, SPECTRUM_SAMPLES) != 0) {
+        audio_file_close(&file);
+        return -1;
+    }
+    sv->channels = (int)audio.channels;
+    sv->rate = (int)audio.rate;
+    audio_file_feed(&file, &audio, SPECTRUM_SAMPLES / sv->channels);
+    sv->count = (int)audio_ring_read(&audio.ring, sv->data, SPECTRUM_SAMPLES);
+    audio_ring_free(&audio.ring);
+    audio_file_close(&file);
+    if (sv->count <= SPECTRUM_MAX_LEN * 2) {
+        fprintf(stderr, "%s: too short for the spectrum check\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+static double relative_error(double got, double want) {
+    double d = fabs(got - want);
+    return fabs(want) > 1.0 ? d / fabs(want) : d;
+}
+
+/* Random lengths and offsets into the samples; magnitudes read sample pairs
+ * as complex bins. Returns the largest relative error. */
+static double check_spectrum_kernel(const struct spectrum_kernels *k, const SampleVector *sv,
+                                    cava_real *src, cava_real *window, cava_real *got,
+                                    cava_real *got_r, unsigned int seed) {
+    uint32_t state = seed;
+    double max_err = 0.0;
+
+    for (int c = 0; c < SPECTRUM_CASES; c++) {
+        int len = 1 + (int)(check_rand(&state) % SPECTRUM_MAX_LEN);
+        int offset = (int)(check_rand(&state) % (sv->count - len * 2));
+        for (int n = 0; n < len * 2; n++) src[n] = (cava_real)sv->data[offset + n];
+        for (int n = 0; n < len; n++) {
+            window[n] = len > 1 ? (cava_real)(0.5 * (1 - cos(2 * M_PI * n / (len - 1)))) : 1;
+        }
+
+        k->window_stereo(src, window, got, got_r, len);
+        for (int n = 0; n < len; n++) {
+            double e = relative_error(got[n], (double)(window[n] * src[n * 2]));
+            double e_r = relative_error(got_r[n], (double)(window[n] * src[n * 2 + 1]));
+            if (e > max_err) max_err = e;
+            if (e_r > max_err) max_err = e_r;
+        }
+
+        k->window_mono(src, window, got, len);
+        for (int n = 0; n < len; n++) {
+            double e = relative_error(got[n], (double)(window[n] * src[n]));
+            if (e > max_err) max_err = e;
+        }
+
+        k->magnitude((const cava_complex *)src, got, len);
+        for (int n = 0; n < len; n++) {
+            double e = relative_error(got[n], hypot(src[n * 2], src[n * 2 + 1]));
+            if (e > max_err) max_err = e;
+        }
+    }
+    return max_err;
+}
+
+/* Same samples through two plans, one on the reference kernels. Compares
+ * the bars before normalization (prev_cava_out): at 16-bit scale cava_out
+ * clamps to 1 and would hide any difference. */
+static double check_spectrum_execute(const SampleVector *sv, const struct spectrum_kernels *k) {
+    struct cava_plan *ref = cava_init(NUM_BARS, sv->rate, sv->channels, 1, 0.77, 50, 10000);
+    struct cava_plan *plan = cava_init(NUM_BARS, sv->rate, sv->channels, 1, 0.77, 50, 10000);
+    double max_err = -1.0;
+
+    if (ref && ref->status == 0 && plan && plan->status == 0) {
+        ref->kernels = &kernels_reference;
+        plan->kernels = k;
+        max_err = 0.0;
+
+        int hop = sv->rate / DEFAULT_FPS * sv->channels;
+        double want[NUM_BARS], got[NUM_BARS];
+        for (int pos = 0; pos + hop <= sv->count; pos += hop) {
+            cava_execute(sv->data + pos, hop, want, ref);
+            cava_execute(sv->data + pos, hop, got, plan);
+            for (int i = 0; i < NUM_BARS; i++) {
+                double e = relative_error(plan->prev_cava_out[i], ref->prev_cava_out[i]);
+                if (e > max_err) max_err = e;
+            }
+        }
+    } else {
+        fprintf(stderr, "FFT init error\n");
+    }
+
+    if (ref && ref->status == 0) cava_destroy(ref);
+    else free(ref);
+    if (plan && plan->status == 0) cava_destroy(plan);
+    else free(plan);
+    return max_err;
+}
+
+static int check_spectrum(const char *path, unsigned int seed) {
+    SampleVector sv = { 0 };
+    size_t len = SPECTRUM_MAX_LEN * 2;
+    cava_real *src = malloc(sizeof(cava_real) * len);
+    cava_real *window = malloc(sizeof(cava_real) * len);
+    cava_real *out_l = malloc(sizeof(cava_real) * len);
+    cava_real *out_r = malloc(sizeof(cava_real) * len);
+    int failed = 0;
+
+    if (!src || !window || !out_l || !out_r || sample_vector_load(&sv, path, seed) != 0) {
+        failed = 1;
+        goto done;
+    }
+
+    printf("kernel,cases,max_error,execute_max_error,magnitude_ns_per_1k,window_ns_per_1k\n");
+    for (int isa = 0; isa < SPECTRUM_ISA_COUNT; isa++) {
+        const struct spectrum_kernels *k = spectrum_kernels_get((enum spectrum_isa)isa);
+        if (!k) continue;
+
+        double err = check_spectrum_kernel(k, &sv, src, window, out_l, out_r, seed);
+        double exec_err = check_spectrum_execute(&sv, k);
+        if (err > SPECTRUM_TOLERANCE || exec_err < 0 || exec_err > SPECTRUM_TOLERANCE) {
+            failed = 1;
+        }
+
+        /* Timing on a fixed block; the check above already covers the tails */
+        for (size_t n = 0; n < len; n++) src[n] = (cava_real)sv.data[n];
+        for (int n = 0; n < SPECTRUM_MAX_LEN; n++) {
+            window[n] = (cava_real)(0.5 * (1 - cos(2 * M_PI * n / (SPECTRUM_MAX_LEN - 1))));
+        }
+        uint64_t start = now_ns();
+        for (int r = 0; r < SPECTRUM_TIMED; r++) {
+            k->magnitude((const cava_complex *)src, out_l, SPECTRUM_MAX_LEN);
+        }
+        uint64_t mid = now_ns();
+        for (int r = 0; r < SPECTRUM_TIMED; r++) {
+            k->window_stereo(src, window, out_l, out_r, SPECTRUM_MAX_LEN);
+        }
+        uint64_t end = now_ns();
+
+        double per_1k = 1000.0 / ((double)SPECTRUM_TIMED * SPECTRUM_MAX_LEN);
+        printf("%s,%d,%.3g,%.3g,%.1f,%.1f%s\n", k->name, SPECTRUM_CASES, err, exec_err,
+               (double)(mid - start) * per_1k, (double)(end - mid) * per_1k,
+               k == spectrum_kernels_select() ? ",selected" : "");
+    }
+    if (failed) fprintf(stderr, "spectrum kernels: outside the documented tolerance\n");
+
+done:
+    free(sv.data);
+    free(src);
+    free(window);
+    free(out_l);
+    free(out_r);
+    return failed;
+}
+
+static int parse_sizes(BenchOptions *opt, const char *list) {
+    opt->num_sizes = 0;
+    const char *p = list;
+    while (*p) {
+        int w, h, consumed;
+        if (opt->num_sizes >= MAX_SIZES ||
+            sscanf(p, "%dx%d%n", &w, &h, &consumed) != 2 || w < 1 || h < 1) {
+            return -1;
+        }
+        opt->sizes[opt->num_sizes][0] = w;
+        opt->sizes[opt->num_sizes][1] = h;
+        opt->num_sizes++;
+        p += consumed;
+        if (*p == ',') p++;
+        else if (*p) return -1;
+    }
+    return opt->num_sizes > 0 ? 0 : -1;
+}
+
+static void print_usage(const char *name) {
+    printf("Usage: %s [options]\n\n", name);
+    printf("Headless frame pipeline benchmark (per-stage ns/frame percentiles)\n\n");
+    printf("Options:\n");
+    printf("  -n, --frames <n>      Measured frames per case (default: %d)\n", DEFAULT_FRAMES);
+    printf("  -w, --warmup <n>      Unmeasured warmup frames per case (default: %d)\n", DEFAULT_WARMUP);
+    printf("  -s, --sizes <list>    Canvas sizes in cells, e.g. 25x13,50x26 (default: 25x13,50x26,100x52)\n");
+    printf("  -c, --canvas          Time canvas clear/draw/render alone (default sizes: %s)\n", CANVAS_SIZES);
+    printf("      --check-encoders  Check braille encoders against the scalar reference\n");
+    printf("      --pose-index      Check and time nearest-pose queries at 1k/10k/100k poses\n");
+    printf("      --particles       Check and time particle step kernels up to %d particles\n", MAX_PARTICLES);
+    printf("      --ring            Stress the audio sample ring with a producer thread\n");
+    printf("      --ingest          Time cavacore sample ingest against the legacy path\n");
+    printf("      --check-spectrum  Check spectrum kernels and cava_execute against a reference\n");
+    printf("  -e, --effects <list>  Effect setups to run (default: all)\n");
+    printf("  -i, --file <path>     Use spectra from a WAV/raw file instead of synthetic\n");
+    printf("  -r, --fps <n>         Simulated frame rate / spectrum hop (default: %d)\n", DEFAULT_FPS);
+    printf("      --seed <n>        Seed for synthetic spectra and effects (default: %d)\n", DEFAULT_SEED);
+    printf("  -j, --json            Write JSON instead of CSV\n");
+    printf("  -h, --help            Show this help\n\n");
+    printf("Effect setups:");
+    for (int i = 0; i < NUM_EFFECT_SETUPS; i++) {
+        printf(" %s", effect_setups[i].name);
+    }
+    printf("\n");
+}
+
+int main(int argc, char *argv[]) {
+    BenchOptions opt = {
+        .frames = DEFAULT_FRAMES,
+        .warmup = DEFAULT_WARMUP,
+        .fps = DEFAULT_FPS,
+        .seed = DEFAULT_SEED,
+    };
+    bool sizes_given = false;
+    bool check = false;
+    bool check_index = false;
+    bool check_particle_kernels = false;
+    bool check_sample_ring = false;
+    bool check_sample_ingest = false;
+    bool check_spectrum_kernels = false;
+
+    static struct option long_options[] = {
+        {"frames",  required_argument, 0, 'n'},
+        {"warmup",  required_argument, 0, 'w'},
+        {"sizes",   required_argument, 0, 's'},
+        {"effects", required_argument, 0, 'e'},
+        {"file",    required_argument, 0, 'i'},
+        {"fps",     required_argument, 0, 'r'},
+        {"seed",    required_argument, 0, 'S'},
+        {"json",    no_argument,       0, 'j'},
+        {"canvas",  no_argument,       0, 'c'},
+        {"check-encoders", no_argument, 0, 'E'},
+        {"pose-index", no_argument, 0, 'P'},
+        {"particles", no_argument, 0, 'A'},
+        {"ring",    no_argument,       0, 'R'},
+        {"ingest",  no_argument,       0, 'G'},
+        {"check-spectrum", no_argument, 0, 'K'},
+        {"help",    no_argument,       0, 'h'},
+        {0, 0, 0, 0}
+    };
+
+    int opt_c;
+    while ((opt_c = getopt_long(argc, argv, "n:w:s:e:i:r:jch", long_options, NULL)) != -1) {
+        switch (opt_c) {
+            case 'n': opt.frames = atoi(optarg); break;
+            case 'w': opt.warmup = atoi(optarg); break;
+            case 's':
+                if (parse_sizes(&opt, optarg) != 0) {
+                    fprintf(stderr, "Invalid size list: %s\n", optarg);
+                    return 1;
+                }
+                sizes_given = true;
+                break;
+            case 'e': opt.effects = optarg; break;
+            case 'i': opt.file = optarg; break;
+            case 'r': opt.fps = atoi(optarg); break;
+            case 'S': opt.seed = (unsigned int)strtoul(optarg, NULL, 10); break;
+            case 'j': opt.json = true; break;
+            case 'c': opt.canvas = true; break;
+            case 'E': check = true; break;
+            case 'P': check_index = true; break;
+            case 'A': check_particle_kernels = true; break;
+            case 'R': check_sample_ring = true; break;
+            case 'G': check_sample_ingest = true; break;
+            case 'K': check_spectrum_kernels = true; break;
+            case 'h':
+                print_usage(argv[0]);
+                return 0;
+            default:
+                print_usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (opt.frames < 1 || opt.warmup < 0 || opt.fps < 1) {
+        fprintf(stderr, "Frames and fps must be positive\n");
+        return 1;
+    }
+
+    if (check) {
+        return check_encoders(opt.seed);
+    }
+    if (check_index) {
+        return check_pose_index(opt.seed);
+    }
+    if (check_particle_kernels) {
+        return check_particles(opt.seed);
+    }
+    if (check_sample_ring) {
+        return check_ring(opt.seed);
+    }
+    if (check_sample_ingest) {
+        return check_ingest(opt.seed);
+    }
+    if (check_spectrum_kernels) {
+        return check_spectrum(opt.file, opt.seed);
+    }
+
+    if (!sizes_given) {
+        parse_sizes(&opt, opt.canvas ? CANVAS_SIZES : "25x13,50x26,100x52");
+    }
+
+    SpectrumTrack track = { 0 };
+    int rc = 0;
+    if (!opt.canvas) {
+        rc = opt.file ? track_from_file(&track, opt.file, opt.fps)
+                      : track_synthetic(&track, opt.fps, opt.seed);
+        if (rc != 0) return 1;
+    }
+
+    uint64_t *samples[STAGE_COUNT];
+    for (int s = 0; s < STAGE_COUNT; s++) {
+        samples[s] = malloc(sizeof(uint64_t) * opt.frames);
+        if (!samples[s]) {
+            fprintf(stderr, "Out of memory\n");
+            return 1;
+        }
+    }
+
+    FILE *out = stdout;
+    bool first = true;
+    if (opt.json) {
+        fprintf(out, "{\n  \"source\": \"%s\",\n  \"fps\": %d,\n  \"results\": [",
+                opt.canvas ? "canvas" : opt.file ? "file" : "synthetic", opt.fps);
+    } else {
+        fprintf(out, "canvas,effects,stage,frames,mean_ns,p50_ns,p90_ns,p99_ns,max_ns\n");
+    }
+
+    int ran = 0;
+    for (int i = 0; i < opt.num_sizes && rc == 0; i++) {
+        if (opt.canvas) {
+            rc = run_canvas_case(&opt, opt.sizes[i][0], opt.sizes[i][1], true,
+                                 samples, out, &first);
+            if (rc == 0) {
+                rc = run_canvas_case(&opt, opt.sizes[i][0], opt.sizes[i][1], false,
+                                     samples, out, &first);
+            }
+            ran++;
+            continue;
+        }
+        for (int e = 0; e < NUM_EFFECT_SETUPS && rc == 0; e++) {
+            if (!effect_selected(opt.effects, effect_setups[e].name)) continue;
+            rc = run_case(&opt, &track, opt.sizes[i][0], opt.sizes[i][1],
+                          &effect_setups[e], samples, out, &first);
+            ran++;
+        }
+    }
+
+    if (opt.json) {
+        fprintf(out, "\n  ]\n}\n");
+    }
+
+    for (int s = 0; s < STAGE_COUNT; s++) free(samples[s]);
+    free(track.bars);
+
+    if (rc != 0) {
+        fprintf(stderr, "Benchmark case failed\n");
+        return 1;
+    }
+    if (ran == 0) {
+        fprintf(stderr, "No effect setup matches: %s\n", opt.effects);
+        return 1;
+    }
+    return 0;
+}
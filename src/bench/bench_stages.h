@@ -0,0 +1,43 @@
+/*
+ * Benchmark stage hooks - ASCII Dancer v3.2+
+ *
+ * Inner pipeline stages that the headless benchmark (make bench) cannot
+ * time from the outside. Hooks compile to nothing unless BRAILLE_BENCH
+ * is defined, so regular builds carry no timing overhead.
+ */
+
+#ifndef BENCH_STAGES_H
+#define BENCH_STAGES_H
+
+typedef enum {
+    BENCH_STAGE_PARTICLES_UPDATE,   /* particles_update() inside effects_update() */
+    BENCH_STAGE_CANVAS_FINALIZE,    /* braille_canvas_finalize(), all callers */
+    BENCH_STAGE_CAVA_INGEST,        /* history append and windowing in cava_execute() */
+    BENCH_STAGE_COUNT
+} BenchStage;
+
+#ifdef BRAILLE_BENCH
+
+#include <stdint.h>
+#include <time.h>
+
+/* Accumulated ns per stage; the bench driver reads and zeroes these per frame */
+extern uint64_t bench_stage_ns[BENCH_STAGE_COUNT];
+
+static inline uint64_t bench_clock_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+#define BENCH_STAGE_BEGIN(stage) uint64_t bench_t0_##stage = bench_clock_ns()
+#define BENCH_STAGE_END(stage) (bench_stage_ns[stage] += bench_clock_ns() - bench_t0_##stage)
+
+#else
+
+#define BENCH_STAGE_BEGIN(stage) ((void)0)
+#define BENCH_STAGE_END(stage) ((void)0)
+
+#endif /* BRAILLE_BENCH */
+
+#endif /* BENCH_STAGES_H */
@@ -9,9 +9,40 @@
 #include <math.h>
 #include <locale.h>
 #include "braille_canvas.h"
+#include "../bench/bench_stages.h"
 
 /* ============ Canvas Management ============ */
 
+static inline int utf8_row_bytes(const BrailleCanvas *canvas) {
+    return canvas->cell_width * BRAILLE_UTF8_BYTES + 1;
+}
+
+static inline char* utf8_row(BrailleCanvas *canvas, int row) {
+    return canvas->utf8 + (size_t)row * utf8_row_bytes(canvas);
+}
+
+/* Grow a span to cover cell x */
+static inline void span_add(BrailleSpan *span, int x) {
+    if (span->x0 >= span->x1) {
+        span->x0 = x;
+        span->x1 = x + 1;
+        return;
+    }
+    if (x < span->x0) span->x0 = x;
+    if (x >= span->x1) span->x1 = x + 1;
+}
+
+/* Grow a span to cover cells [x0, x1) */
+static inline void span_add_range(BrailleSpan *span, int x0, int x1) {
+    if (span->x0 >= span->x1) {
+        span->x0 = x0;
+        span->x1 = x1;
+        return;
+    }
+    if (x0 < span->x0) span->x0 = x0;
+    if (x1 > span->x1) span->x1 = x1;
+}
+
 BrailleCanvas* braille_canvas_create(int cell_width, int cell_height) {
     BrailleCanvas *canvas = calloc(1, sizeof(BrailleCanvas));
     if (!canvas) return NULL;
@@ -21,25 +52,33 @@ BrailleCanvas* braille_canvas_create(int cell_width, int cell_height) {
     canvas->pixel_width = cell_width * BRAILLE_CELL_W;
     canvas->pixel_height = cell_height * BRAILLE_CELL_H;
     
-    /* Allocate pixel buffer */
-    size_t pixel_count = canvas->pixel_width * canvas->pixel_height;
-    canvas->pixels = calloc(pixel_count, sizeof(uint8_t));
+    /* Allocate dot masks: one byte holds all 8 pixels of a cell */
+    size_t cell_count = cell_width * cell_height;
+    canvas->masks = calloc(cell_count, sizeof(uint8_t));
     
     /* Allocate cell buffer (+ 1 per row for null terminator) */
-    size_t cell_count = cell_width * cell_height;
     canvas->cells = calloc(cell_count + cell_height, sizeof(wchar_t));
+    canvas->utf8 = malloc((size_t)cell_height * utf8_row_bytes(canvas));
     
-    /* Allocate dirty flags */
-    canvas->dirty = calloc(cell_count, sizeof(uint8_t));
+    /* Allocate damage tracking (calloc leaves every span empty) */
+    canvas->ink = calloc(cell_height, sizeof(BrailleSpan));
+    canvas->dirty = calloc(cell_height, sizeof(BrailleSpan));
+    canvas->row_changed = calloc(cell_height, sizeof(uint8_t));
     
-    if (!canvas->pixels || !canvas->cells || !canvas->dirty) {
+    if (!canvas->masks || !canvas->cells || !canvas->utf8 ||
+        !canvas->ink || !canvas->dirty || !canvas->row_changed) {
         braille_canvas_destroy(canvas);
         return NULL;
     }
     
     /* Initialize cells to empty braille */
-    for (size_t i = 0; i < cell_count; i++) {
-        canvas->cells[i] = BRAILLE_BASE;
+    canvas->encoder = braille_encoder_select();
+    for (int row = 0; row < cell_height; row++) {
+        const uint8_t *masks = canvas->masks + (size_t)row * cell_width;
+        char *out = utf8_row(canvas, row);
+        canvas->encoder->expand_cells(masks, cell_width, canvas->cells + (size_t)row * cell_width);
+        canvas->encoder->encode_utf8(masks, cell_width, out);
+        out[cell_width * BRAILLE_UTF8_BYTES] = '\0';
     }
     
     return canvas;
@@ -47,83 +86,108 @@ BrailleCanvas* braille_canvas_create(int cell_width, int cell_height) {
 
 void braille_canvas_destroy(BrailleCanvas *canvas) {
     if (!canvas) return;
-    free(canvas->pixels);
+    free(canvas->masks);
     free(canvas->cells);
+    free(canvas->utf8);
+    free(canvas->ink);
     free(canvas->dirty);
+    free(canvas->row_changed);
     free(canvas);
 }
 
-void braille_canvas_clear(BrailleCanvas *canvas) {
+void braille_canvas_begin(BrailleCanvas *canvas) {
     if (!canvas) return;
-    memset(canvas->pixels, 0, canvas->pixel_width * canvas->pixel_height);
-    memset(canvas->dirty, 1, canvas->cell_width * canvas->cell_height);
+    
+    canvas->frame_open = true;
+    
+    /* Only cells drawn on since the last clear can hold dots */
+    for (int row = 0; row < canvas->cell_height; row++) {
+        BrailleSpan *ink = &canvas->ink[row];
+        if (ink->x0 >= ink->x1) continue;
+        
+        memset(canvas->masks + (size_t)row * canvas->cell_width + ink->x0, 0,
+               ink->x1 - ink->x0);
+        
+        BrailleSpan *dirty = &canvas->dirty[row];
+        if (dirty->x0 >= dirty->x1) {
+            *dirty = *ink;
+        } else {
+            if (ink->x0 < dirty->x0) dirty->x0 = ink->x0;
+            if (ink->x1 > dirty->x1) dirty->x1 = ink->x1;
+        }
+        ink->x0 = ink->x1 = 0;
+    }
 }
 
-void braille_canvas_render(BrailleCanvas *canvas) {
+void braille_canvas_finalize(BrailleCanvas *canvas) {
     if (!canvas) return;
     
-    /* Convert each 2x4 pixel block to a braille character */
-    for (int cy = 0; cy < canvas->cell_height; cy++) {
-        for (int cx = 0; cx < canvas->cell_width; cx++) {
-            int cell_idx = cy * canvas->cell_width + cx;
-            
-            /* Skip if not dirty (optimization) */
-            /* if (!canvas->dirty[cell_idx]) continue; */
-            
-            uint8_t pattern = 0;
-            int px_base = cx * BRAILLE_CELL_W;
-            int py_base = cy * BRAILLE_CELL_H;
-            
-            /* Check each dot in the 2x4 grid */
-            for (int dy = 0; dy < BRAILLE_CELL_H; dy++) {
-                for (int dx = 0; dx < BRAILLE_CELL_W; dx++) {
-                    int px = px_base + dx;
-                    int py = py_base + dy;
-                    
-                    if (px < canvas->pixel_width && py < canvas->pixel_height) {
-                        int pixel_idx = py * canvas->pixel_width + px;
-                        if (canvas->pixels[pixel_idx]) {
-                            pattern |= BRAILLE_DOT_BITS[dy][dx];
-                        }
-                    }
-                }
-            }
-            
-            canvas->cells[cell_idx] = BRAILLE_BASE + pattern;
-            canvas->dirty[cell_idx] = 0;
+    /* Re-encoding a finished frame would only repeat work, and would reset
+     * row_changed to whatever was drawn since the first finalize */
+    if (!canvas->frame_open) {
+        canvas->double_finalizes++;
+        return;
+    }
+    
+    BENCH_STAGE_BEGIN(BENCH_STAGE_CANVAS_FINALIZE);
+    
+    canvas->rendered_cells = 0;
+    for (int row = 0; row < canvas->cell_height; row++) {
+        BrailleSpan *dirty = &canvas->dirty[row];
+        canvas->row_changed[row] = 0;
+        if (dirty->x0 >= dirty->x1) continue;
+        
+        /* The dot mask is the braille character's offset from U+2800;
+         * the span is only re-encoded if one of its characters changed */
+        size_t start = (size_t)row * canvas->cell_width + dirty->x0;
+        int count = dirty->x1 - dirty->x0;
+        if (canvas->encoder->expand_cells(canvas->masks + start, count, canvas->cells + start)) {
+            canvas->encoder->encode_utf8(canvas->masks + start, count,
+                                         utf8_row(canvas, row) + dirty->x0 * BRAILLE_UTF8_BYTES);
+            canvas->row_changed[row] = 1;
         }
+        
+        canvas->rendered_cells += count;
+        dirty->x0 = dirty->x1 = 0;
     }
+    
+    canvas->frame_open = false;
+    canvas->frames++;
+    
+    BENCH_STAGE_END(BENCH_STAGE_CANVAS_FINALIZE);
 }
 
-static const wchar_t* braille_canvas_get_row(BrailleCanvas *canvas, int row) {
-    if (!canvas || row < 0 || row >= canvas->cell_height) return NULL;
-    return &canvas->cells[row * canvas->cell_width];
+bool braille_canvas_row_changed(const BrailleCanvas *canvas, int row) {
+    if (!canvas || row < 0 || row >= canvas->cell_height) return false;
+    return canvas->row_changed[row] != 0;
 }
 
 int braille_canvas_to_utf8(BrailleCanvas *canvas, int row, char *out, int max_len) {
-    if (!canvas || !out || row < 0 || row >= canvas->cell_height) return 0;
-    
-    const wchar_t *wrow = braille_canvas_get_row(canvas, row);
-    int written = 0;
-    
-    for (int i = 0; i < canvas->cell_width && written < max_len - 4; i++) {
-        wchar_t wc = wrow[i];
-        /* Manual UTF-8 encoding for braille range */
-        if (wc >= 0x2800 && wc <= 0x28FF) {
-            /* 3-byte UTF-8 encoding */
-            out[written++] = 0xE0 | ((wc >> 12) & 0x0F);
-            out[written++] = 0x80 | ((wc >> 6) & 0x3F);
-            out[written++] = 0x80 | (wc & 0x3F);
-        }
+    if (!canvas || !out || row < 0 || row >= canvas->cell_height || max_len <= 0) {
+        return 0;
     }
+    
+    /* Whole characters only, leaving room for the terminator */
+    int chars = max_len > 4 ? (max_len - 4 + BRAILLE_UTF8_BYTES - 1) / BRAILLE_UTF8_BYTES : 0;
+    if (chars > canvas->cell_width) chars = canvas->cell_width;
+    
+    int written = chars * BRAILLE_UTF8_BYTES;
+    memcpy(out, utf8_row(canvas, row), written);
     out[written] = '\0';
     return written;
 }
 
 /* ============ Pixel Operations ============ */
 
-static inline int pixel_index(const BrailleCanvas *canvas, int x, int y) {
-    return y * canvas->pixel_width + x;
+/* Cell holding pixel (x, y) and the pixel's bit within that cell's mask;
+ * callers check bounds first, so unsigned math turns into shifts */
+static inline int cell_index(const BrailleCanvas *canvas, int x, int y) {
+    return (int)((unsigned)y / BRAILLE_CELL_H) * canvas->cell_width +
+           (int)((unsigned)x / BRAILLE_CELL_W);
+}
+
+static inline uint8_t dot_bit(int x, int y) {
+    return BRAILLE_DOT_BITS[(unsigned)y % BRAILLE_CELL_H][(unsigned)x % BRAILLE_CELL_W];
 }
 
 static inline int in_bounds(const BrailleCanvas *canvas, int x, int y) {
@@ -131,30 +195,156 @@ static inline int in_bounds(const BrailleCanvas *canvas, int x, int y) {
            y >= 0 && y < canvas->pixel_height;
 }
 
-static inline void mark_dirty(BrailleCanvas *canvas, int x, int y) {
-    int cx = x / BRAILLE_CELL_W;
-    int cy = y / BRAILLE_CELL_H;
-    if (cx >= 0 && cx < canvas->cell_width && cy >= 0 && cy < canvas->cell_height) {
-        canvas->dirty[cy * canvas->cell_width + cx] = 1;
-    }
+/* Store a cell's new mask and record the damage */
+static inline void update_cell(BrailleCanvas *canvas, int x, int y, int idx, uint8_t mask) {
+    if (canvas->masks[idx] == mask) return;
+    canvas->masks[idx] = mask;
+    
+    int row = (int)((unsigned)y / BRAILLE_CELL_H);
+    int col = (int)((unsigned)x / BRAILLE_CELL_W);
+    span_add(&canvas->dirty[row], col);
+    if (mask) span_add(&canvas->ink[row], col);
 }
 
 void braille_set_pixel(BrailleCanvas *canvas, int x, int y, bool on) {
     if (!canvas || !in_bounds(canvas, x, y)) return;
-    canvas->pixels[pixel_index(canvas, x, y)] = on ? 1 : 0;
-    mark_dirty(canvas, x, y);
+    int idx = cell_index(canvas, x, y);
+    uint8_t mask = on ? canvas->masks[idx] | dot_bit(x, y)
+                      : canvas->masks[idx] & (uint8_t)~dot_bit(x, y);
+    update_cell(canvas, x, y, idx, mask);
 }
 
 static bool braille_get_pixel(BrailleCanvas *canvas, int x, int y) {
     if (!canvas || !in_bounds(canvas, x, y)) return false;
-    return canvas->pixels[pixel_index(canvas, x, y)] != 0;
+    return (canvas->masks[cell_index(canvas, x, y)] & dot_bit(x, y)) != 0;
 }
 
 void braille_toggle_pixel(BrailleCanvas *canvas, int x, int y) {
     if (!canvas || !in_bounds(canvas, x, y)) return;
-    int idx = pixel_index(canvas, x, y);
-    canvas->pixels[idx] = !canvas->pixels[idx];
-    mark_dirty(canvas, x, y);
+    int idx = cell_index(canvas, x, y);
+    update_cell(canvas, x, y, idx, canvas->masks[idx] ^ dot_bit(x, y));
+}
+
+/* ============ Span Rasterizer ============ */
+
+/* Record damage for pixel rect [x0, x1] x [y0, y1] (already clipped) once,
+ * instead of per dot; cells that end up unchanged are skipped at render */
+static void mark_pixels(BrailleCanvas *canvas, int x0, int y0, int x1, int y1) {
+    int c0 = x0 / BRAILLE_CELL_W, c1 = x1 / BRAILLE_CELL_W + 1;
+    for (int row = y0 / BRAILLE_CELL_H; row <= y1 / BRAILLE_CELL_H; row++) {
+        span_add_range(&canvas->dirty[row], c0, c1);
+        span_add_range(&canvas->ink[row], c0, c1);
+    }
+}
+
+/* Set pixels [x0, x1] of row y: clipped once, then whole cells at a time */
+static void fill_span(BrailleCanvas *canvas, int x0, int x1, int y) {
+    if (y < 0 || y >= canvas->pixel_height) return;
+    if (x0 < 0) x0 = 0;
+    if (x1 >= canvas->pixel_width) x1 = canvas->pixel_width - 1;
+    if (x0 > x1) return;
+    
+    const uint8_t *bits = BRAILLE_DOT_BITS[y % BRAILLE_CELL_H];
+    uint8_t both = bits[0] | bits[1];
+    uint8_t *masks = canvas->masks + (size_t)(y / BRAILLE_CELL_H) * canvas->cell_width;
+    int c0 = x0 / BRAILLE_CELL_W, c1 = x1 / BRAILLE_CELL_W;
+    
+    if (c0 == c1) {
+        masks[c0] |= (x0 & 1 ? 0 : bits[0]) | (x1 & 1 ? bits[1] : 0);
+    } else {
+        masks[c0] |= x0 & 1 ? bits[1] : both;
+        for (int c = c0 + 1; c < c1; c++) masks[c] |= both;
+        masks[c1] |= x1 & 1 ? both : bits[0];
+    }
+    
+    int row = y / BRAILLE_CELL_H;
+    span_add_range(&canvas->dirty[row], c0, c1 + 1);
+    span_add_range(&canvas->ink[row], c0, c1 + 1);
+}
+
+/* Bresenham without per-dot bounds checks; the caller made sure the
+ * whole line is on the canvas */
+static void line_unclipped(BrailleCanvas *canvas, int x1, int y1, int x2, int y2) {
+    int dx = abs(x2 - x1);
+    int dy = -abs(y2 - y1);
+    int sx = x1 < x2 ? 1 : -1;
+    int sy = y1 < y2 ? 1 : -1;
+    int err = dx + dy;
+    
+    while (1) {
+        canvas->masks[cell_index(canvas, x1, y1)] |= dot_bit(x1, y1);
+        
+        if (x1 == x2 && y1 == y2) break;
+        
+        int e2 = 2 * err;
+        if (e2 >= dy) {
+            err += dy;
+            x1 += sx;
+        }
+        if (e2 <= dx) {
+            err += dx;
+            y1 += sy;
+        }
+    }
+}
+
+/* Segment flattening tolerance in pixels */
+#define FLATTEN_TOLERANCE 0.5
+#define FLATTEN_MAX_DEPTH 10
+
+typedef struct {
+    BrailleCanvas *canvas;
+    int x, y;             /* End of the last emitted segment */
+} Flattener;
+
+/* Truncates like the fixed-step sampling did, so curves keep their shape */
+static void flatten_to(Flattener *f, double x, double y) {
+    int ix = (int)x;
+    int iy = (int)y;
+    if (ix == f->x && iy == f->y) return;
+    braille_draw_line(f->canvas, f->x, f->y, ix, iy);
+    f->x = ix;
+    f->y = iy;
+}
+
+/* Split at t = 0.5 until the control point is within tolerance of the chord */
+static void flatten_quad(Flattener *f, double x0, double y0, double x1, double y1,
+                         double x2, double y2, int depth) {
+    double ddx = x0 - 2 * x1 + x2;
+    double ddy = y0 - 2 * y1 + y2;
+    if (depth >= FLATTEN_MAX_DEPTH ||
+        (ddx * ddx + ddy * ddy) <= 16 * FLATTEN_TOLERANCE * FLATTEN_TOLERANCE) {
+        flatten_to(f, x2, y2);
+        return;
+    }
+    
+    double ax = (x0 + x1) / 2, ay = (y0 + y1) / 2;
+    double bx = (x1 + x2) / 2, by = (y1 + y2) / 2;
+    double mx = (ax + bx) / 2, my = (ay + by) / 2;
+    flatten_quad(f, x0, y0, ax, ay, mx, my, depth + 1);
+    flatten_quad(f, mx, my, bx, by, x2, y2, depth + 1);
+}
+
+static void flatten_cubic(Flattener *f, double x0, double y0, double x1, double y1,
+                          double x2, double y2, double x3, double y3, int depth) {
+    double ax = x0 - 2 * x1 + x2, ay = y0 - 2 * y1 + y2;
+    double bx = x1 - 2 * x2 + x3, by = y1 - 2 * y2 + y3;
+    double d = fmax(ax * ax + ay * ay, bx * bx + by * by);
+    /* Max distance from the chord is at most 3/4 of the larger second difference */
+    if (depth >= FLATTEN_MAX_DEPTH ||
+        d * 9.0 / 16.0 <= FLATTEN_TOLERANCE * FLATTEN_TOLERANCE) {
+        flatten_to(f, x3, y3);
+        return;
+    }
+    
+    double p01x = (x0 + x1) / 2, p01y = (y0 + y1) / 2;
+    double p12x = (x1 + x2) / 2, p12y = (y1 + y2) / 2;
+    double p23x = (x2 + x3) / 2, p23y = (y2 + y3) / 2;
+    double qax = (p01x + p12x) / 2, qay = (p01y + p12y) / 2;
+    double qbx = (p12x + p23x) / 2, qby = (p12y + p23y) / 2;
+    double mx = (qax + qbx) / 2, my = (qay + qby) / 2;
+    flatten_cubic(f, x0, y0, p01x, p01y, qax, qay, mx, my, depth + 1);
+    flatten_cubic(f, mx, my, qbx, qby, p23x, p23y, x3, y3, depth + 1);
 }
 
 /* ============ Drawing Primitives ============ */
@@ -163,6 +353,14 @@ void braille_toggle_pixel(BrailleCanvas *canvas, int x, int y) {
 void braille_draw_line(BrailleCanvas *canvas, int x1, int y1, int x2, int y2) {
     if (!canvas) return;
     
+    /* Clip once: lines fully on the canvas skip per-dot checks */
+    if (in_bounds(canvas, x1, y1) && in_bounds(canvas, x2, y2)) {
+        line_unclipped(canvas, x1, y1, x2, y2);
+        mark_pixels(canvas, x1 < x2 ? x1 : x2, y1 < y2 ? y1 : y2,
+                    x1 > x2 ? x1 : x2, y1 > y2 ? y1 : y2);
+        return;
+    }
+    
     int dx = abs(x2 - x1);
     int dy = -abs(y2 - y1);
     int sx = x1 < x2 ? 1 : -1;
@@ -229,9 +427,7 @@ void braille_fill_circle(BrailleCanvas *canvas, int cx, int cy, int r) {
     
     for (int y = -r; y <= r; y++) {
         int half_width = (int)sqrt(r * r - y * y);
-        for (int x = -half_width; x <= half_width; x++) {
-            braille_set_pixel(canvas, cx + x, cy + y, true);
-        }
+        fill_span(canvas, cx - half_width, cx + half_width, cy + y);
     }
 }
 
@@ -296,37 +492,20 @@ void braille_draw_rect(BrailleCanvas *canvas, int x, int y, int w, int h) {
 }
 
 void braille_fill_rect(BrailleCanvas *canvas, int x, int y, int w, int h) {
-    if (!canvas) return;
+    if (!canvas || w < 1) return;
     for (int py = y; py < y + h; py++) {
-        for (int px = x; px < x + w; px++) {
-            braille_set_pixel(canvas, px, py, true);
-        }
+        fill_span(canvas, x, x + w - 1, py);
     }
 }
 
-/* Quadratic bezier using De Casteljau's algorithm */
+/* Quadratic bezier, flattened adaptively with De Casteljau subdivision */
 void braille_draw_bezier_quad(BrailleCanvas *canvas,
                                int x0, int y0, int x1, int y1, int x2, int y2) {
     if (!canvas) return;
     
-    /* Number of segments (more = smoother) */
-    int segments = 20;
-    int prev_x = x0, prev_y = y0;
-    
-    for (int i = 1; i <= segments; i++) {
-        double t = (double)i / segments;
-        double t2 = t * t;
-        double mt = 1.0 - t;
-        double mt2 = mt * mt;
-        
-        /* B(t) = (1-t)²P0 + 2(1-t)tP1 + t²P2 */
-        int x = (int)(mt2 * x0 + 2 * mt * t * x1 + t2 * x2);
-        int y = (int)(mt2 * y0 + 2 * mt * t * y1 + t2 * y2);
-        
-        braille_draw_line(canvas, prev_x, prev_y, x, y);
-        prev_x = x;
-        prev_y = y;
-    }
+    Flattener f = { canvas, x0, y0 };
+    braille_set_pixel(canvas, x0, y0, true);
+    flatten_quad(&f, x0, y0, x1, y1, x2, y2, 0);
 }
 
 /* Cubic bezier */
@@ -335,28 +514,21 @@ void braille_draw_bezier_cubic(BrailleCanvas *canvas,
                                 int x2, int y2, int x3, int y3) {
     if (!canvas) return;
     
-    int segments = 30;
-    int prev_x = x0, prev_y = y0;
-    
-    for (int i = 1; i <= segments; i++) {
-        double t = (double)i / segments;
-        double t2 = t * t;
-        double t3 = t2 * t;
-        double mt = 1.0 - t;
-        double mt2 = mt * mt;
-        double mt3 = mt2 * mt;
-        
-        /* B(t) = (1-t)³P0 + 3(1-t)²tP1 + 3(1-t)t²P2 + t³P3 */
-        int x = (int)(mt3 * x0 + 3 * mt2 * t * x1 + 3 * mt * t2 * x2 + t3 * x3);
-        int y = (int)(mt3 * y0 + 3 * mt2 * t * y1 + 3 * mt * t2 * y2 + t3 * y3);
-        
-        braille_draw_line(canvas, prev_x, prev_y, x, y);
-        prev_x = x;
-        prev_y = y;
-    }
+    Flattener f = { canvas, x0, y0 };
+    braille_set_pixel(canvas, x0, y0, true);
+    flatten_cubic(&f, x0, y0, x1, y1, x2, y2, x3, y3, 0);
+}
+
+/* Widen a scanline's [lo, hi] to cover the disc of radius r at (cx, cy) */
+static void disc_extent(double cx, double cy, double r, double y, double *lo, double *hi) {
+    double dy = y - cy;
+    if (dy * dy > r * r) return;
+    double hw = sqrt(r * r - dy * dy);
+    if (cx - hw < *lo) *lo = cx - hw;
+    if (cx + hw > *hi) *hi = cx + hw;
 }
 
-/* Draw thick line by drawing multiple parallel lines */
+/* Draw thick line as a capsule (segment swept by a disc), one span per row */
 void braille_draw_thick_line(BrailleCanvas *canvas, 
                               int x1, int y1, int x2, int y2, int thickness) {
     if (!canvas || thickness < 1) return;
@@ -366,30 +538,47 @@ void braille_draw_thick_line(BrailleCanvas *canvas,
         return;
     }
     
-    /* Calculate perpendicular offset */
+    /* Same reach as the old per-pixel offsets on axis-aligned lines, which
+     * truncated to a single pixel on diagonals */
+    double r = thickness / 2;
     double dx = x2 - x1;
     double dy = y2 - y1;
     double len = sqrt(dx * dx + dy * dy);
-    if (len < 0.001) {
-        braille_fill_circle(canvas, x1, y1, thickness / 2);
-        return;
-    }
     
-    /* Perpendicular unit vector */
-    double px = -dy / len;
-    double py = dx / len;
+    /* Body corners: the segment offset by +-r along its normal */
+    double nx = len < 0.001 ? 0 : -dy / len * r;
+    double ny = len < 0.001 ? 0 : dx / len * r;
+    double corner_x[4] = { x1 + nx, x2 + nx, x2 - nx, x1 - nx };
+    double corner_y[4] = { y1 + ny, y2 + ny, y2 - ny, y1 - ny };
     
-    /* Draw parallel lines */
-    int half = thickness / 2;
-    for (int i = -half; i <= half; i++) {
-        int ox = (int)(px * i);
-        int oy = (int)(py * i);
-        braille_draw_line(canvas, x1 + ox, y1 + oy, x2 + ox, y2 + oy);
-    }
+    int top = (int)floor((y1 < y2 ? y1 : y2) - r);
+    int bottom = (int)ceil((y1 > y2 ? y1 : y2) + r);
+    if (top < 0) top = 0;
+    if (bottom >= canvas->pixel_height) bottom = canvas->pixel_height - 1;
     
-    /* Round caps */
-    braille_fill_circle(canvas, x1, y1, half);
-    braille_fill_circle(canvas, x2, y2, half);
+    for (int y = top; y <= bottom; y++) {
+        double lo = INFINITY, hi = -INFINITY;
+        
+        /* Round caps */
+        disc_extent(x1, y1, r, y, &lo, &hi);
+        disc_extent(x2, y2, r, y, &lo, &hi);
+        
+        /* Body: where the scanline crosses the four edges */
+        for (int e = 0; e < 4; e++) {
+            double ax = corner_x[e], ay = corner_y[e];
+            double bx = corner_x[(e + 1) % 4], by = corner_y[(e + 1) % 4];
+            if ((y < ay && y < by) || (y > ay && y > by)) continue;
+            double x = ay == by ? (ax < bx ? ax : bx) : ax + (y - ay) * (bx - ax) / (by - ay);
+            double x_end = ay == by ? (ax > bx ? ax : bx) : x;
+            if (x < lo) lo = x;
+            if (x_end > hi) hi = x_end;
+        }
+        
+        /* The capsule is convex, so one span covers the row */
+        if (lo <= hi) {
+            fill_span(canvas, (int)ceil(lo - 0.01), (int)floor(hi + 0.01), y);
+        }
+    }
 }
 
 /*
@@ -17,21 +17,42 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <wchar.h>
+#include "braille_encode.h"
 
 /* Braille base character and dimensions */
 #define BRAILLE_BASE     0x2800
 #define BRAILLE_CELL_W   2   /* pixels per cell horizontally */
 #define BRAILLE_CELL_H   4   /* pixels per cell vertically */
 
+#define BRAILLE_UTF8_BYTES 3  /* Every braille character encodes to 3 bytes */
+
+/* Cells [x0, x1) of one row; empty when x0 >= x1 */
+typedef struct {
+    int x0;
+    int x1;
+} BrailleSpan;
+
 /* Canvas structure */
 typedef struct {
     int pixel_width;      /* Width in pixels (subpixels) */
     int pixel_height;     /* Height in pixels */
     int cell_width;       /* Width in terminal cells */
     int cell_height;      /* Height in terminal cells */
-    uint8_t *pixels;      /* Pixel buffer: 1 byte per pixel (0 or 1) */
+    uint8_t *masks;       /* Dot mask per cell (BRAILLE_DOT_BITS), row-major */
     wchar_t *cells;       /* Output buffer: braille characters */
-    uint8_t *dirty;       /* Dirty flags per cell for partial updates */
+    char *utf8;           /* Encoded rows, cell_width * 3 + 1 bytes each */
+    const BrailleEncoder *encoder;  /* Picked for this CPU at create */
+    
+    /* Damage tracking, per row (v3.2+) */
+    BrailleSpan *ink;     /* Cells drawn on since the last clear */
+    BrailleSpan *dirty;   /* Cells that may have changed since the last render */
+    uint8_t *row_changed; /* Row output changed in the last render */
+    int rendered_cells;   /* Cells re-encoded by the last render */
+    
+    /* Frame lifecycle (v3.2+) */
+    bool frame_open;      /* Between begin and finalize */
+    unsigned long frames; /* Frames finalized */
+    unsigned long double_finalizes; /* Finalize calls with no frame open */
 } BrailleCanvas;
 
 /* Lookup table for dot positions -> bit values */
@@ -50,15 +71,29 @@ BrailleCanvas* braille_canvas_create(int cell_width, int cell_height);
 /* Free canvas resources */
 void braille_canvas_destroy(BrailleCanvas *canvas);
 
-/* Clear all pixels */
-void braille_canvas_clear(BrailleCanvas *canvas);
+/* ============ Frame Lifecycle ============ */
+
+/*
+ * A frame is begin, any number of drawing layers (skeleton, trails,
+ * particles, ...), then one finalize. Layers only draw; the frame's owner
+ * finalizes. Finalizing an already finalized frame is counted in
+ * double_finalizes and skipped.
+ */
+
+/* Start a frame: clear all pixels (only the cells drawn on since the last
+ * clear are touched) */
+void braille_canvas_begin(BrailleCanvas *canvas);
 
-/* Convert pixel buffer to braille characters */
-void braille_canvas_render(BrailleCanvas *canvas);
+/* End the frame: convert dirty cells to braille characters and UTF-8; clean
+ * cells keep last frame's output, so cost follows what changed, not canvas
+ * size */
+void braille_canvas_finalize(BrailleCanvas *canvas);
 
-/* Get the rendered braille string for a row (null-terminated) */
+/* Did the last finalize change this row's output? */
+bool braille_canvas_row_changed(const BrailleCanvas *canvas, int row);
 
-/* Get UTF-8 encoded output for ncurses */
+/* Get UTF-8 encoded output for ncurses (copied from the rendered rows).
+ * Returns the bytes written; out is left untouched when max_len <= 0. */
 int braille_canvas_to_utf8(BrailleCanvas *canvas, int row, char *out, int max_len);
 
 /* ============ Pixel Operations ============ */
@@ -14,18 +14,28 @@
 #include "../dancer/dancer.h"
 #include "braille_canvas.h"
 #include "skeleton_dancer.h"
+#include "pose_pack.h"
 #include "../effects/effects.h"
 #include "../effects/particles.h"  /* For body mask functions */
+#include "../ui/frame_scheduler.h"  /* FRAME_QUALITY_* levels */
 
-/* Canvas size in terminal cells */
+/* Default canvas size in terminal cells */
 #define CANVAS_CELLS_W 25
 #define CANVAS_CELLS_H 13
 
+static int canvas_cells_w = CANVAS_CELLS_W;
+static int canvas_cells_h = CANVAS_CELLS_H;
+
 static BrailleCanvas *canvas = NULL;
 static SkeletonDancer *skeleton = NULL;
 static EffectsManager *effects = NULL;
 static int initialized = 0;
 
+/* Custom choreography (v3.2+); NULL dances the built-in poses */
+static PosePack *pose_pack = NULL;
+static int particle_pool = 0;         /* 0: from canvas area */
+static uint64_t effects_seed_value = 0;
+
 /* Track audio for effects */
 static float last_bass = 0;
 static float last_treble = 0;
@@ -46,6 +56,10 @@ static float current_bpm = 120.0f;
 static bool rhythm_onset = false;
 static float rhythm_onset_strength = 0.0f;
 
+/* Frame timing and adaptive quality (v3.2+) */
+static float frame_dt = 0.0167f;   /* Measured by the frame scheduler */
+static int render_quality = FRAME_QUALITY_FULL;
+
 /* Pixel dimensions */
 static int pixel_width = 0;
 static int pixel_height = 0;
@@ -57,15 +71,19 @@ static bool show_shadow = false;
 /* Ground position */
 static int ground_y = 0;  /* Pixel y-coordinate of ground line */
 
-/* Convert joint normalized coords (0-1) to pixel coords */
+/* Retained frame (v3.2+): view of canvas->cells after the last render */
+static DancerFrame frame_view = {0};
+
+/* Convert joint normalized coords (0-1) to pixel coords, with the
+ * skeleton's own scale so effects line up with it on any canvas size */
 static inline float joint_to_pixel_x(float x) {
-    /* Joint x is 0-1 centered at 0.5, convert to pixel coords */
-    return (x - 0.5f) * (pixel_width * 0.75f) + (pixel_width / 2.0f);
+    /* Joint x is 0-1 centered at 0.5 */
+    return (x - 0.5f) * skeleton->scale + skeleton->offset_x;
 }
 
 static inline float joint_to_pixel_y(float y) {
-    /* Joint y is 0-1 from top, convert to pixel coords with headroom */
-    return y * (pixel_height * 0.70f) + (pixel_height * 0.18f);
+    /* Joint y is 0-1 from top */
+    return y * skeleton->scale + skeleton->offset_y;
 }
 
 int dancer_load_frames(void) {
@@ -74,20 +92,28 @@ int dancer_load_frames(void) {
     setlocale(LC_ALL, "");
     
     /* Create braille canvas */
-    canvas = braille_canvas_create(CANVAS_CELLS_W, CANVAS_CELLS_H);
+    canvas = braille_canvas_create(canvas_cells_w, canvas_cells_h);
     if (!canvas) return -1;
     
     /* Create skeleton dancer */
-    skeleton = skeleton_dancer_create(CANVAS_CELLS_W, CANVAS_CELLS_H);
+    skeleton = skeleton_dancer_create(canvas_cells_w, canvas_cells_h);
     if (!skeleton) {
         braille_canvas_destroy(canvas);
+        canvas = NULL;
         return -1;
     }
+    if (pose_pack) {
+        skeleton_dancer_set_library(skeleton, &pose_pack->library);
+    }
     
     /* Create effects system */
-    pixel_width = CANVAS_CELLS_W * 2;   /* 2 pixels per cell width */
-    pixel_height = CANVAS_CELLS_H * 4;  /* 4 pixels per cell height */
+    pixel_width = canvas_cells_w * 2;   /* 2 pixels per cell width */
+    pixel_height = canvas_cells_h * 4;  /* 4 pixels per cell height */
     effects = effects_create(pixel_width, pixel_height);
+    if (effects && particle_pool > 0) {
+        particles_set_pool(effects->particles, particle_pool);
+    }
+    effects_seed(effects, effects_seed_value);
     
     /* Ground line is at the bottom of the canvas */
     ground_y = pixel_height - 3;
@@ -114,9 +140,88 @@ void dancer_cleanup(void) {
         braille_canvas_destroy(canvas);
         canvas = NULL;
     }
+    pose_pack_close(pose_pack);
+    pose_pack = NULL;
+    memset(&frame_view, 0, sizeof(frame_view));
     initialized = 0;
 }
 
+int dancer_set_pose_pack(const char *path, const char **error) {
+    PosePack *pack = NULL;
+    if (path && path[0]) {
+        pack = pose_pack_open(path, error);
+        if (!pack) return -1;
+    }
+    
+    if (skeleton) {
+        skeleton_dancer_set_library(skeleton, pack ? &pack->library : NULL);
+    }
+    pose_pack_close(pose_pack);
+    pose_pack = pack;
+    return 0;
+}
+
+void dancer_set_particle_pool(int size) {
+    particle_pool = size > 0 ? size : 0;
+    if (effects) particles_set_pool(effects->particles, particle_pool);
+}
+
+void dancer_set_seed(uint64_t seed) {
+    effects_seed_value = seed;
+    effects_seed(effects, seed);
+}
+
+/* Change canvas size. A loaded dancer gets a new canvas and refits the
+ * skeleton and effects in place, so the dance carries on and the particle
+ * system stays the same object; live particles are kept, clamped to the
+ * new canvas. */
+int dancer_set_canvas_size(int cells_w, int cells_h) {
+    if (cells_w < 1 || cells_h < 1) return -1;
+    if (!initialized) {
+        canvas_cells_w = cells_w;
+        canvas_cells_h = cells_h;
+        return 0;
+    }
+    if (cells_w == canvas_cells_w && cells_h == canvas_cells_h) return 0;
+    
+    BrailleCanvas *resized = braille_canvas_create(cells_w, cells_h);
+    if (!resized) return -1;
+    resized->frames = canvas->frames;
+    resized->double_finalizes = canvas->double_finalizes;
+    braille_canvas_destroy(canvas);
+    canvas = resized;
+    canvas_cells_w = cells_w;
+    canvas_cells_h = cells_h;
+    
+    /* The retained frame is blank until the next render */
+    frame_view.width = canvas->cell_width;
+    frame_view.height = canvas->cell_height;
+    frame_view.cells = canvas->cells;
+    
+    skeleton_dancer_set_canvas_size(skeleton, cells_w, cells_h);
+    pixel_width = cells_w * 2;
+    pixel_height = cells_h * 4;
+    ground_y = pixel_height - 3;
+    if (effects) {
+        effects_set_canvas_size(effects, pixel_width, pixel_height);
+        particles_set_pool(effects->particles, particle_pool);
+    }
+    return 0;
+}
+
+void dancer_set_frame_dt(float dt) {
+    if (dt > 0.0f) frame_dt = dt;
+}
+
+void dancer_set_quality(int level) {
+    render_quality = level;
+}
+
+/* New particles are the first thing dropped at minimal quality */
+static inline bool spawning_allowed(void) {
+    return effects && render_quality < FRAME_QUALITY_MINIMAL;
+}
+
 void dancer_update(struct dancer_state *state, double bass, double mid, double treble) {
     if (!skeleton) return;
     
@@ -126,15 +231,15 @@ void dancer_update(struct dancer_state *state, double bass, double mid, double t
     state->mid_intensity = state->mid_intensity * smooth + mid * (1.0 - smooth);
     state->treble_intensity = state->treble_intensity * smooth + treble * (1.0 - smooth);
     
-    /* Calculate dt (approximately 60fps = 0.0167s) */
-    float dt = 0.0167f;
+    /* Measured frame time from the scheduler */
+    float dt = frame_dt;
     
     /* Track bass/treble velocity for transient detection */
     bass_velocity = (float)state->bass_intensity - last_bass;
     treble_velocity = (float)state->treble_intensity - last_treble;
     
     /* Detect bass hit (rising edge above threshold) */
-    if (effects && bass_velocity > 0.05f && state->bass_intensity > bass_threshold) {
+    if (spawning_allowed() && bass_velocity > 0.05f && state->bass_intensity > bass_threshold) {
         /* Use actual foot joint positions - convert to pixel coords */
         float foot_x = (skeleton->current[JOINT_FOOT_L].x + skeleton->current[JOINT_FOOT_R].x) / 2;
         float foot_y = skeleton->current[JOINT_FOOT_L].y;
@@ -144,7 +249,7 @@ void dancer_update(struct dancer_state *state, double bass, double mid, double t
     }
     
     /* Detect treble spike */
-    if (effects && treble_velocity > 0.05f && state->treble_intensity > treble_threshold) {
+    if (spawning_allowed() && treble_velocity > 0.05f && state->treble_intensity > treble_threshold) {
         /* Use actual hand joint positions - convert to pixel coords */
         float hand_x = skeleton->current[JOINT_HAND_R].x;
         float hand_y = skeleton->current[JOINT_HAND_R].y;
@@ -156,7 +261,7 @@ void dancer_update(struct dancer_state *state, double bass, double mid, double t
     /* Detect beat (overall energy spike) */
     float energy = (state->bass_intensity + state->mid_intensity + state->treble_intensity) / 3.0f;
     static float last_energy = 0;
-    if (effects && energy - last_energy > 0.1f && energy > 0.3f) {
+    if (spawning_allowed() && energy - last_energy > 0.1f && energy > 0.3f) {
         /* Burst from center of dancer - convert to pixel coords */
         float center_x = skeleton->current[JOINT_HIP_CENTER].x;
         float center_y = skeleton->current[JOINT_HIP_CENTER].y;
@@ -194,19 +299,17 @@ void dancer_update(struct dancer_state *state, double bass, double mid, double t
     state->phase = skeleton->phase;
 }
 
-void dancer_compose_frame(struct dancer_state *state, char *output) {
+void dancer_render_frame(struct dancer_state *state) {
     (void)state;
     
-    if (!skeleton || !canvas) {
-        strcpy(output, "No dancer loaded\n");
-        return;
-    }
+    if (!skeleton || !canvas) return;
     
-    /* Clear canvas */
-    braille_canvas_clear(canvas);
+    /* Start the frame; every layer below only draws */
+    braille_canvas_begin(canvas);
     
     /* Render trails first (behind dancer) */
-    if (effects && effects->trails && effects->trails->enabled) {
+    if (effects && effects->trails && effects->trails->enabled &&
+        render_quality < FRAME_QUALITY_NO_TRAILS) {
         trails_render(effects->trails, canvas);
     }
     
@@ -218,7 +321,7 @@ void dancer_compose_frame(struct dancer_state *state, char *output) {
     }
     
     /* Render shadow/reflection (mirrored silhouette below ground) */
-    if (show_shadow && skeleton) {
+    if (show_shadow && skeleton && render_quality < FRAME_QUALITY_NO_TRAILS) {
         const Joint *joints = skeleton_dancer_get_joints(skeleton);
         if (joints) {
             /* Draw connecting lines for shadow silhouette */
@@ -287,13 +390,34 @@ void dancer_compose_frame(struct dancer_state *state, char *output) {
         particles_render(effects->particles, canvas);
     }
     
-    /* Convert pixels to braille characters */
-    braille_canvas_render(canvas);
+    /* Convert pixels to braille characters, once per frame */
+    braille_canvas_finalize(canvas);
+    
+    frame_view.width = canvas->cell_width;
+    frame_view.height = canvas->cell_height;
+    frame_view.cells = canvas->cells;
+    frame_view.double_finalizes = canvas->double_finalizes;
+    frame_view.seq++;
+}
+
+const DancerFrame* dancer_get_frame(void) {
+    if (!canvas || frame_view.seq == 0) return NULL;
+    return &frame_view;
+}
+
+void dancer_compose_frame(struct dancer_state *state, char *output) {
+    if (!skeleton || !canvas) {
+        strcpy(output, "No dancer loaded\n");
+        return;
+    }
+    
+    dancer_render_frame(state);
     
-    /* Convert to UTF-8 output */
+    /* Convert to UTF-8 output (3 bytes per cell, +1 for the terminator) */
     char *ptr = output;
+    int row_bytes = canvas->cell_width * 3 + 5;
     for (int row = 0; row < canvas->cell_height; row++) {
-        int len = braille_canvas_to_utf8(canvas, row, ptr, 256);
+        int len = braille_canvas_to_utf8(canvas, row, ptr, row_bytes);
         ptr += len;
         *ptr++ = '\n';
     }
@@ -422,8 +546,8 @@ void dancer_update_with_rhythm(struct dancer_state *state,
     rhythm_onset = onset_detected;
     rhythm_onset_strength = onset_strength;
     
-    /* Calculate dt (approximately 60fps = 0.0167s) */
-    float dt = 0.0167f;
+    /* Measured frame time from the scheduler */
+    float dt = frame_dt;
     
     /* Note: visualizer is now updated separately via dancer_update_spectrum() */
     
@@ -446,7 +570,7 @@ void dancer_update_with_rhythm(struct dancer_state *state,
     /* Continuous particle spawning based on energy level */
     float spawn_interval = particle_spawn_rate / (0.5f + energy * 2.0f);  /* Faster when louder */
     
-    if (effects && particle_spawn_timer >= spawn_interval && energy > 0.05f) {
+    if (spawning_allowed() && particle_spawn_timer >= spawn_interval && energy > 0.05f) {
         particle_spawn_timer = 0.0f;
         
         /* Spawn particles based on which band is dominant */
@@ -466,7 +590,7 @@ void dancer_update_with_rhythm(struct dancer_state *state,
     }
     
     /* Strong transient detection - burst on velocity spikes */
-    if (effects && bass_velocity > 0.08f && state->bass_intensity > bass_threshold) {
+    if (spawning_allowed() && bass_velocity > 0.08f && state->bass_intensity > bass_threshold) {
         float foot_x = (skeleton->current[JOINT_FOOT_L].x + skeleton->current[JOINT_FOOT_R].x) / 2;
         float foot_y = skeleton->current[JOINT_FOOT_L].y;
         effects_on_bass_hit(effects, (float)state->bass_intensity, 
@@ -474,7 +598,7 @@ void dancer_update_with_rhythm(struct dancer_state *state,
     }
     
     /* Treble spike burst */
-    if (effects && treble_velocity > 0.08f && state->treble_intensity > treble_threshold) {
+    if (spawning_allowed() && treble_velocity > 0.08f && state->treble_intensity > treble_threshold) {
         float hand_x = skeleton->current[JOINT_HAND_R].x;
         float hand_y = skeleton->current[JOINT_HAND_R].y;
         effects_on_treble_spike(effects, (float)state->treble_intensity, 
@@ -482,7 +606,7 @@ void dancer_update_with_rhythm(struct dancer_state *state,
     }
     
     /* Rhythm onset detection - burst particles on detected onsets */
-    if (effects && rhythm_onset && rhythm_onset_strength > 0.3f) {
+    if (spawning_allowed() && rhythm_onset && rhythm_onset_strength > 0.3f) {
         float center_x = skeleton->current[JOINT_HIP_CENTER].x;
         float center_y = skeleton->current[JOINT_HIP_CENTER].y;
         effects_on_beat(effects, rhythm_onset_strength,
@@ -494,7 +618,7 @@ void dancer_update_with_rhythm(struct dancer_state *state,
     static float note_timer = 0;
     note_timer += dt;
     
-    if (effects && energy > 0.15f && beat_phase < 0.1f && last_phase > 0.9f) {
+    if (spawning_allowed() && energy > 0.15f && beat_phase < 0.1f && last_phase > 0.9f) {
         float center_x = skeleton->current[JOINT_HIP_CENTER].x;
         float center_y = skeleton->current[JOINT_HIP_CENTER].y;
         effects_on_beat(effects, energy * 0.7f,
@@ -506,7 +630,7 @@ void dancer_update_with_rhythm(struct dancer_state *state,
             /* Spawn from head area - randomize position */
             float head_x = skeleton->current[JOINT_HEAD].x;
             float head_y = skeleton->current[JOINT_HEAD].y;
-            int offset_x = (rand() % 30) - 15;
+            int offset_x = rng_int(&effects->rng, 30) - 15;
             particles_emit_music_notes(effects->particles,
                                        joint_to_pixel_x(head_x) + offset_x,
                                        joint_to_pixel_y(head_y) - 3,
@@ -515,10 +639,10 @@ void dancer_update_with_rhythm(struct dancer_state *state,
     }
     
     /* Also spawn notes on half-beats at high energy */
-    if (effects && effects->particles && energy > 0.5f && 
+    if (spawning_allowed() && effects->particles && energy > 0.5f && 
         beat_phase > 0.45f && beat_phase < 0.55f && note_timer > 0.2f) {
         note_timer = 0;
-        float hand_x = (rand() % 2 == 0) ? 
+        float hand_x = (rng_int(&effects->rng, 2) == 0) ? 
             skeleton->current[JOINT_HAND_L].x : skeleton->current[JOINT_HAND_R].x;
         float hand_y = skeleton->current[JOINT_HAND_L].y;
         particles_emit_music_notes(effects->particles,
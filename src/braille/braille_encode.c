@@ -0,0 +1,254 @@
+/*
+ * Braille Encoders Implementation
+ */
+
+#include <string.h>
+#include "braille_encode.h"
+#include "braille_canvas.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define BRAILLE_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#define BRAILLE_ARM 1
+#include <arm_neon.h>
+#endif
+
+/* The vector sets write cells[] as 32-bit lanes */
+#if WCHAR_MAX <= 0xFFFF
+#undef BRAILLE_X86
+#undef BRAILLE_ARM
+#endif
+
+/* ============ Scalar reference ============ */
+
+static void encode_utf8_scalar(const uint8_t *masks, int count, char *out) {
+    for (int i = 0; i < count; i++) {
+        wchar_t wc = BRAILLE_BASE + masks[i];
+        out[i * 3]     = (char)(0xE0 | ((wc >> 12) & 0x0F));
+        out[i * 3 + 1] = (char)(0x80 | ((wc >> 6) & 0x3F));
+        out[i * 3 + 2] = (char)(0x80 | (wc & 0x3F));
+    }
+}
+
+static int expand_cells_scalar(const uint8_t *masks, int count, wchar_t *cells) {
+    int changed = 0;
+    for (int i = 0; i < count; i++) {
+        wchar_t wc = BRAILLE_BASE + masks[i];
+        if (cells[i] != wc) {
+            cells[i] = wc;
+            changed = 1;
+        }
+    }
+    return changed;
+}
+
+static const BrailleEncoder encoder_scalar = {
+    .name = "scalar",
+    .encode_utf8 = encode_utf8_scalar,
+    .expand_cells = expand_cells_scalar,
+};
+
+/* ============ Lookup table ============ */
+
+/* Precomputed UTF-8 for all 256 braille characters */
+#define UTF8_SEQ(m)  { 0xE2, 0xA0 | ((m) >> 6), 0x80 | ((m) & 0x3F) }
+#define UTF8_SEQ4(m)  UTF8_SEQ(m), UTF8_SEQ((m) + 1), UTF8_SEQ((m) + 2), UTF8_SEQ((m) + 3)
+#define UTF8_SEQ16(m) UTF8_SEQ4(m), UTF8_SEQ4((m) + 4), UTF8_SEQ4((m) + 8), UTF8_SEQ4((m) + 12)
+#define UTF8_SEQ64(m) UTF8_SEQ16(m), UTF8_SEQ16((m) + 16), UTF8_SEQ16((m) + 32), UTF8_SEQ16((m) + 48)
+
+static const uint8_t utf8_table[256][3] = {
+    UTF8_SEQ64(0), UTF8_SEQ64(64), UTF8_SEQ64(128), UTF8_SEQ64(192)
+};
+
+static void encode_utf8_table(const uint8_t *masks, int count, char *out) {
+    for (int i = 0; i < count; i++) {
+        memcpy(out + i * 3, utf8_table[masks[i]], 3);
+    }
+}
+
+/* Branch-free so the compiler can vectorize it */
+static int expand_cells_table(const uint8_t *masks, int count, wchar_t *cells) {
+    int changed = 0;
+    for (int i = 0; i < count; i++) {
+        wchar_t wc = BRAILLE_BASE + masks[i];
+        changed |= cells[i] != wc;
+        cells[i] = wc;
+    }
+    return changed;
+}
+
+static const BrailleEncoder encoder_table = {
+    .name = "table",
+    .encode_utf8 = encode_utf8_table,
+    .expand_cells = expand_cells_table,
+};
+
+#ifdef BRAILLE_X86
+
+/* ============ SSSE3: 16 cells -> 48 bytes with three pshufb ============ */
+
+/* Output byte p belongs to cell p / 3; the lead byte (p % 3 == 0) is
+ * constant, so it takes no source byte (-1 shuffles in a zero) */
+static const int8_t ssse3_gather[3][16] = {
+    { -1, 0, 0, -1, 1, 1, -1, 2, 2, -1, 3, 3, -1, 4, 4, -1 },
+    { 5, 5, -1, 6, 6, -1, 7, 7, -1, 8, 8, -1, 9, 9, -1, 10 },
+    { 10, -1, 11, 11, -1, 12, 12, -1, 13, 13, -1, 14, 14, -1, 15, 15 },
+};
+
+/* Fixed bits of each output byte: 0xE2 lead, 0xA0 middle, 0x80 last */
+static const uint8_t ssse3_prefix[3][16] = {
+    { 0xE2, 0xA0, 0x80, 0xE2, 0xA0, 0x80, 0xE2, 0xA0, 0x80, 0xE2, 0xA0, 0x80, 0xE2, 0xA0, 0x80, 0xE2 },
+    { 0xA0, 0x80, 0xE2, 0xA0, 0x80, 0xE2, 0xA0, 0x80, 0xE2, 0xA0, 0x80, 0xE2, 0xA0, 0x80, 0xE2, 0xA0 },
+    { 0x80, 0xE2, 0xA0, 0x80, 0xE2, 0xA0, 0x80, 0xE2, 0xA0, 0x80, 0xE2, 0xA0, 0x80, 0xE2, 0xA0, 0x80 },
+};
+
+/* Mask bits taken by middle bytes (m >> 6) and last bytes (m & 0x3F) */
+static const uint8_t ssse3_high[3][16] = {
+    { 0, 0x03, 0, 0, 0x03, 0, 0, 0x03, 0, 0, 0x03, 0, 0, 0x03, 0, 0 },
+    { 0x03, 0, 0, 0x03, 0, 0, 0x03, 0, 0, 0x03, 0, 0, 0x03, 0, 0, 0x03 },
+    { 0, 0, 0x03, 0, 0, 0x03, 0, 0, 0x03, 0, 0, 0x03, 0, 0, 0x03, 0 },
+};
+
+static const uint8_t ssse3_low[3][16] = {
+    { 0, 0, 0x3F, 0, 0, 0x3F, 0, 0, 0x3F, 0, 0, 0x3F, 0, 0, 0x3F, 0 },
+    { 0, 0x3F, 0, 0, 0x3F, 0, 0, 0x3F, 0, 0, 0x3F, 0, 0, 0x3F, 0, 0 },
+    { 0x3F, 0, 0, 0x3F, 0, 0, 0x3F, 0, 0, 0x3F, 0, 0, 0x3F, 0, 0, 0x3F },
+};
+
+__attribute__((target("ssse3")))
+static void encode_utf8_ssse3(const uint8_t *masks, int count, char *out) {
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i m = _mm_loadu_si128((const __m128i *)(masks + i));
+        for (int k = 0; k < 3; k++) {
+            __m128i s = _mm_shuffle_epi8(m, _mm_loadu_si128((const __m128i *)ssse3_gather[k]));
+            /* Byte shift via 16-bit lanes; the & drops bits from the neighbour */
+            __m128i high = _mm_and_si128(_mm_srli_epi16(s, 6),
+                                         _mm_loadu_si128((const __m128i *)ssse3_high[k]));
+            __m128i low = _mm_and_si128(s, _mm_loadu_si128((const __m128i *)ssse3_low[k]));
+            __m128i v = _mm_or_si128(_mm_loadu_si128((const __m128i *)ssse3_prefix[k]),
+                                     _mm_or_si128(high, low));
+            _mm_storeu_si128((__m128i *)(out + i * 3 + k * 16), v);
+        }
+    }
+    encode_utf8_table(masks + i, count - i, out + i * 3);
+}
+
+__attribute__((target("ssse3")))
+static int expand_cells_ssse3(const uint8_t *masks, int count, wchar_t *cells) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i base = _mm_set1_epi32(BRAILLE_BASE);
+    __m128i diff = zero;
+    int i = 0;
+
+    for (; i + 16 <= count; i += 16) {
+        __m128i m = _mm_loadu_si128((const __m128i *)(masks + i));
+        __m128i lo16 = _mm_unpacklo_epi8(m, zero);
+        __m128i hi16 = _mm_unpackhi_epi8(m, zero);
+        __m128i w[4] = {
+            _mm_add_epi32(_mm_unpacklo_epi16(lo16, zero), base),
+            _mm_add_epi32(_mm_unpackhi_epi16(lo16, zero), base),
+            _mm_add_epi32(_mm_unpacklo_epi16(hi16, zero), base),
+            _mm_add_epi32(_mm_unpackhi_epi16(hi16, zero), base),
+        };
+        for (int k = 0; k < 4; k++) {
+            __m128i *dst = (__m128i *)(cells + i + k * 4);
+            diff = _mm_or_si128(diff, _mm_xor_si128(_mm_loadu_si128(dst), w[k]));
+            _mm_storeu_si128(dst, w[k]);
+        }
+    }
+
+    int changed = _mm_movemask_epi8(_mm_cmpeq_epi8(diff, zero)) != 0xFFFF;
+    return expand_cells_table(masks + i, count - i, cells + i) | changed;
+}
+
+static const BrailleEncoder encoder_ssse3 = {
+    .name = "ssse3",
+    .encode_utf8 = encode_utf8_ssse3,
+    .expand_cells = expand_cells_ssse3,
+};
+
+#endif /* BRAILLE_X86 */
+
+#ifdef BRAILLE_ARM
+
+/* ============ NEON: 16 cells -> 48 bytes with one interleaving store ============ */
+
+static void encode_utf8_neon(const uint8_t *masks, int count, char *out) {
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        uint8x16_t m = vld1q_u8(masks + i);
+        uint8x16x3_t v;
+        v.val[0] = vdupq_n_u8(0xE2);
+        v.val[1] = vorrq_u8(vshrq_n_u8(m, 6), vdupq_n_u8(0xA0));
+        v.val[2] = vorrq_u8(vandq_u8(m, vdupq_n_u8(0x3F)), vdupq_n_u8(0x80));
+        vst3q_u8((uint8_t *)out + i * 3, v);
+    }
+    encode_utf8_table(masks + i, count - i, out + i * 3);
+}
+
+static int expand_cells_neon(const uint8_t *masks, int count, wchar_t *cells) {
+    const uint32x4_t base = vdupq_n_u32(BRAILLE_BASE);
+    uint32x4_t diff = vdupq_n_u32(0);
+    int i = 0;
+
+    for (; i + 16 <= count; i += 16) {
+        uint8x16_t m = vld1q_u8(masks + i);
+        uint16x8_t lo16 = vmovl_u8(vget_low_u8(m));
+        uint16x8_t hi16 = vmovl_u8(vget_high_u8(m));
+        uint32x4_t w[4] = {
+            vaddq_u32(vmovl_u16(vget_low_u16(lo16)), base),
+            vaddq_u32(vmovl_u16(vget_high_u16(lo16)), base),
+            vaddq_u32(vmovl_u16(vget_low_u16(hi16)), base),
+            vaddq_u32(vmovl_u16(vget_high_u16(hi16)), base),
+        };
+        for (int k = 0; k < 4; k++) {
+            uint32_t *dst = (uint32_t *)(cells + i + k * 4);
+            diff = vorrq_u32(diff, veorq_u32(vld1q_u32(dst), w[k]));
+            vst1q_u32(dst, w[k]);
+        }
+    }
+
+    int changed = vmaxvq_u32(diff) != 0;
+    return expand_cells_table(masks + i, count - i, cells + i) | changed;
+}
+
+static const BrailleEncoder encoder_neon = {
+    .name = "neon",
+    .encode_utf8 = encode_utf8_neon,
+    .expand_cells = expand_cells_neon,
+};
+
+#endif /* BRAILLE_ARM */
+
+/* ============ Selection ============ */
+
+const BrailleEncoder* braille_encoder_get(BrailleISA isa) {
+    switch (isa) {
+        case BRAILLE_ISA_SCALAR:
+            return &encoder_scalar;
+        case BRAILLE_ISA_TABLE:
+            return &encoder_table;
+#ifdef BRAILLE_X86
+        case BRAILLE_ISA_SSSE3:
+            return __builtin_cpu_supports("ssse3") ? &encoder_ssse3 : NULL;
+#endif
+#ifdef BRAILLE_ARM
+        case BRAILLE_ISA_NEON:
+            return &encoder_neon;
+#endif
+        default:
+            return NULL;
+    }
+}
+
+const BrailleEncoder* braille_encoder_select(void) {
+    for (int isa = BRAILLE_ISA_COUNT - 1; isa > BRAILLE_ISA_SCALAR; isa--) {
+        const BrailleEncoder *enc = braille_encoder_get((BrailleISA)isa);
+        if (enc) return enc;
+    }
+    return &encoder_scalar;
+}
@@ -0,0 +1,43 @@
+/*
+ * Braille Encoders - ASCII Dancer v3.2+
+ *
+ * Turns rows of BrailleCanvas dot masks into output: wide characters for
+ * cells[] and the 3-byte UTF-8 sequence of each character. The scalar set
+ * is the reference; the table, SSSE3 and NEON sets must produce identical
+ * bytes and are picked once per canvas for the running CPU.
+ *
+ * Every braille character U+2800 + m encodes as
+ *   0xE2, 0xA0 | (m >> 6), 0x80 | (m & 0x3F)
+ */
+
+#ifndef BRAILLE_ENCODE_H
+#define BRAILLE_ENCODE_H
+
+#include <stdint.h>
+#include <wchar.h>
+
+typedef enum {
+    BRAILLE_ISA_SCALAR,
+    BRAILLE_ISA_TABLE,
+    BRAILLE_ISA_SSSE3,
+    BRAILLE_ISA_NEON,
+    BRAILLE_ISA_COUNT
+} BrailleISA;
+
+typedef struct {
+    const char *name;
+
+    /* out[3i .. 3i+2] = UTF-8 of U+2800 + masks[i] for i in [0, count) */
+    void (*encode_utf8)(const uint8_t *masks, int count, char *out);
+
+    /* cells[i] = U+2800 + masks[i]; returns nonzero if any cell changed */
+    int (*expand_cells)(const uint8_t *masks, int count, wchar_t *cells);
+} BrailleEncoder;
+
+/* Fastest encoder supported by the running CPU */
+const BrailleEncoder* braille_encoder_select(void);
+
+/* Specific encoder, or NULL if not compiled in / not supported by this CPU */
+const BrailleEncoder* braille_encoder_get(BrailleISA isa);
+
+#endif /* BRAILLE_ENCODE_H */
@@ -0,0 +1,183 @@
+/*
+ * Pose Index Implementation
+ */
+
+#include <math.h>
+#include "pose_index.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* Facing as a signed fraction of a half turn, in [-1, 1) */
+static float wrap_facing(float facing) {
+    float t = facing / (float)M_PI;
+    return t - 2.0f * floorf((t + 1.0f) * 0.5f);
+}
+
+PoseFeatures pose_features_target(float energy, float bass, float treble,
+                                  float dip, float facing) {
+    PoseFeatures f = {{
+        energy * POSE_WEIGHT_ENERGY,
+        bass * POSE_WEIGHT_BASS,
+        treble * POSE_WEIGHT_TREBLE,
+        dip * POSE_WEIGHT_DIP,
+        wrap_facing(facing) * POSE_WEIGHT_FACING,
+    }};
+    return f;
+}
+
+PoseFeatures pose_features(const Pose *p) {
+    return pose_features_target((p->energy_min + p->energy_max) * 0.5f,
+                                p->bass_affinity, p->treble_affinity,
+                                p->dip_amount, p->facing);
+}
+
+/* ============ Build ============ */
+
+static float axis_value(const Pose *poses, uint32_t idx, int axis) {
+    return pose_features(&poses[idx]).v[axis];
+}
+
+static void swap_idx(uint32_t *a, uint32_t *b) {
+    uint32_t t = *a;
+    *a = *b;
+    *b = t;
+}
+
+/* Quickselect: slice[k] gets the k-th smallest value on axis, smaller or
+ * equal values before it and larger or equal after */
+static void select_kth(const Pose *poses, uint32_t *slice, int lo, int hi, int k, int axis) {
+    while (hi - lo > 1) {
+        /* Median of three as pivot */
+        int mid = lo + (hi - lo) / 2;
+        if (axis_value(poses, slice[mid], axis) < axis_value(poses, slice[lo], axis)) swap_idx(&slice[mid], &slice[lo]);
+        if (axis_value(poses, slice[hi - 1], axis) < axis_value(poses, slice[lo], axis)) swap_idx(&slice[hi - 1], &slice[lo]);
+        if (axis_value(poses, slice[hi - 1], axis) < axis_value(poses, slice[mid], axis)) swap_idx(&slice[hi - 1], &slice[mid]);
+        float pivot = axis_value(poses, slice[mid], axis);
+
+        /* Hoare partition */
+        int i = lo, j = hi - 1;
+        while (i <= j) {
+            while (axis_value(poses, slice[i], axis) < pivot) i++;
+            while (axis_value(poses, slice[j], axis) > pivot) j--;
+            if (i <= j) {
+                swap_idx(&slice[i], &slice[j]);
+                i++;
+                j--;
+            }
+        }
+        /* Now [lo, j] <= pivot, [i, hi) >= pivot, (j, i) == pivot */
+        if (k <= j) {
+            hi = j + 1;
+        } else if (k >= i) {
+            lo = i;
+        } else {
+            return;
+        }
+    }
+}
+
+static void build(const Pose *poses, uint32_t *slice, int lo, int hi, int depth) {
+    if (hi - lo <= 1) return;
+    int mid = lo + (hi - lo) / 2;
+    select_kth(poses, slice, lo, hi, mid, depth % POSE_FEATURES);
+    build(poses, slice, lo, mid, depth + 1);
+    build(poses, slice, mid + 1, hi, depth + 1);
+}
+
+void pose_index_build(const Pose *poses, int count, uint32_t *by_category,
+                      PoseFeatures *features, int *category_start) {
+    /* Counting sort by category */
+    for (int c = 0; c <= POSE_CAT_COUNT; c++) category_start[c] = 0;
+    for (int i = 0; i < count; i++) {
+        category_start[poses[i].category + 1]++;
+    }
+    for (int c = 0; c < POSE_CAT_COUNT; c++) {
+        category_start[c + 1] += category_start[c];
+    }
+    int fill[POSE_CAT_COUNT];
+    for (int c = 0; c < POSE_CAT_COUNT; c++) fill[c] = category_start[c];
+    for (int i = 0; i < count; i++) {
+        by_category[fill[poses[i].category]++] = (uint32_t)i;
+    }
+
+    for (int c = 0; c < POSE_CAT_COUNT; c++) {
+        build(poses, by_category, category_start[c], category_start[c + 1], 0);
+    }
+    for (int i = 0; i < count; i++) {
+        features[i] = pose_features(&poses[by_category[i]]);
+    }
+}
+
+/* ============ Query ============ */
+
+#define POSE_INDEX_LEAF 16
+
+typedef struct {
+    const uint32_t *slice;
+    const PoseFeatures *features;
+    PoseFeatures target;
+    PoseFilter filter;
+    void *user;
+    int best;
+    float best_d2;
+} Search;
+
+static void visit(Search *s, int pos) {
+    const PoseFeatures *f = &s->features[pos];
+    float d2 = 0.0f;
+    for (int k = 0; k < POSE_FEATURES; k++) {
+        float d = f->v[k] - s->target.v[k];
+        d2 += d * d;
+    }
+    if (d2 < s->best_d2) {
+        int idx = (int)s->slice[pos];
+        if (!s->filter || s->filter(idx, s->user)) {
+            s->best = idx;
+            s->best_d2 = d2;
+        }
+    }
+}
+
+static void search(Search *s, int lo, int hi, int depth) {
+    while (lo < hi) {
+        if (hi - lo <= POSE_INDEX_LEAF) {
+            /* Small subtrees are cheaper to scan than to descend */
+            for (int i = lo; i < hi; i++) visit(s, i);
+            return;
+        }
+        int mid = lo + (hi - lo) / 2;
+        visit(s, mid);
+
+        /* Near side first; the far side only if the split plane is closer
+         * than the best found there */
+        int axis = depth % POSE_FEATURES;
+        float diff = s->target.v[axis] - s->features[mid].v[axis];
+        depth++;
+        if (diff <= 0.0f) {
+            search(s, lo, mid, depth);
+            lo = mid + 1;
+        } else {
+            search(s, mid + 1, hi, depth);
+            hi = mid;
+        }
+        if (diff * diff >= s->best_d2) return;
+    }
+}
+
+int pose_index_nearest(const PoseLibrary *lib, PoseCategory cat,
+                       const PoseFeatures *target, PoseFilter filter, void *user) {
+    int start = lib->category_start[cat];
+    Search s = {
+        .slice = lib->by_category + start,
+        .features = lib->features + start,
+        .target = *target,
+        .filter = filter,
+        .user = user,
+        .best = -1,
+        .best_d2 = INFINITY,
+    };
+    search(&s, 0, pose_library_count(lib, cat), 0);
+    return s.best;
+}
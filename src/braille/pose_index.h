@@ -0,0 +1,59 @@
+/*
+ * Pose Index - ASCII Dancer v3.2+
+ *
+ * Nearest-neighbour pose selection. Every pose maps to a weighted feature
+ * vector (energy, bass and treble affinity, dip, facing), and each category's
+ * slice of PoseLibrary.by_category is laid out as an implicit k-d tree over
+ * those vectors, so picking a pose is one query rather than random draws.
+ * The layout and the vectors (PoseLibrary.features, in the same order) are
+ * computed once, by pose_gen and posepack, and ship with the library; loading
+ * needs no build step, and a query reads a 20-byte vector per visited node
+ * rather than whole Pose records.
+ *
+ * Implicit tree over a slice [lo, hi): the node sits at mid = lo + (hi - lo) / 2
+ * and splits on axis depth % POSE_FEATURES; [lo, mid) holds values <= the
+ * node's on that axis and (mid, hi) values >= it.
+ */
+
+#ifndef POSE_INDEX_H
+#define POSE_INDEX_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "skeleton_dancer.h"
+
+#define POSE_FEATURES 5
+
+/* Axis weights: distances compare these scaled values */
+#define POSE_WEIGHT_ENERGY  1.0f
+#define POSE_WEIGHT_BASS    0.5f
+#define POSE_WEIGHT_TREBLE  0.5f
+#define POSE_WEIGHT_DIP     0.5f
+#define POSE_WEIGHT_FACING  0.25f   /* Per half turn */
+
+typedef struct PoseFeatures {
+    float v[POSE_FEATURES];
+} PoseFeatures;
+
+/* Return false to skip a pose (e.g. one danced recently) */
+typedef bool (*PoseFilter)(int pose_idx, void *user);
+
+/* Feature vector of a pose: energy at the middle of its range */
+PoseFeatures pose_features(const Pose *pose);
+
+/* Feature vector to search for */
+PoseFeatures pose_features_target(float energy, float bass, float treble,
+                                  float dip, float facing);
+
+/* Fill a library's category index for poses[0 .. count): by_category gets
+ * count entries grouped by category, each group in k-d tree layout, features
+ * the matching count vectors and category_start the POSE_CAT_COUNT + 1 group
+ * offsets */
+void pose_index_build(const Pose *poses, int count, uint32_t *by_category,
+                      PoseFeatures *features, int *category_start);
+
+/* Nearest pose of a category accepted by filter (NULL accepts all), or -1 */
+int pose_index_nearest(const PoseLibrary *lib, PoseCategory cat,
+                       const PoseFeatures *target, PoseFilter filter, void *user);
+
+#endif /* POSE_INDEX_H */
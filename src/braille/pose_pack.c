@@ -0,0 +1,205 @@
+/*
+ * Pose Packs Implementation
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "pose_pack.h"
+#include "pose_index.h"
+
+/* Records are the in-memory Pose (pose_size in the header catches layout
+ * changes); these keep every section naturally aligned in the mapping */
+_Static_assert(sizeof(PosePackHeader) % 8 == 0, "header keeps poses 8-byte aligned");
+_Static_assert(sizeof(Pose) % 8 == 0, "poses keep the index aligned");
+
+static const char *category_names[POSE_CAT_COUNT] = {
+    [POSE_CAT_IDLE]          = "idle",
+    [POSE_CAT_CALM]          = "calm",
+    [POSE_CAT_GROOVE]        = "groove",
+    [POSE_CAT_ENERGETIC]     = "energetic",
+    [POSE_CAT_INTENSE]       = "intense",
+    [POSE_CAT_BASS_HIT]      = "bass_hit",
+    [POSE_CAT_TREBLE_ACCENT] = "treble_accent",
+    [POSE_CAT_SPIN]          = "spin",
+    [POSE_CAT_DIP]           = "dip",
+    [POSE_CAT_MOONWALK]      = "moonwalk",
+    [POSE_CAT_BALLET]        = "ballet",
+    [POSE_CAT_BREAKDANCE]    = "breakdance",
+    [POSE_CAT_WALTZ]         = "waltz",
+    [POSE_CAT_ROBOT]         = "robot",
+    [POSE_CAT_HEADBANG]      = "headbang",
+};
+
+const char* pose_category_name(PoseCategory cat) {
+    if ((unsigned)cat >= POSE_CAT_COUNT) return "unknown";
+    return category_names[cat];
+}
+
+int pose_category_from_name(const char *name) {
+    for (int c = 0; c < POSE_CAT_COUNT; c++) {
+        if (strcmp(name, category_names[c]) == 0) return c;
+    }
+    return -1;
+}
+
+/* ============ Loading ============ */
+
+/* Structure checks only: O(1) for the header, 4 bytes per pose for the index */
+static const char* validate(const PosePackHeader *h, size_t size) {
+    if (size < sizeof(*h) || memcmp(h->magic, POSE_PACK_MAGIC, sizeof(h->magic)) != 0) {
+        return "not a pose pack";
+    }
+    if (h->version != POSE_PACK_VERSION) return "unsupported pose pack version";
+    if (h->header_size != sizeof(*h) || h->pose_size != sizeof(Pose) ||
+        h->num_categories != POSE_CAT_COUNT) {
+        return "pose pack built for a different pose layout";
+    }
+    if (h->file_size != size) return "truncated pose pack";
+    if (h->num_poses == 0) return "pose pack is empty";
+
+    uint64_t n = h->num_poses;
+    if (h->poses_offset % 8 != 0 || h->poses_offset > size ||
+        n > (size - h->poses_offset) / sizeof(Pose)) {
+        return "pose records out of bounds";
+    }
+    if (h->index_offset % 4 != 0 || h->index_offset > size ||
+        n > (size - h->index_offset) / sizeof(uint32_t)) {
+        return "category index out of bounds";
+    }
+    if (h->features_offset % 4 != 0 || h->features_offset > size ||
+        n > (size - h->features_offset) / sizeof(PoseFeatures)) {
+        return "pose features out of bounds";
+    }
+
+    if (h->category_start[0] != 0 || h->category_start[POSE_CAT_COUNT] != n) {
+        return "bad category index";
+    }
+    for (int c = 0; c < POSE_CAT_COUNT; c++) {
+        if (h->category_start[c] > h->category_start[c + 1]) return "bad category index";
+    }
+
+    const uint32_t *index = (const uint32_t *)((const char *)h + h->index_offset);
+    for (uint64_t i = 0; i < n; i++) {
+        if (index[i] >= n) return "bad category index";
+    }
+    return NULL;
+}
+
+PosePack* pose_pack_open(const char *path, const char **error) {
+    const char *err = NULL;
+    void *map = MAP_FAILED;
+    size_t size = 0;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        err = "cannot open pose pack";
+        goto fail;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        err = "cannot read pose pack";
+        goto fail;
+    }
+    size = (size_t)st.st_size;
+
+    map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED) {
+        err = "cannot map pose pack";
+        goto fail;
+    }
+    close(fd);
+    fd = -1;
+
+    const PosePackHeader *h = map;
+    err = validate(h, size);
+    if (err) goto fail;
+
+    /* Pose selection jumps around the file; skip readahead */
+    madvise(map, size, MADV_RANDOM);
+
+    PosePack *pack = calloc(1, sizeof(PosePack));
+    if (!pack) {
+        err = "out of memory";
+        goto fail;
+    }
+    pack->map = map;
+    pack->map_size = size;
+    pack->library.poses = (const Pose *)((const char *)map + h->poses_offset);
+    pack->library.num_poses = (int)h->num_poses;
+    pack->library.by_category = (const uint32_t *)((const char *)map + h->index_offset);
+    pack->library.features = (const PoseFeatures *)((const char *)map + h->features_offset);
+    memcpy(pack->library.category_start, h->category_start,
+           sizeof(pack->library.category_start));
+    return pack;
+
+fail:
+    if (map != MAP_FAILED) munmap(map, size);
+    if (fd >= 0) close(fd);
+    if (error) *error = err;
+    return NULL;
+}
+
+void pose_pack_close(PosePack *pack) {
+    if (!pack) return;
+    munmap(pack->map, pack->map_size);
+    free(pack);
+}
+
+/* ============ Writing ============ */
+
+int pose_pack_write(const PoseLibrary *lib, const char *path) {
+    if (!lib || lib->num_poses < 1) return -1;
+
+    uint64_t n = (uint64_t)lib->num_poses;
+    PosePackHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, POSE_PACK_MAGIC, sizeof(h.magic));
+    h.version = POSE_PACK_VERSION;
+    h.header_size = sizeof(h);
+    h.pose_size = sizeof(Pose);
+    h.num_categories = POSE_CAT_COUNT;
+    h.num_poses = (uint32_t)n;
+    h.poses_offset = sizeof(h);
+    h.index_offset = h.poses_offset + n * sizeof(Pose);
+    h.features_offset = h.index_offset + n * sizeof(uint32_t);
+    h.file_size = h.features_offset + n * sizeof(PoseFeatures);
+    for (int c = 0; c <= POSE_CAT_COUNT; c++) {
+        h.category_start[c] = (uint32_t)lib->category_start[c];
+    }
+
+    FILE *f = fopen(path, "wb");
+    if (!f) return -1;
+
+    /* Names are NUL-padded so the same poses always give the same bytes */
+    int ok = fwrite(&h, sizeof(h), 1, f) == 1;
+    for (uint64_t i = 0; ok && i < n; i++) {
+        Pose p = lib->poses[i];
+        const char *name = lib->poses[i].name;
+        memset(p.name, 0, sizeof(p.name));
+        memcpy(p.name, name, strnlen(name, sizeof(p.name) - 1));
+        ok = fwrite(&p, sizeof(p), 1, f) == 1;
+    }
+    if (ok) ok = fwrite(lib->by_category, sizeof(uint32_t), n, f) == n;
+    if (ok) ok = fwrite(lib->features, sizeof(PoseFeatures), n, f) == n;
+
+    if (fclose(f) != 0) ok = 0;
+    return ok ? 0 : -1;
+}
+
+void pose_pack_print_pose(FILE *f, const Pose *pose) {
+    fprintf(f, "pose %.*s %s %.9g %.9g %.9g %.9g %.9g %.9g\n",
+            (int)sizeof(pose->name), pose->name, pose_category_name(pose->category),
+            pose->energy_min, pose->energy_max,
+            pose->bass_affinity, pose->treble_affinity,
+            pose->facing, pose->dip_amount);
+    for (int j = 0; j < JOINT_COUNT; j++) {
+        fprintf(f, j % 5 == 0 ? "   " : "  ");
+        fprintf(f, " %.9g %.9g", pose->joints[j].x, pose->joints[j].y);
+        if (j % 5 == 4) fputc('\n', f);
+    }
+}
@@ -0,0 +1,76 @@
+/*
+ * Pose Packs - ASCII Dancer v3.2+
+ *
+ * Versioned binary pose libraries that load with mmap and no parsing. The
+ * file holds a header, the Pose records exactly as the dancer reads them and
+ * the category index, so the PoseLibrary points straight into the mapping
+ * and only the pages of poses the dancer actually dances are read in.
+ *
+ * Layout (host byte order; offsets from the start of the file):
+ *   PosePackHeader
+ *   Pose      poses[num_poses]          at poses_offset (8-byte aligned)
+ *   uint32_t  by_category[num_poses]    at index_offset (4-byte aligned),
+ *             each category's slice in k-d tree layout (pose_index.h)
+ *   PoseFeatures features[num_poses]    at features_offset (4-byte aligned),
+ *             in by_category order
+ *
+ * Packs are compiled from text with the posepack tool (src/tools/posepack.c).
+ * Pose values are not re-checked at load: posepack rejects non-finite
+ * values, and a pack is trusted like the config file.
+ */
+
+#ifndef POSE_PACK_H
+#define POSE_PACK_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "skeleton_dancer.h"
+
+#define POSE_PACK_MAGIC   "BBPOSES"   /* 8 bytes with the terminator */
+#define POSE_PACK_VERSION 2           /* Bump when Pose or the layout changes */
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;       /* sizeof(PosePackHeader) */
+    uint32_t pose_size;         /* sizeof(Pose) */
+    uint32_t num_categories;    /* POSE_CAT_COUNT */
+    uint32_t num_poses;
+    uint32_t reserved;
+    uint64_t poses_offset;
+    uint64_t index_offset;
+    uint64_t features_offset;
+    uint64_t file_size;
+    uint32_t category_start[POSE_CAT_COUNT + 1];
+} PosePackHeader;
+
+typedef struct {
+    PoseLibrary library;        /* Views into the mapping */
+    void *map;
+    size_t map_size;
+} PosePack;
+
+/* ============ Loading ============ */
+
+/* Map a pack read-only. Returns NULL and sets *error (static text) on failure. */
+PosePack* pose_pack_open(const char *path, const char **error);
+void pose_pack_close(PosePack *pack);
+
+/* ============ Writing ============ */
+
+/* Write lib as a pack. Returns 0 on success, -1 on error. */
+int pose_pack_write(const PoseLibrary *lib, const char *path);
+
+/* One pose in posepack text form (see src/tools/posepack.c) */
+void pose_pack_print_pose(FILE *f, const Pose *pose);
+
+/* ============ Categories ============ */
+
+/* Lowercase name used in pose text ("groove", "bass_hit", ...) */
+const char* pose_category_name(PoseCategory cat);
+
+/* Category for a name, or -1 if unknown */
+int pose_category_from_name(const char *name);
+
+#endif /* POSE_PACK_H */
@@ -1,6 +1,9 @@
 /*
  * Advanced Skeleton Dancer Implementation
  * Rich audio-reactive animation with 30+ poses
+ *
+ * Poses come from a read-only PoseLibrary; the built-in one is authored in
+ * src/tools/pose_gen.c and compiled into pose_table.c at build time.
  */
 
 #include <stdio.h>
@@ -8,6 +11,7 @@
 #include <string.h>
 #include <math.h>
 #include "skeleton_dancer.h"
+#include "pose_index.h"
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -63,10 +67,6 @@ static float random_float(SkeletonDancer *d) {
     return (float)((d->random_state >> 16) & 0x7FFF) / 32767.0f;
 }
 
-static int random_int(SkeletonDancer *d, int max) {
-    return (int)(random_float(d) * max);
-}
-
 /* ============ Joint Interpolation ============ */
 
 static Joint joint_lerp(Joint a, Joint b, float t) {
@@ -100,1847 +100,6 @@ static void setup_humanoid_skeleton(SkeletonDef *skel) {
     skel->head_radius = 4;
 }
 
-/* ============ Pose Generation ============ */
-
-#define DEG2RAD(d) ((d) * M_PI / 180.0f)
-
-static Pose make_pose(const char *name, PoseCategory cat,
-                      float head_x, float head_y,
-                      float shoulder_angle, float lean,
-                      float l_arm_upper, float l_arm_lower,
-                      float r_arm_upper, float r_arm_lower,
-                      float l_leg_upper, float l_leg_lower,
-                      float r_leg_upper, float r_leg_lower,
-                      float energy_min, float energy_max,
-                      float bass_aff, float treble_aff) {
-    Pose pose = {0};
-    strncpy(pose.name, name, sizeof(pose.name) - 1);
-    pose.category = cat;
-    pose.energy_min = energy_min;
-    pose.energy_max = energy_max;
-    pose.bass_affinity = bass_aff;
-    pose.treble_affinity = treble_aff;
-    pose.num_joints = JOINT_COUNT;
-    pose.facing = 0.0f;      /* Default: facing forward */
-    pose.dip_amount = 0.0f;  /* Default: no dip */
-    
-    float lean_rad = DEG2RAD(lean);
-    float shoulder_rad = DEG2RAD(shoulder_angle);
-    
-    /* Body dimensions - adjusted for better human proportions (v2.4 polish)
-     * Head is smaller relative to body, legs are longer for better silhouette
-     */
-    float head_size = 0.06f;       /* Was 0.08f - smaller head */
-    float neck_len = 0.04f;        /* Was 0.05f - shorter neck */
-    float shoulder_width = 0.14f;  /* Was 0.15f - slightly narrower */
-    float upper_arm = 0.10f;       /* Was 0.12f - shorter arms */
-    float lower_arm = 0.09f;       /* Was 0.10f */
-    float spine_len = 0.16f;       /* Was 0.20f - shorter torso */
-    float hip_width = 0.08f;       /* Was 0.10f - narrower hips */
-    float upper_leg = 0.18f;       /* Was 0.15f - LONGER legs */
-    float lower_leg = 0.16f;       /* Was 0.13f - LONGER lower legs */
-    
-    pose.joints[JOINT_HEAD].x = head_x;
-    pose.joints[JOINT_HEAD].y = head_y;
-    
-    pose.joints[JOINT_NECK].x = head_x + sinf(lean_rad) * neck_len;
-    pose.joints[JOINT_NECK].y = head_y + head_size + neck_len;
-    
-    float neck_x = pose.joints[JOINT_NECK].x;
-    float neck_y = pose.joints[JOINT_NECK].y;
-    
-    float sh_offset_x = cosf(lean_rad + shoulder_rad) * shoulder_width;
-    float sh_offset_y = sinf(lean_rad + shoulder_rad) * shoulder_width;
-    
-    pose.joints[JOINT_SHOULDER_L].x = neck_x - sh_offset_x;
-    pose.joints[JOINT_SHOULDER_L].y = neck_y + sh_offset_y * 0.3f;
-    pose.joints[JOINT_SHOULDER_R].x = neck_x + sh_offset_x;
-    pose.joints[JOINT_SHOULDER_R].y = neck_y - sh_offset_y * 0.3f;
-    
-    /* Arms */
-    float l_up = DEG2RAD(l_arm_upper);
-    pose.joints[JOINT_ELBOW_L].x = pose.joints[JOINT_SHOULDER_L].x + sinf(l_up) * upper_arm;
-    pose.joints[JOINT_ELBOW_L].y = pose.joints[JOINT_SHOULDER_L].y + cosf(l_up) * upper_arm;
-    float l_lo = DEG2RAD(l_arm_lower);
-    pose.joints[JOINT_HAND_L].x = pose.joints[JOINT_ELBOW_L].x + sinf(l_lo) * lower_arm;
-    pose.joints[JOINT_HAND_L].y = pose.joints[JOINT_ELBOW_L].y + cosf(l_lo) * lower_arm;
-    
-    float r_up = DEG2RAD(r_arm_upper);
-    pose.joints[JOINT_ELBOW_R].x = pose.joints[JOINT_SHOULDER_R].x + sinf(r_up) * upper_arm;
-    pose.joints[JOINT_ELBOW_R].y = pose.joints[JOINT_SHOULDER_R].y + cosf(r_up) * upper_arm;
-    float r_lo = DEG2RAD(r_arm_lower);
-    pose.joints[JOINT_HAND_R].x = pose.joints[JOINT_ELBOW_R].x + sinf(r_lo) * lower_arm;
-    pose.joints[JOINT_HAND_R].y = pose.joints[JOINT_ELBOW_R].y + cosf(r_lo) * lower_arm;
-    
-    /* Hips */
-    pose.joints[JOINT_HIP_CENTER].x = neck_x + sinf(lean_rad) * spine_len;
-    pose.joints[JOINT_HIP_CENTER].y = neck_y + cosf(lean_rad) * spine_len;
-    float hip_x = pose.joints[JOINT_HIP_CENTER].x;
-    float hip_y = pose.joints[JOINT_HIP_CENTER].y;
-    
-    pose.joints[JOINT_HIP_L].x = hip_x - hip_width;
-    pose.joints[JOINT_HIP_L].y = hip_y;
-    pose.joints[JOINT_HIP_R].x = hip_x + hip_width;
-    pose.joints[JOINT_HIP_R].y = hip_y;
-    
-    /* Legs */
-    float ll_up = DEG2RAD(l_leg_upper);
-    pose.joints[JOINT_KNEE_L].x = pose.joints[JOINT_HIP_L].x + sinf(ll_up) * upper_leg;
-    pose.joints[JOINT_KNEE_L].y = pose.joints[JOINT_HIP_L].y + cosf(ll_up) * upper_leg;
-    float ll_lo = DEG2RAD(l_leg_lower);
-    pose.joints[JOINT_FOOT_L].x = pose.joints[JOINT_KNEE_L].x + sinf(ll_lo) * lower_leg;
-    pose.joints[JOINT_FOOT_L].y = pose.joints[JOINT_KNEE_L].y + cosf(ll_lo) * lower_leg;
-    
-    float rl_up = DEG2RAD(r_leg_upper);
-    pose.joints[JOINT_KNEE_R].x = pose.joints[JOINT_HIP_R].x + sinf(rl_up) * upper_leg;
-    pose.joints[JOINT_KNEE_R].y = pose.joints[JOINT_HIP_R].y + cosf(rl_up) * upper_leg;
-    float rl_lo = DEG2RAD(r_leg_lower);
-    pose.joints[JOINT_FOOT_R].x = pose.joints[JOINT_KNEE_R].x + sinf(rl_lo) * lower_leg;
-    pose.joints[JOINT_FOOT_R].y = pose.joints[JOINT_KNEE_R].y + cosf(rl_lo) * lower_leg;
-    
-    return pose;
-}
-
-static void add_pose(SkeletonDancer *d, Pose pose) {
-    if (d->num_poses >= MAX_POSES) return;
-    int idx = d->num_poses++;
-    d->poses[idx] = pose;
-    
-    /* Add to category index */
-    int cat = pose.category;
-    if (d->category_counts[cat] < MAX_POSES) {
-        d->poses_by_category[cat][d->category_counts[cat]++] = idx;
-    }
-}
-
-/* Forward declaration for procedural pose generation */
-static void generate_pose_variations(SkeletonDancer *d);
-
-static void add_all_poses(SkeletonDancer *d) {
-    /* ========== IDLE POSES (very low energy) ========== */
-    add_pose(d, make_pose("idle_stand", POSE_CAT_IDLE,
-        0.5f, 0.1f, 0, 0,
-        10, 5, -10, -5,     /* arms relaxed down */
-        3, 0, -3, 0,        /* legs neutral */
-        0.0f, 0.15f, 0.3f, 0.3f));
-    
-    add_pose(d, make_pose("idle_breathe", POSE_CAT_IDLE,
-        0.5f, 0.11f, 0, 0,
-        12, 8, -12, -8,
-        2, 0, -2, 0,
-        0.0f, 0.15f, 0.3f, 0.3f));
-    
-    add_pose(d, make_pose("idle_shift_l", POSE_CAT_IDLE,
-        0.48f, 0.1f, -3, -5,
-        15, 10, -8, -3,
-        -5, 5, 8, -5,
-        0.0f, 0.15f, 0.3f, 0.3f));
-    
-    add_pose(d, make_pose("idle_shift_r", POSE_CAT_IDLE,
-        0.52f, 0.1f, 3, 5,
-        8, 3, -15, -10,
-        8, -5, -5, 5,
-        0.0f, 0.15f, 0.3f, 0.3f));
-    
-    /* ========== CALM POSES (gentle swaying) ========== */
-    add_pose(d, make_pose("calm_sway_l", POSE_CAT_CALM,
-        0.47f, 0.1f, -5, -8,
-        20, 15, -5, 0,
-        -8, 8, 12, -8,
-        0.1f, 0.3f, 0.4f, 0.4f));
-    
-    add_pose(d, make_pose("calm_sway_r", POSE_CAT_CALM,
-        0.53f, 0.1f, 5, 8,
-        5, 0, -20, -15,
-        12, -8, -8, 8,
-        0.1f, 0.3f, 0.4f, 0.4f));
-    
-    add_pose(d, make_pose("calm_nod", POSE_CAT_CALM,
-        0.5f, 0.12f, 0, 3,
-        15, 10, -15, -10,
-        5, 0, -5, 0,
-        0.1f, 0.3f, 0.5f, 0.3f));
-    
-    add_pose(d, make_pose("calm_arms_soft", POSE_CAT_CALM,
-        0.5f, 0.1f, 0, 0,
-        -20, 30, 20, -30,
-        3, 0, -3, 0,
-        0.1f, 0.3f, 0.3f, 0.5f));
-    
-    add_pose(d, make_pose("calm_lean_back", POSE_CAT_CALM,
-        0.5f, 0.09f, 0, -5,
-        25, 20, -25, -20,
-        -5, 10, 5, -10,
-        0.1f, 0.3f, 0.4f, 0.4f));
-    
-    /* ========== GROOVE POSES (medium energy, rhythmic) ========== */
-    add_pose(d, make_pose("groove_bounce", POSE_CAT_GROOVE,
-        0.5f, 0.08f, 0, 0,
-        -30, 45, 30, -45,
-        10, -15, -10, 15,
-        0.25f, 0.55f, 0.6f, 0.4f));
-    
-    add_pose(d, make_pose("groove_step_l", POSE_CAT_GROOVE,
-        0.45f, 0.1f, -8, -12,
-        -45, 60, 20, -10,
-        -25, 40, 15, -10,
-        0.25f, 0.55f, 0.7f, 0.3f));
-    
-    add_pose(d, make_pose("groove_step_r", POSE_CAT_GROOVE,
-        0.55f, 0.1f, 8, 12,
-        -20, 10, 45, -60,
-        15, -10, -25, 40,
-        0.25f, 0.55f, 0.7f, 0.3f));
-    
-    add_pose(d, make_pose("groove_arms_out", POSE_CAT_GROOVE,
-        0.5f, 0.1f, 0, 0,
-        -60, 30, 60, -30,
-        8, -5, -8, 5,
-        0.25f, 0.55f, 0.4f, 0.7f));
-    
-    add_pose(d, make_pose("groove_hip_l", POSE_CAT_GROOVE,
-        0.48f, 0.1f, 10, -15,
-        -40, 50, 15, 0,
-        -20, 30, 25, -20,
-        0.25f, 0.55f, 0.8f, 0.3f));
-    
-    add_pose(d, make_pose("groove_hip_r", POSE_CAT_GROOVE,
-        0.52f, 0.1f, -10, 15,
-        -15, 0, 40, -50,
-        25, -20, -20, 30,
-        0.25f, 0.55f, 0.8f, 0.3f));
-    
-    add_pose(d, make_pose("groove_clap_up", POSE_CAT_GROOVE,
-        0.5f, 0.09f, 0, 0,
-        -80, -60, 80, 60,
-        5, 0, -5, 0,
-        0.25f, 0.55f, 0.3f, 0.9f));
-    
-    add_pose(d, make_pose("groove_clap_down", POSE_CAT_GROOVE,
-        0.5f, 0.11f, 0, 2,
-        -30, 70, 30, -70,
-        5, 0, -5, 0,
-        0.25f, 0.55f, 0.3f, 0.8f));
-    
-    /* ========== ENERGETIC POSES (high energy) ========== */
-    add_pose(d, make_pose("energy_arms_up", POSE_CAT_ENERGETIC,
-        0.5f, 0.07f, 0, 0,
-        -90, -45, 90, 45,
-        15, -20, -15, 20,
-        0.5f, 0.8f, 0.5f, 0.8f));
-    
-    add_pose(d, make_pose("energy_pump_l", POSE_CAT_ENERGETIC,
-        0.48f, 0.08f, -5, -8,
-        -120, -90, 30, 0,
-        -15, 25, 20, -15,
-        0.5f, 0.8f, 0.7f, 0.6f));
-    
-    add_pose(d, make_pose("energy_pump_r", POSE_CAT_ENERGETIC,
-        0.52f, 0.08f, 5, 8,
-        -30, 0, 120, 90,
-        20, -15, -15, 25,
-        0.5f, 0.8f, 0.7f, 0.6f));
-    
-    add_pose(d, make_pose("energy_wide", POSE_CAT_ENERGETIC,
-        0.5f, 0.09f, 0, 0,
-        -75, 20, 75, -20,
-        25, -10, -25, 10,
-        0.5f, 0.8f, 0.6f, 0.7f));
-    
-    add_pose(d, make_pose("energy_lean_l", POSE_CAT_ENERGETIC,
-        0.42f, 0.12f, -15, -20,
-        -60, 45, 45, -30,
-        -35, 50, 30, -25,
-        0.5f, 0.8f, 0.8f, 0.4f));
-    
-    add_pose(d, make_pose("energy_lean_r", POSE_CAT_ENERGETIC,
-        0.58f, 0.12f, 15, 20,
-        -45, 30, 60, -45,
-        30, -25, -35, 50,
-        0.5f, 0.8f, 0.8f, 0.4f));
-    
-    add_pose(d, make_pose("energy_twist", POSE_CAT_ENERGETIC,
-        0.5f, 0.1f, 20, 10,
-        -90, 30, 45, -60,
-        20, -10, -30, 40,
-        0.5f, 0.8f, 0.7f, 0.5f));
-    
-    /* ========== INTENSE POSES (very high energy, jumps) ========== */
-    add_pose(d, make_pose("intense_jump", POSE_CAT_INTENSE,
-        0.5f, 0.02f, 0, 0,
-        -100, -60, 100, 60,
-        35, -70, -35, 70,
-        0.75f, 1.0f, 0.6f, 0.7f));
-    
-    add_pose(d, make_pose("intense_star", POSE_CAT_INTENSE,
-        0.5f, 0.03f, 0, 0,
-        -120, -30, 120, 30,
-        45, -20, -45, 20,
-        0.75f, 1.0f, 0.5f, 0.8f));
-    
-    add_pose(d, make_pose("intense_crouch", POSE_CAT_INTENSE,
-        0.5f, 0.2f, 0, 5,
-        -30, 60, 30, -60,
-        45, -90, -45, 90,
-        0.75f, 1.0f, 0.9f, 0.3f));
-    
-    add_pose(d, make_pose("intense_kick_l", POSE_CAT_INTENSE,
-        0.55f, 0.1f, 10, 15,
-        -60, 30, 75, -45,
-        -60, 80, 10, -5,
-        0.75f, 1.0f, 0.8f, 0.5f));
-    
-    add_pose(d, make_pose("intense_kick_r", POSE_CAT_INTENSE,
-        0.45f, 0.1f, -10, -15,
-        -75, 45, 60, -30,
-        10, -5, -60, 80,
-        0.75f, 1.0f, 0.8f, 0.5f));
-    
-    add_pose(d, make_pose("intense_spin", POSE_CAT_INTENSE,
-        0.5f, 0.08f, 30, 25,
-        -100, 20, 80, -70,
-        40, -30, -20, 35,
-        0.75f, 1.0f, 0.6f, 0.6f));
-    
-    /* ========== BASS HIT POSES (reactive to bass) ========== */
-    add_pose(d, make_pose("bass_drop", POSE_CAT_BASS_HIT,
-        0.5f, 0.15f, 0, 8,
-        -20, 50, 20, -50,
-        30, -50, -30, 50,
-        0.3f, 1.0f, 1.0f, 0.2f));
-    
-    add_pose(d, make_pose("bass_stomp_l", POSE_CAT_BASS_HIT,
-        0.48f, 0.12f, -5, -10,
-        -40, 55, 25, -20,
-        -40, 60, 20, -15,
-        0.3f, 1.0f, 1.0f, 0.2f));
-    
-    add_pose(d, make_pose("bass_stomp_r", POSE_CAT_BASS_HIT,
-        0.52f, 0.12f, 5, 10,
-        -25, 20, 40, -55,
-        20, -15, -40, 60,
-        0.3f, 1.0f, 1.0f, 0.2f));
-    
-    add_pose(d, make_pose("bass_pulse", POSE_CAT_BASS_HIT,
-        0.5f, 0.13f, 0, 5,
-        -50, 40, 50, -40,
-        20, -25, -20, 25,
-        0.3f, 1.0f, 0.9f, 0.3f));
-    
-    /* ========== TREBLE ACCENT POSES (reactive to hi-hats, etc) ========== */
-    add_pose(d, make_pose("treble_flick_l", POSE_CAT_TREBLE_ACCENT,
-        0.5f, 0.1f, -3, -5,
-        -100, -80, 15, 0,
-        5, 0, -5, 0,
-        0.2f, 1.0f, 0.2f, 1.0f));
-    
-    add_pose(d, make_pose("treble_flick_r", POSE_CAT_TREBLE_ACCENT,
-        0.5f, 0.1f, 3, 5,
-        -15, 0, 100, 80,
-        5, 0, -5, 0,
-        0.2f, 1.0f, 0.2f, 1.0f));
-    
-    add_pose(d, make_pose("treble_snap", POSE_CAT_TREBLE_ACCENT,
-        0.5f, 0.09f, 0, 0,
-        -85, -70, 85, 70,
-        8, -3, -8, 3,
-        0.2f, 1.0f, 0.3f, 0.9f));
-    
-    add_pose(d, make_pose("treble_wave", POSE_CAT_TREBLE_ACCENT,
-        0.5f, 0.1f, 5, 3,
-        -70, 50, -50, 80,
-        5, 0, -5, 0,
-        0.2f, 1.0f, 0.2f, 1.0f));
-    
-    /* ========== ADDITIONAL BASS HITS ========== */
-    add_pose(d, make_pose("bass_slam", POSE_CAT_BASS_HIT,
-        0.5f, 0.16f, 0, 12,
-        -15, 45, 15, -45,
-        35, -55, -35, 55,
-        0.4f, 1.0f, 1.0f, 0.1f));
-    
-    add_pose(d, make_pose("bass_bounce_l", POSE_CAT_BASS_HIT,
-        0.45f, 0.14f, -8, 6,
-        -35, 50, 20, -30,
-        -30, 50, 25, -20,
-        0.35f, 1.0f, 0.95f, 0.2f));
-    
-    add_pose(d, make_pose("bass_bounce_r", POSE_CAT_BASS_HIT,
-        0.55f, 0.14f, 8, 6,
-        -20, 30, 35, -50,
-        25, -20, -30, 50,
-        0.35f, 1.0f, 0.95f, 0.2f));
-    
-    add_pose(d, make_pose("bass_chest_pop", POSE_CAT_BASS_HIT,
-        0.5f, 0.11f, 0, -3,
-        -40, 35, 40, -35,
-        15, -10, -15, 10,
-        0.4f, 1.0f, 0.9f, 0.3f));
-    
-    /* ========== ADDITIONAL TREBLE ACCENTS ========== */
-    add_pose(d, make_pose("treble_double_flick", POSE_CAT_TREBLE_ACCENT,
-        0.5f, 0.08f, 0, 0,
-        -95, -75, 95, 75,
-        6, -2, -6, 2,
-        0.25f, 1.0f, 0.2f, 1.0f));
-    
-    add_pose(d, make_pose("treble_shimmy", POSE_CAT_TREBLE_ACCENT,
-        0.5f, 0.1f, 10, 0,
-        -60, 40, 70, -50,
-        8, -5, -8, 5,
-        0.2f, 1.0f, 0.25f, 0.95f));
-    
-    add_pose(d, make_pose("treble_pop", POSE_CAT_TREBLE_ACCENT,
-        0.5f, 0.09f, -5, -3,
-        -80, -50, 60, 30,
-        10, -5, -10, 5,
-        0.2f, 1.0f, 0.3f, 0.9f));
-    
-    /* ========== HIP HOP MOVES ========== */
-    add_pose(d, make_pose("hiphop_step", POSE_CAT_GROOVE,
-        0.48f, 0.1f, -6, 5,
-        -45, 55, 30, -25,
-        -25, 40, 20, -15,
-        0.3f, 0.6f, 0.7f, 0.4f));
-    
-    add_pose(d, make_pose("hiphop_bounce", POSE_CAT_GROOVE,
-        0.5f, 0.12f, 0, 8,
-        -35, 50, 35, -50,
-        20, -30, -20, 30,
-        0.3f, 0.6f, 0.75f, 0.35f));
-    
-    add_pose(d, make_pose("hiphop_lean", POSE_CAT_GROOVE,
-        0.53f, 0.1f, 10, 12,
-        -50, 40, 25, -15,
-        15, -10, -25, 35,
-        0.3f, 0.6f, 0.65f, 0.4f));
-    
-    add_pose(d, make_pose("hiphop_rock", POSE_CAT_GROOVE,
-        0.47f, 0.11f, -10, 8,
-        -30, 45, 50, -40,
-        -20, 35, 30, -25,
-        0.3f, 0.6f, 0.7f, 0.35f));
-    
-    /* ========== POPPING MOVES ========== */
-    add_pose(d, make_pose("pop_arm_l", POSE_CAT_ENERGETIC,
-        0.5f, 0.09f, -3, 0,
-        -90, 0, 40, -30,
-        8, -3, -8, 3,
-        0.45f, 0.8f, 0.5f, 0.7f));
-    
-    add_pose(d, make_pose("pop_arm_r", POSE_CAT_ENERGETIC,
-        0.5f, 0.09f, 3, 0,
-        -40, 30, 90, 0,
-        -8, 3, 8, -3,
-        0.45f, 0.8f, 0.5f, 0.7f));
-    
-    add_pose(d, make_pose("pop_chest", POSE_CAT_ENERGETIC,
-        0.5f, 0.08f, 0, -5,
-        -50, 35, 50, -35,
-        10, -5, -10, 5,
-        0.5f, 0.85f, 0.6f, 0.6f));
-    
-    add_pose(d, make_pose("pop_neck", POSE_CAT_ENERGETIC,
-        0.52f, 0.1f, 8, 0,
-        -35, 40, 45, -35,
-        5, 0, -5, 0,
-        0.45f, 0.8f, 0.4f, 0.7f));
-    
-    /* ========== LOCKING MOVES ========== */
-    add_pose(d, make_pose("lock_point_l", POSE_CAT_ENERGETIC,
-        0.5f, 0.09f, -5, -3,
-        -130, -100, 25, 10,
-        10, -5, -5, 0,
-        0.5f, 0.85f, 0.4f, 0.8f));
-    
-    add_pose(d, make_pose("lock_point_r", POSE_CAT_ENERGETIC,
-        0.5f, 0.09f, 5, -3,
-        -25, -10, 130, 100,
-        -5, 0, 10, -5,
-        0.5f, 0.85f, 0.4f, 0.8f));
-    
-    add_pose(d, make_pose("lock_freeze", POSE_CAT_ENERGETIC,
-        0.5f, 0.1f, 0, 0,
-        -85, -40, 85, 40,
-        15, -8, -15, 8,
-        0.55f, 0.9f, 0.5f, 0.7f));
-    
-    add_pose(d, make_pose("lock_wrist", POSE_CAT_ENERGETIC,
-        0.5f, 0.09f, 3, -2,
-        -70, 60, 80, -70,
-        8, -3, -8, 3,
-        0.5f, 0.85f, 0.45f, 0.75f));
-    
-    /* ========== HOUSE DANCE MOVES ========== */
-    add_pose(d, make_pose("house_jack_up", POSE_CAT_GROOVE,
-        0.5f, 0.07f, 0, -5,
-        -55, 30, 55, -30,
-        20, -25, -20, 25,
-        0.3f, 0.6f, 0.6f, 0.5f));
-    
-    add_pose(d, make_pose("house_jack_down", POSE_CAT_GROOVE,
-        0.5f, 0.13f, 0, 8,
-        -40, 50, 40, -50,
-        30, -40, -30, 40,
-        0.3f, 0.6f, 0.65f, 0.45f));
-    
-    add_pose(d, make_pose("house_stomp_l", POSE_CAT_GROOVE,
-        0.45f, 0.11f, -8, 5,
-        -50, 45, 30, -20,
-        -35, 55, 20, -10,
-        0.3f, 0.6f, 0.7f, 0.4f));
-    
-    add_pose(d, make_pose("house_stomp_r", POSE_CAT_GROOVE,
-        0.55f, 0.11f, 8, 5,
-        -30, 20, 50, -45,
-        20, -10, -35, 55,
-        0.3f, 0.6f, 0.7f, 0.4f));
-    
-    /* ========== VOGUING MOVES ========== */
-    add_pose(d, make_pose("vogue_arms_frame", POSE_CAT_GROOVE,
-        0.5f, 0.09f, 0, -3,
-        -105, -45, 105, 45,
-        5, 0, -5, 0,
-        0.35f, 0.65f, 0.3f, 0.85f));
-    
-    add_pose(d, make_pose("vogue_dip", POSE_CAT_GROOVE,
-        0.5f, 0.15f, 0, 15,
-        -80, 50, 80, -50,
-        40, -70, -40, 70,
-        0.35f, 0.65f, 0.5f, 0.7f));
-    
-    add_pose(d, make_pose("vogue_hand_l", POSE_CAT_GROOVE,
-        0.48f, 0.1f, -5, 0,
-        -95, -70, 30, 20,
-        5, 0, -5, 0,
-        0.3f, 0.6f, 0.3f, 0.9f));
-    
-    add_pose(d, make_pose("vogue_hand_r", POSE_CAT_GROOVE,
-        0.52f, 0.1f, 5, 0,
-        -30, -20, 95, 70,
-        -5, 0, 5, 0,
-        0.3f, 0.6f, 0.3f, 0.9f));
-    
-    /* ========== KRUMP MOVES ========== */
-    add_pose(d, make_pose("krump_stomp", POSE_CAT_INTENSE,
-        0.5f, 0.14f, 0, 10,
-        -45, 60, 45, -60,
-        35, -55, -35, 55,
-        0.7f, 1.0f, 0.9f, 0.3f));
-    
-    add_pose(d, make_pose("krump_chest_pop", POSE_CAT_INTENSE,
-        0.5f, 0.08f, 0, -8,
-        -60, 25, 60, -25,
-        15, -10, -15, 10,
-        0.7f, 1.0f, 0.8f, 0.4f));
-    
-    add_pose(d, make_pose("krump_arm_swing", POSE_CAT_INTENSE,
-        0.48f, 0.1f, -10, 5,
-        -110, -50, 70, -40,
-        -20, 35, 25, -20,
-        0.75f, 1.0f, 0.7f, 0.5f));
-    
-    add_pose(d, make_pose("krump_buck", POSE_CAT_INTENSE,
-        0.5f, 0.12f, 15, 8,
-        -55, 45, 75, -55,
-        25, -35, -30, 45,
-        0.75f, 1.0f, 0.85f, 0.35f));
-    
-    /* ========== TUTTING MOVES ========== */
-    add_pose(d, make_pose("tut_box_l", POSE_CAT_GROOVE,
-        0.5f, 0.1f, 0, 0,
-        -90, -90, 45, 45,
-        5, 0, -5, 0,
-        0.25f, 0.55f, 0.3f, 0.8f));
-    
-    add_pose(d, make_pose("tut_box_r", POSE_CAT_GROOVE,
-        0.5f, 0.1f, 0, 0,
-        -45, -45, 90, 90,
-        -5, 0, 5, 0,
-        0.25f, 0.55f, 0.3f, 0.8f));
-    
-    add_pose(d, make_pose("tut_king", POSE_CAT_GROOVE,
-        0.5f, 0.09f, 0, -2,
-        -90, 0, 90, 0,
-        8, -3, -8, 3,
-        0.3f, 0.6f, 0.35f, 0.85f));
-    
-    add_pose(d, make_pose("tut_pharaoh", POSE_CAT_GROOVE,
-        0.5f, 0.09f, 0, 0,
-        -90, 90, 90, -90,
-        5, 0, -5, 0,
-        0.3f, 0.6f, 0.3f, 0.9f));
-    
-    /* ========== WAVING MOVES ========== */
-    add_pose(d, make_pose("wave_arm_1", POSE_CAT_CALM,
-        0.5f, 0.1f, 0, 0,
-        -80, -30, 40, 20,
-        3, 0, -3, 0,
-        0.15f, 0.4f, 0.3f, 0.7f));
-    
-    add_pose(d, make_pose("wave_arm_2", POSE_CAT_CALM,
-        0.5f, 0.1f, 0, 0,
-        -60, 10, 60, -10,
-        3, 0, -3, 0,
-        0.15f, 0.4f, 0.3f, 0.7f));
-    
-    add_pose(d, make_pose("wave_arm_3", POSE_CAT_CALM,
-        0.5f, 0.1f, 0, 0,
-        -40, 20, 80, 30,
-        3, 0, -3, 0,
-        0.15f, 0.4f, 0.3f, 0.7f));
-    
-    add_pose(d, make_pose("wave_body", POSE_CAT_CALM,
-        0.52f, 0.1f, 5, 3,
-        -50, 30, 60, -40,
-        10, -5, -8, 3,
-        0.15f, 0.4f, 0.4f, 0.6f));
-    
-    /* ========== FLEXING MOVES ========== */
-    add_pose(d, make_pose("flex_double", POSE_CAT_ENERGETIC,
-        0.5f, 0.08f, 0, -3,
-        -110, -90, 110, 90,
-        10, -5, -10, 5,
-        0.5f, 0.8f, 0.6f, 0.6f));
-    
-    add_pose(d, make_pose("flex_side_l", POSE_CAT_ENERGETIC,
-        0.48f, 0.09f, -5, 0,
-        -120, -85, 35, 20,
-        5, 0, -8, 3,
-        0.5f, 0.8f, 0.55f, 0.65f));
-    
-    add_pose(d, make_pose("flex_side_r", POSE_CAT_ENERGETIC,
-        0.52f, 0.09f, 5, 0,
-        -35, -20, 120, 85,
-        8, -3, -5, 0,
-        0.5f, 0.8f, 0.55f, 0.65f));
-    
-    /* ========== CELEBRATION MOVES ========== */
-    add_pose(d, make_pose("celebrate_v", POSE_CAT_ENERGETIC,
-        0.5f, 0.07f, 0, -5,
-        -120, -60, 120, 60,
-        15, -10, -15, 10,
-        0.55f, 0.9f, 0.4f, 0.85f));
-    
-    add_pose(d, make_pose("celebrate_yeah", POSE_CAT_ENERGETIC,
-        0.5f, 0.08f, 0, -3,
-        -100, -70, 45, 20,
-        12, -8, -8, 5,
-        0.55f, 0.85f, 0.45f, 0.8f));
-    
-    add_pose(d, make_pose("celebrate_wave", POSE_CAT_ENERGETIC,
-        0.5f, 0.09f, 5, 0,
-        -90, -50, 90, 50,
-        10, -5, -10, 5,
-        0.5f, 0.85f, 0.4f, 0.8f));
-    
-    /* ========== NEW: FUNKY MOVES (groove with style) ========== */
-    add_pose(d, make_pose("funky_robot_l", POSE_CAT_GROOVE,
-        0.5f, 0.1f, -5, 0,
-        -90, 0, 45, -90,      /* Robot arm angles */
-        10, -5, -10, 5,
-        0.25f, 0.6f, 0.5f, 0.6f));
-    
-    add_pose(d, make_pose("funky_robot_r", POSE_CAT_GROOVE,
-        0.5f, 0.1f, 5, 0,
-        -45, 90, 90, 0,       /* Mirror robot */
-        -10, 5, 10, -5,
-        0.25f, 0.6f, 0.5f, 0.6f));
-    
-    add_pose(d, make_pose("funky_disco_point", POSE_CAT_GROOVE,
-        0.5f, 0.08f, 5, -5,
-        -130, -100, 30, 0,    /* Classic disco point up */
-        15, -10, -5, 0,
-        0.3f, 0.7f, 0.4f, 0.8f));
-    
-    add_pose(d, make_pose("funky_strut", POSE_CAT_GROOVE,
-        0.52f, 0.1f, 8, 10,
-        -50, 35, 40, -25,
-        -20, 35, 30, -20,     /* Strutting walk */
-        0.3f, 0.6f, 0.6f, 0.5f));
-    
-    add_pose(d, make_pose("funky_shoulder_roll", POSE_CAT_GROOVE,
-        0.5f, 0.11f, 15, 5,
-        -35, 60, -25, 40,     /* Asymmetric shoulders */
-        8, -3, -8, 3,
-        0.25f, 0.55f, 0.5f, 0.5f));
-    
-    /* ========== NEW: WAVE ARMS (smooth flowing) ========== */
-    add_pose(d, make_pose("wave_left_high", POSE_CAT_CALM,
-        0.5f, 0.1f, 0, -3,
-        -110, -60, 20, 30,    /* Left arm up in wave */
-        3, 0, -3, 0,
-        0.15f, 0.4f, 0.3f, 0.7f));
-    
-    add_pose(d, make_pose("wave_both_up", POSE_CAT_CALM,
-        0.5f, 0.09f, 0, 0,
-        -100, -50, 100, 50,   /* Both arms waving high */
-        5, 0, -5, 0,
-        0.15f, 0.45f, 0.3f, 0.8f));
-    
-    add_pose(d, make_pose("wave_flow_l", POSE_CAT_CALM,
-        0.48f, 0.1f, -5, -3,
-        -80, 40, -40, 60,     /* Flowing wave motion */
-        -5, 8, 10, -8,
-        0.1f, 0.35f, 0.4f, 0.6f));
-    
-    add_pose(d, make_pose("wave_flow_r", POSE_CAT_CALM,
-        0.52f, 0.1f, 5, 3,
-        40, -60, 80, -40,     /* Mirror flow */
-        10, -8, -5, 8,
-        0.1f, 0.35f, 0.4f, 0.6f));
-    
-    /* ========== NEW: HEAD BOB VARIANTS ========== */
-    add_pose(d, make_pose("headbang_down", POSE_CAT_ENERGETIC,
-        0.5f, 0.13f, 0, 12,   /* Head down (neck bent forward) */
-        -25, 40, 25, -40,
-        10, -5, -10, 5,
-        0.4f, 0.75f, 0.7f, 0.4f));
-    
-    add_pose(d, make_pose("headbang_back", POSE_CAT_ENERGETIC,
-        0.5f, 0.08f, 0, -8,   /* Head back */
-        -40, 30, 40, -30,
-        8, -3, -8, 3,
-        0.4f, 0.75f, 0.6f, 0.5f));
-    
-    add_pose(d, make_pose("head_tilt_l", POSE_CAT_GROOVE,
-        0.48f, 0.1f, -8, 0,   /* Tilt head left */
-        -30, 45, -20, 30,
-        5, 0, -5, 0,
-        0.2f, 0.5f, 0.5f, 0.5f));
-    
-    add_pose(d, make_pose("head_tilt_r", POSE_CAT_GROOVE,
-        0.52f, 0.1f, 8, 0,    /* Tilt head right */
-        20, -30, 30, -45,
-        -5, 0, 5, 0,
-        0.2f, 0.5f, 0.5f, 0.5f));
-    
-    /* ========== NEW: BREAKDANCE INSPIRED ========== */
-    add_pose(d, make_pose("break_freeze_l", POSE_CAT_INTENSE,
-        0.4f, 0.15f, -20, -25,
-        -70, 90, 120, 60,     /* Dramatic freeze pose */
-        -50, 70, 25, -15,
-        0.7f, 1.0f, 0.8f, 0.5f));
-    
-    add_pose(d, make_pose("break_freeze_r", POSE_CAT_INTENSE,
-        0.6f, 0.15f, 20, 25,
-        -120, -60, 70, -90,   /* Mirror freeze */
-        25, -15, -50, 70,
-        0.7f, 1.0f, 0.8f, 0.5f));
-    
-    add_pose(d, make_pose("break_toprock", POSE_CAT_ENERGETIC,
-        0.5f, 0.1f, 10, 8,
-        -55, 40, 70, -50,
-        -30, 45, 25, -35,     /* Toprock step */
-        0.5f, 0.85f, 0.75f, 0.4f));
-    
-    add_pose(d, make_pose("break_windmill_prep", POSE_CAT_INTENSE,
-        0.45f, 0.18f, -15, 20,
-        -30, 90, 60, -70,     /* Getting low */
-        -40, 80, 30, -60,
-        0.75f, 1.0f, 0.9f, 0.3f));
-    
-    /* ========== NEW: SMOOTH GROOVES ========== */
-    add_pose(d, make_pose("smooth_slide_l", POSE_CAT_GROOVE,
-        0.42f, 0.1f, -12, -10,
-        -35, 50, 10, 0,
-        -30, 50, 20, -15,     /* Smooth slide left */
-        0.25f, 0.55f, 0.6f, 0.4f));
-    
-    add_pose(d, make_pose("smooth_slide_r", POSE_CAT_GROOVE,
-        0.58f, 0.1f, 12, 10,
-        -10, 0, 35, -50,
-        20, -15, -30, 50,     /* Smooth slide right */
-        0.25f, 0.55f, 0.6f, 0.4f));
-    
-    add_pose(d, make_pose("smooth_body_roll", POSE_CAT_GROOVE,
-        0.5f, 0.12f, 5, 8,
-        -40, 55, 40, -55,     /* Body rolling motion */
-        15, -20, -15, 20,
-        0.3f, 0.6f, 0.7f, 0.4f));
-    
-    add_pose(d, make_pose("smooth_isolation", POSE_CAT_GROOVE,
-        0.5f, 0.1f, -8, 5,
-        -50, 30, 60, -40,     /* Chest isolation feel */
-        5, 0, -5, 0,
-        0.25f, 0.55f, 0.5f, 0.5f));
-    
-    /* ========== NEW: PARTY MOVES ========== */
-    add_pose(d, make_pose("party_hands_up", POSE_CAT_ENERGETIC,
-        0.5f, 0.08f, 0, -5,
-        -95, -55, 95, 55,     /* Hands up! */
-        10, -8, -10, 8,
-        0.5f, 0.85f, 0.4f, 0.9f));
-    
-    add_pose(d, make_pose("party_fist_pump", POSE_CAT_ENERGETIC,
-        0.5f, 0.07f, 0, -3,
-        -110, -80, 40, 20,    /* Fist pump! */
-        12, -10, -8, 5,
-        0.55f, 0.9f, 0.6f, 0.7f));
-    
-    add_pose(d, make_pose("party_double_pump", POSE_CAT_ENERGETIC,
-        0.5f, 0.06f, 0, 0,
-        -115, -85, 115, 85,   /* Double fist pump */
-        15, -12, -15, 12,
-        0.6f, 0.95f, 0.5f, 0.8f));
-    
-    add_pose(d, make_pose("party_jump_prep", POSE_CAT_ENERGETIC,
-        0.5f, 0.14f, 0, 5,
-        -30, 50, 30, -50,     /* Getting ready to jump */
-        25, -40, -25, 40,
-        0.5f, 0.8f, 0.8f, 0.4f));
-    
-    /* ========== NEW: MOONWALK / GLIDE POSES ========== */
-    add_pose(d, make_pose("glide_prep", POSE_CAT_GROOVE,
-        0.5f, 0.09f, 3, 3,
-        -25, 35, 25, -35,
-        -5, 20, 15, -25,      /* Weight shifting */
-        0.3f, 0.55f, 0.6f, 0.4f));
-    
-    add_pose(d, make_pose("glide_slide", POSE_CAT_GROOVE,
-        0.5f, 0.1f, -3, 0,
-        -30, 40, 30, -40,
-        15, -30, -20, 45,     /* Sliding motion */
-        0.3f, 0.55f, 0.65f, 0.35f));
-    
-    /* ========== NEW: DRAMATIC POSES ========== */
-    add_pose(d, make_pose("dramatic_reach", POSE_CAT_INTENSE,
-        0.5f, 0.08f, 0, -10,
-        -135, -90, 50, 30,    /* Reaching for the sky */
-        10, -5, -10, 5,
-        0.6f, 1.0f, 0.4f, 0.9f));
-    
-    add_pose(d, make_pose("dramatic_pose", POSE_CAT_INTENSE,
-        0.55f, 0.1f, 15, 10,
-        -80, 20, 100, -50,    /* Dramatic stance */
-        -25, 40, 35, -25,
-        0.65f, 1.0f, 0.6f, 0.7f));
-    
-    add_pose(d, make_pose("dramatic_bow", POSE_CAT_CALM,
-        0.5f, 0.18f, 0, 25,   /* Taking a bow */
-        10, 30, -10, -30,
-        10, 0, -10, 0,
-        0.0f, 0.3f, 0.5f, 0.5f));
-    
-    /* ========== NEW: ADDITIONAL IDLE VARIATIONS ========== */
-    add_pose(d, make_pose("idle_sway", POSE_CAT_IDLE,
-        0.5f, 0.1f, 3, 2,
-        15, 10, -10, -5,
-        5, -3, -3, 2,
-        0.0f, 0.12f, 0.4f, 0.4f));
-    
-    add_pose(d, make_pose("idle_arms_cross", POSE_CAT_IDLE,
-        0.5f, 0.1f, 0, 0,
-        30, 75, -30, -75,     /* Arms crossed look */
-        2, 0, -2, 0,
-        0.0f, 0.15f, 0.3f, 0.3f));
-    
-    /* ========== NEW: SPIN POSES ========== */
-    add_pose(d, make_pose("spin_wind_l", POSE_CAT_INTENSE,
-        0.48f, 0.09f, -25, -15,
-        -60, 20, 90, -40,     /* Spinning left */
-        -35, 55, 30, -40,
-        0.7f, 1.0f, 0.6f, 0.6f));
-    
-    add_pose(d, make_pose("spin_wind_r", POSE_CAT_INTENSE,
-        0.52f, 0.09f, 25, 15,
-        -90, 40, 60, -20,     /* Spinning right */
-        30, -40, -35, 55,
-        0.7f, 1.0f, 0.6f, 0.6f));
-    
-    add_pose(d, make_pose("spin_arms_out", POSE_CAT_ENERGETIC,
-        0.5f, 0.08f, 15, 10,
-        -75, 15, 75, -15,     /* Arms out spinning */
-        20, -15, -20, 15,
-        0.55f, 0.85f, 0.5f, 0.7f));
-    
-    /* ========== MASSIVE EXPANSION: GROOVE VARIATIONS ========== */
-    /* Subtle head tilts and body shifts for more natural movement */
-    add_pose(d, make_pose("groove_tilt_l", POSE_CAT_GROOVE,
-        0.48f, 0.09f, -8, 5,
-        -20, 25, 15, -20,
-        10, -15, -8, 12,
-        0.25f, 0.45f, 0.5f, 0.5f));
-    
-    add_pose(d, make_pose("groove_tilt_r", POSE_CAT_GROOVE,
-        0.52f, 0.09f, 8, -5,
-        -15, 20, 20, -25,
-        -8, 12, 10, -15,
-        0.25f, 0.45f, 0.5f, 0.5f));
-    
-    add_pose(d, make_pose("groove_sink", POSE_CAT_GROOVE,
-        0.5f, 0.12f, 0, 8,
-        -25, 35, 25, -35,
-        12, -18, -12, 18,
-        0.35f, 0.55f, 0.55f, 0.45f));
-    
-    add_pose(d, make_pose("groove_rise", POSE_CAT_GROOVE,
-        0.5f, 0.07f, 0, -5,
-        -30, 30, 30, -30,
-        8, -12, -8, 12,
-        0.2f, 0.4f, 0.45f, 0.55f));
-    
-    /* ========== ROBOT / MECHANICAL MOVES ========== */
-    add_pose(d, make_pose("robot_arm_l", POSE_CAT_ENERGETIC,
-        0.5f, 0.09f, 0, 0,
-        -90, 0, 0, 0,
-        5, -5, -5, 5,
-        0.4f, 0.65f, 0.5f, 0.5f));
-    
-    add_pose(d, make_pose("robot_arm_r", POSE_CAT_ENERGETIC,
-        0.5f, 0.09f, 0, 0,
-        0, 0, 90, 0,
-        5, -5, -5, 5,
-        0.4f, 0.65f, 0.5f, 0.5f));
-    
-    add_pose(d, make_pose("robot_arms_up", POSE_CAT_ENERGETIC,
-        0.5f, 0.08f, 0, 0,
-        -90, -90, 90, 90,
-        0, 0, 0, 0,
-        0.35f, 0.6f, 0.5f, 0.5f));
-    
-    add_pose(d, make_pose("robot_step_l", POSE_CAT_ENERGETIC,
-        0.48f, 0.1f, 0, 0,
-        -45, 90, 45, -90,
-        -30, 45, 15, -20,
-        0.45f, 0.7f, 0.6f, 0.4f));
-    
-    add_pose(d, make_pose("robot_step_r", POSE_CAT_ENERGETIC,
-        0.52f, 0.1f, 0, 0,
-        -45, -90, 45, 90,
-        15, -20, -30, 45,
-        0.45f, 0.7f, 0.4f, 0.6f));
-    
-    /* ========== WAVE DANCE ========== */
-    add_pose(d, make_pose("wave_start", POSE_CAT_GROOVE,
-        0.5f, 0.09f, -5, 3,
-        -100, -60, 30, 20,
-        8, -10, -8, 10,
-        0.3f, 0.5f, 0.5f, 0.5f));
-    
-    add_pose(d, make_pose("wave_mid_l", POSE_CAT_GROOVE,
-        0.5f, 0.09f, -8, 5,
-        -70, -30, 45, 10,
-        10, -12, -10, 12,
-        0.3f, 0.5f, 0.5f, 0.5f));
-    
-    add_pose(d, make_pose("wave_mid_r", POSE_CAT_GROOVE,
-        0.5f, 0.09f, 8, -5,
-        -45, -10, 70, 30,
-        10, -12, -10, 12,
-        0.3f, 0.5f, 0.5f, 0.5f));
-    
-    add_pose(d, make_pose("wave_end", POSE_CAT_GROOVE,
-        0.5f, 0.09f, 5, -3,
-        -30, -20, 100, 60,
-        8, -10, -8, 10,
-        0.3f, 0.5f, 0.5f, 0.5f));
-    
-    /* ========== BOUNCE VARIATIONS ========== */
-    add_pose(d, make_pose("bounce_low", POSE_CAT_ENERGETIC,
-        0.5f, 0.13f, 0, 10,
-        -40, 45, 40, -45,
-        18, -25, -18, 25,
-        0.5f, 0.75f, 0.6f, 0.4f));
-    
-    add_pose(d, make_pose("bounce_high", POSE_CAT_ENERGETIC,
-        0.5f, 0.05f, 0, -8,
-        -35, 30, 35, -30,
-        5, -8, -5, 8,
-        0.4f, 0.6f, 0.45f, 0.55f));
-    
-    add_pose(d, make_pose("bounce_twist_l", POSE_CAT_ENERGETIC,
-        0.48f, 0.1f, -15, 8,
-        -50, 40, 30, -25,
-        -25, 35, 20, -28,
-        0.55f, 0.8f, 0.65f, 0.35f));
-    
-    add_pose(d, make_pose("bounce_twist_r", POSE_CAT_ENERGETIC,
-        0.52f, 0.1f, 15, -8,
-        -30, 25, 50, -40,
-        20, -28, -25, 35,
-        0.55f, 0.8f, 0.35f, 0.65f));
-    
-    /* ========== ISOLATIONS ========== */
-    add_pose(d, make_pose("iso_chest_l", POSE_CAT_GROOVE,
-        0.47f, 0.09f, -10, 0,
-        -25, 30, 20, -25,
-        8, -10, -8, 10,
-        0.3f, 0.5f, 0.5f, 0.5f));
-    
-    add_pose(d, make_pose("iso_chest_r", POSE_CAT_GROOVE,
-        0.53f, 0.09f, 10, 0,
-        -20, 25, 25, -30,
-        8, -10, -8, 10,
-        0.3f, 0.5f, 0.5f, 0.5f));
-    
-    add_pose(d, make_pose("iso_hip_l", POSE_CAT_GROOVE,
-        0.5f, 0.1f, 0, -5,
-        -30, 35, 30, -35,
-        -20, 25, 15, -18,
-        0.35f, 0.55f, 0.6f, 0.4f));
-    
-    add_pose(d, make_pose("iso_hip_r", POSE_CAT_GROOVE,
-        0.5f, 0.1f, 0, 5,
-        -30, 35, 30, -35,
-        15, -18, -20, 25,
-        0.35f, 0.55f, 0.4f, 0.6f));
-    
-    /* ========== FREESTYLE / WILD MOVES ========== */
-    add_pose(d, make_pose("wild_flail1", POSE_CAT_INTENSE,
-        0.5f, 0.07f, -12, -8,
-        -120, 45, 80, -60,
-        -28, 40, 35, -30,
-        0.7f, 1.0f, 0.65f, 0.55f));
-    
-    add_pose(d, make_pose("wild_flail2", POSE_CAT_INTENSE,
-        0.5f, 0.07f, 12, 8,
-        -80, 60, 120, -45,
-        35, -30, -28, 40,
-        0.7f, 1.0f, 0.55f, 0.65f));
-    
-    add_pose(d, make_pose("wild_kick_l", POSE_CAT_INTENSE,
-        0.55f, 0.08f, 10, 12,
-        -60, 30, 45, -20,
-        -60, 10, 30, -35,
-        0.75f, 1.0f, 0.8f, 0.3f));
-    
-    add_pose(d, make_pose("wild_kick_r", POSE_CAT_INTENSE,
-        0.45f, 0.08f, -10, -12,
-        -45, 20, 60, -30,
-        30, -35, -60, 10,
-        0.75f, 1.0f, 0.3f, 0.8f));
-    
-    /* ========== CELEBRATION POSES ========== */
-    add_pose(d, make_pose("celebrate_jump", POSE_CAT_TREBLE_ACCENT,
-        0.5f, 0.04f, 0, -15,
-        -130, -45, 130, 45,
-        10, -15, -10, 15,
-        0.55f, 0.85f, 0.4f, 0.85f));
-    
-    add_pose(d, make_pose("celebrate_wave", POSE_CAT_TREBLE_ACCENT,
-        0.5f, 0.08f, -10, 5,
-        -140, -30, 80, 20,
-        15, -20, -15, 20,
-        0.5f, 0.8f, 0.5f, 0.75f));
-    
-    add_pose(d, make_pose("celebrate_clap", POSE_CAT_TREBLE_ACCENT,
-        0.5f, 0.09f, 0, 2,
-        -60, -85, 60, 85,
-        8, -10, -8, 10,
-        0.45f, 0.7f, 0.5f, 0.5f));
-    
-    /* ========== FOOTWORK EMPHASIS ========== */
-    add_pose(d, make_pose("step_cross_l", POSE_CAT_GROOVE,
-        0.45f, 0.1f, 5, 3,
-        -25, 30, 20, -25,
-        20, -25, -5, 8,
-        0.3f, 0.5f, 0.65f, 0.35f));
-    
-    add_pose(d, make_pose("step_cross_r", POSE_CAT_GROOVE,
-        0.55f, 0.1f, -5, -3,
-        -20, 25, 25, -30,
-        -5, 8, 20, -25,
-        0.3f, 0.5f, 0.35f, 0.65f));
-    
-    add_pose(d, make_pose("step_back_l", POSE_CAT_GROOVE,
-        0.52f, 0.1f, 3, 5,
-        -30, 35, 25, -30,
-        5, -8, 25, -35,
-        0.35f, 0.55f, 0.4f, 0.6f));
-    
-    add_pose(d, make_pose("step_back_r", POSE_CAT_GROOVE,
-        0.48f, 0.1f, -3, -5,
-        -25, 30, 30, -35,
-        25, -35, 5, -8,
-        0.35f, 0.55f, 0.6f, 0.4f));
-    
-    /* ========== SHOULDER MOVES ========== */
-    add_pose(d, make_pose("shoulder_pop_l", POSE_CAT_GROOVE,
-        0.5f, 0.09f, -5, 0,
-        -35, 25, 15, -10,
-        10, -12, -10, 12,
-        0.3f, 0.5f, 0.5f, 0.5f));
-    
-    add_pose(d, make_pose("shoulder_pop_r", POSE_CAT_GROOVE,
-        0.5f, 0.09f, 5, 0,
-        -15, 10, 35, -25,
-        10, -12, -10, 12,
-        0.3f, 0.5f, 0.5f, 0.5f));
-    
-    add_pose(d, make_pose("shoulder_roll", POSE_CAT_GROOVE,
-        0.5f, 0.1f, 0, 3,
-        -40, 40, 40, -40,
-        12, -15, -12, 15,
-        0.35f, 0.55f, 0.5f, 0.5f));
-    
-    /* ========== ARM CHOREOGRAPHY ========== */
-    add_pose(d, make_pose("arms_snake_l", POSE_CAT_ENERGETIC,
-        0.5f, 0.08f, -8, 5,
-        -110, -40, 70, 30,
-        15, -18, -12, 15,
-        0.45f, 0.7f, 0.5f, 0.55f));
-    
-    add_pose(d, make_pose("arms_snake_r", POSE_CAT_ENERGETIC,
-        0.5f, 0.08f, 8, -5,
-        -70, -30, 110, 40,
-        12, -15, -15, 18,
-        0.45f, 0.7f, 0.55f, 0.5f));
-    
-    add_pose(d, make_pose("arms_circle_up", POSE_CAT_ENERGETIC,
-        0.5f, 0.07f, 0, -5,
-        -135, -20, 135, 20,
-        8, -10, -8, 10,
-        0.4f, 0.65f, 0.5f, 0.6f));
-    
-    add_pose(d, make_pose("arms_circle_down", POSE_CAT_ENERGETIC,
-        0.5f, 0.11f, 0, 8,
-        -45, 60, 45, -60,
-        15, -20, -15, 20,
-        0.5f, 0.75f, 0.55f, 0.45f));
-    
-    /* ========== BASS HIT REACTIONS ========== */
-    add_pose(d, make_pose("bass_stomp_l", POSE_CAT_BASS_HIT,
-        0.5f, 0.11f, 5, 12,
-        -35, 40, 30, -35,
-        -40, 60, 20, -25,
-        0.55f, 0.85f, 0.75f, 0.35f));
-    
-    add_pose(d, make_pose("bass_stomp_r", POSE_CAT_BASS_HIT,
-        0.5f, 0.11f, -5, -12,
-        -30, 35, 35, -40,
-        20, -25, -40, 60,
-        0.55f, 0.85f, 0.35f, 0.75f));
-    
-    add_pose(d, make_pose("bass_crouch_deep", POSE_CAT_BASS_HIT,
-        0.5f, 0.14f, 0, 15,
-        -25, 40, 25, -40,
-        25, -35, -25, 35,
-        0.6f, 0.9f, 0.65f, 0.35f));
-    
-    add_pose(d, make_pose("bass_punch_low", POSE_CAT_BASS_HIT,
-        0.5f, 0.1f, 0, 10,
-        -50, -70, 50, 70,
-        18, -22, -18, 22,
-        0.55f, 0.85f, 0.5f, 0.55f));
-    
-    /* ========== RELAXED / SMOOTH MOVES ========== */
-    add_pose(d, make_pose("smooth_sway_l", POSE_CAT_CALM,
-        0.48f, 0.1f, -5, 3,
-        -20, 20, 15, -15,
-        -12, 15, 8, -10,
-        0.2f, 0.35f, 0.55f, 0.45f));
-    
-    add_pose(d, make_pose("smooth_sway_r", POSE_CAT_CALM,
-        0.52f, 0.1f, 5, -3,
-        -15, 15, 20, -20,
-        8, -10, -12, 15,
-        0.2f, 0.35f, 0.45f, 0.55f));
-    
-    add_pose(d, make_pose("smooth_wave", POSE_CAT_CALM,
-        0.5f, 0.1f, 0, 2,
-        -30, 25, 30, -25,
-        10, -12, -10, 12,
-        0.2f, 0.35f, 0.5f, 0.5f));
-    
-    add_pose(d, make_pose("smooth_groove", POSE_CAT_CALM,
-        0.5f, 0.11f, 3, 5,
-        -25, 30, 25, -30,
-        15, -18, -15, 18,
-        0.25f, 0.4f, 0.52f, 0.48f));
-    
-    /* ========== SHARP / PRECISE MOVES (POPPING STYLE) ========== */
-    add_pose(d, make_pose("pop_hit1", POSE_CAT_ENERGETIC,
-        0.5f, 0.08f, 0, -3,
-        -60, 45, 60, -45,
-        8, -10, -8, 10,
-        0.4f, 0.65f, 0.5f, 0.5f));
-    
-    add_pose(d, make_pose("pop_hit2", POSE_CAT_ENERGETIC,
-        0.5f, 0.08f, -8, 0,
-        -90, 25, 40, -15,
-        12, -15, -12, 15,
-        0.42f, 0.68f, 0.52f, 0.48f));
-    
-    add_pose(d, make_pose("pop_hit3", POSE_CAT_ENERGETIC,
-        0.5f, 0.08f, 8, 0,
-        -40, 15, 90, -25,
-        12, -15, -12, 15,
-        0.42f, 0.68f, 0.48f, 0.52f));
-    
-    add_pose(d, make_pose("pop_freeze", POSE_CAT_ENERGETIC,
-        0.5f, 0.09f, 0, 2,
-        -75, 60, 75, -60,
-        10, -12, -10, 12,
-        0.38f, 0.62f, 0.5f, 0.5f));
-    
-    /* ========== FLUID / CONTINUOUS FLOW ========== */
-    add_pose(d, make_pose("flow_a", POSE_CAT_GROOVE,
-        0.5f, 0.09f, -5, 3,
-        -55, 20, 40, -10,
-        8, -10, -8, 10,
-        0.3f, 0.52f, 0.5f, 0.5f));
-    
-    add_pose(d, make_pose("flow_b", POSE_CAT_GROOVE,
-        0.5f, 0.09f, 0, 0,
-        -40, 30, 55, -25,
-        10, -12, -10, 12,
-        0.32f, 0.54f, 0.5f, 0.5f));
-    
-    add_pose(d, make_pose("flow_c", POSE_CAT_GROOVE,
-        0.5f, 0.09f, 5, -3,
-        -35, 15, 65, -35,
-        8, -10, -8, 10,
-        0.3f, 0.52f, 0.5f, 0.5f));
-    
-    add_pose(d, make_pose("flow_d", POSE_CAT_GROOVE,
-        0.5f, 0.09f, 8, -5,
-        -25, 5, 80, -45,
-        10, -12, -10, 12,
-        0.32f, 0.54f, 0.48f, 0.52f));
-    
-    /* ========== POWER MOVES ========== */
-    add_pose(d, make_pose("power_stance", POSE_CAT_INTENSE,
-        0.5f, 0.1f, 0, 5,
-        -80, 30, 80, -30,
-        -25, 35, 25, -35,
-        0.6f, 0.9f, 0.55f, 0.55f));
-    
-    add_pose(d, make_pose("power_reach_l", POSE_CAT_INTENSE,
-        0.5f, 0.08f, -12, -8,
-        -140, -50, 50, 20,
-        -20, 28, 15, -18,
-        0.65f, 0.95f, 0.6f, 0.5f));
-    
-    add_pose(d, make_pose("power_reach_r", POSE_CAT_INTENSE,
-        0.5f, 0.08f, 12, 8,
-        -50, -20, 140, 50,
-        15, -18, -20, 28,
-        0.65f, 0.95f, 0.5f, 0.6f));
-    
-    add_pose(d, make_pose("power_pump", POSE_CAT_INTENSE,
-        0.5f, 0.08f, 0, -5,
-        -100, -60, 100, 60,
-        12, -15, -12, 15,
-        0.6f, 0.9f, 0.5f, 0.55f));
-    
-    /* ========== v3.1: SPIN POSES ========== */
-    /* These poses have facing directions for spins */
-    {
-        Pose spin;
-        
-        /* Spin wind-up (facing slightly left) */
-        spin = make_pose("spin_windup", POSE_CAT_SPIN,
-            0.5f, 0.09f, -20, 10,
-            -45, 60, 80, -30,
-            -15, 20, 20, -25,
-            0.5f, 0.9f, 0.6f, 0.5f);
-        spin.facing = -0.4f;  /* Slightly turned */
-        add_pose(d, spin);
-        
-        /* Mid-spin (facing side) */
-        spin = make_pose("spin_mid_l", POSE_CAT_SPIN,
-            0.5f, 0.08f, 0, 5,
-            -70, 30, 70, -30,
-            -10, 15, 10, -15,
-            0.55f, 0.95f, 0.55f, 0.55f);
-        spin.facing = -1.57f;  /* 90 degrees left */
-        add_pose(d, spin);
-        
-        spin = make_pose("spin_mid_r", POSE_CAT_SPIN,
-            0.5f, 0.08f, 0, -5,
-            -70, 30, 70, -30,
-            10, -15, -10, 15,
-            0.55f, 0.95f, 0.55f, 0.55f);
-        spin.facing = 1.57f;  /* 90 degrees right */
-        add_pose(d, spin);
-        
-        /* Back-facing spin moment */
-        spin = make_pose("spin_back", POSE_CAT_SPIN,
-            0.5f, 0.09f, 0, 0,
-            -60, 40, 60, -40,
-            5, -8, -5, 8,
-            0.6f, 1.0f, 0.5f, 0.5f);
-        spin.facing = 3.14f;  /* Facing away */
-        add_pose(d, spin);
-        
-        /* Spin completion (arms out) */
-        spin = make_pose("spin_finish", POSE_CAT_SPIN,
-            0.5f, 0.07f, 15, -8,
-            -90, 10, 90, -10,
-            12, -15, -12, 15,
-            0.55f, 0.9f, 0.55f, 0.6f);
-        spin.facing = 0.3f;  /* Slight turn */
-        add_pose(d, spin);
-        
-        /* Pirouette style */
-        spin = make_pose("pirouette_up", POSE_CAT_SPIN,
-            0.5f, 0.06f, 0, -10,
-            -130, -30, 130, 30,
-            -5, 8, 5, -8,
-            0.6f, 1.0f, 0.4f, 0.7f);
-        spin.facing = 0.0f;
-        add_pose(d, spin);
-        
-        /* Breakdance spin prep */
-        spin = make_pose("break_spin_low", POSE_CAT_SPIN,
-            0.5f, 0.14f, 25, 20,
-            -40, 70, 100, -45,
-            -35, 50, 30, -40,
-            0.65f, 1.0f, 0.7f, 0.4f);
-        spin.facing = -0.8f;
-        add_pose(d, spin);
-    }
-    
-    /* ========== v3.1: DIP POSES ========== */
-    /* Dramatic dips and drops */
-    {
-        Pose dip;
-        
-        /* Deep dip (dramatic low pose) */
-        dip = make_pose("dip_deep", POSE_CAT_DIP,
-            0.5f, 0.22f, 0, 30,
-            -20, 50, 20, -50,
-            -35, 55, 35, -55,
-            0.5f, 1.0f, 0.75f, 0.3f);
-        dip.dip_amount = 0.8f;
-        add_pose(d, dip);
-        
-        /* Side dip left */
-        dip = make_pose("dip_left", POSE_CAT_DIP,
-            0.45f, 0.18f, -25, 20,
-            -60, 40, 30, -20,
-            -40, 55, 20, -30,
-            0.45f, 0.9f, 0.6f, 0.4f);
-        dip.dip_amount = 0.5f;
-        dip.facing = -0.3f;
-        add_pose(d, dip);
-        
-        /* Side dip right */
-        dip = make_pose("dip_right", POSE_CAT_DIP,
-            0.55f, 0.18f, 25, -20,
-            -30, 20, 60, -40,
-            20, -30, -40, 55,
-            0.45f, 0.9f, 0.6f, 0.4f);
-        dip.dip_amount = 0.5f;
-        dip.facing = 0.3f;
-        add_pose(d, dip);
-        
-        /* Drop it low */
-        dip = make_pose("drop_low", POSE_CAT_DIP,
-            0.5f, 0.25f, 0, 35,
-            -50, 60, 50, -60,
-            -45, 70, 45, -70,
-            0.6f, 1.0f, 0.85f, 0.25f);
-        dip.dip_amount = 1.0f;  /* Maximum dip */
-        add_pose(d, dip);
-        
-        /* Dramatic lean back */
-        dip = make_pose("lean_back_dip", POSE_CAT_DIP,
-            0.5f, 0.08f, 0, -25,
-            -100, -40, 100, 40,
-            25, -35, -25, 35,
-            0.5f, 0.9f, 0.5f, 0.6f);
-        dip.dip_amount = 0.3f;
-        add_pose(d, dip);
-        
-        /* Matrix dodge */
-        dip = make_pose("matrix_lean", POSE_CAT_DIP,
-            0.5f, 0.06f, 0, -35,
-            -80, -20, 80, 20,
-            20, -28, -20, 28,
-            0.55f, 0.95f, 0.45f, 0.55f);
-        dip.dip_amount = 0.4f;
-        add_pose(d, dip);
-        
-        /* Bass drop pose */
-        dip = make_pose("bass_drop", POSE_CAT_DIP,
-            0.5f, 0.2f, 0, 25,
-            -60, 50, 60, -50,
-            -30, 45, 30, -45,
-            0.7f, 1.0f, 0.9f, 0.2f);
-        dip.dip_amount = 0.7f;
-        add_pose(d, dip);
-        
-        /* Recovery from dip */
-        dip = make_pose("dip_recover", POSE_CAT_DIP,
-            0.5f, 0.12f, 0, 10,
-            -40, 35, 40, -35,
-            -20, 30, 20, -30,
-            0.4f, 0.85f, 0.6f, 0.4f);
-        dip.dip_amount = 0.3f;
-        add_pose(d, dip);
-    }
-    
-    /* ========== GENRE-SPECIFIC POSES ========== */
-    /* Electronic/EDM - Arms up, symmetrical */
-    add_pose(d, make_pose("edm_hands_up", POSE_CAT_ENERGETIC,
-        0.5f, 0.07f, 0, -5,
-        -140, -20, 140, 20,
-        8, -10, -8, 10,
-        0.5f, 0.9f, 0.4f, 0.8f));
-    
-    add_pose(d, make_pose("edm_pump", POSE_CAT_INTENSE,
-        0.5f, 0.09f, 0, 3,
-        -120, -50, 120, 50,
-        12, -15, -12, 15,
-        0.6f, 1.0f, 0.5f, 0.7f));
-    
-    /* Hip-hop - More asymmetrical, attitude */
-    add_pose(d, make_pose("hiphop_lean", POSE_CAT_GROOVE,
-        0.52f, 0.11f, 10, 8,
-        -35, 45, 80, -35,
-        -18, 25, 15, -20,
-        0.35f, 0.65f, 0.7f, 0.35f));
-    
-    add_pose(d, make_pose("hiphop_bounce", POSE_CAT_ENERGETIC,
-        0.5f, 0.12f, -5, 10,
-        -45, 55, 45, -55,
-        -22, 32, 22, -32,
-        0.45f, 0.8f, 0.75f, 0.3f));
-    
-    /* Rock - Head bang, power stance */
-    add_pose(d, make_pose("rock_headbang", POSE_CAT_INTENSE,
-        0.5f, 0.14f, 0, 20,
-        -30, 40, 30, -40,
-        -15, 22, 15, -22,
-        0.55f, 0.95f, 0.6f, 0.5f));
-    
-    add_pose(d, make_pose("rock_power", POSE_CAT_INTENSE,
-        0.5f, 0.08f, 0, -8,
-        -90, 30, 90, -30,
-        -30, 42, 30, -42,
-        0.6f, 1.0f, 0.55f, 0.55f));
-    
-    /* Jazz/Swing - Smooth, flowing */
-    add_pose(d, make_pose("jazz_slide", POSE_CAT_GROOVE,
-        0.48f, 0.1f, -8, 5,
-        -55, 25, 40, -15,
-        -25, 35, 10, -15,
-        0.3f, 0.6f, 0.4f, 0.6f));
-    
-    add_pose(d, make_pose("jazz_snap", POSE_CAT_GROOVE,
-        0.52f, 0.09f, 5, 3,
-        -40, 65, 55, -20,
-        12, -18, -10, 15,
-        0.35f, 0.65f, 0.35f, 0.7f));
-    
-    /* Classical/Orchestral - Elegant, conductor-like */
-    add_pose(d, make_pose("classical_conduct", POSE_CAT_CALM,
-        0.5f, 0.08f, 0, -5,
-        -70, 30, 70, -30,
-        5, -8, -5, 8,
-        0.2f, 0.5f, 0.3f, 0.7f));
-    
-    add_pose(d, make_pose("classical_sway", POSE_CAT_CALM,
-        0.5f, 0.09f, 5, 3,
-        -25, 20, 35, -25,
-        8, -10, -8, 10,
-        0.15f, 0.4f, 0.4f, 0.6f));
-    
-    /* ========== v3.2: MOONWALK POSES (Pop/Hip-hop easter egg) ========== */
-    {
-        Pose mw;
-        /* Moonwalk slide back - one foot forward, weight back */
-        mw = make_pose("moonwalk_slide1", POSE_CAT_MOONWALK,
-            0.48f, 0.10f, -3, 5,
-            -25, 30, 30, -25,
-            15, 20, -15, -10,
-            0.3f, 0.7f, 0.8f, 0.3f);
-        add_pose(d, mw);
-        
-        mw = make_pose("moonwalk_slide2", POSE_CAT_MOONWALK,
-            0.52f, 0.10f, 3, 5,
-            -30, 25, 25, -30,
-            -15, -10, 15, 20,
-            0.8f, 0.3f, 0.3f, 0.7f);
-        add_pose(d, mw);
-        
-        /* Moonwalk glide - smooth transition */
-        mw = make_pose("moonwalk_glide", POSE_CAT_MOONWALK,
-            0.5f, 0.10f, 0, 3,
-            -20, 40, 20, -40,
-            10, 15, -10, -15,
-            0.5f, 0.6f, 0.6f, 0.5f);
-        add_pose(d, mw);
-        
-        /* Moonwalk toe point */
-        mw = make_pose("moonwalk_toe", POSE_CAT_MOONWALK,
-            0.5f, 0.11f, 0, 8,
-            -35, 35, 35, -35,
-            8, 25, -8, -5,
-            0.2f, 0.5f, 0.9f, 0.2f);
-        add_pose(d, mw);
-    }
-    
-    /* ========== BALLET/CLASSICAL POSES ========== */
-    {
-        Pose bl;
-        /* First position - heels together, arms rounded low */
-        bl = make_pose("ballet_first", POSE_CAT_BALLET,
-            0.5f, 0.10f, 0, 0,
-            -60, 70, 60, -70,
-            10, -15, -10, 15,
-            0.3f, 0.6f, 0.3f, 0.6f);
-        add_pose(d, bl);
-        
-        /* Arabesque - one leg extended back, arms out */
-        bl = make_pose("ballet_arabesque", POSE_CAT_BALLET,
-            0.5f, 0.08f, 15, -10,
-            -90, 10, 90, -10,
-            5, -5, -80, 20,
-            0.2f, 0.35f, 0.2f, 0.95f);
-        add_pose(d, bl);
-        
-        /* Plié - bent knees, arms soft */
-        bl = make_pose("ballet_plie", POSE_CAT_BALLET,
-            0.5f, 0.15f, 0, 5,
-            -50, 60, 50, -60,
-            20, 50, -20, -50,
-            0.4f, 0.85f, 0.4f, 0.85f);
-        add_pose(d, bl);
-        
-        /* Port de bras - flowing arm movement */
-        bl = make_pose("ballet_port_de_bras", POSE_CAT_BALLET,
-            0.5f, 0.09f, 5, -8,
-            -120, 30, 45, -50,
-            8, -10, -8, 10,
-            0.25f, 0.5f, 0.35f, 0.65f);
-        add_pose(d, bl);
-        
-        /* Relevé - on toes */
-        bl = make_pose("ballet_releve", POSE_CAT_BALLET,
-            0.5f, 0.07f, 0, -15,
-            -140, 20, 140, -20,
-            5, -8, -5, 8,
-            0.15f, 0.3f, 0.15f, 0.3f);
-        add_pose(d, bl);
-    }
-    
-    /* ========== BREAKDANCE POSES (Hip-hop easter egg) ========== */
-    {
-        Pose bd;
-        /* Toprock stance */
-        bd = make_pose("break_toprock", POSE_CAT_BREAKDANCE,
-            0.5f, 0.11f, 0, 10,
-            -45, 50, 60, -40,
-            -25, 35, 25, -35,
-            0.5f, 0.85f, 0.7f, 0.4f);
-        add_pose(d, bd);
-        
-        /* Freeze - hand on ground, legs up */
-        bd = make_pose("break_freeze", POSE_CAT_BREAKDANCE,
-            0.55f, 0.2f, 20, 25,
-            -120, 60, 30, -45,
-            -70, 80, 45, -60,
-            0.7f, 1.0f, 0.3f, 0.9f);
-        bd.dip_amount = 0.6f;
-        add_pose(d, bd);
-        
-        /* Indian step */
-        bd = make_pose("break_indian", POSE_CAT_BREAKDANCE,
-            0.5f, 0.13f, -8, 12,
-            -60, 55, 70, -50,
-            -30, 40, 35, -45,
-            0.6f, 0.95f, 0.55f, 0.65f);
-        add_pose(d, bd);
-        
-        /* Power move prep */
-        bd = make_pose("break_power_prep", POSE_CAT_BREAKDANCE,
-            0.5f, 0.16f, 0, 18,
-            -80, 45, 80, -45,
-            -45, 55, 45, -55,
-            0.55f, 1.0f, 0.55f, 1.0f);
-        add_pose(d, bd);
-    }
-    
-    /* ========== WALTZ/BALLROOM POSES ========== */
-    {
-        Pose wz;
-        /* Waltz frame - partner hold position */
-        wz = make_pose("waltz_frame", POSE_CAT_WALTZ,
-            0.5f, 0.09f, 0, -3,
-            -80, 60, 45, -50,
-            8, -10, -8, 10,
-            0.25f, 0.5f, 0.35f, 0.6f);
-        add_pose(d, wz);
-        
-        /* Waltz turn */
-        wz = make_pose("waltz_turn", POSE_CAT_WALTZ,
-            0.5f, 0.10f, 8, 5,
-            -75, 55, 50, -55,
-            15, -15, -10, 20,
-            0.3f, 0.55f, 0.4f, 0.55f);
-        add_pose(d, wz);
-        
-        /* Waltz rise */
-        wz = make_pose("waltz_rise", POSE_CAT_WALTZ,
-            0.5f, 0.07f, 0, -10,
-            -70, 50, 55, -55,
-            5, -8, -5, 8,
-            0.2f, 0.4f, 0.25f, 0.45f);
-        add_pose(d, wz);
-        
-        /* Waltz sway */
-        wz = make_pose("waltz_sway", POSE_CAT_WALTZ,
-            0.52f, 0.10f, 10, 3,
-            -65, 45, 60, -50,
-            12, -12, -8, 15,
-            0.28f, 0.52f, 0.32f, 0.55f);
-        add_pose(d, wz);
-    }
-    
-    /* ========== ROBOT POSES (Electronic/techno easter egg) ========== */
-    {
-        Pose rb;
-        /* Robot lock - stiff, angular */
-        rb = make_pose("robot_lock", POSE_CAT_ROBOT,
-            0.5f, 0.09f, 0, 0,
-            -90, 90, 90, -90,
-            0, 0, 0, 0,
-            0.3f, 0.6f, 0.3f, 0.6f);
-        add_pose(d, rb);
-        
-        /* Robot arm extend */
-        rb = make_pose("robot_extend", POSE_CAT_ROBOT,
-            0.5f, 0.09f, 0, 0,
-            -90, 0, 0, 0,
-            0, 0, 0, 0,
-            0.35f, 0.65f, 0.35f, 0.65f);
-        add_pose(d, rb);
-        
-        /* Robot tilt */
-        rb = make_pose("robot_tilt", POSE_CAT_ROBOT,
-            0.5f, 0.10f, -20, 0,
-            -90, 90, 90, -90,
-            5, -5, -5, 5,
-            0.35f, 0.65f, 0.35f, 0.65f);
-        add_pose(d, rb);
-        
-        /* Robot wave */
-        rb = make_pose("robot_wave", POSE_CAT_ROBOT,
-            0.5f, 0.09f, 0, 5,
-            -120, -45, 45, -90,
-            0, 5, 0, -5,
-            0.3f, 0.6f, 0.3f, 0.6f);
-        add_pose(d, rb);
-        
-        /* Robot isolate */
-        rb = make_pose("robot_isolate", POSE_CAT_ROBOT,
-            0.52f, 0.10f, 0, -5,
-            -90, 45, 90, -45,
-            8, -8, -8, 8,
-            0.32f, 0.62f, 0.32f, 0.62f);
-        add_pose(d, rb);
-    }
-    
-    /* ========== HEADBANG POSES (Rock/metal easter egg) ========== */
-    {
-        Pose hb;
-        /* Headbang down */
-        hb = make_pose("headbang_down", POSE_CAT_HEADBANG,
-            0.5f, 0.14f, 0, 35,
-            -30, 40, 30, -40,
-            -15, 25, 15, -25,
-            0.5f, 0.9f, 0.5f, 0.9f);
-        add_pose(d, hb);
-        
-        /* Headbang up */
-        hb = make_pose("headbang_up", POSE_CAT_HEADBANG,
-            0.5f, 0.08f, 0, -20,
-            -35, 35, 35, -35,
-            -12, 20, 12, -20,
-            0.45f, 0.85f, 0.45f, 0.85f);
-        add_pose(d, hb);
-        
-        /* Devil horns */
-        hb = make_pose("headbang_horns", POSE_CAT_HEADBANG,
-            0.5f, 0.09f, 0, 15,
-            -120, -60, 120, 60,
-            -10, 18, 10, -18,
-            0.48f, 0.88f, 0.48f, 0.88f);
-        add_pose(d, hb);
-        
-        /* Power stance headbang */
-        hb = make_pose("headbang_power", POSE_CAT_HEADBANG,
-            0.5f, 0.11f, 0, 25,
-            -60, 45, 60, -45,
-            -25, 40, 25, -40,
-            0.55f, 1.0f, 0.55f, 1.0f);
-        add_pose(d, hb);
-    }
-    
-    /* ========== PROCEDURAL POSE VARIATIONS ========== */
-    /* Generate variations of existing poses with subtle modifications */
-    int base_poses = d->num_poses;
-    generate_pose_variations(d);
-    
-    /* Log the number of poses for debugging */
-    fprintf(stderr, "[skeleton_dancer] %d base poses -> %d total poses after variations\n", 
-            base_poses, d->num_poses);
-}
-
-/* Generate procedural variations of base poses to reach 1000+ unique poses */
-static void generate_pose_variations(SkeletonDancer *d) {
-    int base_count = d->num_poses;
-    
-    /* First pass: Create mirrored versions of all poses */
-    for (int i = 0; i < base_count && d->num_poses < MAX_POSES - 100; i++) {
-        const Pose *base = &d->poses[i];
-        
-        /* Variation 1: Mirrored pose (swap left/right) */
-        Pose mirror = *base;
-        char name[32];
-        snprintf(name, sizeof(name), "%s_mir", base->name);
-        snprintf(mirror.name, sizeof(mirror.name), "%s", name);
-        
-        /* Swap arm joints */
-        Joint temp;
-        temp = mirror.joints[JOINT_SHOULDER_L];
-        mirror.joints[JOINT_SHOULDER_L] = mirror.joints[JOINT_SHOULDER_R];
-        mirror.joints[JOINT_SHOULDER_R] = temp;
-        mirror.joints[JOINT_SHOULDER_L].x = 1.0f - mirror.joints[JOINT_SHOULDER_L].x;
-        mirror.joints[JOINT_SHOULDER_R].x = 1.0f - mirror.joints[JOINT_SHOULDER_R].x;
-        
-        temp = mirror.joints[JOINT_ELBOW_L];
-        mirror.joints[JOINT_ELBOW_L] = mirror.joints[JOINT_ELBOW_R];
-        mirror.joints[JOINT_ELBOW_R] = temp;
-        mirror.joints[JOINT_ELBOW_L].x = 1.0f - mirror.joints[JOINT_ELBOW_L].x;
-        mirror.joints[JOINT_ELBOW_R].x = 1.0f - mirror.joints[JOINT_ELBOW_R].x;
-        
-        temp = mirror.joints[JOINT_HAND_L];
-        mirror.joints[JOINT_HAND_L] = mirror.joints[JOINT_HAND_R];
-        mirror.joints[JOINT_HAND_R] = temp;
-        mirror.joints[JOINT_HAND_L].x = 1.0f - mirror.joints[JOINT_HAND_L].x;
-        mirror.joints[JOINT_HAND_R].x = 1.0f - mirror.joints[JOINT_HAND_R].x;
-        
-        /* Swap leg joints */
-        temp = mirror.joints[JOINT_HIP_L];
-        mirror.joints[JOINT_HIP_L] = mirror.joints[JOINT_HIP_R];
-        mirror.joints[JOINT_HIP_R] = temp;
-        mirror.joints[JOINT_HIP_L].x = 1.0f - mirror.joints[JOINT_HIP_L].x;
-        mirror.joints[JOINT_HIP_R].x = 1.0f - mirror.joints[JOINT_HIP_R].x;
-        
-        temp = mirror.joints[JOINT_KNEE_L];
-        mirror.joints[JOINT_KNEE_L] = mirror.joints[JOINT_KNEE_R];
-        mirror.joints[JOINT_KNEE_R] = temp;
-        mirror.joints[JOINT_KNEE_L].x = 1.0f - mirror.joints[JOINT_KNEE_L].x;
-        mirror.joints[JOINT_KNEE_R].x = 1.0f - mirror.joints[JOINT_KNEE_R].x;
-        
-        temp = mirror.joints[JOINT_FOOT_L];
-        mirror.joints[JOINT_FOOT_L] = mirror.joints[JOINT_FOOT_R];
-        mirror.joints[JOINT_FOOT_R] = temp;
-        mirror.joints[JOINT_FOOT_L].x = 1.0f - mirror.joints[JOINT_FOOT_L].x;
-        mirror.joints[JOINT_FOOT_R].x = 1.0f - mirror.joints[JOINT_FOOT_R].x;
-        
-        /* Mirror center joints */
-        mirror.joints[JOINT_HEAD].x = 1.0f - mirror.joints[JOINT_HEAD].x;
-        mirror.joints[JOINT_NECK].x = 1.0f - mirror.joints[JOINT_NECK].x;
-        mirror.joints[JOINT_HIP_CENTER].x = 1.0f - mirror.joints[JOINT_HIP_CENTER].x;
-        
-        add_pose(d, mirror);
-    }
-    
-    /* Second pass: Create geometric variations for groove+ poses */
-    int after_mirrors = d->num_poses;
-    for (int i = 0; i < after_mirrors && d->num_poses < MAX_POSES - 50; i++) {
-        const Pose *base = &d->poses[i];
-        if (base->category < POSE_CAT_GROOVE) continue;
-        
-        /* Variation: Arms higher */
-        Pose arms_up = *base;
-        snprintf(arms_up.name, sizeof(arms_up.name), "%s_hi", base->name);
-        arms_up.joints[JOINT_ELBOW_L].y -= 0.04f;
-        arms_up.joints[JOINT_ELBOW_R].y -= 0.04f;
-        arms_up.joints[JOINT_HAND_L].y -= 0.06f;
-        arms_up.joints[JOINT_HAND_R].y -= 0.06f;
-        add_pose(d, arms_up);
-    }
-    
-    /* Third pass: Create stance variations */
-    int after_arms = d->num_poses;
-    for (int i = 0; i < after_arms && d->num_poses < MAX_POSES - 50; i++) {
-        const Pose *base = &d->poses[i];
-        if (base->category < POSE_CAT_GROOVE) continue;
-        
-        /* Skip some to stay within limits */
-        if (i % 3 != 0) continue;
-        
-        /* Variation: Wider stance */
-        Pose wide = *base;
-        snprintf(wide.name, sizeof(wide.name), "%s_w", base->name);
-        wide.joints[JOINT_FOOT_L].x -= 0.03f;
-        wide.joints[JOINT_FOOT_R].x += 0.03f;
-        wide.joints[JOINT_KNEE_L].x -= 0.02f;
-        wide.joints[JOINT_KNEE_R].x += 0.02f;
-        add_pose(d, wide);
-    }
-    
-    /* Fourth pass: Create crouch variations for energetic+ poses */
-    int after_wide = d->num_poses;
-    for (int i = 0; i < after_wide && d->num_poses < MAX_POSES - 30; i++) {
-        const Pose *base = &d->poses[i];
-        if (base->category < POSE_CAT_ENERGETIC) continue;
-        if (i % 4 != 0) continue;  /* Every 4th pose */
-        
-        Pose crouch = *base;
-        snprintf(crouch.name, sizeof(crouch.name), "%s_cr", base->name);
-        /* Lower entire body */
-        for (int j = 0; j < MAX_JOINTS; j++) {
-            crouch.joints[j].y += 0.02f;  /* Move down */
-        }
-        /* Bend knees more */
-        crouch.joints[JOINT_KNEE_L].y += 0.03f;
-        crouch.joints[JOINT_KNEE_R].y += 0.03f;
-        crouch.joints[JOINT_KNEE_L].x -= 0.02f;
-        crouch.joints[JOINT_KNEE_R].x += 0.02f;
-        add_pose(d, crouch);
-    }
-    
-    /* Fifth pass: Create lean variations */
-    int after_crouch = d->num_poses;
-    for (int i = 0; i < after_crouch && d->num_poses < MAX_POSES - 20; i++) {
-        const Pose *base = &d->poses[i];
-        if (base->category < POSE_CAT_GROOVE) continue;
-        if (i % 5 != 0) continue;  /* Every 5th pose */
-        
-        /* Lean left */
-        Pose lean_l = *base;
-        snprintf(lean_l.name, sizeof(lean_l.name), "%s_ll", base->name);
-        lean_l.joints[JOINT_HEAD].x -= 0.02f;
-        lean_l.joints[JOINT_NECK].x -= 0.015f;
-        lean_l.joints[JOINT_SHOULDER_L].x -= 0.01f;
-        lean_l.joints[JOINT_SHOULDER_R].x -= 0.01f;
-        add_pose(d, lean_l);
-        
-        if (d->num_poses >= MAX_POSES) break;
-        
-        /* Lean right */
-        Pose lean_r = *base;
-        snprintf(lean_r.name, sizeof(lean_r.name), "%s_lr", base->name);
-        lean_r.joints[JOINT_HEAD].x += 0.02f;
-        lean_r.joints[JOINT_NECK].x += 0.015f;
-        lean_r.joints[JOINT_SHOULDER_L].x += 0.01f;
-        lean_r.joints[JOINT_SHOULDER_R].x += 0.01f;
-        add_pose(d, lean_r);
-    }
-    
-    /* Sixth pass: Arms forward/back variations for intense poses */
-    int after_lean = d->num_poses;
-    for (int i = 0; i < after_lean && d->num_poses < MAX_POSES - 10; i++) {
-        const Pose *base = &d->poses[i];
-        if (base->category < POSE_CAT_INTENSE) continue;
-        if (i % 6 != 0) continue;
-        
-        Pose punch = *base;
-        snprintf(punch.name, sizeof(punch.name), "%s_pn", base->name);
-        /* Extend one arm forward */
-        punch.joints[JOINT_HAND_L].y -= 0.03f;
-        punch.joints[JOINT_ELBOW_L].y -= 0.02f;
-        add_pose(d, punch);
-    }
-}
-
 /* ============ Audio Analysis ============ */
 
 static void update_beat_detector(BeatDetector *bd, float energy, float dt) {
@@ -2073,23 +232,32 @@ static void add_to_history(SkeletonDancer *d, int pose_idx) {
     d->history_idx = (d->history_idx + 1) % POSE_HISTORY;
 }
 
+static bool pose_not_recent(int pose_idx, void *user) {
+    return !pose_in_history((const SkeletonDancer *)user, pose_idx);
+}
+
+static float clamp01(float v) {
+    return v < 0.0f ? 0.0f : v > 1.0f ? 1.0f : v;
+}
+
+/* Best match in a category for what the music is doing now, skipping poses
+ * danced recently. The target is jittered a little so steady input still
+ * moves through neighbouring poses. */
 static int select_pose_from_category(SkeletonDancer *d, PoseCategory cat) {
-    if (d->category_counts[cat] == 0) return 0;
+    if (pose_library_count(d->library, cat) == 0) return 0;
     
-    /* Try to find a pose not in recent history */
-    int attempts = 10;
-    while (attempts-- > 0) {
-        int idx = random_int(d, d->category_counts[cat]);
-        int pose_idx = d->poses_by_category[cat][idx];
-        
-        if (!pose_in_history(d, pose_idx)) {
-            return pose_idx;
-        }
+    AudioAnalysis *a = &d->audio;
+    float energy = skeleton_dancer_get_effective_energy(d) + (random_float(d) - 0.5f) * 0.15f;
+    float bass = clamp01(a->bass_smooth) + (random_float(d) - 0.5f) * 0.3f;
+    float treble = clamp01(a->treble_smooth) + (random_float(d) - 0.5f) * 0.3f;
+    PoseFeatures target = pose_features_target(energy, bass, treble, d->dip_target, d->facing);
+    
+    int pose_idx = pose_index_nearest(d->library, cat, &target, pose_not_recent, d);
+    if (pose_idx < 0) {
+        /* Every pose in the category is recent */
+        pose_idx = pose_index_nearest(d->library, cat, &target, NULL, NULL);
     }
-    
-    /* Fall back to random */
-    int idx = random_int(d, d->category_counts[cat]);
-    return d->poses_by_category[cat][idx];
+    return pose_idx;
 }
 
 static int select_best_pose(SkeletonDancer *d) {
@@ -2134,7 +302,7 @@ static int select_best_pose(SkeletonDancer *d) {
     switch (a->detected_style) {
         case STYLE_ELECTRONIC:
             /* Electronic/EDM -> Robot moves */
-            if (random_float(d) < easter_egg_chance && d->category_counts[POSE_CAT_ROBOT] > 0) {
+            if (random_float(d) < easter_egg_chance && pose_library_count(d->library, POSE_CAT_ROBOT) > 0) {
                 return select_pose_from_category(d, POSE_CAT_ROBOT);
             }
             break;
@@ -2142,9 +310,9 @@ static int select_best_pose(SkeletonDancer *d) {
         case STYLE_HIPHOP:
             /* Hip-hop -> Moonwalk or Breakdance */
             if (random_float(d) < easter_egg_chance) {
-                if (random_float(d) < 0.5f && d->category_counts[POSE_CAT_MOONWALK] > 0) {
+                if (random_float(d) < 0.5f && pose_library_count(d->library, POSE_CAT_MOONWALK) > 0) {
                     return select_pose_from_category(d, POSE_CAT_MOONWALK);
-                } else if (d->category_counts[POSE_CAT_BREAKDANCE] > 0) {
+                } else if (pose_library_count(d->library, POSE_CAT_BREAKDANCE) > 0) {
                     return select_pose_from_category(d, POSE_CAT_BREAKDANCE);
                 }
             }
@@ -2153,9 +321,9 @@ static int select_best_pose(SkeletonDancer *d) {
         case STYLE_CLASSICAL:
             /* Classical -> Ballet or Waltz */
             if (random_float(d) < easter_egg_chance) {
-                if (random_float(d) < 0.6f && d->category_counts[POSE_CAT_BALLET] > 0) {
+                if (random_float(d) < 0.6f && pose_library_count(d->library, POSE_CAT_BALLET) > 0) {
                     return select_pose_from_category(d, POSE_CAT_BALLET);
-                } else if (d->category_counts[POSE_CAT_WALTZ] > 0) {
+                } else if (pose_library_count(d->library, POSE_CAT_WALTZ) > 0) {
                     return select_pose_from_category(d, POSE_CAT_WALTZ);
                 }
             }
@@ -2163,14 +331,14 @@ static int select_best_pose(SkeletonDancer *d) {
             
         case STYLE_ROCK:
             /* Rock/Metal -> Headbang */
-            if (random_float(d) < easter_egg_chance && d->category_counts[POSE_CAT_HEADBANG] > 0) {
+            if (random_float(d) < easter_egg_chance && pose_library_count(d->library, POSE_CAT_HEADBANG) > 0) {
                 return select_pose_from_category(d, POSE_CAT_HEADBANG);
             }
             break;
             
         case STYLE_POP:
             /* Pop -> Moonwalk */
-            if (random_float(d) < easter_egg_chance && d->category_counts[POSE_CAT_MOONWALK] > 0) {
+            if (random_float(d) < easter_egg_chance && pose_library_count(d->library, POSE_CAT_MOONWALK) > 0) {
                 return select_pose_from_category(d, POSE_CAT_MOONWALK);
             }
             break;
@@ -2192,7 +360,7 @@ static int select_best_pose(SkeletonDancer *d) {
     int pose_idx = select_pose_from_category(d, primary_cat);
     
     /* Verify energy range */
-    const Pose *p = &d->poses[pose_idx];
+    const Pose *p = &d->library->poses[pose_idx];
     if (energy < p->energy_min || energy > p->energy_max) {
         /* Try adjacent categories */
         if (primary_cat > 0 && random_float(d) < 0.3f) {
@@ -2207,26 +375,37 @@ static int select_best_pose(SkeletonDancer *d) {
 
 /* ============ Physics Update ============ */
 
+/* Longest step the explicit spring-damper stays stable at: damping * step
+ * must stay well below 1 for the stiffest, most damped joints */
+#define PHYSICS_MAX_STEP (1.0f / 30.0f)
+
 static void update_joint_physics(JointPhysics *jp, float dt) {
-    /* Spring-damper system */
-    float dx = jp->target.x - jp->position.x;
-    float dy = jp->target.y - jp->position.y;
-    
-    /* Acceleration from spring */
-    float ax = dx * jp->stiffness;
-    float ay = dy * jp->stiffness;
-    
-    /* Apply acceleration */
-    jp->velocity.x += ax * dt;
-    jp->velocity.y += ay * dt;
-    
-    /* Apply damping */
-    jp->velocity.x *= (1.0f - jp->damping * dt);
-    jp->velocity.y *= (1.0f - jp->damping * dt);
-    
-    /* Update position */
-    jp->position.x += jp->velocity.x * dt;
-    jp->position.y += jp->velocity.y * dt;
+    /* Long frames (low frame rates, --analyze hops) run as several steps */
+    int steps = (int)ceilf(dt / PHYSICS_MAX_STEP);
+    if (steps < 1) steps = 1;
+    float h = dt / steps;
+
+    for (int s = 0; s < steps; s++) {
+        /* Spring-damper system */
+        float dx = jp->target.x - jp->position.x;
+        float dy = jp->target.y - jp->position.y;
+
+        /* Acceleration from spring */
+        float ax = dx * jp->stiffness;
+        float ay = dy * jp->stiffness;
+
+        /* Apply acceleration */
+        jp->velocity.x += ax * h;
+        jp->velocity.y += ay * h;
+
+        /* Apply damping */
+        jp->velocity.x *= (1.0f - jp->damping * h);
+        jp->velocity.y *= (1.0f - jp->damping * h);
+
+        /* Update position */
+        jp->position.x += jp->velocity.x * h;
+        jp->position.y += jp->velocity.y * h;
+    }
 }
 
 /* ============ Main Update ============ */
@@ -2278,7 +457,7 @@ void skeleton_dancer_update(SkeletonDancer *d, float bass, float mid, float treb
         if (fabsf(d->spin_momentum) < 0.05f) d->spin_momentum = 0;
     } else {
         /* Get target facing from current pose */
-        const Pose *target_pose = &d->poses[d->pose_secondary];
+        const Pose *target_pose = &d->library->poses[d->pose_secondary];
         float pose_facing = target_pose->facing;
         
         /* When not spinning, smoothly return toward pose facing */
@@ -2300,7 +479,7 @@ void skeleton_dancer_update(SkeletonDancer *d, float bass, float mid, float treb
     while (d->facing < -6.28f) { d->facing += 6.28f; d->facing_target += 6.28f; }
     
     /* v3.1: Update dip system */
-    const Pose *current_pose = &d->poses[d->pose_secondary];
+    const Pose *current_pose = &d->library->poses[d->pose_secondary];
     d->dip_target = current_pose->dip_amount;
     /* Strong bass can trigger extra dip */
     if (a->bass > 0.8f && a->bass_velocity > 4.0f) {
@@ -2343,7 +522,7 @@ void skeleton_dancer_update(SkeletonDancer *d, float bass, float mid, float treb
     if (!is_silent && effective_energy > 0.8f && d->time_in_pose > 0.3f) {
         if (random_float(d) < 0.1f) {
             /* Chance to select spin pose */
-            if (d->category_counts[POSE_CAT_SPIN] > 0) {
+            if (pose_library_count(d->library, POSE_CAT_SPIN) > 0) {
                 d->time_in_pose = 0;
                 d->pose_primary = d->pose_secondary;
                 d->pose_secondary = select_pose_from_category(d, POSE_CAT_SPIN);
@@ -2354,7 +533,7 @@ void skeleton_dancer_update(SkeletonDancer *d, float bass, float mid, float treb
             }
         } else if (random_float(d) < 0.08f && a->bass > 0.75f) {
             /* Chance to select dip pose on bass hits */
-            if (d->category_counts[POSE_CAT_DIP] > 0) {
+            if (pose_library_count(d->library, POSE_CAT_DIP) > 0) {
                 d->time_in_pose = 0;
                 d->pose_primary = d->pose_secondary;
                 d->pose_secondary = select_pose_from_category(d, POSE_CAT_DIP);
@@ -2430,8 +609,8 @@ void skeleton_dancer_update(SkeletonDancer *d, float bass, float mid, float treb
     float micro_bounce = sinf(d->time_total * 8.0f) * 0.005f * a->bass_smooth * mod_scale;
     
     /* Interpolate base pose */
-    const Pose *p1 = &d->poses[d->pose_primary];
-    const Pose *p2 = &d->poses[d->pose_secondary];
+    const Pose *p1 = &d->library->poses[d->pose_primary];
+    const Pose *p2 = &d->library->poses[d->pose_secondary];
     float eased_blend = ease_in_out_cubic(d->blend);
     
     for (int i = 0; i < JOINT_COUNT; i++) {
@@ -2538,6 +717,12 @@ void skeleton_dancer_update(SkeletonDancer *d, float bass, float mid, float treb
 
 /* ============ Rendering ============ */
 
+/* Pixel size n as drawn on the reference canvas, scaled to this one */
+static int stroke_px(const SkeletonDancer *d, int n) {
+    int v = (int)(n * d->stroke + 0.5f);
+    return v > 1 ? v : 1;
+}
+
 static void joint_to_pixel(const SkeletonDancer *d, Joint j, int *px, int *py) {
     /* v3.1: Apply facing direction (affects x scale) and dip (affects y offset) */
     float facing_scale = cosf(d->facing);  /* 1.0 when facing forward, 0 when sideways, -1 when back */
@@ -2580,10 +765,24 @@ void skeleton_dancer_render(SkeletonDancer *d, BrailleCanvas *canvas) {
                 cx += (int)(-dy / len * curve_offset);
                 cy += (int)(dx / len * curve_offset);
             }
-            braille_draw_bezier_quad(canvas, x1, y1, cx, cy, x2, y2);
+            /* Wider canvases draw the curve as parallel strokes */
+            int width = stroke_px(d, 1);
+            float nx = 0.0f, ny = 0.0f;
+            if (len > 0.001f) {
+                nx = -dy / len;
+                ny = dx / len;
+            }
+            for (int k = 0; k < width; k++) {
+                float off = k - (width - 1) * 0.5f;
+                int ox = (int)lroundf(nx * off);
+                int oy = (int)lroundf(ny * off);
+                braille_draw_bezier_quad(canvas, x1 + ox, y1 + oy, cx + ox, cy + oy,
+                                         x2 + ox, y2 + oy);
+            }
         } else {
-            if (bone->thickness > 1) {
-                braille_draw_thick_line(canvas, x1, y1, x2, y2, bone->thickness);
+            int thickness = stroke_px(d, bone->thickness);
+            if (thickness > 1) {
+                braille_draw_thick_line(canvas, x1, y1, x2, y2, thickness);
             } else {
                 braille_draw_line(canvas, x1, y1, x2, y2);
             }
@@ -2593,7 +792,7 @@ void skeleton_dancer_render(SkeletonDancer *d, BrailleCanvas *canvas) {
     /* Draw head */
     int head_x, head_y;
     joint_to_pixel(d, d->current[JOINT_HEAD], &head_x, &head_y);
-    braille_fill_circle(canvas, head_x, head_y, d->skeleton.head_radius);
+    braille_fill_circle(canvas, head_x, head_y, stroke_px(d, d->skeleton.head_radius));
     
     /* Draw torso shape - filled triangle between shoulders and hip */
     int sh_l_x, sh_l_y, sh_r_x, sh_r_y, hip_x, hip_y;
@@ -2602,28 +801,30 @@ void skeleton_dancer_render(SkeletonDancer *d, BrailleCanvas *canvas) {
     joint_to_pixel(d, d->current[JOINT_HIP_CENTER], &hip_x, &hip_y);
     
     /* Draw torso outline */
-    braille_draw_thick_line(canvas, sh_l_x, sh_l_y, sh_r_x, sh_r_y, 2);
-    braille_draw_line(canvas, sh_l_x, sh_l_y, hip_x - 3, hip_y);
-    braille_draw_line(canvas, sh_r_x, sh_r_y, hip_x + 3, hip_y);
-    braille_draw_line(canvas, hip_x - 3, hip_y, hip_x + 3, hip_y);
+    int hip_w = stroke_px(d, 3);
+    braille_draw_thick_line(canvas, sh_l_x, sh_l_y, sh_r_x, sh_r_y, stroke_px(d, 2));
+    braille_draw_line(canvas, sh_l_x, sh_l_y, hip_x - hip_w, hip_y);
+    braille_draw_line(canvas, sh_r_x, sh_r_y, hip_x + hip_w, hip_y);
+    braille_draw_line(canvas, hip_x - hip_w, hip_y, hip_x + hip_w, hip_y);
     
     /* Draw hands - slightly larger */
     int hx, hy;
+    int hand_r = stroke_px(d, 3);
     joint_to_pixel(d, d->current[JOINT_HAND_L], &hx, &hy);
-    braille_fill_circle(canvas, hx, hy, 3);
+    braille_fill_circle(canvas, hx, hy, hand_r);
     joint_to_pixel(d, d->current[JOINT_HAND_R], &hx, &hy);
-    braille_fill_circle(canvas, hx, hy, 3);
+    braille_fill_circle(canvas, hx, hy, hand_r);
     
     /* Draw feet */
     int fx, fy;
+    int foot_dy = stroke_px(d, 1);
+    int foot_rx = stroke_px(d, 4), foot_ry = stroke_px(d, 2);
     joint_to_pixel(d, d->current[JOINT_FOOT_L], &fx, &fy);
-    braille_draw_ellipse(canvas, fx, fy + 1, 4, 2);  /* Horizontal ellipse for foot */
-    braille_fill_circle(canvas, fx, fy + 1, 2);      /* Fill center */
+    braille_draw_ellipse(canvas, fx, fy + foot_dy, foot_rx, foot_ry);  /* Horizontal ellipse for foot */
+    braille_fill_circle(canvas, fx, fy + foot_dy, foot_ry);            /* Fill center */
     joint_to_pixel(d, d->current[JOINT_FOOT_R], &fx, &fy);
-    braille_draw_ellipse(canvas, fx, fy + 1, 4, 2);
-    braille_fill_circle(canvas, fx, fy + 1, 2);
-    
-    braille_canvas_render(canvas);
+    braille_draw_ellipse(canvas, fx, fy + foot_dy, foot_rx, foot_ry);
+    braille_fill_circle(canvas, fx, fy + foot_dy, foot_ry);
 }
 
 /* Get current joint positions for effects/shadows */
@@ -2633,20 +834,34 @@ const Joint* skeleton_dancer_get_joints(SkeletonDancer *d) {
 
 /* ============ Creation/Destruction ============ */
 
-SkeletonDancer* skeleton_dancer_create(int canvas_cell_width, int canvas_cell_height) {
-    SkeletonDancer *d = calloc(1, sizeof(SkeletonDancer));
-    if (!d) return NULL;
+/* Scale of the default 25x13-cell canvas, which the pixel sizes in
+ * skeleton_dancer_render are drawn for */
+#define REFERENCE_SCALE (13 * BRAILLE_CELL_H * 0.70f)
+
+void skeleton_dancer_set_canvas_size(SkeletonDancer *d, int canvas_cell_width, int canvas_cell_height) {
+    if (!d) return;
     
     d->canvas_width = canvas_cell_width * BRAILLE_CELL_W;
     d->canvas_height = canvas_cell_height * BRAILLE_CELL_H;
     
-    /* Scale to fit with more headroom at top */
+    /* One scale for both axes, so the dancer keeps its proportions on any
+     * canvas; fit to the narrower side with more headroom at top */
     float scale_x = d->canvas_width * 0.75f;
     float scale_y = d->canvas_height * 0.70f;  /* Smaller to leave room */
     d->scale = (scale_x < scale_y) ? scale_x : scale_y;
+    d->stroke = d->scale / REFERENCE_SCALE;
     
+    /* Centered; a width-limited dancer moves down to keep its feet where a
+     * full-height one's would be */
     d->offset_x = d->canvas_width / 2.0f;
-    d->offset_y = d->canvas_height * 0.18f;  /* More offset from top for head room */
+    d->offset_y = d->canvas_height * 0.18f + (scale_y - d->scale);
+}
+
+SkeletonDancer* skeleton_dancer_create(int canvas_cell_width, int canvas_cell_height) {
+    SkeletonDancer *d = calloc(1, sizeof(SkeletonDancer));
+    if (!d) return NULL;
+    
+    skeleton_dancer_set_canvas_size(d, canvas_cell_width, canvas_cell_height);
     
     /* Initialize random state */
     d->random_state = 12345;
@@ -2654,8 +869,8 @@ SkeletonDancer* skeleton_dancer_create(int canvas_cell_width, int canvas_cell_he
     /* Setup skeleton */
     setup_humanoid_skeleton(&d->skeleton);
     
-    /* Add all poses */
-    add_all_poses(d);
+    /* Built-in pose library, generated at build time */
+    d->library = &pose_library_builtin;
     
     /* Initialize pose history */
     for (int i = 0; i < POSE_HISTORY; i++) {
@@ -2670,12 +885,12 @@ SkeletonDancer* skeleton_dancer_create(int canvas_cell_width, int canvas_cell_he
     
     /* Initialize physics */
     for (int i = 0; i < JOINT_COUNT; i++) {
-        d->physics[i].position = d->poses[0].joints[i];
-        d->physics[i].target = d->poses[0].joints[i];
+        d->physics[i].position = d->library->poses[0].joints[i];
+        d->physics[i].target = d->library->poses[0].joints[i];
         d->physics[i].velocity = (Joint){0, 0};
         d->physics[i].stiffness = 15.0f;
         d->physics[i].damping = 8.0f;
-        d->current[i] = d->poses[0].joints[i];
+        d->current[i] = d->library->poses[0].joints[i];
     }
     
     /* Initialize beat detector */
@@ -2701,6 +916,22 @@ void skeleton_dancer_destroy(SkeletonDancer *d) {
     free(d);
 }
 
+void skeleton_dancer_set_library(SkeletonDancer *d, const PoseLibrary *lib) {
+    if (!d) return;
+    
+    d->library = lib ? lib : &pose_library_builtin;
+    
+    /* Old indices mean nothing in the new library; joint physics carries
+     * the body over to its first pose */
+    for (int i = 0; i < POSE_HISTORY; i++) {
+        d->pose_history[i] = -1;
+    }
+    d->pose_primary = 0;
+    d->pose_secondary = 0;
+    d->blend = 1.0f;
+    d->time_in_pose = 0.0f;
+}
+
 /* ============ Rhythm-Aware Update (v2.3) ============ */
 
 void skeleton_dancer_update_with_phase(SkeletonDancer *d, 
@@ -2903,8 +1134,8 @@ void skeleton_dancer_update_with_phase(SkeletonDancer *d,
     float knee_pump = beat_bounce * 0.04f * bass_intensity * mod_scale;
     
     /* Interpolate base pose */
-    const Pose *p1 = &d->poses[d->pose_primary];
-    const Pose *p2 = &d->poses[d->pose_secondary];
+    const Pose *p1 = &d->library->poses[d->pose_primary];
+    const Pose *p2 = &d->library->poses[d->pose_secondary];
     float eased_blend = ease_in_out_cubic(d->blend);
     
     for (int i = 0; i < JOINT_COUNT; i++) {
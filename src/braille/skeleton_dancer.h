@@ -15,10 +15,11 @@
 
 #include "braille_canvas.h"
 #include <stdbool.h>
+#include <stdint.h>
 
 #define MAX_JOINTS 16
 #define MAX_BONES 20
-#define MAX_POSES 1200
+#define MAX_POSES 1200          /* Cap on the built-in library (pose_gen) */
 #define POSE_HISTORY 24
 
 /* Joint IDs for humanoid skeleton */
@@ -102,6 +103,32 @@ typedef struct {
     float dip_amount;       /* v3.1: How much the body dips down (0-1) */
 } Pose;
 
+struct PoseFeatures;
+
+/* Read-only pose library: the poses plus an index grouping them by category.
+ * Category c owns by_category[category_start[c] .. category_start[c + 1]).
+ * features[i] is the feature vector of pose by_category[i] (pose_index.h). */
+typedef struct {
+    const Pose *poses;
+    int num_poses;
+    const uint32_t *by_category;
+    const struct PoseFeatures *features;
+    int category_start[POSE_CAT_COUNT + 1];
+} PoseLibrary;
+
+/* Built-in library, emitted at build time by src/tools/pose_gen.c */
+extern const PoseLibrary pose_library_builtin;
+
+/* Number of poses in a category */
+static inline int pose_library_count(const PoseLibrary *lib, PoseCategory cat) {
+    return lib->category_start[cat + 1] - lib->category_start[cat];
+}
+
+/* Library index of the i-th pose of a category */
+static inline int pose_library_at(const PoseLibrary *lib, PoseCategory cat, int i) {
+    return (int)lib->by_category[lib->category_start[cat] + i];
+}
+
 /* Skeleton definition */
 typedef struct {
     Bone bones[MAX_BONES];
@@ -217,11 +244,8 @@ typedef struct {
     /* Audio analysis */
     AudioAnalysis audio;
     
-    /* Pose library */
-    Pose poses[MAX_POSES];
-    int num_poses;
-    int poses_by_category[POSE_CAT_COUNT][MAX_POSES];
-    int category_counts[POSE_CAT_COUNT];
+    /* Pose library (shared, read-only) */
+    const PoseLibrary *library;
     
     /* Skeleton definition */
     SkeletonDef skeleton;
@@ -232,6 +256,7 @@ typedef struct {
     float scale;
     float offset_x;
     float offset_y;
+    float stroke;           /* Line widths and radii relative to a 25x13-cell canvas */
     
     /* Random seed for variation */
     unsigned int random_state;
@@ -249,6 +274,14 @@ typedef struct {
 SkeletonDancer* skeleton_dancer_create(int canvas_cell_width, int canvas_cell_height);
 void skeleton_dancer_destroy(SkeletonDancer *dancer);
 
+/* Refit the skeleton to a new canvas size, keeping the animation state */
+void skeleton_dancer_set_canvas_size(SkeletonDancer *dancer, int canvas_cell_width, int canvas_cell_height);
+
+/* ============ Pose Library (v3.2+) ============ */
+/* Switch to another library (NULL = built-in); the dancer keeps a pointer, so
+ * lib must outlive it. Restarts pose selection from the library's first pose. */
+void skeleton_dancer_set_library(SkeletonDancer *dancer, const PoseLibrary *lib);
+
 /* ============ Animation ============ */
 void skeleton_dancer_update(SkeletonDancer *dancer, 
                             float bass, float mid, float treble,
@@ -256,6 +289,7 @@ void skeleton_dancer_update(SkeletonDancer *dancer,
 void skeleton_dancer_update_with_phase(SkeletonDancer *dancer, float bass, float mid, float treble, float dt, float beat_phase, float bpm);
 
 /* ============ Rendering ============ */
+/* Draw the figure into an open canvas frame; the caller finalizes it */
 void skeleton_dancer_render(SkeletonDancer *dancer, BrailleCanvas *canvas);
 
 /* ============ Accessors ============ */
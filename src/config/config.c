@@ -56,6 +56,8 @@ void config_init(Config *cfg) {
     strncpy(cfg->audio_source, "auto", sizeof(cfg->audio_source) - 1);
     cfg->sample_rate = 44100;
     cfg->use_pipewire = 1;
+    cfg->fft_planner = 1;
+    cfg->analysis_hop = 512;
     
     /* Visual settings */
     cfg->theme = THEME_DEFAULT;
@@ -66,11 +68,16 @@ void config_init(Config *cfg) {
     /* Terminal settings */
     cfg->target_fps = 60;
     cfg->auto_scale = 1;
+    cfg->adaptive_quality = 0;
+    cfg->diff_output = 1;
     
     /* Animation settings */
     cfg->smoothing = 0.8f;
     cfg->energy_decay = 0.95f;
     
+    /* Export settings */
+    cfg->record_asciicast = 1;
+    
     /* Debug */
     cfg->debug_mode = 0;
 }
@@ -176,6 +183,14 @@ int config_load(Config *cfg, const char *path) {
                 cfg->sample_rate = atoi(value);
             } else if (strcmp(key, "use_pipewire") == 0) {
                 cfg->use_pipewire = (strcmp(value, "true") == 0 || strcmp(value, "1") == 0);
+            } else if (strcmp(key, "fft_planner") == 0) {
+                if (strcasecmp(value, "estimate") == 0) cfg->fft_planner = 0;
+                else if (strcasecmp(value, "patient") == 0) cfg->fft_planner = 2;
+                else cfg->fft_planner = 1;
+            } else if (strcmp(key, "analysis_hop") == 0) {
+                cfg->analysis_hop = atoi(value);
+                if (cfg->analysis_hop < 64) cfg->analysis_hop = 64;
+                if (cfg->analysis_hop > 8192) cfg->analysis_hop = 8192;
             }
         } else if (strcmp(section, "visual") == 0) {
             if (strcmp(key, "theme") == 0) {
@@ -186,18 +201,33 @@ int config_load(Config *cfg, const char *path) {
                 cfg->show_ground = (strcmp(value, "true") == 0 || strcmp(value, "1") == 0);
             } else if (strcmp(key, "show_shadow") == 0) {
                 cfg->show_shadow = (strcmp(value, "true") == 0 || strcmp(value, "1") == 0);
+            } else if (strcmp(key, "particle_pool") == 0) {
+                cfg->particle_pool = atoi(value);
+                if (cfg->particle_pool < 0) cfg->particle_pool = 0;
             }
         } else if (strcmp(section, "terminal") == 0) {
             if (strcmp(key, "fps") == 0) {
                 cfg->target_fps = atoi(value);
             } else if (strcmp(key, "auto_scale") == 0) {
                 cfg->auto_scale = (strcmp(value, "true") == 0 || strcmp(value, "1") == 0);
+            } else if (strcmp(key, "adaptive_quality") == 0) {
+                cfg->adaptive_quality = (strcmp(value, "true") == 0 || strcmp(value, "1") == 0);
+            } else if (strcmp(key, "diff_output") == 0) {
+                cfg->diff_output = (strcmp(value, "true") == 0 || strcmp(value, "1") == 0);
             }
         } else if (strcmp(section, "animation") == 0) {
             if (strcmp(key, "smoothing") == 0) {
                 cfg->smoothing = (float)atof(value);
             } else if (strcmp(key, "energy_decay") == 0) {
                 cfg->energy_decay = (float)atof(value);
+            } else if (strcmp(key, "pose_pack") == 0) {
+                strncpy(cfg->pose_pack, value, sizeof(cfg->pose_pack) - 1);
+            } else if (strcmp(key, "seed") == 0) {
+                cfg->seed = strtoull(value, NULL, 0);
+            }
+        } else if (strcmp(section, "export") == 0) {
+            if (strcmp(key, "asciicast") == 0) {
+                cfg->record_asciicast = (strcmp(value, "true") == 0 || strcmp(value, "1") == 0);
             }
         } else if (strcmp(section, "debug") == 0) {
             if (strcmp(key, "enabled") == 0) {
@@ -231,21 +261,32 @@ static int config_save(const Config *cfg, const char *path) {
     fprintf(f, "[audio]\n");
     fprintf(f, "source = %s\n", cfg->audio_source);
     fprintf(f, "sample_rate = %d\n", cfg->sample_rate);
-    fprintf(f, "use_pipewire = %s\n\n", cfg->use_pipewire ? "true" : "false");
+    fprintf(f, "use_pipewire = %s\n", cfg->use_pipewire ? "true" : "false");
+    fprintf(f, "fft_planner = %s\n", cfg->fft_planner == 0 ? "estimate" :
+                                      cfg->fft_planner == 2 ? "patient" : "measure");
+    fprintf(f, "analysis_hop = %d\n\n", cfg->analysis_hop);
     
     fprintf(f, "[visual]\n");
     fprintf(f, "theme = %s\n", config_theme_name(cfg->theme));
     fprintf(f, "sensitivity = %.2f\n", cfg->sensitivity);
     fprintf(f, "show_ground = %s\n", cfg->show_ground ? "true" : "false");
-    fprintf(f, "show_shadow = %s\n\n", cfg->show_shadow ? "true" : "false");
+    fprintf(f, "show_shadow = %s\n", cfg->show_shadow ? "true" : "false");
+    fprintf(f, "particle_pool = %d\n\n", cfg->particle_pool);
     
     fprintf(f, "[terminal]\n");
     fprintf(f, "fps = %d\n", cfg->target_fps);
-    fprintf(f, "auto_scale = %s\n\n", cfg->auto_scale ? "true" : "false");
+    fprintf(f, "auto_scale = %s\n", cfg->auto_scale ? "true" : "false");
+    fprintf(f, "adaptive_quality = %s\n", cfg->adaptive_quality ? "true" : "false");
+    fprintf(f, "diff_output = %s\n\n", cfg->diff_output ? "true" : "false");
     
     fprintf(f, "[animation]\n");
     fprintf(f, "smoothing = %.2f\n", cfg->smoothing);
-    fprintf(f, "energy_decay = %.2f\n\n", cfg->energy_decay);
+    fprintf(f, "energy_decay = %.2f\n", cfg->energy_decay);
+    fprintf(f, "pose_pack = %s\n", cfg->pose_pack);
+    fprintf(f, "seed = %llu\n\n", cfg->seed);
+    
+    fprintf(f, "[export]\n");
+    fprintf(f, "asciicast = %s\n\n", cfg->record_asciicast ? "true" : "false");
     
     fprintf(f, "[debug]\n");
     fprintf(f, "enabled = %s\n", cfg->debug_mode ? "true" : "false");
@@ -31,20 +31,30 @@ typedef struct {
     char audio_source[256];
     int sample_rate;
     int use_pipewire;       /* 1 = PipeWire, 0 = PulseAudio */
+    int fft_planner;        /* 0 = estimate, 1 = measure, 2 = patient */
+    int analysis_hop;       /* Frames per analysis step */
     
     /* Visual settings */
     ColorTheme theme;
     float sensitivity;
     int show_ground;
     int show_shadow;
+    int particle_pool;      /* Particles for all effects; 0 = from canvas area */
     
     /* Terminal settings */
     int target_fps;
     int auto_scale;
+    int adaptive_quality;   /* Lower effect quality when over frame budget */
+    int diff_output;        /* Redraw only changed dancer cells */
     
     /* Animation settings */
     float smoothing;
     float energy_decay;
+    char pose_pack[256];    /* Pose pack file; empty = built-in poses */
+    unsigned long long seed; /* Effects randomness; 0 = new each run */
+    
+    /* Export settings */
+    int record_asciicast;   /* Write an asciicast v2 file with each recording */
     
     /* Debug */
     int debug_mode;
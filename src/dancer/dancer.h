@@ -5,6 +5,9 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <wchar.h>
 
 // Frame dimensions
 #define FRAME_WIDTH 25
@@ -26,6 +29,40 @@ void dancer_compose_frame(struct dancer_state *state, char *output);
 void calculate_bands(const double *cava_out, int num_bars, double *bass, double *mid, double *treble);
 void dancer_cleanup(void);
 
+// Canvas size in terminal cells (default FRAME_WIDTH x FRAME_HEIGHT).
+// compose_frame output must then hold cells_h * (cells_w * 3 + 1) + 1 bytes.
+int dancer_set_canvas_size(int cells_w, int cells_h);
+
+// Retained frame (v3.2+): dancer_render_frame() rasterizes once per frame into
+// the dancer's canvas; the dancer, its shadow and the recorder then all read
+// the same cells. dancer_compose_frame() renders and encodes to UTF-8.
+// Each frame is one braille_canvas_begin()/finalize() pair around every layer.
+typedef struct {
+    int width;               // Cells per row
+    int height;              // Rows
+    const wchar_t *cells;    // width * height braille characters, row-major
+    unsigned long seq;       // Frames rendered so far
+    unsigned long double_finalizes;  // Canvas finalized twice in a frame; stays 0
+} DancerFrame;
+
+void dancer_render_frame(struct dancer_state *state);
+const DancerFrame* dancer_get_frame(void);  // NULL until a frame is rendered
+
+static inline const wchar_t* dancer_frame_row(const DancerFrame *frame, int row) {
+    return frame->cells + (size_t)row * frame->width;
+}
+
+// Pose pack (v3.2+): dance a pose pack file (see braille/pose_pack.h) instead
+// of the built-in poses; NULL or "" switches back. The pack stays mapped until
+// replaced or dancer_cleanup(). Returns -1 and sets *error if it cannot load.
+int dancer_set_pose_pack(const char *path, const char **error);
+
+// Frame timing (v3.2+): measured seconds per frame used by all dancer updates
+void dancer_set_frame_dt(float dt);
+
+// Adaptive quality (v3.2+): FRAME_QUALITY_* level from ui/frame_scheduler.h
+void dancer_set_quality(int level);
+
 // Effects control (v2.2)
 void dancer_set_particles(bool enabled);
 void dancer_set_trails(bool enabled);
@@ -37,6 +74,14 @@ bool dancer_get_breathing(void);
 
 int dancer_get_particle_count(void);
 
+// Particle pool (v3.2+): total particles shared by the dancer and background
+// effects; 0 sizes it from the canvas area. Kept across canvas resizes.
+void dancer_set_particle_pool(int size);
+
+// Effects seed (v3.2+): the same seed and audio give the same particles and
+// shake. Kept across canvas resizes; 0 until set.
+void dancer_set_seed(uint64_t seed);
+
 // Rhythm-aware update (v2.3) - pass beat phase and BPM for tighter sync
 void dancer_update_with_rhythm(struct dancer_state *state,
                                double bass, double mid, double treble,
@@ -11,6 +11,10 @@
 #define M_PI 3.14159265358979323846
 #endif
 
+/* Canvas area (pixels) the screen-filling effects were tuned for, the
+ * default 25x13 cell dancer canvas */
+#define BG_REFERENCE_AREA (50.0f * 52.0f)
+
 /* Forward declarations for static generator functions */
 static void background_fx_generate_ambient(BackgroundFX *fx);
 static void background_fx_generate_wave(BackgroundFX *fx, float energy);
@@ -22,9 +26,17 @@ static void background_fx_generate_vortex(BackgroundFX *fx);
 
 /* ============ Private Helpers ============ */
 
+/* Screen-filling effects spawn in proportion to canvas area, so a big
+ * terminal is as dense as the default canvas */
+static float area_scale(const BackgroundFX *fx) {
+    float area = (float)fx->particles->canvas_width * fx->particles->canvas_height;
+    return area > BG_REFERENCE_AREA ? area / BG_REFERENCE_AREA : 1.0f;
+}
+
 /* Create emitter config for ambient particles */
 static EmitterConfig create_ambient_config(float x, float y, float intensity) {
     EmitterConfig config = {0};
+    config.owner = PARTICLE_OWNER_BACKGROUND;
     config.x = x;
     config.y = y;
     config.pattern = SPAWN_BURST;
@@ -46,6 +58,7 @@ static EmitterConfig create_ambient_config(float x, float y, float intensity) {
 /* Create emitter config for wave particles */
 static EmitterConfig create_wave_config(float x, float y, float band_idx, float energy) {
     EmitterConfig config = {0};
+    config.owner = PARTICLE_OWNER_BACKGROUND;
     config.x = x;
     config.y = y;
     config.pattern = SPAWN_FOUNTAIN;
@@ -80,6 +93,7 @@ static EmitterConfig create_wave_config(float x, float y, float band_idx, float
 /* Create emitter config for aura particles */
 static EmitterConfig create_aura_config(float x, float y, float energy) {
     EmitterConfig config = {0};
+    config.owner = PARTICLE_OWNER_BACKGROUND;
     config.x = x;
     config.y = y;
     config.pattern = SPAWN_BURST;
@@ -115,6 +129,7 @@ BackgroundFX* background_fx_create(ParticleSystem *particles) {
     fx->enabled = true;
     fx->intensity = 0.8f;
     fx->speed = 1.0f;
+    background_fx_seed(fx, 0);
     
     /* Initialize defaults - increased for visibility */
     fx->ambient.particle_count = 50;
@@ -150,6 +165,10 @@ void background_fx_destroy(BackgroundFX *fx) {
     }
 }
 
+void background_fx_seed(BackgroundFX *fx, uint64_t seed) {
+    if (fx) rng_seed(&fx->rng, seed, RNG_STREAM_BACKGROUND);
+}
+
 void background_fx_enable(BackgroundFX *fx, bool enabled) {
     if (fx) fx->enabled = enabled;
 }
@@ -269,12 +288,12 @@ static void background_fx_generate_ambient(BackgroundFX *fx) {
     
     /* Spawn a few ambient particles per frame */
     static float spawn_accumulator = 0.0f;
-    spawn_accumulator += fx->dt * fx->ambient.twinkle_rate;
+    spawn_accumulator += fx->dt * fx->ambient.twinkle_rate * area_scale(fx);
     
     while (spawn_accumulator >= 1.0f) {
         /* Random position across screen */
-        float x = (float)(rand() % fx->particles->canvas_width);
-        float y = (float)(rand() % fx->particles->canvas_height);
+        float x = (float)rng_int(&fx->rng, fx->particles->canvas_width);
+        float y = (float)rng_int(&fx->rng, fx->particles->canvas_height);
         
         EmitterConfig config = create_ambient_config(x, y, fx->intensity);
         particles_spawn(fx->particles, &config, 1);
@@ -300,7 +319,7 @@ static void background_fx_generate_wave(BackgroundFX *fx, float energy __attribu
         
         /* Wave amplitude affects spawn rate */
         float spawn_chance = band_energy * fx->intensity * fx->dt * 10.0f;
-        if ((float)rand() / RAND_MAX < spawn_chance) {
+        if (rng_float(&fx->rng) < spawn_chance) {
             EmitterConfig config = create_wave_config(x, y, (float)i, band_energy);
             particles_spawn(fx->particles, &config, 2);
         }
@@ -333,12 +352,28 @@ static void background_fx_generate_aura(BackgroundFX *fx, float energy) {
 static void background_fx_generate_burst(BackgroundFX *fx, float energy) {
     if (!fx || !fx->particles) return;
     
-    /* Explosion at dancer position */
-    /* count removed - unused */
-    particles_emit_beat_burst(fx->particles, 
-                             (float)fx->aura.dancer_x,
-                             (float)fx->aura.dancer_y,
-                             energy * fx->intensity);
+    /* Explosion at dancer position: the dancer's beat burst preset, drawn
+     * from the background budget */
+    float intensity = energy * fx->intensity;
+    EmitterConfig config = {0};
+    config.owner = PARTICLE_OWNER_BACKGROUND;
+    config.x = (float)fx->aura.dancer_x;
+    config.y = (float)fx->aura.dancer_y;
+    config.pattern = SPAWN_EXPLOSION;
+    config.type = PARTICLE_SPARK;
+    config.min_speed = 40.0f * intensity;
+    config.max_speed = 80.0f * intensity;
+    config.spread_angle = M_PI * 2;
+    config.min_life = 0.2f;
+    config.max_life = 0.5f;
+    config.size_min = 1.0f;
+    config.size_max = 2.0f;
+    config.gravity = 80.0f;
+    config.drag = 0.94f;
+    config.fade_out = true;
+    config.shrink = true;
+    
+    particles_spawn(fx->particles, &config, (int)(4 + intensity * 12));
 }
 
 static void background_fx_generate_ribbons(BackgroundFX *fx) {
@@ -358,8 +393,8 @@ static void background_fx_generate_ribbons(BackgroundFX *fx) {
         
         /* Spawn particles along the bar */
         float spawn_chance = height * fx->intensity * fx->dt * 15.0f;
-        if ((float)rand() / RAND_MAX < spawn_chance) {
-            float y = fx->particles->canvas_height - (float)(rand() % (bar_height + 1));
+        if (rng_float(&fx->rng) < spawn_chance) {
+            float y = fx->particles->canvas_height - (float)rng_int(&fx->rng, bar_height + 1);
             
             EmitterConfig config = create_wave_config(x, y, (float)i, height);
             config.min_speed = 1.0f;
@@ -378,13 +413,14 @@ static void background_fx_generate_rain(BackgroundFX *fx) {
     static float rain_timer = 0.0f;
     rain_timer += fx->dt;
     
-    float spawn_interval = 1.0f / (fx->rain.spawn_rate * fx->intensity);
+    float spawn_interval = 1.0f / (fx->rain.spawn_rate * fx->intensity * area_scale(fx));
     
     if (rain_timer >= spawn_interval) {
-        float x = (float)(rand() % fx->particles->canvas_width);
+        float x = (float)rng_int(&fx->rng, fx->particles->canvas_width);
         float y = 0.0f;
         
         EmitterConfig config = {0};
+        config.owner = PARTICLE_OWNER_BACKGROUND;
         config.x = x;
         config.y = y;
         config.pattern = SPAWN_POINT;
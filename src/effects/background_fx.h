@@ -95,6 +95,8 @@ typedef struct {
     double current_time;
     float dt;
     
+    Rng rng;                /* Spawn positions and chances */
+    
 } BackgroundFX;
 
 /* ============ Lifecycle ============ */
@@ -105,6 +107,9 @@ BackgroundFX* background_fx_create(ParticleSystem *particles);
 /* Destroy system */
 void background_fx_destroy(BackgroundFX *fx);
 
+/* Restart randomness (seed 0 at creation) */
+void background_fx_seed(BackgroundFX *fx, uint64_t seed);
+
 /* Enable/disable effects */
 void background_fx_enable(BackgroundFX *fx, bool enabled);
 
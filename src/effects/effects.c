@@ -5,6 +5,7 @@
  */
 
 #include "effects.h"
+#include "../bench/bench_stages.h"
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
@@ -44,9 +45,24 @@ EffectsManager* effects_create(int canvas_width, int canvas_height) {
     fx->enhancements.shake_amount = 0;
     fx->enhancements.shake_decay = 0.8f;
     
+    rng_seed(&fx->rng, 0, RNG_STREAM_EFFECTS);
     return fx;
 }
 
+void effects_set_canvas_size(EffectsManager *fx, int canvas_width, int canvas_height) {
+    if (!fx) return;
+    fx->canvas_width = canvas_width;
+    fx->canvas_height = canvas_height;
+    fx->enhancements.floor_y = canvas_height - 4;
+    particles_set_canvas_size(fx->particles, canvas_width, canvas_height);
+}
+
+void effects_seed(EffectsManager *fx, uint64_t seed) {
+    if (!fx) return;
+    rng_seed(&fx->rng, seed, RNG_STREAM_EFFECTS);
+    particles_seed(fx->particles, seed);
+}
+
 void effects_destroy(EffectsManager *fx) {
     if (!fx) return;
     
@@ -60,7 +76,9 @@ void effects_update(EffectsManager *fx, float dt, float bass __attribute__((unus
     
     /* Update particles */
     if (fx->particles) {
+        BENCH_STAGE_BEGIN(BENCH_STAGE_PARTICLES_UPDATE);
         particles_update(fx->particles, dt);
+        BENCH_STAGE_END(BENCH_STAGE_PARTICLES_UPDATE);
     }
     
     /* Update breathing animation */
@@ -97,8 +115,8 @@ void effects_update(EffectsManager *fx, float dt, float bass __attribute__((unus
         fx->enhancements.shake_amount *= fx->enhancements.shake_decay;
         
         if (fx->enhancements.shake_amount > 0.1f) {
-            fx->enhancements.shake_offset_x = (int)((((float)rand() / RAND_MAX) - 0.5f) * fx->enhancements.shake_amount * 2);
-            fx->enhancements.shake_offset_y = (int)((((float)rand() / RAND_MAX) - 0.5f) * fx->enhancements.shake_amount * 2);
+            fx->enhancements.shake_offset_x = (int)((rng_float(&fx->rng) - 0.5f) * fx->enhancements.shake_amount * 2);
+            fx->enhancements.shake_offset_y = (int)((rng_float(&fx->rng) - 0.5f) * fx->enhancements.shake_amount * 2);
         } else {
             fx->enhancements.shake_offset_x = 0;
             fx->enhancements.shake_offset_y = 0;
@@ -50,6 +50,7 @@ typedef struct {
     ParticleSystem *particles;
     MotionTrails *trails;
     VisualEnhancements enhancements;
+    Rng rng;                    /* Shake and dancer-side randomness */
     
     /* Canvas dimensions */
     int canvas_width;
@@ -63,6 +64,12 @@ typedef struct {
 EffectsManager* effects_create(int canvas_width, int canvas_height);
 void effects_destroy(EffectsManager *fx);
 
+/* Resize for a new canvas (pixels); particles and trails are kept */
+void effects_set_canvas_size(EffectsManager *fx, int canvas_width, int canvas_height);
+
+/* Seed this manager and its particle system (both start at seed 0) */
+void effects_seed(EffectsManager *fx, uint64_t seed);
+
 /* Update all effects */
 void effects_update(EffectsManager *fx, float dt, float bass, float treble, float energy);
 
@@ -84,7 +91,7 @@ int effects_get_floor_offset(EffectsManager *fx);
 /* Get screen shake */
 void effects_get_shake_offset(EffectsManager *fx, int *dx, int *dy);
 
-/* Render all effects to canvas */
+/* Draw all effects into an open canvas frame; not finalized here */
 void effects_render(EffectsManager *fx, BrailleCanvas *canvas);
 
 /* Control */
@@ -0,0 +1,209 @@
+/*
+ * Particle Step Kernels Implementation
+ */
+
+#include <math.h>
+#include "particle_step.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define PARTICLE_X86 1
+#include <immintrin.h>
+#endif
+
+/* Closer than this to the body center has no direction to push along */
+#define BODY_MIN_DIST 0.1f
+
+/* ============ Scalar reference ============ */
+
+static void step_scalar(ParticleArrays *p, const ParticleStep *s) {
+    for (int i = 0; i < p->count; i++) {
+        float life = p->lifetime[i] - s->life_dt;
+
+        /* Gravity, drag, then move */
+        float vx = p->vx[i] * s->drag;
+        float vy = (p->vy[i] + p->ay[i] * s->dt) * s->drag;
+        float x = p->x[i] + vx * s->dt;
+        float y = p->y[i] + vy * s->dt;
+
+        /* Push away from the body, strongly when inside it and gently
+         * near it */
+        if (s->body) {
+            float dx = x - s->body_x;
+            float dy = y - s->body_y;
+            float dist = sqrtf(dx * dx + dy * dy);
+            if (dist < s->push_radius && dist > BODY_MIN_DIST) {
+                float push_factor = (s->body_radius - dist) / s->body_radius;
+                vx += (dx / dist) * s->repel * push_factor;
+                vy += (dy / dist) * s->repel * push_factor;
+            }
+            if (dist > BODY_MIN_DIST && dist < s->drift_radius) {
+                vx += (dx / dist) * s->drift;
+                vy += (dy / dist) * s->drift;
+            }
+        }
+
+        if (x < s->min_x || x > s->max_x || y < s->min_y || y > s->max_y) {
+            life = 0.0f;
+        }
+
+        p->lifetime[i] = life;
+        p->vx[i] = vx;
+        p->vy[i] = vy;
+        p->x[i] = x;
+        p->y[i] = y;
+    }
+}
+
+static const ParticleStepper stepper_scalar = {
+    .name = "scalar",
+    .step = step_scalar,
+};
+
+#ifdef PARTICLE_X86
+
+/* ============ SSE2: 4 particles per iteration ============ */
+
+/* Masked terms are added as +0, which leaves the velocity unchanged */
+__attribute__((target("sse2")))
+static void step_sse2(ParticleArrays *p, const ParticleStep *s) {
+    const __m128 dt = _mm_set1_ps(s->dt);
+    const __m128 life_dt = _mm_set1_ps(s->life_dt);
+    const __m128 drag = _mm_set1_ps(s->drag);
+    const __m128 body_x = _mm_set1_ps(s->body_x);
+    const __m128 body_y = _mm_set1_ps(s->body_y);
+    const __m128 radius = _mm_set1_ps(s->body_radius);
+    const __m128 push_radius = _mm_set1_ps(s->push_radius);
+    const __m128 drift_radius = _mm_set1_ps(s->drift_radius);
+    const __m128 min_dist = _mm_set1_ps(BODY_MIN_DIST);
+    const __m128 repel = _mm_set1_ps(s->repel);
+    const __m128 drift = _mm_set1_ps(s->drift);
+    const __m128 min_x = _mm_set1_ps(s->min_x), max_x = _mm_set1_ps(s->max_x);
+    const __m128 min_y = _mm_set1_ps(s->min_y), max_y = _mm_set1_ps(s->max_y);
+
+    for (int i = 0; i < p->count; i += 4) {
+        __m128 life = _mm_sub_ps(_mm_load_ps(p->lifetime + i), life_dt);
+        __m128 vx = _mm_mul_ps(_mm_load_ps(p->vx + i), drag);
+        __m128 vy = _mm_mul_ps(_mm_add_ps(_mm_load_ps(p->vy + i),
+                                          _mm_mul_ps(_mm_load_ps(p->ay + i), dt)), drag);
+        __m128 x = _mm_add_ps(_mm_load_ps(p->x + i), _mm_mul_ps(vx, dt));
+        __m128 y = _mm_add_ps(_mm_load_ps(p->y + i), _mm_mul_ps(vy, dt));
+
+        if (s->body) {
+            __m128 dx = _mm_sub_ps(x, body_x);
+            __m128 dy = _mm_sub_ps(y, body_y);
+            __m128 dist = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+            __m128 ux = _mm_div_ps(dx, dist);
+            __m128 uy = _mm_div_ps(dy, dist);
+            __m128 away = _mm_cmpgt_ps(dist, min_dist);
+
+            __m128 push = _mm_and_ps(away, _mm_cmplt_ps(dist, push_radius));
+            __m128 push_factor = _mm_div_ps(_mm_sub_ps(radius, dist), radius);
+            vx = _mm_add_ps(vx, _mm_and_ps(push, _mm_mul_ps(_mm_mul_ps(ux, repel), push_factor)));
+            vy = _mm_add_ps(vy, _mm_and_ps(push, _mm_mul_ps(_mm_mul_ps(uy, repel), push_factor)));
+
+            __m128 near = _mm_and_ps(away, _mm_cmplt_ps(dist, drift_radius));
+            vx = _mm_add_ps(vx, _mm_and_ps(near, _mm_mul_ps(ux, drift)));
+            vy = _mm_add_ps(vy, _mm_and_ps(near, _mm_mul_ps(uy, drift)));
+        }
+
+        __m128 out = _mm_or_ps(_mm_or_ps(_mm_cmplt_ps(x, min_x), _mm_cmpgt_ps(x, max_x)),
+                               _mm_or_ps(_mm_cmplt_ps(y, min_y), _mm_cmpgt_ps(y, max_y)));
+        _mm_store_ps(p->lifetime + i, _mm_andnot_ps(out, life));
+        _mm_store_ps(p->vx + i, vx);
+        _mm_store_ps(p->vy + i, vy);
+        _mm_store_ps(p->x + i, x);
+        _mm_store_ps(p->y + i, y);
+    }
+}
+
+static const ParticleStepper stepper_sse2 = {
+    .name = "sse2",
+    .step = step_sse2,
+};
+
+/* ============ AVX: 8 particles per iteration ============ */
+
+__attribute__((target("avx")))
+static void step_avx(ParticleArrays *p, const ParticleStep *s) {
+    const __m256 dt = _mm256_set1_ps(s->dt);
+    const __m256 life_dt = _mm256_set1_ps(s->life_dt);
+    const __m256 drag = _mm256_set1_ps(s->drag);
+    const __m256 body_x = _mm256_set1_ps(s->body_x);
+    const __m256 body_y = _mm256_set1_ps(s->body_y);
+    const __m256 radius = _mm256_set1_ps(s->body_radius);
+    const __m256 push_radius = _mm256_set1_ps(s->push_radius);
+    const __m256 drift_radius = _mm256_set1_ps(s->drift_radius);
+    const __m256 min_dist = _mm256_set1_ps(BODY_MIN_DIST);
+    const __m256 repel = _mm256_set1_ps(s->repel);
+    const __m256 drift = _mm256_set1_ps(s->drift);
+    const __m256 min_x = _mm256_set1_ps(s->min_x), max_x = _mm256_set1_ps(s->max_x);
+    const __m256 min_y = _mm256_set1_ps(s->min_y), max_y = _mm256_set1_ps(s->max_y);
+
+    for (int i = 0; i < p->count; i += 8) {
+        __m256 life = _mm256_sub_ps(_mm256_load_ps(p->lifetime + i), life_dt);
+        __m256 vx = _mm256_mul_ps(_mm256_load_ps(p->vx + i), drag);
+        __m256 vy = _mm256_mul_ps(_mm256_add_ps(_mm256_load_ps(p->vy + i),
+                                                _mm256_mul_ps(_mm256_load_ps(p->ay + i), dt)), drag);
+        __m256 x = _mm256_add_ps(_mm256_load_ps(p->x + i), _mm256_mul_ps(vx, dt));
+        __m256 y = _mm256_add_ps(_mm256_load_ps(p->y + i), _mm256_mul_ps(vy, dt));
+
+        if (s->body) {
+            __m256 dx = _mm256_sub_ps(x, body_x);
+            __m256 dy = _mm256_sub_ps(y, body_y);
+            __m256 dist = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)));
+            __m256 ux = _mm256_div_ps(dx, dist);
+            __m256 uy = _mm256_div_ps(dy, dist);
+            __m256 away = _mm256_cmp_ps(dist, min_dist, _CMP_GT_OQ);
+
+            __m256 push = _mm256_and_ps(away, _mm256_cmp_ps(dist, push_radius, _CMP_LT_OQ));
+            __m256 push_factor = _mm256_div_ps(_mm256_sub_ps(radius, dist), radius);
+            vx = _mm256_add_ps(vx, _mm256_and_ps(push, _mm256_mul_ps(_mm256_mul_ps(ux, repel), push_factor)));
+            vy = _mm256_add_ps(vy, _mm256_and_ps(push, _mm256_mul_ps(_mm256_mul_ps(uy, repel), push_factor)));
+
+            __m256 near = _mm256_and_ps(away, _mm256_cmp_ps(dist, drift_radius, _CMP_LT_OQ));
+            vx = _mm256_add_ps(vx, _mm256_and_ps(near, _mm256_mul_ps(ux, drift)));
+            vy = _mm256_add_ps(vy, _mm256_and_ps(near, _mm256_mul_ps(uy, drift)));
+        }
+
+        __m256 out = _mm256_or_ps(
+            _mm256_or_ps(_mm256_cmp_ps(x, min_x, _CMP_LT_OQ), _mm256_cmp_ps(x, max_x, _CMP_GT_OQ)),
+            _mm256_or_ps(_mm256_cmp_ps(y, min_y, _CMP_LT_OQ), _mm256_cmp_ps(y, max_y, _CMP_GT_OQ)));
+        _mm256_store_ps(p->lifetime + i, _mm256_andnot_ps(out, life));
+        _mm256_store_ps(p->vx + i, vx);
+        _mm256_store_ps(p->vy + i, vy);
+        _mm256_store_ps(p->x + i, x);
+        _mm256_store_ps(p->y + i, y);
+    }
+}
+
+static const ParticleStepper stepper_avx = {
+    .name = "avx",
+    .step = step_avx,
+};
+
+#endif /* PARTICLE_X86 */
+
+/* ============ Selection ============ */
+
+const ParticleStepper* particle_stepper_get(ParticleISA isa) {
+    switch (isa) {
+        case PARTICLE_ISA_SCALAR:
+            return &stepper_scalar;
+#ifdef PARTICLE_X86
+        case PARTICLE_ISA_SSE2:
+            return __builtin_cpu_supports("sse2") ? &stepper_sse2 : NULL;
+        case PARTICLE_ISA_AVX:
+            return __builtin_cpu_supports("avx") ? &stepper_avx : NULL;
+#endif
+        default:
+            return NULL;
+    }
+}
+
+const ParticleStepper* particle_stepper_select(void) {
+    for (int isa = PARTICLE_ISA_COUNT - 1; isa > PARTICLE_ISA_SCALAR; isa--) {
+        const ParticleStepper *st = particle_stepper_get((ParticleISA)isa);
+        if (st) return st;
+    }
+    return &stepper_scalar;
+}
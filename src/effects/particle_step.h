@@ -0,0 +1,72 @@
+/*
+ * Particle Step Kernels - ASCII Dancer v3.2+
+ *
+ * One physics step over the live particles of a ParticleSystem, kept as a
+ * structure of arrays. The scalar kernel is the reference; the SSE2 and AVX
+ * kernels do 4 and 8 particles per instruction with the same operations in
+ * the same order, so they give the same floats, and one is picked per
+ * system for the running CPU.
+ */
+
+#ifndef PARTICLE_STEP_H
+#define PARTICLE_STEP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Arrays are aligned and padded to this many floats, so kernels run whole
+ * vectors past count without a scalar tail */
+#define PARTICLE_LANES 8
+
+/* Live particles: particle i is x[i], y[i], ... for i < count. Dead ones are
+ * swap-removed, so [0, count) is always dense. */
+typedef struct {
+    float *x, *y;           /* Position */
+    float *vx, *vy;         /* Velocity */
+    float *ay;              /* Vertical acceleration (emitter gravity) */
+    float *lifetime;        /* Remaining life (seconds); <= 0 once dead */
+    float *max_life;        /* Initial lifetime */
+    uint8_t *type;          /* ParticleType */
+    int count;
+    int capacity;           /* Multiple of PARTICLE_LANES */
+} ParticleArrays;
+
+/* Per-step constants, derived from the system once per update */
+typedef struct {
+    float dt;
+    float life_dt;          /* dt scaled by the silence fade multiplier */
+    float drag;             /* Velocity multiplier per step */
+    bool body;              /* Apply body repulsion below */
+    float body_x, body_y;
+    float body_radius;
+    float push_radius;      /* Strong push inside this distance */
+    float drift_radius;     /* Gentle drift inside this distance (0: off) */
+    float repel;            /* Push strength */
+    float drift;            /* Drift per step */
+    float min_x, max_x;     /* Particles outside these bounds die */
+    float min_y, max_y;
+} ParticleStep;
+
+typedef enum {
+    PARTICLE_ISA_SCALAR,
+    PARTICLE_ISA_SSE2,
+    PARTICLE_ISA_AVX,
+    PARTICLE_ISA_COUNT
+} ParticleISA;
+
+typedef struct {
+    const char *name;
+
+    /* Age, integrate and repel particles [0, count); particles that run out
+     * of life or leave the bounds end with lifetime <= 0. May also touch the
+     * padding after count. */
+    void (*step)(ParticleArrays *p, const ParticleStep *s);
+} ParticleStepper;
+
+/* Fastest kernel supported by the running CPU */
+const ParticleStepper* particle_stepper_select(void);
+
+/* Specific kernel, or NULL if not compiled in / not supported by this CPU */
+const ParticleStepper* particle_stepper_get(ParticleISA isa);
+
+#endif /* PARTICLE_STEP_H */
@@ -4,30 +4,81 @@
 
 #include "particles.h"
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
 #include <math.h>
-#include <time.h>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
-/* Random float between 0 and 1 */
-static float randf(void) {
-    return (float)rand() / (float)RAND_MAX;
+/* Spawns draw their random numbers in bulk, this many particles at a time */
+#define SPAWN_CHUNK 64
+#define SPAWN_DRAWS 6       /* Random numbers per particle */
+
+/* Point t (0-1) of the way from min to max */
+static float lerpf(float min, float max, float t) {
+    return min + t * (max - min);
 }
 
-/* Random float in range */
-static float randf_range(float min, float max) {
-    return min + randf() * (max - min);
+/* Move the live arrays to one zeroed block of the given capacity, each
+ * array 32-byte aligned, keeping the live particles */
+static bool resize_arrays(ParticleSystem *ps, int capacity) {
+    size_t n = (size_t)(capacity + PARTICLE_LANES - 1) / PARTICLE_LANES * PARTICLE_LANES;
+    size_t floats = n * sizeof(float);
+    void *storage = calloc(1, floats * 7 + n * 2 + 31);
+    if (!storage) return false;
+    
+    char *base = (char *)(((uintptr_t)storage + 31) & ~(uintptr_t)31);
+    ParticleArrays *a = &ps->live;
+    ParticleArrays grown = {
+        .x = (float *)base,
+        .y = (float *)(base + floats),
+        .vx = (float *)(base + floats * 2),
+        .vy = (float *)(base + floats * 3),
+        .ay = (float *)(base + floats * 4),
+        .lifetime = (float *)(base + floats * 5),
+        .max_life = (float *)(base + floats * 6),
+        .type = (uint8_t *)(base + floats * 7),
+        .count = a->count,
+        .capacity = (int)n,
+    };
+    uint8_t *owner = (uint8_t *)(base + floats * 7 + n);
+    
+    if (a->count > 0) {
+        size_t live = (size_t)a->count * sizeof(float);
+        memcpy(grown.x, a->x, live);
+        memcpy(grown.y, a->y, live);
+        memcpy(grown.vx, a->vx, live);
+        memcpy(grown.vy, a->vy, live);
+        memcpy(grown.ay, a->ay, live);
+        memcpy(grown.lifetime, a->lifetime, live);
+        memcpy(grown.max_life, a->max_life, live);
+        memcpy(grown.type, a->type, (size_t)a->count);
+        memcpy(owner, ps->owner, (size_t)a->count);
+    }
+    
+    free(ps->storage);
+    ps->storage = storage;
+    ps->live = grown;
+    ps->owner = owner;
+    return true;
 }
 
 ParticleSystem* particles_create(int canvas_width, int canvas_height) {
     ParticleSystem *ps = calloc(1, sizeof(ParticleSystem));
     if (!ps) return NULL;
-    
     ps->canvas_width = canvas_width;
     ps->canvas_height = canvas_height;
+    
+    /* Start small; the arrays grow up to the pool size as effects need */
+    if (!resize_arrays(ps, PARTICLE_DANCER_BUDGET)) {
+        free(ps);
+        return NULL;
+    }
+    particles_set_pool(ps, 0);
+    ps->stepper = particle_stepper_select();
+    
     ps->world_gravity = 120.0f;  /* Pixels per second^2 */
     ps->world_drag = 0.98f;
     ps->enabled = true;
@@ -39,124 +90,211 @@ ParticleSystem* particles_create(int canvas_width, int canvas_height) {
     ps->body_radius = 8.0f;
     ps->repulsion_strength = 60.0f;  /* Default outward repulsion */
     
-    /* Particle cap for visual clarity */
-    ps->max_active = 40;  /* Reduced from 256 for cleaner visuals */
-    
     /* Normal fade speed */
     ps->fade_multiplier = 1.0f;
     
-    /* Seed random if not already */
-    static bool seeded = false;
-    if (!seeded) {
-        srand((unsigned)time(NULL));
-        seeded = true;
-    }
-    
+    particles_seed(ps, 0);
     return ps;
 }
 
 void particles_destroy(ParticleSystem *ps) {
-    if (ps) free(ps);
+    if (!ps) return;
+    free(ps->storage);
+    free(ps);
 }
 
-/* Find next available particle slot */
-static int find_slot(ParticleSystem *ps) {
-    /* Try round-robin first */
-    for (int i = 0; i < MAX_PARTICLES; i++) {
-        int idx = (ps->next_slot + i) % MAX_PARTICLES;
-        if (!ps->particles[idx].active) {
-            ps->next_slot = (idx + 1) % MAX_PARTICLES;
-            return idx;
-        }
+void particles_set_pool(ParticleSystem *ps, int pool_size) {
+    if (!ps) return;
+    
+    if (pool_size <= 0) {
+        long area = (long)ps->canvas_width * ps->canvas_height;
+        pool_size = (int)(area / PARTICLE_POOL_AREA < MAX_PARTICLES ?
+                          area / PARTICLE_POOL_AREA : MAX_PARTICLES);
     }
+    if (pool_size < PARTICLE_POOL_MIN) pool_size = PARTICLE_POOL_MIN;
+    if (pool_size > MAX_PARTICLES) pool_size = MAX_PARTICLES;
+    ps->pool_size = pool_size;
+    
+    /* Only the limits change: live particles and counters carry over, and
+     * an owner over a smaller budget spawns nothing until enough die */
+    
+    /* The dancer keeps its old cap for visual clarity: past 40 live
+     * particles only a quarter of each spawn goes ahead */
+    ParticleBudget *dancer = &ps->budgets[PARTICLE_OWNER_DANCER];
+    dancer->budget = PARTICLE_DANCER_BUDGET;
+    dancer->soft_limit = 40;
+    
+    /* Background effects get the rest and thin out in the last quarter */
+    ParticleBudget *bg = &ps->budgets[PARTICLE_OWNER_BACKGROUND];
+    bg->budget = pool_size - PARTICLE_DANCER_BUDGET;
+    bg->soft_limit = bg->budget * 3 / 4;
+}
+
+void particles_set_canvas_size(ParticleSystem *ps, int canvas_width, int canvas_height) {
+    if (!ps) return;
+    ps->canvas_width = canvas_width;
+    ps->canvas_height = canvas_height;
     
-    /* All full - overwrite oldest (round-robin position) */
-    int idx = ps->next_slot;
-    ps->next_slot = (ps->next_slot + 1) % MAX_PARTICLES;
-    return idx;
+    /* Pull live particles that are now off-canvas in to the nearest edge */
+    ParticleArrays *a = &ps->live;
+    float max_x = (float)(canvas_width - 1);
+    float max_y = (float)(canvas_height - 1);
+    for (int i = 0; i < a->count; i++) {
+        if (a->x[i] > max_x) a->x[i] = max_x;
+        else if (a->x[i] < 0.0f) a->x[i] = 0.0f;
+        if (a->y[i] > max_y) a->y[i] = max_y;
+        else if (a->y[i] < 0.0f) a->y[i] = 0.0f;
+    }
+}
+
+void particles_seed(ParticleSystem *ps, uint64_t seed) {
+    if (!ps) return;
+    rng_seed(&ps->rng, seed, RNG_STREAM_PARTICLES);
+}
+
+const ParticleBudget* particles_get_budget(const ParticleSystem *ps, ParticleOwner owner) {
+    if (!ps || (unsigned)owner >= PARTICLE_OWNER_COUNT) return NULL;
+    return &ps->budgets[owner];
+}
+
+/* How many of count spawns an owner may add now. Past the soft limit a
+ * quarter go ahead, with the fraction carried to later calls so that
+ * single-particle emitters still spawn every fourth call; nothing goes
+ * past the budget. The rest are counted as dropped. */
+static int budget_allow(ParticleBudget *b, int count) {
+    int allowed = count;
+    if (b->live >= b->soft_limit) {
+        b->lod_credit += count * 0.25f;
+        allowed = (int)b->lod_credit;
+        b->lod_credit -= (float)allowed;
+    }
+    if (allowed > b->budget - b->live) allowed = b->budget - b->live;
+    if (allowed < 0) allowed = 0;
+    b->dropped += count - allowed;
+    return allowed;
+}
+
+/* Slot for a new particle at the end of the live range, growing the
+ * arrays (doubling, up to the pool size) when full; -1 if out of room */
+static int find_slot(ParticleSystem *ps) {
+    ParticleArrays *a = &ps->live;
+    if (a->count == a->capacity) {
+        int grown = a->capacity * 2 < ps->pool_size ? a->capacity * 2 : ps->pool_size;
+        if (grown <= a->capacity || !resize_arrays(ps, grown)) return -1;
+    }
+    return a->count++;
+}
+
+/* Swap-remove particle i: the last live particle takes its slot */
+static void remove_particle(ParticleSystem *ps, int i) {
+    ParticleArrays *a = &ps->live;
+    ps->budgets[ps->owner[i]].live--;
+    int last = --a->count;
+    ps->owner[i] = ps->owner[last];
+    a->x[i] = a->x[last];
+    a->y[i] = a->y[last];
+    a->vx[i] = a->vx[last];
+    a->vy[i] = a->vy[last];
+    a->ay[i] = a->ay[last];
+    a->lifetime[i] = a->lifetime[last];
+    a->max_life[i] = a->max_life[last];
+    a->type[i] = a->type[last];
 }
 
 void particles_spawn(ParticleSystem *ps, const EmitterConfig *config, int count) {
     if (!ps || !ps->enabled || !config) return;
     
-    /* Cap spawning if we're at max active particles */
-    if (ps->active_count >= ps->max_active) {
-        count = count / 4;  /* Drastically reduce spawns when full */
-        if (count < 1) return;
-    }
+    if ((unsigned)config->owner >= PARTICLE_OWNER_COUNT || count < 1) return;
+    
+    /* Thin out or drop spawns past the owner's budget */
+    ParticleBudget *budget = &ps->budgets[config->owner];
+    count = budget_allow(budget, count);
     
+    ParticleArrays *a = &ps->live;
+    float draws[SPAWN_CHUNK * SPAWN_DRAWS];
     for (int i = 0; i < count; i++) {
         int idx = find_slot(ps);
-        Particle *p = &ps->particles[idx];
+        if (idx < 0) {
+            budget->dropped += count - i;
+            break;
+        }
+        
+        /* u[0]: dead-center push, u[1]: speed, u[2]: angle,
+         * u[3], u[4]: position, u[5]: lifetime */
+        int k = i % SPAWN_CHUNK;
+        if (k == 0) {
+            int n = count - i < SPAWN_CHUNK ? count - i : SPAWN_CHUNK;
+            rng_fill(&ps->rng, draws, n * SPAWN_DRAWS);
+        }
+        const float *u = draws + k * SPAWN_DRAWS;
         
         /* Position */
-        p->x = config->x;
-        p->y = config->y;
+        float x = config->x;
+        float y = config->y;
         
         /* Body mask check - nudge spawn point outward if too close to body */
         if (ps->body_mask_enabled) {
-            float dx = p->x - ps->body_center_x;
-            float dy = p->y - ps->body_center_y;
+            float dx = x - ps->body_center_x;
+            float dy = y - ps->body_center_y;
             float dist = sqrtf(dx * dx + dy * dy);
             
             /* If within body exclusion zone, push outward */
             if (dist < ps->body_radius && dist > 0.1f) {
                 float push = (ps->body_radius - dist) + 3.0f;
-                p->x += (dx / dist) * push;
-                p->y += (dy / dist) * push;
+                x += (dx / dist) * push;
+                y += (dy / dist) * push;
             } else if (dist < 0.1f) {
                 /* Dead center - push in random direction */
-                float angle = randf() * 2.0f * M_PI;
-                p->x += cosf(angle) * (ps->body_radius + 3.0f);
-                p->y += sinf(angle) * (ps->body_radius + 3.0f);
+                float angle = u[0] * 2.0f * M_PI;
+                x += cosf(angle) * (ps->body_radius + 3.0f);
+                y += sinf(angle) * (ps->body_radius + 3.0f);
             }
         }
         
         /* Velocity based on pattern */
         float angle, speed;
-        speed = randf_range(config->min_speed, config->max_speed);
+        speed = lerpf(config->min_speed, config->max_speed, u[1]);
         
         switch (config->pattern) {
             case SPAWN_BURST:
             case SPAWN_EXPLOSION:
-                angle = randf() * 2.0f * M_PI;
+                angle = u[2] * 2.0f * M_PI;
                 break;
             case SPAWN_FOUNTAIN:
-                angle = -M_PI/2 + randf_range(-config->spread_angle/2, config->spread_angle/2);
+                angle = -M_PI/2 + lerpf(-config->spread_angle/2, config->spread_angle/2, u[2]);
                 break;
             case SPAWN_RAIN:
-                angle = M_PI/2 + randf_range(-0.2f, 0.2f);
-                p->y = 0;
-                p->x = randf() * ps->canvas_width;
+                angle = M_PI/2 + lerpf(-0.2f, 0.2f, u[2]);
+                y = 0;
+                x = u[3] * ps->canvas_width;
                 break;
             case SPAWN_SPARKLE:
-                angle = randf() * 2.0f * M_PI;
-                p->x += randf_range(-10, 10);
-                p->y += randf_range(-10, 10);
+                angle = u[2] * 2.0f * M_PI;
+                x += lerpf(-10, 10, u[3]);
+                y += lerpf(-10, 10, u[4]);
                 speed *= 0.3f;
                 break;
             default: /* SPAWN_POINT */
-                angle = config->base_angle + randf_range(-config->spread_angle/2, config->spread_angle/2);
+                angle = config->base_angle + lerpf(-config->spread_angle/2, config->spread_angle/2, u[2]);
                 break;
         }
         
-        p->vx = cosf(angle) * speed;
-        p->vy = sinf(angle) * speed;
-        p->ax = 0;
-        p->ay = config->gravity;
+        a->x[idx] = x;
+        a->y[idx] = y;
+        a->vx[idx] = cosf(angle) * speed;
+        a->vy[idx] = sinf(angle) * speed;
+        a->ay[idx] = config->gravity;
         
         /* Lifetime */
-        p->max_life = randf_range(config->min_life, config->max_life);
-        p->lifetime = p->max_life;
+        a->max_life[idx] = lerpf(config->min_life, config->max_life, u[5]);
+        a->lifetime[idx] = a->max_life[idx];
         
-        /* Appearance */
-        p->size = randf_range(config->size_min, config->size_max);
-        p->brightness = 1.0f;
-        p->type = config->type;
-        p->color_index = config->color_base;
-        p->active = true;
+        /* Appearance (the renderer does not scale particles by size) */
+        a->type[idx] = (uint8_t)config->type;
+        ps->owner[idx] = (uint8_t)config->owner;
         
-        ps->active_count++;
+        budget->live++;
+        budget->spawned++;
         ps->total_spawned++;
     }
 }
@@ -369,104 +507,65 @@ void particles_emit_music_notes(ParticleSystem *ps, float x, float y, float inte
 void particles_update(ParticleSystem *ps, float dt) {
     if (!ps || !ps->enabled) return;
     
-    ps->active_count = 0;
-    
-    /* Apply fade multiplier to dt for faster clearing */
-    float effective_dt = dt * ps->fade_multiplier;
-    
-    for (int i = 0; i < MAX_PARTICLES; i++) {
-        Particle *p = &ps->particles[i];
-        if (!p->active) continue;
-        
-        /* Update lifetime (faster when fade_multiplier > 1) */
-        p->lifetime -= effective_dt;
-        if (p->lifetime <= 0) {
-            p->active = false;
-            ps->total_died++;
-            continue;
-        }
-        
-        /* Fade and shrink based on remaining life */
-        float life_ratio = p->lifetime / p->max_life;
-        p->brightness = life_ratio;
-        
-        /* Apply acceleration (gravity) */
-        p->vy += p->ay * dt;
-        p->vx += p->ax * dt;
-        
-        /* Apply drag */
-        p->vx *= ps->world_drag;
-        p->vy *= ps->world_drag;
-        
-        /* Update position */
-        p->x += p->vx * dt;
-        p->y += p->vy * dt;
-        
-        /* Body mask check during movement - push particles away from body */
-        if (ps->body_mask_enabled) {
-            float dx = p->x - ps->body_center_x;
-            float dy = p->y - ps->body_center_y;
-            float dist = sqrtf(dx * dx + dy * dy);
-            
-            if (dist < ps->body_radius * 0.9f && dist > 0.1f) {
-                /* Push outward with repulsion force */
-                float repel = ps->repulsion_strength > 0 ? ps->repulsion_strength : 50.0f;
-                float push_factor = (ps->body_radius - dist) / ps->body_radius;
-                p->vx += (dx / dist) * repel * push_factor;
-                p->vy += (dy / dist) * repel * push_factor;
-            }
-        }
-        
-        /* Apply outward bias even outside body mask (v2.4) */
-        if (ps->repulsion_strength > 0 && ps->body_mask_enabled) {
-            float dx = p->x - ps->body_center_x;
-            float dy = p->y - ps->body_center_y;
-            float dist = sqrtf(dx * dx + dy * dy);
-            
-            if (dist > 0.1f && dist < ps->body_radius * 2.0f) {
-                /* Gentle outward drift */
-                float drift = ps->repulsion_strength * 0.1f * dt;
-                p->vx += (dx / dist) * drift;
-                p->vy += (dy / dist) * drift;
-            }
-        }
-        
+    ParticleStep step = {
+        .dt = dt,
+        /* Apply fade multiplier to dt for faster clearing */
+        .life_dt = dt * ps->fade_multiplier,
+        .drag = ps->world_drag,
+        /* Body mask - push particles away from body, plus an outward bias
+         * even outside it (v2.4) */
+        .body = ps->body_mask_enabled,
+        .body_x = ps->body_center_x,
+        .body_y = ps->body_center_y,
+        .body_radius = ps->body_radius,
+        .push_radius = ps->body_radius * 0.9f,
+        .drift_radius = ps->repulsion_strength > 0 ? ps->body_radius * 2.0f : 0.0f,
+        .repel = ps->repulsion_strength > 0 ? ps->repulsion_strength : 50.0f,
+        .drift = ps->repulsion_strength * 0.1f * dt,
         /* Bounds check - deactivate if off screen */
-        if (p->x < -10 || p->x > ps->canvas_width + 10 ||
-            p->y < -10 || p->y > ps->canvas_height + 10) {
-            p->active = false;
-            ps->total_died++;
+        .min_x = -10,
+        .max_x = ps->canvas_width + 10,
+        .min_y = -10,
+        .max_y = ps->canvas_height + 10,
+    };
+    ps->stepper->step(&ps->live, &step);
+    
+    /* Drop particles that ran out of life or left the screen */
+    ParticleArrays *a = &ps->live;
+    for (int i = 0; i < a->count; ) {
+        if (a->lifetime[i] > 0) {
+            i++;
             continue;
         }
-        
-        ps->active_count++;
+        remove_particle(ps, i);
+        ps->total_died++;
     }
 }
 
 void particles_render(ParticleSystem *ps, BrailleCanvas *canvas) {
     if (!ps || !ps->enabled || !canvas) return;
     
-    for (int i = 0; i < MAX_PARTICLES; i++) {
-        const Particle *p = &ps->particles[i];
-        if (!p->active) continue;
-        
-        int px = (int)(p->x + 0.5f);
-        int py = (int)(p->y + 0.5f);
+    const ParticleArrays *a = &ps->live;
+    for (int i = 0; i < a->count; i++) {
+        float x = a->x[i], y = a->y[i];
+        int px = (int)(x + 0.5f);
+        int py = (int)(y + 0.5f);
         
         /* Skip if brightness too low */
-        if (p->brightness < 0.1f) continue;
+        float brightness = a->lifetime[i] / a->max_life[i];
+        if (brightness < 0.1f) continue;
         
         /* Body mask check - don't render particles that would obscure the character */
         if (ps->body_mask_enabled) {
-            float dx = p->x - ps->body_center_x;
-            float dy = p->y - ps->body_center_y;
+            float dx = x - ps->body_center_x;
+            float dy = y - ps->body_center_y;
             float dist = sqrtf(dx * dx + dy * dy);
             
             /* Skip rendering if inside body exclusion zone */
             if (dist < ps->body_radius * 0.8f) continue;
         }
         
-        switch (p->type) {
+        switch ((ParticleType)a->type[i]) {
             case PARTICLE_SPARK:
                 /* Single bright pixel */
                 braille_set_pixel(canvas, px, py, true);
@@ -475,7 +574,7 @@ void particles_render(ParticleSystem *ps, BrailleCanvas *canvas) {
             case PARTICLE_DOT:
                 /* 2x2 dot for larger effect */
                 braille_set_pixel(canvas, px, py, true);
-                if (p->brightness > 0.5f) {
+                if (brightness > 0.5f) {
                     braille_set_pixel(canvas, px + 1, py, true);
                     braille_set_pixel(canvas, px, py + 1, true);
                 }
@@ -484,9 +583,9 @@ void particles_render(ParticleSystem *ps, BrailleCanvas *canvas) {
             case PARTICLE_TRAIL:
                 /* Single pixel with velocity trail */
                 braille_set_pixel(canvas, px, py, true);
-                if (p->brightness > 0.3f) {
-                    int tx = px - (int)(p->vx * 0.02f);
-                    int ty = py - (int)(p->vy * 0.02f);
+                if (brightness > 0.3f) {
+                    int tx = px - (int)(a->vx[i] * 0.02f);
+                    int ty = py - (int)(a->vy[i] * 0.02f);
                     braille_draw_line(canvas, px, py, tx, ty);
                 }
                 break;
@@ -494,7 +593,7 @@ void particles_render(ParticleSystem *ps, BrailleCanvas *canvas) {
             case PARTICLE_STAR:
                 /* 5-pixel star pattern */
                 braille_set_pixel(canvas, px, py, true);
-                if (p->brightness > 0.5f) {
+                if (brightness > 0.5f) {
                     braille_set_pixel(canvas, px - 1, py, true);
                     braille_set_pixel(canvas, px + 1, py, true);
                     braille_set_pixel(canvas, px, py - 1, true);
@@ -514,7 +613,7 @@ void particles_render(ParticleSystem *ps, BrailleCanvas *canvas) {
                 braille_set_pixel(canvas, px + 1, py - 2, true);
                 braille_set_pixel(canvas, px + 1, py - 3, true);
                 /* Flag at top */
-                if (p->brightness > 0.4f) {
+                if (brightness > 0.4f) {
                     braille_set_pixel(canvas, px + 2, py - 2, true);
                     braille_set_pixel(canvas, px + 2, py - 3, true);
                 }
@@ -526,11 +625,10 @@ void particles_render(ParticleSystem *ps, BrailleCanvas *canvas) {
 void particles_clear(ParticleSystem *ps) {
     if (!ps) return;
     
-    for (int i = 0; i < MAX_PARTICLES; i++) {
-        ps->particles[i].active = false;
+    ps->live.count = 0;
+    for (int o = 0; o < PARTICLE_OWNER_COUNT; o++) {
+        ps->budgets[o].live = 0;
     }
-    ps->active_count = 0;
-    ps->next_slot = 0;
 }
 
 void particles_set_enabled(ParticleSystem *ps, bool enabled) {
@@ -542,7 +640,7 @@ bool particles_is_enabled(ParticleSystem *ps) {
 }
 
 int particles_get_active_count(ParticleSystem *ps) {
-    return ps ? ps->active_count : 0;
+    return ps ? ps->live.count : 0;
 }
 
 void particles_set_body_mask(ParticleSystem *ps, float center_x, float center_y __attribute__((unused)),
@@ -574,7 +672,8 @@ void particles_emit_controlled(ParticleSystem *ps,
     if (!ps || !ps->enabled) return;
     
     /* Don't spawn if at particle cap */
-    if (ps->active_count >= ps->max_active) return;
+    const ParticleBudget *dancer = &ps->budgets[PARTICLE_OWNER_DANCER];
+    if (dancer->live >= dancer->soft_limit) return;
     
     /* Count scales with onset + energy */
     int count = (int)(onset * 6.0f + energy * 4.0f);
@@ -6,6 +6,16 @@
  * - Physics simulation (velocity, gravity, drag)
  * - Lifetime and fade out
  * - Configurable spawn patterns
+ *
+ * Live particles are stored as a structure of arrays and kept dense with
+ * swap-remove, so spawning is O(1) and update/render touch only live
+ * particles; the physics step is vectorized (particle_step.h).
+ *
+ * The pool is sized at runtime (config or canvas area) and its arrays grow
+ * on demand up to that size. The dancer's emitters and BackgroundFX draw on
+ * separate budgets, so dense background effects cannot crowd out bass-hit
+ * bursts; spawns past a budget's soft limit thin out, and spawns lost that
+ * way or to the hard limit are counted per budget.
  */
 
 #ifndef PARTICLES_H
@@ -13,9 +23,19 @@
 
 #include <stdbool.h>
 #include "../braille/braille_canvas.h"
+#include "particle_step.h"
+#include "rng.h"
 
-/* Maximum particles in system */
-#define MAX_PARTICLES 256
+/* Largest pool; the pool size itself is set at runtime */
+#define MAX_PARTICLES 32768
+
+/* Reserved for the dancer's own emitters (the old fixed pool size) */
+#define PARTICLE_DANCER_BUDGET 256
+
+/* Automatic pool: one particle per this many canvas pixels, at least
+ * PARTICLE_POOL_MIN */
+#define PARTICLE_POOL_AREA 16
+#define PARTICLE_POOL_MIN 512
 
 /* Particle spawn patterns */
 typedef enum {
@@ -27,6 +47,22 @@ typedef enum {
     SPAWN_SPARKLE       /* Random sparkles around point */
 } SpawnPattern;
 
+/* Who spawned a particle; each owner has its own budget */
+typedef enum {
+    PARTICLE_OWNER_DANCER,      /* Bass hits, bursts, stomps (default) */
+    PARTICLE_OWNER_BACKGROUND,  /* BackgroundFX */
+    PARTICLE_OWNER_COUNT
+} ParticleOwner;
+
+typedef struct {
+    int live;
+    int soft_limit;         /* Past this, a quarter of each spawn goes ahead */
+    int budget;             /* Hard limit on live particles */
+    float lod_credit;       /* Fractional spawns carried between calls */
+    long spawned;
+    long dropped;           /* Spawns lost to the soft or hard limit */
+} ParticleBudget;
+
 /* Particle types affect rendering */
 typedef enum {
     PARTICLE_SPARK,     /* Single bright pixel */
@@ -36,20 +72,6 @@ typedef enum {
     PARTICLE_NOTE       /* Music note shape */
 } ParticleType;
 
-/* Individual particle */
-typedef struct {
-    float x, y;         /* Position */
-    float vx, vy;       /* Velocity */
-    float ax, ay;       /* Acceleration (for custom forces) */
-    float lifetime;     /* Remaining life (0-1) */
-    float max_life;     /* Initial lifetime */
-    float size;         /* Size multiplier */
-    float brightness;   /* 0-1, affects color intensity */
-    ParticleType type;
-    int color_index;    /* Index into color gradient */
-    bool active;
-} Particle;
-
 /* Emitter configuration */
 typedef struct {
     float x, y;             /* Emission point */
@@ -65,6 +87,7 @@ typedef struct {
     float size_max;         /* Maximum particle size */
     SpawnPattern pattern;
     ParticleType type;
+    ParticleOwner owner;    /* Budget to spawn from */
     int color_base;         /* Base color for particles */
     bool fade_out;          /* Fade brightness over lifetime */
     bool shrink;            /* Shrink size over lifetime */
@@ -72,9 +95,15 @@ typedef struct {
 
 /* Particle system state */
 typedef struct {
-    Particle particles[MAX_PARTICLES];
-    int active_count;
-    int next_slot;          /* Round-robin allocation */
+    ParticleArrays live;    /* Brightness is lifetime / max_life */
+    uint8_t *owner;         /* ParticleOwner per live particle */
+    void *storage;          /* Backs the live arrays and owner */
+    const ParticleStepper *stepper;
+    Rng rng;                /* Spawn randomness (seed 0 until reseeded) */
+    
+    /* Pool and budgets */
+    int pool_size;          /* Arrays grow up to this many particles */
+    ParticleBudget budgets[PARTICLE_OWNER_COUNT];
     
     /* Global settings */
     float world_gravity;
@@ -93,9 +122,6 @@ typedef struct {
     /* Outward repulsion from body center (v2.4) */
     float repulsion_strength;
     
-    /* Max particle cap for visual clarity */
-    int max_active;
-    
     /* Silence fade multiplier */
     float fade_multiplier;
     
@@ -127,7 +153,7 @@ void particles_emit_music_notes(ParticleSystem *ps, float x, float y, float inte
 /* Update physics */
 void particles_update(ParticleSystem *ps, float dt);
 
-/* Render to canvas */
+/* Draw into an open canvas frame (braille_canvas_begin); not finalized here */
 void particles_render(ParticleSystem *ps, BrailleCanvas *canvas);
 
 /* Control */
@@ -155,6 +181,22 @@ void particles_emit_controlled(ParticleSystem *ps,
 /* Set outward repulsion strength from body center */
 void particles_set_repulsion(ParticleSystem *ps, float strength);
 
+/* Size the pool (0: from canvas area, see PARTICLE_POOL_AREA; clamped to
+ * MAX_PARTICLES). The dancer keeps PARTICLE_DANCER_BUDGET and BackgroundFX
+ * gets the rest. Live particles and budget counters are kept. */
+void particles_set_pool(ParticleSystem *ps, int pool_size);
+
+/* New canvas bounds (pixels); live particles outside them are moved to the
+ * nearest edge. The automatic pool size is not recomputed; see
+ * particles_set_pool. */
+void particles_set_canvas_size(ParticleSystem *ps, int canvas_width, int canvas_height);
+
+/* Restart spawn randomness; the same seed gives the same particles */
+void particles_seed(ParticleSystem *ps, uint64_t seed);
+
+/* Budget state of one owner */
+const ParticleBudget* particles_get_budget(const ParticleSystem *ps, ParticleOwner owner);
+
 /* Statistics */
 int particles_get_active_count(ParticleSystem *ps);
 
@@ -0,0 +1,32 @@
+/*
+ * Effects PRNG Implementation
+ */
+
+#include "rng.h"
+
+/* splitmix64, to spread a seed over the whole state */
+static uint64_t splitmix64(uint64_t *x) {
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+void rng_seed(Rng *r, uint64_t seed, uint32_t stream) {
+    uint64_t x = seed ^ ((uint64_t)stream << 32 | stream);
+    uint64_t a = splitmix64(&x);
+    uint64_t b = splitmix64(&x);
+    r->s[0] = (uint32_t)a;
+    r->s[1] = (uint32_t)(a >> 32);
+    r->s[2] = (uint32_t)b;
+    r->s[3] = (uint32_t)(b >> 32);
+}
+
+void rng_fill(Rng *r, float *out, int n) {
+    /* State in locals so it stays in registers across the loop */
+    Rng local = *r;
+    for (int i = 0; i < n; i++) {
+        out[i] = rng_float(&local);
+    }
+    *r = local;
+}
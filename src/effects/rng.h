@@ -0,0 +1,64 @@
+/*
+ * Effects PRNG - ASCII Dancer v3.2+
+ *
+ * Small xoshiro128++ generator that each effects system embeds, instead of
+ * libc rand() and its hidden global state. Seeding a system the same way
+ * replays its effects bit for bit, independent of what else draws numbers.
+ * Systems sharing one seed pick different streams so their sequences do
+ * not line up.
+ */
+
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+typedef struct {
+    uint32_t s[4];
+} Rng;
+
+/* Streams of the effects systems, mixed into the seed */
+typedef enum {
+    RNG_STREAM_PARTICLES = 1,
+    RNG_STREAM_EFFECTS,
+    RNG_STREAM_BACKGROUND,
+} RngStream;
+
+/* Seed from a 64-bit seed and a stream; any seed, 0 included, is valid */
+void rng_seed(Rng *r, uint64_t seed, uint32_t stream);
+
+/* Fill out with n floats in [0, 1), the same as n rng_float() calls */
+void rng_fill(Rng *r, float *out, int n);
+
+static inline uint32_t rng_rotl(uint32_t x, int k) {
+    return (x << k) | (x >> (32 - k));
+}
+
+static inline uint32_t rng_next(Rng *r) {
+    uint32_t *s = r->s;
+    uint32_t result = rng_rotl(s[0] + s[3], 7) + s[0];
+    uint32_t t = s[1] << 9;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rng_rotl(s[3], 11);
+    return result;
+}
+
+/* Uniform float in [0, 1) from the top 24 bits */
+static inline float rng_float(Rng *r) {
+    return (float)(rng_next(r) >> 8) * (1.0f / 16777216.0f);
+}
+
+static inline float rng_range(Rng *r, float min, float max) {
+    return min + rng_float(r) * (max - min);
+}
+
+/* Uniform int in [0, n) for n > 0 */
+static inline int rng_int(Rng *r, int n) {
+    return (int)(((uint64_t)rng_next(r) * (uint32_t)n) >> 32);
+}
+
+#endif /* RNG_H */
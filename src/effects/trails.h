@@ -65,7 +65,7 @@ void trails_set_tracked_joints(MotionTrails *trails, const int *joint_ids, int c
 /* Update with current joint positions */
 void trails_update(MotionTrails *trails, Joint *joints, int num_joints, float dt);
 
-/* Render trails to canvas */
+/* Draw trails into an open canvas frame; not finalized here */
 void trails_render(MotionTrails *trails, BrailleCanvas *canvas);
 
 /* Control */
@@ -0,0 +1,225 @@
+/*
+ * Asciicast Writer Implementation
+ */
+
+#include "asciicast.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define ESC "\\u001b"   /* Escape character inside a JSON string */
+
+static void put(AsciicastWriter *cw, const char *s, size_t n) {
+    if (cw->len + n > cw->cap) {
+        size_t cap = cw->cap ? cw->cap * 2 : 65536;
+        while (cap < cw->len + n) cap *= 2;
+        char *grown = realloc(cw->buf, cap);
+        if (!grown) {
+            cw->failed = true;
+            return;
+        }
+        cw->buf = grown;
+        cw->cap = cap;
+    }
+    memcpy(cw->buf + cw->len, s, n);
+    cw->len += n;
+}
+
+static void puts_raw(AsciicastWriter *cw, const char *s) {
+    put(cw, s, strlen(s));
+}
+
+/* Frame text is UTF-8 from the recorder; only JSON's specials need escapes */
+static void put_text(AsciicastWriter *cw, const char *s, size_t n) {
+    size_t start = 0;
+    for (size_t i = 0; i < n; i++) {
+        unsigned char c = (unsigned char)s[i];
+        if (c != '"' && c != '\\' && c >= 0x20) continue;
+
+        put(cw, s + start, i - start);
+        char esc[8];
+        if (c == '"' || c == '\\') {
+            esc[0] = '\\';
+            esc[1] = (char)c;
+            put(cw, esc, 2);
+        } else {
+            snprintf(esc, sizeof(esc), "\\u%04x", c);
+            put(cw, esc, 6);
+        }
+        start = i + 1;
+    }
+    put(cw, s + start, n - start);
+}
+
+/* Emit the buffered event as one line */
+static void flush_event(AsciicastWriter *cw, uint64_t time_us, const char *type) {
+    if (cw->failed) return;
+    int n = fprintf(cw->file, "[%llu.%06llu, \"%s\", \"",
+                    (unsigned long long)(time_us / 1000000),
+                    (unsigned long long)(time_us % 1000000), type);
+    size_t w = fwrite(cw->buf, 1, cw->len, cw->file);
+    int e = fputs("\"]\n", cw->file);
+    if (n < 0 || w != cw->len || e < 0) {
+        cw->failed = true;
+        return;
+    }
+    cw->bytes += n + (long)w + 3;
+    cw->events++;
+    cw->last_us = time_us;
+    cw->len = 0;
+}
+
+static void write_header(AsciicastWriter *cw, int width, int height) {
+    int n = fprintf(cw->file,
+                    "{\"version\": 2, \"width\": %d, \"height\": %d, \"timestamp\": %lld, "
+                    "\"title\": \"braille-boogie\", "
+                    "\"env\": {\"TERM\": \"xterm-256color\", \"SHELL\": null}}\n",
+                    width, height, (long long)cw->timestamp);
+    if (n < 0) cw->failed = true;
+    else cw->bytes += n;
+}
+
+int asciicast_open(AsciicastWriter *cw, const char *path, time_t timestamp) {
+    memset(cw, 0, sizeof(*cw));
+    cw->path = strdup(path);
+    if (!cw->path) return -1;
+    cw->file = fopen(path, "w");
+    if (!cw->file) {
+        free(cw->path);
+        cw->path = NULL;
+        return -1;
+    }
+    setvbuf(cw->file, NULL, _IOFBF, 1 << 16);
+    cw->timestamp = timestamp;
+    return 0;
+}
+
+void asciicast_set_palette(AsciicastWriter *cw, const int16_t (*palette)[2]) {
+    cw->palette = palette;
+}
+
+/* ============ Frames ============ */
+
+/* Characters the cursor is known to advance one column over */
+static bool narrow_text(const char *s, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        unsigned char c = (unsigned char)s[i];
+        if (c < 0x80) continue;
+        /* Two-byte sequences and U+2000-U+2FFF (box drawing, braille) */
+        if (c >= 0xC0 && c < 0xE0) continue;
+        if (c == 0xE2) {
+            i += 2;
+            continue;
+        }
+        if (c >= 0x80 && c < 0xC0) continue;
+        return false;
+    }
+    return true;
+}
+
+static void move_to(AsciicastWriter *cw, int row, int col) {
+    char seq[32];
+    if (row == cw->cursor_row && col == cw->cursor_col) return;
+    if (row == cw->cursor_row && col > cw->cursor_col) {
+        snprintf(seq, sizeof(seq), ESC "[%dC", col - cw->cursor_col);
+    } else {
+        snprintf(seq, sizeof(seq), ESC "[%d;%dH", row + 1, col + 1);
+    }
+    puts_raw(cw, seq);
+}
+
+static void set_style(AsciicastWriter *cw, int16_t pair, uint16_t attr) {
+    int16_t fg = -1, bg = -1;
+    if (cw->palette && pair >= 0 && pair < FRAME_RECORDER_PAIRS) {
+        fg = cw->palette[pair][0];
+        bg = cw->palette[pair][1];
+    }
+    if (fg == cw->fg && bg == cw->bg && attr == cw->attr) return;
+
+    char seq[64];
+    int n = snprintf(seq, sizeof(seq), ESC "[0");
+    if (attr & CELL_ATTR_BOLD) n += snprintf(seq + n, sizeof(seq) - n, ";1");
+    if (attr & CELL_ATTR_DIM) n += snprintf(seq + n, sizeof(seq) - n, ";2");
+    if (fg >= 0) n += snprintf(seq + n, sizeof(seq) - n, ";38;5;%d", fg);
+    if (bg >= 0) n += snprintf(seq + n, sizeof(seq) - n, ";48;5;%d", bg);
+    snprintf(seq + n, sizeof(seq) - n, "m");
+    puts_raw(cw, seq);
+
+    cw->fg = fg;
+    cw->bg = bg;
+    cw->attr = attr;
+}
+
+/* Known terminal state after ESC[0m ESC[2J */
+static void reset_screen(AsciicastWriter *cw) {
+    puts_raw(cw, ESC "[0m" ESC "[2J");
+    cw->fg = cw->bg = -1;
+    cw->attr = 0;
+    cw->cursor_row = cw->cursor_col = -1;
+}
+
+void asciicast_frame(AsciicastWriter *cw, const void *frame, size_t size) {
+    if (!cw->file || cw->failed || size < sizeof(RecFrameHeader)) return;
+
+    RecFrameHeader fh;
+    memcpy(&fh, frame, sizeof(fh));
+
+    if (cw->width == 0) {
+        /* First frame: header, then hide the cursor and start clean */
+        write_header(cw, fh.width, fh.height);
+        puts_raw(cw, ESC "[?25l");
+        reset_screen(cw);
+    } else if (fh.width != cw->width || fh.height != cw->height) {
+        char dims[32];
+        snprintf(dims, sizeof(dims), "%dx%d", fh.width, fh.height);
+        puts_raw(cw, dims);
+        flush_event(cw, fh.time_us, "r");
+        reset_screen(cw);
+    }
+    cw->width = fh.width;
+    cw->height = fh.height;
+
+    const char *p = (const char *)frame + sizeof(fh);
+    const char *end = (const char *)frame + size;
+    for (uint32_t r = 0; r < fh.runs && p + sizeof(RecRun) <= end; r++) {
+        RecRun run;
+        memcpy(&run, p, sizeof(run));
+        p += sizeof(run);
+        if (p + run.bytes > end) break;
+
+        move_to(cw, run.row, run.col);
+        set_style(cw, run.pair, run.attr);
+        put_text(cw, p, run.bytes);
+
+        /* Where the cursor ends up is only known for single-width text */
+        if (narrow_text(p, run.bytes)) {
+            cw->cursor_row = run.row;
+            cw->cursor_col = run.col + run.len;
+        } else {
+            cw->cursor_row = cw->cursor_col = -1;
+        }
+        p += run.bytes;
+    }
+
+    /* Unchanged frames carry no event; the next one keeps its own time */
+    if (cw->len > 0) flush_event(cw, fh.time_us, "o");
+}
+
+int asciicast_close(AsciicastWriter *cw) {
+    if (!cw->file) return -1;
+
+    if (cw->width > 0) {
+        puts_raw(cw, ESC "[0m" ESC "[?25h");
+        flush_event(cw, cw->last_us, "o");
+    }
+    if (fclose(cw->file) != 0) cw->failed = true;
+    cw->file = NULL;
+
+    /* No frames means no header either; an empty file is not a recording */
+    if (cw->width == 0) remove(cw->path);
+    free(cw->path);
+    cw->path = NULL;
+    free(cw->buf);
+    cw->buf = NULL;
+    cw->len = cw->cap = 0;
+    return cw->failed ? -1 : 0;
+}
@@ -0,0 +1,70 @@
+/*
+ * Asciicast Writer - ASCII Dancer v3.2+
+ *
+ * Writes recorded frames as an asciicast v2 file that asciinema can play
+ * directly. The header carries the size of the first frame; every frame
+ * after it is one "o" event holding only the cursor moves, SGR changes and
+ * text that turn the previous frame into this one. Event times come from
+ * the frames' own timestamps, so replay follows the render loop's clock.
+ *
+ * Frames are handed over in the recorder's run encoding (frame_recorder.h),
+ * which the recorder's writer thread produces anyway.
+ */
+
+#ifndef ASCIICAST_H
+#define ASCIICAST_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "frame_recorder.h"
+
+#define ASCIICAST_EXT ".cast"
+
+typedef struct AsciicastWriter {
+    FILE *file;
+    char *path;
+    time_t timestamp;           /* Recording start, for the header */
+
+    /* Event being built (JSON-escaped) */
+    char *buf;
+    size_t len;
+    size_t cap;
+
+    /* Terminal state at the end of the last event */
+    int width;                  /* 0 until the header is written */
+    int height;
+    int cursor_row;             /* -1 when unknown */
+    int cursor_col;
+    int16_t fg, bg;             /* -1 for the terminal default */
+    uint16_t attr;              /* CELL_ATTR_* */
+    uint64_t last_us;
+
+    const int16_t (*palette)[2]; /* fg, bg per color pair; NULL for none */
+
+    long bytes;
+    long events;
+    bool failed;
+} AsciicastWriter;
+
+/* Create the file; the header follows with the first frame.
+ * Returns 0 on success, -1 on error. */
+int asciicast_open(AsciicastWriter *cw, const char *path, time_t timestamp);
+
+/* Color pairs used by later frames (FRAME_RECORDER_PAIRS entries, kept by
+ * reference) */
+void asciicast_set_palette(AsciicastWriter *cw, const int16_t (*palette)[2]);
+
+/* One frame: a RecFrameHeader and its runs, as in a REC_DELTA record. A
+ * frame of a new size must be complete (every cell in a run); it resizes
+ * the recording and redraws from a cleared screen. */
+void asciicast_frame(AsciicastWriter *cw, const void *frame, size_t size);
+
+/* Restore the terminal at the end of the recording and close the file; a
+ * recording that never got a frame is deleted rather than left empty.
+ * Returns 0 if everything was written. */
+int asciicast_close(AsciicastWriter *cw);
+
+#endif /* ASCIICAST_H */
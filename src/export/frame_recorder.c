@@ -3,12 +3,24 @@
  */
 
 #include "frame_recorder.h"
+#include "asciicast.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <errno.h>
 #include <time.h>
 #include <sys/stat.h>
-#include <ncurses.h>
+
+/* Writer sleep while the ring is empty (a frame at 60 fps is ~16 ms) */
+#define WRITER_IDLE_NS 2000000L
+
+/* Longest run; keeps run.bytes within 16 bits */
+#define REC_MAX_RUN 4096
+
+#define REC_UTF8_MAX 4
+
+/* Numbered names tried when recordings start within the same second */
+#define REC_NAME_TRIES 100
 
 /* Create output directory if it doesn't exist */
 static void ensure_directory(const char *path) {
@@ -18,19 +30,34 @@ static void ensure_directory(const char *path) {
     }
 }
 
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* Grow a slot to hold count cells; only called by the side owning it */
+static int slot_reserve(RecSlot *slot, int count) {
+    if (count <= slot->capacity) return 0;
+    Cell *grown = realloc(slot->cells, (size_t)count * sizeof(Cell));
+    if (!grown) return -1;
+    slot->cells = grown;
+    slot->capacity = count;
+    return 0;
+}
+
 FrameRecorder* frame_recorder_create(int width, int height, const char *output_dir) {
     /* Validate dimensions */
     if (width <= 0 || height <= 0) return NULL;
-    
+
     FrameRecorder *rec = calloc(1, sizeof(FrameRecorder));
     if (!rec) return NULL;
-    
+
     rec->width = width;
     rec->height = height;
     rec->recording = false;
-    rec->frame_number = 0;
     rec->total_frames = 0;
-    
+
     /* Use default directory if none provided */
     const char *dir = output_dir;
     if (!dir || dir[0] == '\0') {
@@ -45,88 +72,327 @@ FrameRecorder* frame_recorder_create(int width, int height, const char *output_d
     }
     memset(rec->output_dir, 0, sizeof(rec->output_dir));
     snprintf(rec->output_dir, sizeof(rec->output_dir), "%s", dir);
-    
-    /* Allocate frame buffer */
-    rec->frame_buffer = calloc(height, sizeof(char*));
-    if (!rec->frame_buffer) {
-        free(rec);
-        return NULL;
-    }
-    
-    for (int i = 0; i < height; i++) {
-        rec->frame_buffer[i] = calloc(width * 20, sizeof(char)); /* Allow for ANSI codes */
-        if (!rec->frame_buffer[i]) {
-            for (int j = 0; j < i; j++) free(rec->frame_buffer[j]);
-            free(rec->frame_buffer);
-            free(rec);
+
+    /* Preallocate and touch the ring so capturing neither allocates nor
+     * page faults */
+    for (int i = 0; i < FRAME_RECORDER_SLOTS; i++) {
+        if (slot_reserve(&rec->slots[i], width * height) != 0) {
+            frame_recorder_destroy(rec);
             return NULL;
         }
+        memset(rec->slots[i].cells, 0, (size_t)width * height * sizeof(Cell));
     }
-    
-    ensure_directory(rec->output_dir);
+
+    for (int p = 0; p < FRAME_RECORDER_PAIRS; p++) {
+        rec->palette[p][0] = rec->palette[p][1] = -1;
+    }
+
     return rec;
 }
 
 void frame_recorder_destroy(FrameRecorder *recorder) {
     if (!recorder) return;
-    
-    if (recorder->frame_buffer && recorder->height > 0) {
-        for (int i = 0; i < recorder->height; i++) {
-            if (recorder->frame_buffer[i]) {
-                free(recorder->frame_buffer[i]);
-                recorder->frame_buffer[i] = NULL;
+
+    if (recorder->recording) frame_recorder_stop(recorder);
+
+    for (int i = 0; i < FRAME_RECORDER_SLOTS; i++) {
+        free(recorder->slots[i].cells);
+    }
+    free(recorder->previous);
+    free(recorder->index);
+    free(recorder->scratch);
+    free(recorder);
+}
+
+/* ============ Writer thread ============ */
+
+/* Encode one character as UTF-8; returns bytes written */
+static int utf8_encode(wchar_t wc, char *out) {
+    uint32_t c = (uint32_t)wc;
+    if (wc == CELL_EMPTY) c = ' ';
+    if (c > 0x10FFFF || (c >= 0xD800 && c <= 0xDFFF)) c = 0xFFFD;
+
+    if (c < 0x80) {
+        out[0] = (char)c;
+        return 1;
+    }
+    if (c < 0x800) {
+        out[0] = (char)(0xC0 | (c >> 6));
+        out[1] = (char)(0x80 | (c & 0x3F));
+        return 2;
+    }
+    if (c < 0x10000) {
+        out[0] = (char)(0xE0 | (c >> 12));
+        out[1] = (char)(0x80 | ((c >> 6) & 0x3F));
+        out[2] = (char)(0x80 | (c & 0x3F));
+        return 3;
+    }
+    out[0] = (char)(0xF0 | (c >> 18));
+    out[1] = (char)(0x80 | ((c >> 12) & 0x3F));
+    out[2] = (char)(0x80 | ((c >> 6) & 0x3F));
+    out[3] = (char)(0x80 | (c & 0x3F));
+    return 4;
+}
+
+static bool same_cell(const Cell *a, const Cell *b) {
+    return a->ch == b->ch && a->pair == b->pair && a->attr == b->attr;
+}
+
+static void write_record(FrameRecorder *rec, RecRecordType type, const void *payload,
+                         size_t size) {
+    RecRecordHeader hdr = { .type = type, .size = (uint32_t)size };
+    if (fwrite(&hdr, sizeof(hdr), 1, rec->file) != 1 ||
+        fwrite(payload, 1, size, rec->file) != size) {
+        rec->write_failed = true;
+        return;
+    }
+    atomic_fetch_add(&rec->written_bytes, (long)(sizeof(hdr) + size));
+}
+
+/* Runs of cells that differ from the previous frame (all cells when key);
+ * returns the payload size in rec->scratch */
+static size_t encode_frame(FrameRecorder *rec, const RecSlot *slot, bool key) {
+    char *out = rec->scratch + sizeof(RecFrameHeader);
+    uint32_t runs = 0;
+    int w = slot->width;
+
+    for (int y = 0; y < slot->height; y++) {
+        const Cell *row = slot->cells + (size_t)y * w;
+        const Cell *prev = key ? NULL : rec->previous + (size_t)y * w;
+        if (prev && memcmp(row, prev, (size_t)w * sizeof(Cell)) == 0) continue;
+
+        int x = 0;
+        while (x < w) {
+            if (prev && same_cell(&row[x], &prev[x])) {
+                x++;
+                continue;
+            }
+
+            /* Changed cells in one style, up to the first unchanged one */
+            RecRun run = { .row = (uint16_t)y, .col = (uint16_t)x,
+                           .pair = row[x].pair, .attr = row[x].attr };
+            char *text = out + sizeof(RecRun);
+            char *p = text;
+            while (x < w && run.len < REC_MAX_RUN &&
+                   row[x].pair == run.pair && row[x].attr == run.attr &&
+                   (!prev || !same_cell(&row[x], &prev[x]))) {
+                p += utf8_encode(row[x].ch, p);
+                run.len++;
+                x++;
             }
+            run.bytes = (uint16_t)(p - text);
+            memcpy(out, &run, sizeof(run));
+            out = p;
+            runs++;
         }
-        free(recorder->frame_buffer);
-        recorder->frame_buffer = NULL;
     }
-    
-    free(recorder);
+
+    RecFrameHeader fh = {
+        .time_us = slot->time_us,
+        .width = (uint16_t)slot->width,
+        .height = (uint16_t)slot->height,
+        .runs = runs,
+    };
+    memcpy(rec->scratch, &fh, sizeof(fh));
+    return (size_t)(out - rec->scratch);
 }
 
-void frame_recorder_start(FrameRecorder *recorder) {
-    if (!recorder) return;
-    
-    recorder->recording = true;
-    recorder->frame_number = 0;
-    recorder->total_frames = 0;
-    recorder->start_time = (double)clock() / CLOCKS_PER_SEC;
-    
-    /* Create timestamped subdirectory */
+static void write_slot(FrameRecorder *rec, const RecSlot *slot) {
+    if (rec->write_failed) return;
+
+    if (slot->palette_changed) {
+        write_record(rec, REC_PALETTE, slot->palette, sizeof(slot->palette));
+        memcpy(rec->cast_palette, slot->palette, sizeof(rec->cast_palette));
+    }
+
+    /* Room for the worst case: every cell its own run of 4 bytes */
+    size_t count = (size_t)slot->width * slot->height;
+    size_t need = sizeof(RecFrameHeader) + count * (sizeof(RecRun) + REC_UTF8_MAX);
+    if (need > rec->scratch_capacity) {
+        char *grown = realloc(rec->scratch, need);
+        if (!grown) {
+            rec->write_failed = true;
+            return;
+        }
+        rec->scratch = grown;
+        rec->scratch_capacity = need;
+    }
+
+    /* Index entry */
+    if ((int)atomic_load(&rec->written_frames) == rec->index_capacity) {
+        int cap = rec->index_capacity ? rec->index_capacity * 2 : 1024;
+        RecIndexEntry *grown = realloc(rec->index, (size_t)cap * sizeof(RecIndexEntry));
+        if (!grown) {
+            rec->write_failed = true;
+            return;
+        }
+        rec->index = grown;
+        rec->index_capacity = cap;
+    }
+
+    bool resized = !rec->previous || slot->width != rec->prev_width ||
+                   slot->height != rec->prev_height;
+    bool key = resized || rec->since_key >= FRAME_RECORDER_KEY_INTERVAL;
+
+    long n = atomic_load(&rec->written_frames);
+    rec->index[n] = (RecIndexEntry){
+        .offset = (uint64_t)ftell(rec->file),
+        .time_us = slot->time_us,
+        .keyframe = key,
+    };
+
+    /* The asciicast only needs the changes, even where the container
+     * stores a keyframe; after a palette change every cell is redrawn,
+     * since unchanged cells still show the old colors */
+    bool cast_full = resized || slot->palette_changed;
+    size_t size = encode_frame(rec, slot, cast_full);
+    if (rec->cast) asciicast_frame(rec->cast, rec->scratch, size);
+    if (key != cast_full) size = encode_frame(rec, slot, key);
+    write_record(rec, key ? REC_KEYFRAME : REC_DELTA, rec->scratch, size);
+    if (rec->write_failed) return;
+
+    /* Keep the frame for the next delta */
+    if (key) {
+        Cell *prev = realloc(rec->previous, count * sizeof(Cell));
+        if (!prev) {
+            rec->write_failed = true;
+            return;
+        }
+        rec->previous = prev;
+        rec->prev_width = slot->width;
+        rec->prev_height = slot->height;
+        rec->since_key = 0;
+    }
+    memcpy(rec->previous, slot->cells, count * sizeof(Cell));
+    rec->since_key++;
+    atomic_store(&rec->written_frames, n + 1);
+}
+
+static void *writer_thread_main(void *data) {
+    FrameRecorder *rec = (FrameRecorder *)data;
+
+    for (;;) {
+        uint64_t tail = atomic_load_explicit(&rec->tail, memory_order_relaxed);
+        uint64_t head = atomic_load_explicit(&rec->head, memory_order_acquire);
+        if (tail == head) {
+            /* Drain everything captured before stopping */
+            if (!atomic_load(&rec->running)) break;
+            struct timespec ts = { .tv_sec = 0, .tv_nsec = WRITER_IDLE_NS };
+            nanosleep(&ts, NULL);
+            continue;
+        }
+
+        write_slot(rec, &rec->slots[tail % FRAME_RECORDER_SLOTS]);
+        atomic_store_explicit(&rec->tail, tail + 1, memory_order_release);
+    }
+
+    return NULL;
+}
+
+/* ============ Recording ============ */
+
+int frame_recorder_start(FrameRecorder *recorder) {
+    if (!recorder || recorder->recording) return -1;
+
+    /* One timestamped container (and asciicast) per recording. The
+     * container is created exclusively; a second recording in the same
+     * second gets a numeric suffix instead of overwriting the first. */
+    ensure_directory(recorder->output_dir);
     time_t now = time(NULL);
     const struct tm *t = localtime(&now);
-    char subdir[sizeof(recorder->output_dir)];
-    int written = snprintf(subdir, sizeof(subdir), "%s/recording_%04d%02d%02d_%02d%02d%02d",
+    char stamp[300];
+    snprintf(stamp, sizeof(stamp), "%s/recording_%04d%02d%02d_%02d%02d%02d",
              recorder->output_dir,
              t->tm_year + 1900, t->tm_mon + 1, t->tm_mday,
              t->tm_hour, t->tm_min, t->tm_sec);
-    if (written >= (int)sizeof(subdir)) subdir[sizeof(subdir) - 1] = '\0';
-    memcpy(recorder->output_dir, subdir, sizeof(recorder->output_dir));
-    ensure_directory(recorder->output_dir);
+
+    char base[310];
+    recorder->file = NULL;
+    for (int n = 1; n <= REC_NAME_TRIES && !recorder->file; n++) {
+        if (n == 1) snprintf(base, sizeof(base), "%s", stamp);
+        else snprintf(base, sizeof(base), "%s_%d", stamp, n);
+        snprintf(recorder->path, sizeof(recorder->path), "%s" FRAME_RECORDER_EXT, base);
+        recorder->file = fopen(recorder->path, "wbx");
+        if (!recorder->file && errno != EEXIST) return -1;
+    }
+    if (!recorder->file) return -1;
+    snprintf(recorder->cast_path, sizeof(recorder->cast_path), "%s" ASCIICAST_EXT, base);
+    setvbuf(recorder->file, NULL, _IOFBF, 1 << 18);
+
+    if (recorder->asciicast) {
+        recorder->cast = malloc(sizeof(AsciicastWriter));
+        if (!recorder->cast || asciicast_open(recorder->cast, recorder->cast_path, now) != 0) {
+            free(recorder->cast);
+            recorder->cast = NULL;
+            fclose(recorder->file);
+            recorder->file = NULL;
+            return -1;
+        }
+        for (int p = 0; p < FRAME_RECORDER_PAIRS; p++) {
+            recorder->cast_palette[p][0] = recorder->cast_palette[p][1] = -1;
+        }
+        asciicast_set_palette(recorder->cast, recorder->cast_palette);
+    }
+
+    RecFileHeader hdr = { .version = FRAME_RECORDER_VERSION,
+                          .header_size = sizeof(RecFileHeader) };
+    memcpy(hdr.magic, FRAME_RECORDER_MAGIC, sizeof(FRAME_RECORDER_MAGIC));
+    fwrite(&hdr, sizeof(hdr), 1, recorder->file);
+
+    atomic_store(&recorder->head, 0);
+    atomic_store(&recorder->tail, 0);
+    atomic_store(&recorder->written_frames, 0);
+    atomic_store(&recorder->written_bytes, (long)sizeof(hdr));
+    free(recorder->previous);
+    recorder->previous = NULL;
+    recorder->write_failed = false;
+    recorder->palette_dirty = true;
+    recorder->total_frames = 0;
+    recorder->dropped_frames = 0;
+    recorder->start_ns = now_ns();
+
+    atomic_store(&recorder->running, true);
+    if (pthread_create(&recorder->thread, NULL, writer_thread_main, recorder) != 0) {
+        atomic_store(&recorder->running, false);
+        fclose(recorder->file);
+        recorder->file = NULL;
+        if (recorder->cast) {
+            asciicast_close(recorder->cast);
+            free(recorder->cast);
+            recorder->cast = NULL;
+        }
+        return -1;
+    }
+    recorder->recording = true;
+    return 0;
 }
 
 void frame_recorder_stop(FrameRecorder *recorder) {
-    if (!recorder) return;
-    
+    if (!recorder || !recorder->recording) return;
+
     recorder->recording = false;
-    recorder->duration = ((double)clock() / CLOCKS_PER_SEC) - recorder->start_time;
-    
-    /* Write summary file */
-    char summary_path[280];
-    snprintf(summary_path, sizeof(summary_path), "%s/summary.txt", recorder->output_dir);
-    
-    FILE *f = fopen(summary_path, "w");
-    if (f) {
-        fprintf(f, "ASCII Dancer Recording\n");
-        fprintf(f, "======================\n");
-        fprintf(f, "Frames: %d\n", recorder->total_frames);
-        fprintf(f, "Duration: %.2f seconds\n", recorder->duration);
-        fprintf(f, "FPS: %.2f\n", recorder->total_frames / recorder->duration);
-        fprintf(f, "\nTo create GIF:\n");
-        fprintf(f, "  cat frame_*.txt | convert -delay 1.67 -loop 0 txt:- output.gif\n");
-        fprintf(f, "\nTo create video:\n");
-        fprintf(f, "  # Use asciinema or similar tool\n");
-        fclose(f);
+    recorder->duration = (double)(now_ns() - recorder->start_ns) / 1e9;
+    atomic_store(&recorder->running, false);
+    pthread_join(recorder->thread, NULL);
+
+    /* Index and footer */
+    long frames = atomic_load(&recorder->written_frames);
+    RecFileFooter footer = {
+        .index_offset = (uint64_t)ftell(recorder->file),
+        .frames = (uint64_t)frames,
+    };
+    memcpy(footer.magic, FRAME_RECORDER_MAGIC, sizeof(FRAME_RECORDER_MAGIC));
+    if (frames > 0) {
+        fwrite(recorder->index, sizeof(RecIndexEntry), (size_t)frames, recorder->file);
+    }
+    fwrite(&footer, sizeof(footer), 1, recorder->file);
+    fclose(recorder->file);
+    recorder->file = NULL;
+
+    if (recorder->cast) {
+        asciicast_close(recorder->cast);
+        free(recorder->cast);
+        recorder->cast = NULL;
     }
 }
 
@@ -134,47 +400,71 @@ bool frame_recorder_is_recording(FrameRecorder *recorder) {
     return recorder ? recorder->recording : false;
 }
 
-void frame_recorder_capture(FrameRecorder *recorder) {
-    if (!recorder || !recorder->recording) return;
-    
-    /* Capture current screen content using ncurses */
-    char filename[280];
-    snprintf(filename, sizeof(filename), "%s/frame_%06d.txt", 
-             recorder->output_dir, recorder->frame_number);
-    
-    FILE *f = fopen(filename, "w");
-    if (!f) return;
-    
-    /* Read screen content with colors */
-    for (int y = 0; y < LINES && y < recorder->height; y++) {
-        for (int x = 0; x < COLS && x < recorder->width; x++) {
-            chtype ch = mvinch(y, x);
-            
-            /* Extract character and attributes */
-            char c = ch & A_CHARTEXT;
-            (void)(ch & A_ATTRIBUTES);  /* attrs reserved for future use */
-            short pair_num = PAIR_NUMBER(ch);
-            
-            /* Write with ANSI color codes if colored */
-            if (pair_num > 0) {
-                short fg, bg;
-                pair_content(pair_num, &fg, &bg);
-                
-                /* Convert to ANSI */
-                if (fg >= 0) {
-                    fprintf(f, "\033[38;5;%dm", fg);
-                }
-            }
-            
-            fputc(c ? c : ' ', f);
-        }
-        fprintf(f, "\033[0m\n"); /* Reset colors at line end */
+void frame_recorder_set_asciicast(FrameRecorder *recorder, bool enabled) {
+    if (recorder) recorder->asciicast = enabled;
+}
+
+void frame_recorder_set_palette(FrameRecorder *recorder, const int16_t fg[],
+                                const int16_t bg[], int count) {
+    if (!recorder) return;
+    for (int p = 0; p < FRAME_RECORDER_PAIRS; p++) {
+        recorder->palette[p][0] = p < count ? fg[p] : -1;
+        recorder->palette[p][1] = p < count ? bg[p] : -1;
+    }
+    recorder->palette_dirty = true;
+}
+
+/* Next free ring slot sized for width x height, or NULL (frame dropped) */
+static RecSlot* claim_slot(FrameRecorder *rec, int width, int height, uint64_t frame_ns) {
+    if (!rec || !rec->recording || width <= 0 || height <= 0) return NULL;
+
+    uint64_t head = atomic_load_explicit(&rec->head, memory_order_relaxed);
+    uint64_t tail = atomic_load_explicit(&rec->tail, memory_order_acquire);
+    RecSlot *slot = &rec->slots[head % FRAME_RECORDER_SLOTS];
+    if (head - tail >= FRAME_RECORDER_SLOTS ||
+        slot_reserve(slot, width * height) != 0) {
+        rec->dropped_frames++;
+        return NULL;
+    }
+
+    slot->width = width;
+    slot->height = height;
+    slot->time_us = frame_ns > rec->start_ns ? (frame_ns - rec->start_ns) / 1000 : 0;
+    slot->palette_changed = rec->palette_dirty;
+    if (rec->palette_dirty) {
+        memcpy(slot->palette, rec->palette, sizeof(slot->palette));
+        rec->palette_dirty = false;
+    }
+    return slot;
+}
+
+static void publish_slot(FrameRecorder *rec) {
+    uint64_t head = atomic_load_explicit(&rec->head, memory_order_relaxed);
+    atomic_store_explicit(&rec->head, head + 1, memory_order_release);
+    rec->total_frames++;
+}
+
+void frame_recorder_capture(FrameRecorder *recorder, const Cell *cells,
+                            int width, int height, uint64_t frame_ns) {
+    if (!cells) return;
+    RecSlot *slot = claim_slot(recorder, width, height, frame_ns);
+    if (!slot) return;
+
+    memcpy(slot->cells, cells, (size_t)width * height * sizeof(Cell));
+    publish_slot(recorder);
+}
+
+void frame_recorder_capture_cells(FrameRecorder *recorder, const wchar_t *cells,
+                                  int width, int height, uint64_t frame_ns) {
+    if (!cells) return;
+    RecSlot *slot = claim_slot(recorder, width, height, frame_ns);
+    if (!slot) return;
+
+    int count = width * height;
+    for (int i = 0; i < count; i++) {
+        slot->cells[i] = (Cell){ .ch = cells[i], .pair = 0, .attr = 0 };
     }
-    
-    fclose(f);
-    
-    recorder->frame_number++;
-    recorder->total_frames++;
+    publish_slot(recorder);
 }
 
 void frame_recorder_get_stats(const FrameRecorder *recorder, int *frames, double *duration) {
@@ -182,7 +472,7 @@ void frame_recorder_get_stats(const FrameRecorder *recorder, int *frames, double
     if (frames) *frames = recorder->total_frames;
     if (duration) {
         if (recorder->recording) {
-            *duration = ((double)clock() / CLOCKS_PER_SEC) - recorder->start_time;
+            *duration = (double)(now_ns() - recorder->start_ns) / 1e9;
         } else {
             *duration = recorder->duration;
         }
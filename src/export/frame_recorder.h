@@ -1,8 +1,34 @@
 /*
  * Frame Recorder - ASCII Dancer v3.0+
- * 
- * Capture terminal frames to PNG sequence for GIF/video export
- * Supports ANSI escape sequences and true color
+ *
+ * Records the composed dancer region (characters, color pairs and
+ * attributes) into a single container file (v3.2+).
+ *
+ * Capturing copies the region's cells into a preallocated ring slot and
+ * returns; the render loop never formats text or touches the disk. A writer
+ * thread takes the slots in order, delta-encodes each frame against the
+ * previous one and appends it to the file. When the writer falls behind and
+ * the ring is full, new frames are dropped and counted.
+ *
+ * Container layout (host byte order, like pose packs):
+ *   RecFileHeader
+ *   records, each a RecRecordHeader and its payload:
+ *     REC_PALETTE   int16_t fg, bg per color pair; applies to later frames
+ *     REC_KEYFRAME  RecFrameHeader, then runs covering every cell
+ *     REC_DELTA     RecFrameHeader, then runs of cells changed since the
+ *                   previous frame
+ *   RecIndexEntry index[frames]     one per frame record, in order
+ *   RecFileFooter                   locates the index
+ *
+ * A run is a RecRun and run.bytes of UTF-8 text for run.len cells of one
+ * row in one style. A keyframe is written first, after a size change and
+ * every FRAME_RECORDER_KEY_INTERVAL frames, so playback can start from
+ * any keyframe found through the index. The index and footer are written
+ * on stop; without them the reader falls back to walking the records.
+ *
+ * Frame times come from the caller's frame clock. With asciicast output on,
+ * the writer also streams the same frames to an asciicast v2 file next to
+ * the container (asciicast.h).
  */
 
 #ifndef FRAME_RECORDER_H
@@ -10,42 +36,162 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
+#include <wchar.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include "../render/cell_buffer.h"
+
+struct AsciicastWriter;
+
+#define FRAME_RECORDER_MAGIC   "BBREC"  /* 8 bytes with the terminator */
+#define FRAME_RECORDER_VERSION 1
+#define FRAME_RECORDER_EXT     ".bbrec"
+
+#define FRAME_RECORDER_SLOTS        8     /* Frames the writer may fall behind */
+#define FRAME_RECORDER_PAIRS        256   /* Color pairs kept in the palette */
+#define FRAME_RECORDER_KEY_INTERVAL 120   /* Frames between keyframes */
+
+/* ============ Container format ============ */
+
+typedef enum {
+    REC_PALETTE = 1,
+    REC_KEYFRAME,
+    REC_DELTA
+} RecRecordType;
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;       /* sizeof(RecFileHeader) */
+} RecFileHeader;
+
+typedef struct {
+    uint32_t type;              /* RecRecordType */
+    uint32_t size;              /* Payload bytes after this header */
+} RecRecordHeader;
+
+typedef struct {
+    uint64_t time_us;           /* Since recording started */
+    uint16_t width;
+    uint16_t height;
+    uint32_t runs;
+} RecFrameHeader;
+
+typedef struct {
+    uint16_t row;
+    uint16_t col;
+    uint16_t len;               /* Cells */
+    uint16_t bytes;             /* UTF-8 bytes that follow */
+    int16_t pair;
+    uint16_t attr;              /* CELL_ATTR_* */
+} RecRun;
+
+typedef struct {
+    uint64_t offset;            /* Of the frame's RecRecordHeader */
+    uint64_t time_us;
+    uint32_t keyframe;
+    uint32_t reserved;
+} RecIndexEntry;
+
+typedef struct {
+    uint64_t index_offset;
+    uint64_t frames;
+    char magic[8];
+} RecFileFooter;
+
+/* ============ Recorder ============ */
+
+/* One captured frame, owned by the render thread until published */
+typedef struct {
+    Cell *cells;
+    int capacity;               /* Cells allocated */
+    int width;
+    int height;
+    uint64_t time_us;
+    bool palette_changed;       /* palette below goes out before this frame */
+    int16_t palette[FRAME_RECORDER_PAIRS][2];
+} RecSlot;
 
 typedef struct {
     bool recording;
     char output_dir[256];
-    int frame_number;
-    int width;
+    char path[320];             /* Container being written */
+    char cast_path[320];        /* Asciicast being written, if enabled */
+    bool asciicast;             /* Also write an asciicast v2 file */
+    int width;                  /* Initial slot size */
     int height;
-    
-    /* Frame buffer - stores ANSI colored text */
-    char **frame_buffer;
-    
+
+    /* Ring of captured frames: the render thread fills slot head % SLOTS,
+     * the writer drains slot tail % SLOTS */
+    RecSlot slots[FRAME_RECORDER_SLOTS];
+    _Atomic uint64_t head;
+    _Atomic uint64_t tail;
+
+    /* Palette set by the render thread, sent with the next captured frame */
+    int16_t palette[FRAME_RECORDER_PAIRS][2];
+    bool palette_dirty;
+
+    /* Writer thread state */
+    pthread_t thread;
+    _Atomic bool running;
+    FILE *file;
+    Cell *previous;             /* Last frame written */
+    int prev_width, prev_height;
+    int since_key;
+    RecIndexEntry *index;
+    int index_capacity;
+    char *scratch;              /* Encoded frame payload */
+    size_t scratch_capacity;
+    bool write_failed;
+    struct AsciicastWriter *cast;
+    int16_t cast_palette[FRAME_RECORDER_PAIRS][2];
+
     /* Recording statistics */
-    int total_frames;
-    double start_time;
+    int total_frames;           /* Captured */
+    _Atomic long written_frames;
+    _Atomic long written_bytes;
+    long dropped_frames;        /* Ring full */
+    uint64_t start_ns;
     double duration;
-    
+
 } FrameRecorder;
 
-/* Create recorder */
+/* Create recorder; width x height cells are preallocated per ring slot */
 FrameRecorder* frame_recorder_create(int width, int height, const char *output_dir);
 
-/* Destroy recorder */
+/* Destroy recorder (stops a recording in progress) */
 void frame_recorder_destroy(FrameRecorder *recorder);
 
-/* Start/stop recording */
-void frame_recorder_start(FrameRecorder *recorder);
+/* Start a recording into a new timestamped container in the output
+ * directory; an existing recording is never overwritten. Returns 0 on
+ * success, -1 if the file or thread failed. */
+int frame_recorder_start(FrameRecorder *recorder);
+
+/* Stop recording: drain the ring, write the index and close the file */
 void frame_recorder_stop(FrameRecorder *recorder);
 
 /* Check if recording */
 bool frame_recorder_is_recording(FrameRecorder *recorder);
 
-/* Capture current terminal frame */
-void frame_recorder_capture(FrameRecorder *recorder);
+/* Write an asciicast v2 file alongside the container (from the next start) */
+void frame_recorder_set_asciicast(FrameRecorder *recorder, bool enabled);
+
+/* Color pair table (foreground, background per pair; -1 for default) used
+ * by the frames captured from now on */
+void frame_recorder_set_palette(FrameRecorder *recorder, const int16_t fg[],
+                                const int16_t bg[], int count);
+
+/* Capture the composed region (e.g. the renderer's cell buffer). frame_ns
+ * is the frame's CLOCK_MONOTONIC time (the scheduler's frame start). */
+void frame_recorder_capture(FrameRecorder *recorder, const Cell *cells,
+                            int width, int height, uint64_t frame_ns);
 
-/* Export captured frames to text files (for post-processing with asciinema or similar) */
-void frame_recorder_export_text(FrameRecorder *recorder, const char *filename);
+/* Capture a block of wide-character cells (e.g. the dancer's retained frame)
+ * without colors (v3.2+) */
+void frame_recorder_capture_cells(FrameRecorder *recorder, const wchar_t *cells,
+                                  int width, int height, uint64_t frame_ns);
 
 /* Get recording stats */
 void frame_recorder_get_stats(const FrameRecorder *recorder, int *frames, double *duration);
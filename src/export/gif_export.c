@@ -0,0 +1,631 @@
+/*
+ * GIF Export Implementation
+ */
+
+#include "gif_export.h"
+#include "rec_reader.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#define GIF_TRANSPARENT 0       /* Reserved palette index */
+#define GIF_BLACK       16      /* Stands in for xterm color 0 */
+#define GIF_DEFAULT_FG  7       /* Terminal default foreground */
+#define GIF_MAX_DIM     65535
+#define GIF_MAX_THREADS 64
+#define GIF_BATCH       32      /* Frames per batch, per thread */
+
+#define LZW_MIN_BITS  8
+#define LZW_MAX_BITS  12
+#define LZW_HASH_BITS 13        /* Table over twice the 4096 codes */
+#define LZW_HASH_SIZE (1 << LZW_HASH_BITS)
+
+/* How a cell looks: kind, braille dots, foreground and background packed in
+ * 32 bits, so comparing two frames is comparing words */
+#define LOOK_BLANK 0
+#define LOOK_DOTS  1
+#define LOOK_BLOCK 2
+#define LOOK_KEEP  0xFFFFFFFFu  /* Unchanged: transparent in this frame */
+#define LOOK(kind, dots, fg, bg) \
+    ((uint32_t)(kind) << 24 | (uint32_t)(dots) << 16 | (uint32_t)(fg) << 8 | (uint32_t)(bg))
+
+/* One GIF frame: filled by the reader thread, encoded by a worker */
+typedef struct {
+    int x, y, w, h;             /* Changed cells' bounding box */
+    uint32_t *looks;            /* w x h, LOOK_KEEP where unchanged */
+    size_t looks_cap;
+    unsigned time_cs;
+    uint8_t *data;              /* LZW code stream, before sub-blocking */
+    size_t len;
+    size_t cap;
+    bool failed;
+} GifJob;
+
+typedef struct {
+    uint8_t *pixels;
+    size_t pixels_cap;
+    int32_t keys[LZW_HASH_SIZE];    /* prefix << 8 | byte; -1 when free */
+    uint16_t codes[LZW_HASH_SIZE];
+} GifWorker;
+
+typedef struct {
+    const GifExportOptions *opt;
+    int cell_w, cell_h;         /* Pixels */
+    uint8_t *glyphs;            /* Dot pattern per braille character */
+    uint8_t dim[256];           /* Darker stand-in per color */
+    uint8_t background;
+    int16_t palette[FRAME_RECORDER_PAIRS][2];
+
+    GifJob *jobs;
+    int count;                  /* Jobs in the batch */
+    int first;                  /* First job still to encode */
+    _Atomic int next_job;
+    GifWorker *workers;
+    int threads;
+} GifExporter;
+
+typedef struct {
+    GifExporter *ex;
+    GifWorker *worker;
+} WorkerArg;
+
+void gif_export_defaults(GifExportOptions *opt) {
+    memset(opt, 0, sizeof(*opt));
+    opt->dot_pitch = 4;
+    opt->threads = 0;
+    opt->min_delay_cs = 2;
+    opt->loop = 0;
+    opt->theme = NULL;
+}
+
+/* ============ Colors ============ */
+
+static void xterm_rgb(int c, uint8_t rgb[3]) {
+    static const uint8_t base[16][3] = {
+        {0, 0, 0}, {128, 0, 0}, {0, 128, 0}, {128, 128, 0},
+        {0, 0, 128}, {128, 0, 128}, {0, 128, 128}, {192, 192, 192},
+        {128, 128, 128}, {255, 0, 0}, {0, 255, 0}, {255, 255, 0},
+        {0, 0, 255}, {255, 0, 255}, {0, 255, 255}, {255, 255, 255},
+    };
+    static const uint8_t cube[6] = {0, 95, 135, 175, 215, 255};
+
+    if (c < 16) {
+        memcpy(rgb, base[c], 3);
+    } else if (c < 232) {
+        c -= 16;
+        rgb[0] = cube[c / 36];
+        rgb[1] = cube[(c / 6) % 6];
+        rgb[2] = cube[c % 6];
+    } else {
+        rgb[0] = rgb[1] = rgb[2] = (uint8_t)(8 + 10 * (c - 232));
+    }
+}
+
+/* Nearest color at 60% brightness, for CELL_ATTR_DIM */
+static void build_dim_table(uint8_t dim[256]) {
+    for (int c = 0; c < 256; c++) {
+        uint8_t rgb[3];
+        xterm_rgb(c, rgb);
+        int want[3] = { rgb[0] * 3 / 5, rgb[1] * 3 / 5, rgb[2] * 3 / 5 };
+
+        int best = GIF_BLACK, best_dist = 1 << 30;
+        for (int k = 1; k < 256; k++) {
+            uint8_t cand[3];
+            xterm_rgb(k, cand);
+            int dr = cand[0] - want[0], dg = cand[1] - want[1], db = cand[2] - want[2];
+            int dist = dr * dr + dg * dg + db * db;
+            if (dist < best_dist) {
+                best = k;
+                best_dist = dist;
+            }
+        }
+        dim[c] = (uint8_t)best;
+    }
+}
+
+/* Pairs the theme system sets up get the theme's colors */
+static void apply_theme(const ThemeColors *t, int16_t palette[][2]) {
+    for (int i = 0; i < GRADIENT_STEPS; i++) {
+        palette[COLOR_PAIR_DANCER_BASE + i][0] = t->dancer_colors[i];
+        palette[COLOR_PAIR_DANCER_BASE + i][1] = t->background;
+        palette[COLOR_PAIR_SHADOW_BASE + i][0] = t->shadow_color;
+        palette[COLOR_PAIR_SHADOW_BASE + i][1] = t->background;
+    }
+    const struct { int pair; short fg; } fixed[] = {
+        { COLOR_PAIR_GROUND,     t->ground_color },
+        { COLOR_PAIR_BAR_BASS,   t->bass_color },
+        { COLOR_PAIR_BAR_MID,    t->mid_color },
+        { COLOR_PAIR_BAR_TREBLE, t->treble_color },
+        { COLOR_PAIR_INFO,       t->info_color },
+        { COLOR_PAIR_BPM,        t->bpm_color },
+    };
+    for (size_t i = 0; i < sizeof(fixed) / sizeof(fixed[0]); i++) {
+        palette[fixed[i].pair][0] = fixed[i].fg;
+        palette[fixed[i].pair][1] = t->background;
+    }
+}
+
+static uint32_t cell_look(const GifExporter *ex, const Cell *cell) {
+    int16_t fg = -1, bg = -1;
+    if (cell->pair >= 0 && cell->pair < FRAME_RECORDER_PAIRS) {
+        fg = ex->palette[cell->pair][0];
+        bg = ex->palette[cell->pair][1];
+    }
+    int bgi = bg < 0 || bg > 255 ? ex->background : bg;
+    if (bgi == 0) bgi = GIF_BLACK;
+
+    wchar_t ch = cell->ch;
+    int kind = LOOK_BLOCK, dots = 0;
+    if (ch >= 0x2800 && ch <= 0x28FF) {
+        dots = (int)(ch - 0x2800);
+        kind = dots ? LOOK_DOTS : LOOK_BLANK;
+    } else if (ch <= L' ' || ch == 0x7F || ch == 0xA0) {
+        kind = LOOK_BLANK;
+    }
+    if (kind == LOOK_BLANK) return LOOK(LOOK_BLANK, 0, 0, bgi);
+
+    int fgi = fg < 0 || fg > 255 ? GIF_DEFAULT_FG : fg;
+    if ((cell->attr & CELL_ATTR_BOLD) && fgi < 8) fgi += 8;
+    if (cell->attr & CELL_ATTR_DIM) fgi = ex->dim[fgi];
+    if (fgi == 0) fgi = GIF_BLACK;
+    if (fgi == bgi) return LOOK(LOOK_BLANK, 0, 0, bgi);    /* Invisible ink */
+    return LOOK(kind, dots, fgi, bgi);
+}
+
+/* ============ Rasterizing ============ */
+
+/* Braille bit for each dot row and column (U+2800 + bits) */
+static const int dot_bit[4][2] = { {0, 3}, {1, 4}, {2, 5}, {6, 7} };
+
+/* A disc of radius 0.4 pitch centered in each dot's pitch x pitch square */
+static int build_glyphs(GifExporter *ex) {
+    int p = ex->opt->dot_pitch;
+    size_t size = (size_t)ex->cell_w * ex->cell_h;
+    ex->glyphs = calloc(256, size);
+    if (!ex->glyphs) return -1;
+
+    float r2 = 0.16f * (float)(p * p);
+    for (int mask = 0; mask < 256; mask++) {
+        uint8_t *g = ex->glyphs + (size_t)mask * size;
+        for (int row = 0; row < 4; row++) {
+            for (int col = 0; col < 2; col++) {
+                if (!(mask & (1 << dot_bit[row][col]))) continue;
+                for (int py = 0; py < p; py++) {
+                    for (int px = 0; px < p; px++) {
+                        float dx = (float)px + 0.5f - (float)p * 0.5f;
+                        float dy = (float)py + 0.5f - (float)p * 0.5f;
+                        if (dx * dx + dy * dy > r2) continue;
+                        g[(size_t)(row * p + py) * ex->cell_w + col * p + px] = 1;
+                    }
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+static void rasterize(const GifExporter *ex, const GifJob *job, uint8_t *pixels) {
+    int cw = ex->cell_w, ch = ex->cell_h;
+    size_t stride = (size_t)job->w * cw;
+    size_t glyph_size = (size_t)cw * ch;
+
+    for (int cy = 0; cy < job->h; cy++) {
+        for (int cx = 0; cx < job->w; cx++) {
+            uint32_t look = job->looks[(size_t)cy * job->w + cx];
+            uint8_t *dst = pixels + (size_t)cy * ch * stride + (size_t)cx * cw;
+
+            if (look == LOOK_KEEP) {
+                for (int py = 0; py < ch; py++) memset(dst + py * stride, GIF_TRANSPARENT, cw);
+                continue;
+            }
+            uint8_t fg = (uint8_t)(look >> 8), bg = (uint8_t)look;
+            if ((look >> 24) != LOOK_DOTS) {
+                uint8_t fill = (look >> 24) == LOOK_BLOCK ? fg : bg;
+                for (int py = 0; py < ch; py++) memset(dst + py * stride, fill, cw);
+                continue;
+            }
+            const uint8_t *g = ex->glyphs + ((look >> 16) & 0xFF) * glyph_size;
+            for (int py = 0; py < ch; py++) {
+                for (int px = 0; px < cw; px++) {
+                    dst[py * stride + px] = g[py * cw + px] ? fg : bg;
+                }
+            }
+        }
+    }
+}
+
+/* ============ LZW ============ */
+
+typedef struct {
+    GifJob *job;
+    uint32_t acc;
+    int bits;
+} BitWriter;
+
+static void put_code(BitWriter *bw, unsigned code, int size) {
+    GifJob *job = bw->job;
+    if (job->len + 4 > job->cap) {
+        size_t cap = job->cap ? job->cap * 2 : 65536;
+        uint8_t *grown = realloc(job->data, cap);
+        if (!grown) {
+            job->failed = true;
+            job->len = 0;
+            return;
+        }
+        job->data = grown;
+        job->cap = cap;
+    }
+    bw->acc |= (uint32_t)code << bw->bits;
+    bw->bits += size;
+    while (bw->bits >= 8) {
+        job->data[job->len++] = (uint8_t)bw->acc;
+        bw->acc >>= 8;
+        bw->bits -= 8;
+    }
+}
+
+/* GIF variable-width LZW; the code size grows when the next code needs
+ * another bit and the table is cleared when it reaches 4096 codes */
+static void lzw_encode(GifWorker *wk, const uint8_t *pixels, size_t n, GifJob *job) {
+    BitWriter bw = { .job = job };
+    const unsigned clear = 1u << LZW_MIN_BITS;
+    unsigned next = clear + 2;
+    int size = LZW_MIN_BITS + 1;
+
+    job->len = 0;
+    memset(wk->keys, 0xFF, sizeof(wk->keys));
+    put_code(&bw, clear, size);
+
+    unsigned cur = pixels[0];
+    for (size_t i = 1; i < n; i++) {
+        int32_t key = (int32_t)(cur << 8 | pixels[i]);
+        unsigned h = ((uint32_t)key * 2654435761u) >> (32 - LZW_HASH_BITS);
+        while (wk->keys[h] != -1 && wk->keys[h] != key) h = (h + 1) & (LZW_HASH_SIZE - 1);
+        if (wk->keys[h] == key) {
+            cur = wk->codes[h];
+            continue;
+        }
+
+        put_code(&bw, cur, size);
+        if (next < (1u << LZW_MAX_BITS)) {
+            if (next == 1u << size) size++;
+            wk->keys[h] = key;
+            wk->codes[h] = (uint16_t)next++;
+        } else {
+            put_code(&bw, clear, size);
+            memset(wk->keys, 0xFF, sizeof(wk->keys));
+            next = clear + 2;
+            size = LZW_MIN_BITS + 1;
+        }
+        cur = pixels[i];
+    }
+
+    /* The decoder adds an entry for the last code too */
+    put_code(&bw, cur, size);
+    if (next == 1u << size && size < LZW_MAX_BITS) size++;
+    put_code(&bw, clear + 1, size);
+    if (bw.bits > 0) put_code(&bw, 0, 8 - bw.bits);
+}
+
+static void encode_job(const GifExporter *ex, GifWorker *wk, GifJob *job) {
+    size_t n = (size_t)job->w * ex->cell_w * job->h * ex->cell_h;
+    if (n > wk->pixels_cap) {
+        uint8_t *grown = realloc(wk->pixels, n);
+        if (!grown) {
+            job->failed = true;
+            return;
+        }
+        wk->pixels = grown;
+        wk->pixels_cap = n;
+    }
+    rasterize(ex, job, wk->pixels);
+    lzw_encode(wk, wk->pixels, n, job);
+}
+
+static void* worker_main(void *arg) {
+    WorkerArg *wa = arg;
+    GifExporter *ex = wa->ex;
+    for (;;) {
+        int i = atomic_fetch_add(&ex->next_job, 1);
+        if (i >= ex->count) break;
+        encode_job(ex, wa->worker, &ex->jobs[i]);
+    }
+    return NULL;
+}
+
+/* Encode jobs first..count-1 on every thread, this one included */
+static void encode_batch(GifExporter *ex) {
+    pthread_t threads[GIF_MAX_THREADS];
+    WorkerArg args[GIF_MAX_THREADS];
+    int started = 0;
+
+    atomic_store(&ex->next_job, ex->first);
+    int wanted = ex->count - ex->first < ex->threads ? ex->count - ex->first : ex->threads;
+    for (int t = 1; t < wanted; t++) {
+        args[t] = (WorkerArg){ ex, &ex->workers[t] };
+        if (pthread_create(&threads[t], NULL, worker_main, &args[t]) != 0) break;
+        started = t;
+    }
+    args[0] = (WorkerArg){ ex, &ex->workers[0] };
+    worker_main(&args[0]);
+    for (int t = 1; t <= started; t++) pthread_join(threads[t], NULL);
+}
+
+/* ============ GIF stream ============ */
+
+static void put_u16(uint8_t *p, unsigned v) {
+    p[0] = (uint8_t)(v & 0xFF);
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static int write_header(FILE *f, int width, int height, int loop) {
+    uint8_t hdr[13] = { 'G', 'I', 'F', '8', '9', 'a' };
+    put_u16(hdr + 6, (unsigned)width);
+    put_u16(hdr + 8, (unsigned)height);
+    hdr[10] = 0xF7;             /* Global table of 256 colors */
+    hdr[11] = GIF_BLACK;        /* Background */
+    hdr[12] = 0;
+    if (fwrite(hdr, sizeof(hdr), 1, f) != 1) return -1;
+
+    uint8_t table[256][3];
+    for (int c = 0; c < 256; c++) xterm_rgb(c, table[c]);
+    if (fwrite(table, sizeof(table), 1, f) != 1) return -1;
+
+    uint8_t netscape[19] = { 0x21, 0xFF, 11, 'N', 'E', 'T', 'S', 'C', 'A', 'P', 'E',
+                             '2', '.', '0', 3, 1, 0, 0, 0 };
+    put_u16(netscape + 16, (unsigned)loop);
+    return fwrite(netscape, sizeof(netscape), 1, f) == 1 ? 0 : -1;
+}
+
+static int write_frame(FILE *f, const GifExporter *ex, const GifJob *job, unsigned delay) {
+    if (delay > 65535) delay = 65535;
+
+    /* Graphic control: keep the previous frame, index 0 transparent */
+    uint8_t gce[8] = { 0x21, 0xF9, 4, (1 << 2) | 1, 0, 0, GIF_TRANSPARENT, 0 };
+    put_u16(gce + 4, delay);
+
+    uint8_t desc[11] = { 0x2C };
+    put_u16(desc + 1, (unsigned)(job->x * ex->cell_w));
+    put_u16(desc + 3, (unsigned)(job->y * ex->cell_h));
+    put_u16(desc + 5, (unsigned)(job->w * ex->cell_w));
+    put_u16(desc + 7, (unsigned)(job->h * ex->cell_h));
+    desc[9] = 0;                /* No local color table */
+    desc[10] = LZW_MIN_BITS;
+
+    if (fwrite(gce, sizeof(gce), 1, f) != 1 || fwrite(desc, sizeof(desc), 1, f) != 1) {
+        return -1;
+    }
+    for (size_t off = 0; off < job->len; off += 255) {
+        size_t n = job->len - off < 255 ? job->len - off : 255;
+        if (fputc((int)n, f) == EOF || fwrite(job->data + off, 1, n, f) != n) return -1;
+    }
+    return fputc(0, f) == EOF ? -1 : 0;
+}
+
+/* Write every encoded job but the last, whose delay depends on the frame
+ * after it; that one moves to the front of the next batch */
+static int write_batch(FILE *f, GifExporter *ex, bool last) {
+    encode_batch(ex);
+
+    int keep = last ? 0 : 1;
+    for (int i = 0; i < ex->count - keep; i++) {
+        const GifJob *job = &ex->jobs[i];
+        if (job->failed) return -1;
+        unsigned delay = i + 1 < ex->count ? ex->jobs[i + 1].time_cs - job->time_cs
+                                           : (unsigned)ex->opt->min_delay_cs;
+        if (write_frame(f, ex, job, delay) != 0) return -1;
+    }
+
+    if (keep && ex->count > 0) {
+        GifJob carried = ex->jobs[ex->count - 1];
+        ex->jobs[ex->count - 1] = ex->jobs[0];
+        ex->jobs[0] = carried;
+        ex->count = ex->first = 1;
+    } else {
+        ex->count = ex->first = 0;
+    }
+    return 0;
+}
+
+/* Queue the cells that differ from what the GIF shows; returns 1 if a frame
+ * was queued, 0 if nothing changed, -1 out of memory */
+static int queue_frame(GifExporter *ex, const RecReader *rd, uint32_t *shown,
+                       uint32_t *looks, int width, int height, unsigned time_cs) {
+    uint32_t blank = LOOK(LOOK_BLANK, 0, 0, ex->background);
+    int x0 = width, y0 = height, x1 = -1, y1 = -1;
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            uint32_t look = blank;
+            if (x < rd->width && y < rd->height) {
+                look = cell_look(ex, &rd->cells[(size_t)y * rd->width + x]);
+            }
+            looks[(size_t)y * width + x] = look;
+            if (look == shown[(size_t)y * width + x]) continue;
+            if (x < x0) x0 = x;
+            if (x > x1) x1 = x;
+            if (y < y0) y0 = y;
+            if (y > y1) y1 = y;
+        }
+    }
+    if (x1 < 0) return 0;
+
+    GifJob *job = &ex->jobs[ex->count];
+    job->x = x0;
+    job->y = y0;
+    job->w = x1 - x0 + 1;
+    job->h = y1 - y0 + 1;
+    job->time_cs = time_cs;
+    job->failed = false;
+
+    size_t n = (size_t)job->w * job->h;
+    if (n > job->looks_cap) {
+        uint32_t *grown = realloc(job->looks, n * sizeof(uint32_t));
+        if (!grown) return -1;
+        job->looks = grown;
+        job->looks_cap = n;
+    }
+    for (int y = y0; y <= y1; y++) {
+        uint32_t *dst = job->looks + (size_t)(y - y0) * job->w;
+        for (int x = x0; x <= x1; x++) {
+            size_t i = (size_t)y * width + x;
+            dst[x - x0] = looks[i] == shown[i] ? LOOK_KEEP : looks[i];
+            shown[i] = looks[i];
+        }
+    }
+    ex->count++;
+    return 1;
+}
+
+static void free_exporter(GifExporter *ex, int batch) {
+    if (ex->jobs) {
+        for (int i = 0; i < batch; i++) {
+            free(ex->jobs[i].looks);
+            free(ex->jobs[i].data);
+        }
+    }
+    if (ex->workers) {
+        for (int t = 0; t < ex->threads; t++) free(ex->workers[t].pixels);
+    }
+    free(ex->jobs);
+    free(ex->workers);
+    free(ex->glyphs);
+}
+
+int gif_export(const char *rec_path, const char *gif_path, const GifExportOptions *opt,
+               GifExportStats *stats, const char **error) {
+    const char *err = NULL;
+    GifExporter ex = { .opt = opt };
+    uint32_t *shown = NULL, *looks = NULL;
+    FILE *f = NULL;
+    int batch = 0;
+
+    if (stats) memset(stats, 0, sizeof(*stats));
+    if (opt->dot_pitch < 1 || opt->dot_pitch > 16 || opt->min_delay_cs < 1) {
+        if (error) *error = "bad export options";
+        return -1;
+    }
+
+    RecReader *rd = rec_reader_open(rec_path, &err);
+    if (!rd) {
+        if (error) *error = err;
+        return -1;
+    }
+
+    ex.cell_w = 2 * opt->dot_pitch;
+    ex.cell_h = 4 * opt->dot_pitch;
+    int width = rd->max_width, height = rd->max_height;
+    if (width * ex.cell_w > GIF_MAX_DIM || height * ex.cell_h > GIF_MAX_DIM) {
+        err = "recording too large for a GIF at this dot size";
+        goto done;
+    }
+
+    ex.threads = opt->threads > 0 ? opt->threads : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (ex.threads < 1) ex.threads = 1;
+    if (ex.threads > GIF_MAX_THREADS) ex.threads = GIF_MAX_THREADS;
+    batch = GIF_BATCH * ex.threads;
+
+    ex.background = GIF_BLACK;
+    if (opt->theme && opt->theme->background > 0 && opt->theme->background < 256) {
+        ex.background = (uint8_t)opt->theme->background;
+    }
+    build_dim_table(ex.dim);
+
+    size_t cells = (size_t)width * height;
+    ex.jobs = calloc((size_t)batch, sizeof(GifJob));
+    ex.workers = calloc((size_t)ex.threads, sizeof(GifWorker));
+    shown = malloc(cells * sizeof(uint32_t));
+    looks = malloc(cells * sizeof(uint32_t));
+    if (!ex.jobs || !ex.workers || !shown || !looks || build_glyphs(&ex) != 0) {
+        err = "out of memory";
+        goto done;
+    }
+    for (size_t i = 0; i < cells; i++) shown[i] = LOOK_KEEP;
+
+    f = fopen(gif_path, "wb");
+    if (!f) {
+        err = "cannot create GIF";
+        goto done;
+    }
+    setvbuf(f, NULL, _IOFBF, 1 << 18);
+    if (write_header(f, width * ex.cell_w, height * ex.cell_h, opt->loop) != 0) {
+        err = "write failed";
+        goto done;
+    }
+
+    long frames_read = 0, frames_written = 0;
+    bool queued = false, pending = false;
+    unsigned last_cs = 0;
+    int more;
+    do {
+        more = rec_reader_next(rd);
+        if (more < 0) {
+            err = "corrupt recording";
+            goto done;
+        }
+
+        unsigned time_cs;
+        if (more) {
+            frames_read++;
+            time_cs = (unsigned)((rd->time_us + 5000) / 10000);
+            /* Too soon after the last GIF frame: fold into the next one */
+            if (queued && time_cs < last_cs + (unsigned)opt->min_delay_cs) {
+                pending = true;
+                continue;
+            }
+        } else {
+            /* The final state, if frames were folded away at the end */
+            if (!pending) break;
+            time_cs = last_cs + (unsigned)opt->min_delay_cs;
+        }
+        pending = false;
+
+        memcpy(ex.palette, rd->palette, sizeof(ex.palette));
+        if (opt->theme) apply_theme(opt->theme, ex.palette);
+
+        int q = queue_frame(&ex, rd, shown, looks, width, height, time_cs);
+        if (q < 0) {
+            err = "out of memory";
+            goto done;
+        }
+        if (q == 0) continue;
+        queued = true;
+        last_cs = time_cs;
+        frames_written++;
+
+        if (ex.count == batch && write_batch(f, &ex, false) != 0) {
+            err = "write failed";
+            goto done;
+        }
+    } while (more);
+
+    if (write_batch(f, &ex, true) != 0 || fputc(0x3B, f) == EOF) {
+        err = "write failed";
+        goto done;
+    }
+
+    if (stats) {
+        stats->frames_read = frames_read;
+        stats->frames_written = frames_written;
+        stats->bytes = ftell(f);
+        stats->width = width * ex.cell_w;
+        stats->height = height * ex.cell_h;
+        stats->threads = ex.threads;
+    }
+
+done:
+    if (f && fclose(f) != 0 && !err) err = "write failed";
+    free(shown);
+    free(looks);
+    free_exporter(&ex, batch);
+    rec_reader_close(rd);
+    if (err) {
+        if (error) *error = err;
+        return -1;
+    }
+    return 0;
+}
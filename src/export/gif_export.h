@@ -0,0 +1,56 @@
+/*
+ * GIF Export - ASCII Dancer v3.2+
+ *
+ * Renders a recording (frame_recorder.h) to an animated GIF with no
+ * external tools. Each braille cell becomes a 2x4 grid of dot_pitch pixel
+ * squares with a disc for every raised dot; other visible characters fill
+ * their cell. Pixels index the xterm 256-color palette directly, which is
+ * the GIF's global color table, so the recorded pair colors (or a theme's,
+ * see GifExportOptions.theme) come through exactly.
+ *
+ * Each GIF frame covers only the bounding box of the cells that changed
+ * since the previous one, with unchanged cells inside it left transparent,
+ * so a still background costs nothing and LZW packs the gaps into a few
+ * codes. Recorded frames closer together than min_delay_cs are merged,
+ * since GIF viewers clamp shorter delays anyway.
+ *
+ * The reader and the diff run on the calling thread; batches of frames are
+ * then rasterized and LZW-encoded in parallel and written in order.
+ */
+
+#ifndef GIF_EXPORT_H
+#define GIF_EXPORT_H
+
+#include <stdint.h>
+
+#include "../render/colors.h"
+
+#define GIF_EXPORT_EXT ".gif"
+
+typedef struct {
+    int dot_pitch;              /* Pixels per braille dot (cell is 2x4 dots) */
+    int threads;                /* Encoder threads; 0 for one per core */
+    int min_delay_cs;           /* Shortest frame delay, 1/100 s */
+    int loop;                   /* Times to play; 0 loops forever */
+    const ThemeColors *theme;   /* Recolor with a theme; NULL keeps the
+                                 * recorded colors */
+} GifExportOptions;
+
+typedef struct {
+    long frames_read;           /* Recorded frames */
+    long frames_written;        /* GIF frames after merging and skipping */
+    long bytes;
+    int width;                  /* Pixels */
+    int height;
+    int threads;
+} GifExportStats;
+
+/* Defaults: 4 pixel dots, all cores, 2 cs (50 fps), loop forever */
+void gif_export_defaults(GifExportOptions *opt);
+
+/* Export a recording. Returns 0 on success; on failure returns -1 and sets
+ * *error. stats may be NULL. */
+int gif_export(const char *rec_path, const char *gif_path, const GifExportOptions *opt,
+               GifExportStats *stats, const char **error);
+
+#endif /* GIF_EXPORT_H */
@@ -0,0 +1,276 @@
+/*
+ * Recording Reader Implementation
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "rec_reader.h"
+
+/* ============ Loading ============ */
+
+static void note_frame_size(RecReader *rd, const RecFrameHeader *fh) {
+    if (fh->width > rd->max_width) rd->max_width = fh->width;
+    if (fh->height > rd->max_height) rd->max_height = fh->height;
+}
+
+/* No footer: the recorder was killed before writing the index. Every record
+ * carries its own size, so walk them up to the last complete one. */
+static const char* scan_records(RecReader *rd) {
+    const char *base = rd->map;
+    size_t pos = sizeof(RecFileHeader);
+
+    rd->pos = pos;
+    rd->frames = 0;
+    while (rd->map_size - pos >= sizeof(RecRecordHeader)) {
+        RecRecordHeader rh;
+        memcpy(&rh, base + pos, sizeof(rh));
+        if (rh.size > rd->map_size - pos - sizeof(rh)) break;   /* Cut short */
+
+        if (rh.type == REC_KEYFRAME || rh.type == REC_DELTA) {
+            RecFrameHeader fh;
+            if (rh.size < sizeof(fh)) break;
+            memcpy(&fh, base + pos + sizeof(rh), sizeof(fh));
+            if (fh.width == 0 || fh.height == 0) return "bad frame size";
+            note_frame_size(rd, &fh);
+            rd->frames++;
+        }
+        pos += sizeof(rh) + rh.size;
+    }
+    rd->end = pos;
+    if (rd->frames == 0) return "recording is empty";
+    return NULL;
+}
+
+/* Header, footer and index; frame sizes come from the frame headers the
+ * index points at. Without a footer the records are scanned instead. */
+static const char* validate(RecReader *rd) {
+    const char *base = rd->map;
+    size_t size = rd->map_size;
+
+    RecFileHeader hdr;
+    RecFileFooter footer;
+    if (size < sizeof(hdr)) return "not a recording";
+    memcpy(&hdr, base, sizeof(hdr));
+    if (memcmp(hdr.magic, FRAME_RECORDER_MAGIC, sizeof(FRAME_RECORDER_MAGIC)) != 0) {
+        return "not a recording";
+    }
+    if (hdr.version != FRAME_RECORDER_VERSION || hdr.header_size != sizeof(hdr)) {
+        return "unsupported recording version";
+    }
+    if (size < sizeof(hdr) + sizeof(footer)) return scan_records(rd);
+    memcpy(&footer, base + size - sizeof(footer), sizeof(footer));
+    if (memcmp(footer.magic, FRAME_RECORDER_MAGIC, sizeof(FRAME_RECORDER_MAGIC)) != 0) {
+        return scan_records(rd);
+    }
+
+    size_t index_room = size - sizeof(footer);
+    if (footer.index_offset < sizeof(hdr) || footer.index_offset > index_room ||
+        footer.frames != (index_room - footer.index_offset) / sizeof(RecIndexEntry) ||
+        (index_room - footer.index_offset) % sizeof(RecIndexEntry) != 0) {
+        return "bad recording index";
+    }
+    if (footer.frames == 0) return "recording is empty";
+
+    rd->pos = sizeof(hdr);
+    rd->end = (size_t)footer.index_offset;
+    rd->frames = footer.frames;
+
+    if (rd->end < rd->pos + sizeof(RecRecordHeader) + sizeof(RecFrameHeader)) {
+        return "bad recording index";
+    }
+    const char *index = base + rd->end;
+    for (uint64_t i = 0; i < footer.frames; i++) {
+        RecIndexEntry e;
+        RecFrameHeader fh;
+        memcpy(&e, index + i * sizeof(e), sizeof(e));
+        if (e.offset < rd->pos ||
+            e.offset > rd->end - sizeof(RecRecordHeader) - sizeof(fh)) {
+            return "bad recording index";
+        }
+        memcpy(&fh, base + e.offset + sizeof(RecRecordHeader), sizeof(fh));
+        if (fh.width == 0 || fh.height == 0) return "bad frame size";
+        note_frame_size(rd, &fh);
+    }
+    return NULL;
+}
+
+RecReader* rec_reader_open(const char *path, const char **error) {
+    const char *err = NULL;
+    RecReader *rd = NULL;
+    void *map = MAP_FAILED;
+    size_t size = 0;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        err = "cannot open recording";
+        goto fail;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        err = "cannot read recording";
+        goto fail;
+    }
+    size = (size_t)st.st_size;
+
+    map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED) {
+        err = "cannot map recording";
+        goto fail;
+    }
+    close(fd);
+    fd = -1;
+
+    /* Playback reads front to back */
+    madvise(map, size, MADV_SEQUENTIAL);
+
+    rd = calloc(1, sizeof(RecReader));
+    if (!rd) {
+        err = "out of memory";
+        goto fail;
+    }
+    rd->map = map;
+    rd->map_size = size;
+
+    err = validate(rd);
+    if (err) goto fail;
+
+    rd->cells = calloc((size_t)rd->max_width * rd->max_height, sizeof(Cell));
+    if (!rd->cells) {
+        err = "out of memory";
+        goto fail;
+    }
+    for (int p = 0; p < FRAME_RECORDER_PAIRS; p++) {
+        rd->palette[p][0] = rd->palette[p][1] = -1;
+    }
+    return rd;
+
+fail:
+    free(rd);
+    if (map != MAP_FAILED) munmap(map, size);
+    if (fd >= 0) close(fd);
+    if (error) *error = err;
+    return NULL;
+}
+
+void rec_reader_close(RecReader *reader) {
+    if (!reader) return;
+    munmap(reader->map, reader->map_size);
+    free(reader->cells);
+    free(reader);
+}
+
+/* ============ Playback ============ */
+
+/* Decode one UTF-8 character; malformed input gives U+FFFD and one byte */
+static int utf8_decode(const unsigned char *s, const unsigned char *end, wchar_t *out) {
+    unsigned char c = s[0];
+    int len;
+    uint32_t cp;
+    if (c < 0x80) {
+        *out = c;
+        return 1;
+    } else if ((c & 0xE0) == 0xC0) {
+        len = 2;
+        cp = c & 0x1F;
+    } else if ((c & 0xF0) == 0xE0) {
+        len = 3;
+        cp = c & 0x0F;
+    } else if ((c & 0xF8) == 0xF0) {
+        len = 4;
+        cp = c & 0x07;
+    } else {
+        *out = 0xFFFD;
+        return 1;
+    }
+    if (end - s < len) {
+        *out = 0xFFFD;
+        return 1;
+    }
+    for (int i = 1; i < len; i++) {
+        if ((s[i] & 0xC0) != 0x80) {
+            *out = 0xFFFD;
+            return 1;
+        }
+        cp = (cp << 6) | (s[i] & 0x3F);
+    }
+    *out = (wchar_t)cp;
+    return len;
+}
+
+static int apply_frame(RecReader *rd, const char *p, const char *end, bool key) {
+    RecFrameHeader fh;
+    if ((size_t)(end - p) < sizeof(fh)) return -1;
+    memcpy(&fh, p, sizeof(fh));
+    p += sizeof(fh);
+    if (fh.width == 0 || fh.height == 0 ||
+        fh.width > rd->max_width || fh.height > rd->max_height) {
+        return -1;
+    }
+
+    /* Only a keyframe may change the size; it covers every cell */
+    if (fh.width != rd->width || fh.height != rd->height) {
+        if (!key) return -1;
+        rd->width = fh.width;
+        rd->height = fh.height;
+        for (int i = 0; i < rd->width * rd->height; i++) {
+            rd->cells[i] = (Cell){ .ch = L' ', .pair = 0, .attr = 0 };
+        }
+    }
+
+    for (uint32_t r = 0; r < fh.runs; r++) {
+        RecRun run;
+        if ((size_t)(end - p) < sizeof(run)) return -1;
+        memcpy(&run, p, sizeof(run));
+        p += sizeof(run);
+        if ((size_t)(end - p) < run.bytes || run.row >= rd->height ||
+            run.len > rd->width - run.col) {
+            return -1;
+        }
+
+        const unsigned char *s = (const unsigned char *)p;
+        const unsigned char *text_end = s + run.bytes;
+        Cell *cell = rd->cells + (size_t)run.row * rd->width + run.col;
+        for (int i = 0; i < run.len; i++) {
+            wchar_t ch = L' ';
+            if (s < text_end) s += utf8_decode(s, text_end, &ch);
+            cell[i] = (Cell){ .ch = ch, .pair = run.pair, .attr = run.attr };
+        }
+        p += run.bytes;
+    }
+
+    rd->time_us = fh.time_us;
+    rd->frame++;
+    return 1;
+}
+
+int rec_reader_next(RecReader *rd) {
+    const char *base = rd->map;
+
+    while (rd->pos < rd->end) {
+        RecRecordHeader hdr;
+        if (rd->end - rd->pos < sizeof(hdr)) return -1;
+        memcpy(&hdr, base + rd->pos, sizeof(hdr));
+        const char *payload = base + rd->pos + sizeof(hdr);
+        if (hdr.size > rd->end - rd->pos - sizeof(hdr)) return -1;
+        rd->pos += sizeof(hdr) + hdr.size;
+
+        switch (hdr.type) {
+            case REC_PALETTE:
+                if (hdr.size != sizeof(rd->palette)) return -1;
+                memcpy(rd->palette, payload, sizeof(rd->palette));
+                break;
+            case REC_KEYFRAME:
+            case REC_DELTA:
+                return apply_frame(rd, payload, payload + hdr.size,
+                                   hdr.type == REC_KEYFRAME);
+            default:
+                break;          /* Record types from later versions */
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,50 @@
+/*
+ * Recording Reader - ASCII Dancer v3.2+
+ *
+ * Plays back a frame recorder container (frame_recorder.h) one frame at a
+ * time. The file is mapped read-only; each step applies the next frame's
+ * runs to a retained cell grid and tracks the color pair palette, so the
+ * caller always sees the complete frame as it was on screen.
+ *
+ * A recording cut short before its index was written (the session crashed
+ * or was killed) still plays: the records are scanned instead, up to the
+ * last complete one.
+ */
+
+#ifndef REC_READER_H
+#define REC_READER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "frame_recorder.h"
+
+typedef struct {
+    void *map;
+    size_t map_size;
+    size_t pos;                 /* Next record */
+    size_t end;                 /* Start of the index, or the end of the last
+                                 * complete record without one */
+    uint64_t frames;            /* From the footer or the record scan */
+    int max_width;              /* Largest frame in the recording */
+    int max_height;
+
+    /* Current frame: width x height cells, row-major */
+    Cell *cells;
+    int width;
+    int height;
+    uint64_t time_us;
+    uint64_t frame;             /* Frames read so far */
+    int16_t palette[FRAME_RECORDER_PAIRS][2];   /* fg, bg; -1 for default */
+} RecReader;
+
+/* Map and check a recording. Returns NULL and sets *error on failure. */
+RecReader* rec_reader_open(const char *path, const char **error);
+
+void rec_reader_close(RecReader *reader);
+
+/* Advance to the next frame. Returns 1 with the frame in reader->cells,
+ * 0 at the end of the recording, -1 on a corrupt record. */
+int rec_reader_next(RecReader *reader);
+
+#endif /* REC_READER_H */
@@ -2,14 +2,70 @@
 // Derived from cava's cavacore.c
 
 #include "cavacore.h"
+#include "../bench/bench_stages.h"
+#include <errno.h>
 #include <math.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <time.h>
 
 #ifndef M_PI
 #define M_PI 3.1415926535897932385
 #endif
 
+static enum cava_planner planner_effort = CAVA_PLANNER_MEASURE;
+
+void cava_set_planner(enum cava_planner planner) {
+    planner_effort = planner;
+}
+
+static double monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+// Wisdom file path; creates the cache directory when create is set.
+// Returns 0 on success, -1 if no usable location exists
+static int wisdom_path(char *path, size_t size, int create) {
+    const char *xdg_cache = getenv("XDG_CACHE_HOME");
+    const char *home = getenv("HOME");
+    char dir[1024];
+
+    if (xdg_cache && xdg_cache[0]) {
+        snprintf(dir, sizeof(dir), "%s", xdg_cache);
+    } else if (home && home[0]) {
+        snprintf(dir, sizeof(dir), "%s/.cache", home);
+    } else {
+        return -1;
+    }
+
+    if (create && mkdir(dir, 0755) != 0 && errno != EEXIST)
+        return -1;
+
+    size_t len = strlen(dir);
+    snprintf(dir + len, sizeof(dir) - len, "/braille-boogie");
+    if (create && mkdir(dir, 0755) != 0 && errno != EEXIST)
+        return -1;
+
+    snprintf(path, size, "%s/%s", dir, CAVA_WISDOM_FILE);
+    return 0;
+}
+
+// Plan from wisdom only if possible, otherwise run the planner and report
+// that new wisdom was generated
+static cava_fft_plan plan_r2c(int n, cava_real *in, cava_complex *out, unsigned flags,
+                              int *planned) {
+    cava_fft_plan plan = CAVA_FFTW(plan_dft_r2c_1d)(n, in, out, flags | FFTW_WISDOM_ONLY);
+    if (plan)
+        return plan;
+
+    *planned = 1;
+    return CAVA_FFTW(plan_dft_r2c_1d)(n, in, out, flags);
+}
+
 struct cava_plan *cava_init(int number_of_bars, unsigned int rate, int channels, int autosens,
                             double noise_reduction, int low_cut_off, int high_cut_off) {
     struct cava_plan *p = malloc(sizeof(struct cava_plan));
@@ -73,9 +129,10 @@ struct cava_plan *cava_init(int number_of_bars, unsigned int rate, int channels,
         power *= 2;
     p->FFTbufferSize = power;
 
-    // Input buffer holds enough samples for bass FFT
+    // Input history holds enough samples for bass FFT (mirrored, so 2x storage)
     p->input_buffer_size = p->FFTbassbufferSize * channels;
-    p->input_buffer = (double *)calloc(p->input_buffer_size, sizeof(double));
+    p->history = (cava_real *)calloc(p->input_buffer_size * 2, sizeof(cava_real));
+    p->history_pos = 0;
 
     // Calculate frequency bands
     int bars_per_channel = number_of_bars / channels;
@@ -135,9 +192,29 @@ struct cava_plan *cava_init(int number_of_bars, unsigned int rate, int channels,
         p->eq[n] /= p->FFTbuffer_upper_cut_off[n] - p->FFTbuffer_lower_cut_off[n] + 1;
     }
 
+    // Magnitudes are only needed up to the highest bin used by any bar
+    p->bass_bins = 0;
+    p->treble_bins = 0;
+    for (int n = 0; n < bars_per_channel; n++) {
+        int *bins = (n < p->bass_cut_off_bar) ? &p->bass_bins : &p->treble_bins;
+        if (p->FFTbuffer_upper_cut_off[n] + 1 > *bins)
+            *bins = p->FFTbuffer_upper_cut_off[n] + 1;
+    }
+    if (p->bass_bins > p->FFTbassbufferSize / 2 + 1)
+        p->bass_bins = p->FFTbassbufferSize / 2 + 1;
+    if (p->treble_bins > p->FFTbufferSize / 2 + 1)
+        p->treble_bins = p->FFTbufferSize / 2 + 1;
+
+    p->mag_bass_l = (cava_real *)calloc(p->FFTbassbufferSize / 2 + 1, sizeof(cava_real));
+    p->mag_bass_r = (cava_real *)calloc(p->FFTbassbufferSize / 2 + 1, sizeof(cava_real));
+    p->mag_l = (cava_real *)calloc(p->FFTbufferSize / 2 + 1, sizeof(cava_real));
+    p->mag_r = (cava_real *)calloc(p->FFTbufferSize / 2 + 1, sizeof(cava_real));
+
+    p->kernels = spectrum_kernels_select();
+
     // Create window functions
-    p->bass_multiplier = (double *)calloc(p->FFTbassbufferSize, sizeof(double));
-    p->multiplier = (double *)calloc(p->FFTbufferSize, sizeof(double));
+    p->bass_multiplier = (cava_real *)calloc(p->FFTbassbufferSize, sizeof(cava_real));
+    p->multiplier = (cava_real *)calloc(p->FFTbufferSize, sizeof(cava_real));
 
     // Hann window
     for (int i = 0; i < p->FFTbassbufferSize; i++) {
@@ -147,138 +224,166 @@ struct cava_plan *cava_init(int number_of_bars, unsigned int rate, int channels,
         p->multiplier[i] = 0.5 * (1 - cos(2 * M_PI * i / (p->FFTbufferSize - 1)));
     }
 
-    // Allocate FFTW buffers and create plans
-    int fftw_flag = FFTW_MEASURE;
+    // Allocate FFTW buffers and create plans, reusing cached wisdom
+    unsigned fftw_flag = planner_effort == CAVA_PLANNER_PATIENT ? FFTW_PATIENT
+                       : planner_effort == CAVA_PLANNER_ESTIMATE ? FFTW_ESTIMATE
+                                                                  : FFTW_MEASURE;
+    char wisdom_file[1100];
+    int have_wisdom_path = wisdom_path(wisdom_file, sizeof(wisdom_file), 0) == 0;
+    if (have_wisdom_path)
+        CAVA_FFTW(import_wisdom_from_filename)(wisdom_file);
+
+    double plan_start = monotonic_ms();
+    int planned = 0;
 
     // Left channel (or mono)
-    p->in_bass_l = fftw_alloc_real(p->FFTbassbufferSize);
-    p->in_bass_l_raw = fftw_alloc_real(p->FFTbassbufferSize);
-    p->out_bass_l = fftw_alloc_complex(p->FFTbassbufferSize / 2 + 1);
-    p->p_bass_l = fftw_plan_dft_r2c_1d(p->FFTbassbufferSize, p->in_bass_l, p->out_bass_l, fftw_flag);
+    p->in_bass_l = CAVA_FFTW(alloc_real)(p->FFTbassbufferSize);
+    p->out_bass_l = CAVA_FFTW(alloc_complex)(p->FFTbassbufferSize / 2 + 1);
+    p->p_bass_l = plan_r2c(p->FFTbassbufferSize, p->in_bass_l, p->out_bass_l, fftw_flag, &planned);
 
-    p->in_l = fftw_alloc_real(p->FFTbufferSize);
-    p->in_l_raw = fftw_alloc_real(p->FFTbufferSize);
-    p->out_l = fftw_alloc_complex(p->FFTbufferSize / 2 + 1);
-    p->p_l = fftw_plan_dft_r2c_1d(p->FFTbufferSize, p->in_l, p->out_l, fftw_flag);
+    p->in_l = CAVA_FFTW(alloc_real)(p->FFTbufferSize);
+    p->out_l = CAVA_FFTW(alloc_complex)(p->FFTbufferSize / 2 + 1);
+    p->p_l = plan_r2c(p->FFTbufferSize, p->in_l, p->out_l, fftw_flag, &planned);
 
-    memset(p->in_bass_l, 0, sizeof(double) * p->FFTbassbufferSize);
-    memset(p->in_l, 0, sizeof(double) * p->FFTbufferSize);
+    // Planning with MEASURE/PATIENT scribbles over the buffers
+    memset(p->in_bass_l, 0, sizeof(cava_real) * p->FFTbassbufferSize);
+    memset(p->in_l, 0, sizeof(cava_real) * p->FFTbufferSize);
 
     // Right channel (stereo only)
     if (channels == 2) {
-        p->in_bass_r = fftw_alloc_real(p->FFTbassbufferSize);
-        p->in_bass_r_raw = fftw_alloc_real(p->FFTbassbufferSize);
-        p->out_bass_r = fftw_alloc_complex(p->FFTbassbufferSize / 2 + 1);
-        p->p_bass_r = fftw_plan_dft_r2c_1d(p->FFTbassbufferSize, p->in_bass_r, p->out_bass_r, fftw_flag);
-
-        p->in_r = fftw_alloc_real(p->FFTbufferSize);
-        p->in_r_raw = fftw_alloc_real(p->FFTbufferSize);
-        p->out_r = fftw_alloc_complex(p->FFTbufferSize / 2 + 1);
-        p->p_r = fftw_plan_dft_r2c_1d(p->FFTbufferSize, p->in_r, p->out_r, fftw_flag);
-
-        memset(p->in_bass_r, 0, sizeof(double) * p->FFTbassbufferSize);
-        memset(p->in_r, 0, sizeof(double) * p->FFTbufferSize);
+        p->in_bass_r = CAVA_FFTW(alloc_real)(p->FFTbassbufferSize);
+        p->out_bass_r = CAVA_FFTW(alloc_complex)(p->FFTbassbufferSize / 2 + 1);
+        p->p_bass_r = plan_r2c(p->FFTbassbufferSize, p->in_bass_r, p->out_bass_r, fftw_flag,
+                               &planned);
+
+        p->in_r = CAVA_FFTW(alloc_real)(p->FFTbufferSize);
+        p->out_r = CAVA_FFTW(alloc_complex)(p->FFTbufferSize / 2 + 1);
+        p->p_r = plan_r2c(p->FFTbufferSize, p->in_r, p->out_r, fftw_flag, &planned);
+
+        memset(p->in_bass_r, 0, sizeof(cava_real) * p->FFTbassbufferSize);
+        memset(p->in_r, 0, sizeof(cava_real) * p->FFTbufferSize);
     }
 
+    p->plan_time_ms = monotonic_ms() - plan_start;
+    p->wisdom_hit = !planned;
+
+    // Persist new wisdom so the next launch skips planning
+    if (planned && wisdom_path(wisdom_file, sizeof(wisdom_file), 1) == 0)
+        CAVA_FFTW(export_wisdom_to_filename)(wisdom_file);
+
     return p;
 }
 
+// Append samples to the mirrored history: each sample is written at pos and
+// pos + size, so ingest cost is O(count) no matter how long the history is
+static void history_append(struct cava_plan *p, const double *src, int count) {
+    int size = p->input_buffer_size;
+    int pos = p->history_pos;
+
+    while (count > 0) {
+        int run = size - pos;
+        if (run > count)
+            run = count;
+        cava_real *lo = p->history + pos;
+        cava_real *hi = lo + size;
+        for (int n = 0; n < run; n++)
+            lo[n] = hi[n] = (cava_real)src[n];
+        src += run;
+        count -= run;
+        pos += run;
+        if (pos == size)
+            pos = 0;
+    }
+
+    p->history_pos = pos;
+}
+
+// De-interleave and window the newest fft_size frames straight from history.
+// Samples are in chronological order; the Hann window is symmetric, so the
+// magnitude spectrum matches the old newest-first layout.
+static void fill_fft_input(const struct cava_plan *p, int fft_size, const cava_real *window,
+                           cava_real *out_l, cava_real *out_r) {
+    const cava_real *src = p->history + p->history_pos + p->input_buffer_size -
+                        fft_size * p->audio_channels;
+
+    if (p->audio_channels == 2)
+        p->kernels->window_stereo(src, window, out_l, out_r, fft_size);
+    else
+        p->kernels->window_mono(src, window, out_l, fft_size);
+}
+
 void cava_execute(const double *cava_in, int new_samples, double *cava_out, struct cava_plan *p) {
-    // Handle overflow
+    // Handle overflow: anything older than one history length would be
+    // overwritten anyway, so keep only the newest samples
     if (new_samples > p->input_buffer_size) {
+        cava_in += new_samples - p->input_buffer_size;
         new_samples = p->input_buffer_size;
     }
 
     int silence = 1;
 
+    BENCH_STAGE_BEGIN(BENCH_STAGE_CAVA_INGEST);
     if (new_samples > 0) {
         p->framerate -= p->framerate / 64;
         p->framerate += (double)((p->rate * p->audio_channels * p->frame_skip) / new_samples) / 64;
         p->frame_skip = 1;
 
-        // Shift input buffer
-        for (int n = p->input_buffer_size - 1; n >= new_samples; n--) {
-            p->input_buffer[n] = p->input_buffer[n - new_samples];
-        }
-
-        // Fill input buffer with new samples
         for (int n = 0; n < new_samples; n++) {
-            p->input_buffer[new_samples - n - 1] = cava_in[n];
-            if (cava_in[n])
+            if (cava_in[n]) {
                 silence = 0;
+                break;
+            }
         }
+
+        history_append(p, cava_in, new_samples);
     } else {
         p->frame_skip++;
     }
 
-    // Fill FFT buffers from input buffer
-    for (int n = 0; n < p->FFTbassbufferSize; n++) {
-        if (p->audio_channels == 2) {
-            p->in_bass_r_raw[n] = p->input_buffer[n * 2];
-            p->in_bass_l_raw[n] = p->input_buffer[n * 2 + 1];
-        } else {
-            p->in_bass_l_raw[n] = p->input_buffer[n];
-        }
-    }
+    // Window FFT inputs directly from the history
+    fill_fft_input(p, p->FFTbassbufferSize, p->bass_multiplier, p->in_bass_l, p->in_bass_r);
+    fill_fft_input(p, p->FFTbufferSize, p->multiplier, p->in_l, p->in_r);
+    BENCH_STAGE_END(BENCH_STAGE_CAVA_INGEST);
 
-    for (int n = 0; n < p->FFTbufferSize; n++) {
-        if (p->audio_channels == 2) {
-            p->in_r_raw[n] = p->input_buffer[n * 2];
-            p->in_l_raw[n] = p->input_buffer[n * 2 + 1];
-        } else {
-            p->in_l_raw[n] = p->input_buffer[n];
-        }
-    }
-
-    // Apply window function
-    for (int i = 0; i < p->FFTbassbufferSize; i++) {
-        p->in_bass_l[i] = p->bass_multiplier[i] * p->in_bass_l_raw[i];
-        if (p->audio_channels == 2)
-            p->in_bass_r[i] = p->bass_multiplier[i] * p->in_bass_r_raw[i];
-    }
-    for (int i = 0; i < p->FFTbufferSize; i++) {
-        p->in_l[i] = p->multiplier[i] * p->in_l_raw[i];
-        if (p->audio_channels == 2)
-            p->in_r[i] = p->multiplier[i] * p->in_r_raw[i];
+    // Execute FFT
+    CAVA_FFTW(execute)(p->p_bass_l);
+    CAVA_FFTW(execute)(p->p_l);
+    if (p->audio_channels == 2) {
+        CAVA_FFTW(execute)(p->p_bass_r);
+        CAVA_FFTW(execute)(p->p_r);
     }
 
-    // Execute FFT
-    fftw_execute(p->p_bass_l);
-    fftw_execute(p->p_l);
+    // Magnitudes once per bin (vectorized), then plain per-bar sums
+    p->kernels->magnitude(p->out_bass_l, p->mag_bass_l, p->bass_bins);
+    p->kernels->magnitude(p->out_l, p->mag_l, p->treble_bins);
     if (p->audio_channels == 2) {
-        fftw_execute(p->p_bass_r);
-        fftw_execute(p->p_r);
+        p->kernels->magnitude(p->out_bass_r, p->mag_bass_r, p->bass_bins);
+        p->kernels->magnitude(p->out_r, p->mag_r, p->treble_bins);
     }
 
     // Process frequency bands
     int bars_per_channel = p->number_of_bars / p->audio_channels;
 
     for (int n = 0; n < bars_per_channel; n++) {
+        // Bass bars read the bass FFT, mids and treble the regular FFT
+        int bass = n < p->bass_cut_off_bar;
+        const cava_real *mag_l = bass ? p->mag_bass_l : p->mag_l;
+        const cava_real *mag_r = bass ? p->mag_bass_r : p->mag_r;
+        int lower = p->FFTbuffer_lower_cut_off[n];
+        int upper = p->FFTbuffer_upper_cut_off[n];
+
         double temp_l = 0;
-        double temp_r = 0;
-
-        // Sum FFT bins within each band
-        for (int i = p->FFTbuffer_lower_cut_off[n]; i <= p->FFTbuffer_upper_cut_off[n]; i++) {
-            if (n < p->bass_cut_off_bar) {
-                // Bass uses bass FFT
-                temp_l += hypot(p->out_bass_l[i][0], p->out_bass_l[i][1]);
-                if (p->audio_channels == 2)
-                    temp_r += hypot(p->out_bass_r[i][0], p->out_bass_r[i][1]);
-            } else {
-                // Mids and treble use regular FFT
-                temp_l += hypot(p->out_l[i][0], p->out_l[i][1]);
-                if (p->audio_channels == 2)
-                    temp_r += hypot(p->out_r[i][0], p->out_r[i][1]);
-            }
-        }
+        for (int i = lower; i <= upper; i++)
+            temp_l += mag_l[i];
 
         // Apply EQ and scaling
-        temp_l *= p->eq[n];
-        cava_out[n] = temp_l;
+        cava_out[n] = temp_l * p->eq[n];
 
         if (p->audio_channels == 2) {
-            temp_r *= p->eq[n];
-            cava_out[n + bars_per_channel] = temp_r;
+            double temp_r = 0;
+            for (int i = lower; i <= upper; i++)
+                temp_r += mag_r[i];
+            cava_out[n + bars_per_channel] = temp_r * p->eq[n];
         }
     }
 
@@ -320,7 +425,7 @@ void cava_execute(const double *cava_in, int new_samples, double *cava_out, stru
 }
 
 void cava_destroy(struct cava_plan *p) {
-    free(p->input_buffer);
+    free(p->history);
     free(p->bass_multiplier);
     free(p->multiplier);
     free(p->eq);
@@ -331,27 +436,27 @@ void cava_destroy(struct cava_plan *p) {
     free(p->cava_mem);
     free(p->cava_peak);
     free(p->prev_cava_out);
+    free(p->mag_bass_l);
+    free(p->mag_bass_r);
+    free(p->mag_l);
+    free(p->mag_r);
 
-    fftw_free(p->in_bass_l);
-    fftw_free(p->in_bass_l_raw);
-    fftw_free(p->out_bass_l);
-    fftw_destroy_plan(p->p_bass_l);
+    CAVA_FFTW(free)(p->in_bass_l);
+    CAVA_FFTW(free)(p->out_bass_l);
+    CAVA_FFTW(destroy_plan)(p->p_bass_l);
 
-    fftw_free(p->in_l);
-    fftw_free(p->in_l_raw);
-    fftw_free(p->out_l);
-    fftw_destroy_plan(p->p_l);
+    CAVA_FFTW(free)(p->in_l);
+    CAVA_FFTW(free)(p->out_l);
+    CAVA_FFTW(destroy_plan)(p->p_l);
 
     if (p->audio_channels == 2) {
-        fftw_free(p->in_bass_r);
-        fftw_free(p->in_bass_r_raw);
-        fftw_free(p->out_bass_r);
-        fftw_destroy_plan(p->p_bass_r);
-
-        fftw_free(p->in_r);
-        fftw_free(p->in_r_raw);
-        fftw_free(p->out_r);
-        fftw_destroy_plan(p->p_r);
+        CAVA_FFTW(free)(p->in_bass_r);
+        CAVA_FFTW(free)(p->out_bass_r);
+        CAVA_FFTW(destroy_plan)(p->p_bass_r);
+
+        CAVA_FFTW(free)(p->in_r);
+        CAVA_FFTW(free)(p->out_r);
+        CAVA_FFTW(destroy_plan)(p->p_r);
     }
 
     free(p);
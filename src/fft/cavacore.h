@@ -4,7 +4,18 @@
 #pragma once
 
 #include <stdint.h>
-#include <fftw3.h>
+
+#include "precision.h"
+#include "spectrum_kernels.h"
+
+// FFTW planner effort. Plans are cached as FFTW wisdom under
+// $XDG_CACHE_HOME/braille-boogie (default ~/.cache/braille-boogie), so the
+// slower planners only cost time on the first launch.
+enum cava_planner {
+    CAVA_PLANNER_ESTIMATE,
+    CAVA_PLANNER_MEASURE,
+    CAVA_PLANNER_PATIENT
+};
 
 // cava_plan: parameters used internally by cavacore
 struct cava_plan {
@@ -25,26 +36,39 @@ struct cava_plan {
     double framerate;
     double noise_reduction;
 
-    fftw_plan p_bass_l, p_bass_r;
-    fftw_plan p_l, p_r;
+    cava_fft_plan p_bass_l, p_bass_r;
+    cava_fft_plan p_l, p_r;
 
-    fftw_complex *out_bass_l, *out_bass_r;
-    fftw_complex *out_l, *out_r;
+    cava_complex *out_bass_l, *out_bass_r;
+    cava_complex *out_l, *out_r;
 
-    double *bass_multiplier;
-    double *multiplier;
+    // Per-bin magnitudes, only up to the highest bin any bar reads
+    cava_real *mag_bass_l, *mag_bass_r;
+    cava_real *mag_l, *mag_r;
+    int bass_bins;
+    int treble_bins;
 
-    double *in_bass_r_raw, *in_bass_l_raw;
-    double *in_bass_r, *in_bass_l;
+    const struct spectrum_kernels *kernels;
 
-    double *in_r_raw, *in_l_raw;
-    double *in_r, *in_l;
+    cava_real *bass_multiplier;
+    cava_real *multiplier;
+
+    cava_real *in_bass_r, *in_bass_l;
+    cava_real *in_r, *in_l;
 
     double *prev_cava_out;
     double *cava_fall;
     double *cava_mem;
     double *cava_peak;
-    double *input_buffer;
+    // Interleaved sample history, stored twice back to back (mirror buffer):
+    // the newest input_buffer_size samples are always contiguous at
+    // history[history_pos .. history_pos + input_buffer_size)
+    cava_real *history;
+    int history_pos;
+
+    // Planning cost in cava_init, reported by --analyze
+    int wisdom_hit;             // 1 if all plans came from cached wisdom
+    double plan_time_ms;
     double *eq;
     double *cut_off_frequency;
 
@@ -52,6 +76,10 @@ struct cava_plan {
     int *FFTbuffer_upper_cut_off;
 };
 
+// Select FFTW planner effort for subsequent cava_init calls
+// (default: CAVA_PLANNER_MEASURE)
+void cava_set_planner(enum cava_planner planner);
+
 // Initialize cavacore
 // Returns a plan struct that must be passed to cava_execute
 // number_of_bars: total number of frequency bars (must be divisible by channels)
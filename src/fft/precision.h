@@ -0,0 +1,20 @@
+// Sample precision for the cavacore path
+// Build with -DCAVA_SINGLE_PRECISION to run windowing, FFT and magnitudes in
+// float (fftwf_*, links -lfftw3f); the default is double (fftw_*)
+
+#pragma once
+
+#include <fftw3.h>
+
+#ifdef CAVA_SINGLE_PRECISION
+typedef float cava_real;
+#define CAVA_FFTW(name) fftwf_##name
+#define CAVA_WISDOM_FILE "fftwf-wisdom"
+#else
+typedef double cava_real;
+#define CAVA_FFTW(name) fftw_##name
+#define CAVA_WISDOM_FILE "fftw-wisdom"
+#endif
+
+typedef CAVA_FFTW(complex) cava_complex;
+typedef CAVA_FFTW(plan) cava_fft_plan;
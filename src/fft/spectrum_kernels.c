@@ -0,0 +1,276 @@
+// Vectorized spectrum kernels for cavacore
+
+#include "spectrum_kernels.h"
+#include <math.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define SPECTRUM_X86 1
+#include <immintrin.h>
+#endif
+
+// Scalar reference implementations
+
+#ifdef CAVA_SINGLE_PRECISION
+#define cava_sqrt sqrtf
+#else
+#define cava_sqrt sqrt
+#endif
+
+static void magnitude_scalar(const cava_complex *in, cava_real *mag, int count) {
+    for (int i = 0; i < count; i++)
+        mag[i] = cava_sqrt(in[i][0] * in[i][0] + in[i][1] * in[i][1]);
+}
+
+static void window_stereo_scalar(const cava_real *src, const cava_real *window,
+                                 cava_real *out_l, cava_real *out_r, int count) {
+    for (int n = 0; n < count; n++) {
+        out_l[n] = window[n] * src[n * 2];
+        out_r[n] = window[n] * src[n * 2 + 1];
+    }
+}
+
+static void window_mono_scalar(const cava_real *src, const cava_real *window, cava_real *out,
+                               int count) {
+    for (int n = 0; n < count; n++)
+        out[n] = window[n] * src[n];
+}
+
+static const struct spectrum_kernels kernels_scalar = {
+    .name = "scalar",
+    .magnitude = magnitude_scalar,
+    .window_stereo = window_stereo_scalar,
+    .window_mono = window_mono_scalar,
+};
+
+#if defined(SPECTRUM_X86) && !defined(CAVA_SINGLE_PRECISION)
+
+// SSE2 (double): two bins / two frames per iteration
+
+__attribute__((target("sse2")))
+static void magnitude_sse2(const cava_complex *in, cava_real *mag, int count) {
+    const double *p = (const double *)in;
+    int i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128d a = _mm_loadu_pd(p + i * 2);      // re0 im0
+        __m128d b = _mm_loadu_pd(p + i * 2 + 2);  // re1 im1
+        a = _mm_mul_pd(a, a);
+        b = _mm_mul_pd(b, b);
+        __m128d sum = _mm_add_pd(_mm_unpacklo_pd(a, b), _mm_unpackhi_pd(a, b));
+        _mm_storeu_pd(mag + i, _mm_sqrt_pd(sum));
+    }
+    magnitude_scalar(in + i, mag + i, count - i);
+}
+
+__attribute__((target("sse2")))
+static void window_stereo_sse2(const cava_real *src, const cava_real *window, cava_real *out_l,
+                               cava_real *out_r, int count) {
+    int n = 0;
+    for (; n + 2 <= count; n += 2) {
+        __m128d a = _mm_loadu_pd(src + n * 2);      // L0 R0
+        __m128d b = _mm_loadu_pd(src + n * 2 + 2);  // L1 R1
+        __m128d w = _mm_loadu_pd(window + n);
+        _mm_storeu_pd(out_l + n, _mm_mul_pd(w, _mm_unpacklo_pd(a, b)));
+        _mm_storeu_pd(out_r + n, _mm_mul_pd(w, _mm_unpackhi_pd(a, b)));
+    }
+    window_stereo_scalar(src + n * 2, window + n, out_l + n, out_r + n, count - n);
+}
+
+__attribute__((target("sse2")))
+static void window_mono_sse2(const cava_real *src, const cava_real *window, cava_real *out,
+                             int count) {
+    int n = 0;
+    for (; n + 2 <= count; n += 2)
+        _mm_storeu_pd(out + n, _mm_mul_pd(_mm_loadu_pd(window + n), _mm_loadu_pd(src + n)));
+    window_mono_scalar(src + n, window + n, out + n, count - n);
+}
+
+static const struct spectrum_kernels kernels_sse2 = {
+    .name = "sse2",
+    .magnitude = magnitude_sse2,
+    .window_stereo = window_stereo_sse2,
+    .window_mono = window_mono_sse2,
+};
+
+// AVX2 (double): four bins / four frames per iteration
+
+__attribute__((target("avx2")))
+static void magnitude_avx2(const cava_complex *in, cava_real *mag, int count) {
+    const double *p = (const double *)in;
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256d a = _mm256_loadu_pd(p + i * 2);      // re0 im0 re1 im1
+        __m256d b = _mm256_loadu_pd(p + i * 2 + 4);  // re2 im2 re3 im3
+        a = _mm256_mul_pd(a, a);
+        b = _mm256_mul_pd(b, b);
+        // hadd yields |0|2|1|3| ordering; permute back to |0|1|2|3|
+        __m256d sum = _mm256_permute4x64_pd(_mm256_hadd_pd(a, b), 0xD8);
+        _mm256_storeu_pd(mag + i, _mm256_sqrt_pd(sum));
+    }
+    magnitude_scalar(in + i, mag + i, count - i);
+}
+
+__attribute__((target("avx2")))
+static void window_stereo_avx2(const cava_real *src, const cava_real *window, cava_real *out_l,
+                               cava_real *out_r, int count) {
+    int n = 0;
+    for (; n + 4 <= count; n += 4) {
+        __m256d a = _mm256_loadu_pd(src + n * 2);      // L0 R0 L1 R1
+        __m256d b = _mm256_loadu_pd(src + n * 2 + 4);  // L2 R2 L3 R3
+        __m256d w = _mm256_loadu_pd(window + n);
+        __m256d l = _mm256_permute4x64_pd(_mm256_unpacklo_pd(a, b), 0xD8);
+        __m256d r = _mm256_permute4x64_pd(_mm256_unpackhi_pd(a, b), 0xD8);
+        _mm256_storeu_pd(out_l + n, _mm256_mul_pd(w, l));
+        _mm256_storeu_pd(out_r + n, _mm256_mul_pd(w, r));
+    }
+    window_stereo_scalar(src + n * 2, window + n, out_l + n, out_r + n, count - n);
+}
+
+__attribute__((target("avx2")))
+static void window_mono_avx2(const cava_real *src, const cava_real *window, cava_real *out,
+                             int count) {
+    int n = 0;
+    for (; n + 4 <= count; n += 4)
+        _mm256_storeu_pd(out + n,
+                         _mm256_mul_pd(_mm256_loadu_pd(window + n), _mm256_loadu_pd(src + n)));
+    window_mono_scalar(src + n, window + n, out + n, count - n);
+}
+
+static const struct spectrum_kernels kernels_avx2 = {
+    .name = "avx2",
+    .magnitude = magnitude_avx2,
+    .window_stereo = window_stereo_avx2,
+    .window_mono = window_mono_avx2,
+};
+
+#elif defined(SPECTRUM_X86)
+
+// SSE2 (float): four bins / four frames per iteration
+
+__attribute__((target("sse2")))
+static void magnitude_sse2(const cava_complex *in, cava_real *mag, int count) {
+    const float *p = (const float *)in;
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 a = _mm_loadu_ps(p + i * 2);      // re0 im0 re1 im1
+        __m128 b = _mm_loadu_ps(p + i * 2 + 4);  // re2 im2 re3 im3
+        a = _mm_mul_ps(a, a);
+        b = _mm_mul_ps(b, b);
+        __m128 re = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 im = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        _mm_storeu_ps(mag + i, _mm_sqrt_ps(_mm_add_ps(re, im)));
+    }
+    magnitude_scalar(in + i, mag + i, count - i);
+}
+
+__attribute__((target("sse2")))
+static void window_stereo_sse2(const cava_real *src, const cava_real *window, cava_real *out_l,
+                               cava_real *out_r, int count) {
+    int n = 0;
+    for (; n + 4 <= count; n += 4) {
+        __m128 a = _mm_loadu_ps(src + n * 2);      // L0 R0 L1 R1
+        __m128 b = _mm_loadu_ps(src + n * 2 + 4);  // L2 R2 L3 R3
+        __m128 w = _mm_loadu_ps(window + n);
+        _mm_storeu_ps(out_l + n, _mm_mul_ps(w, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0))));
+        _mm_storeu_ps(out_r + n, _mm_mul_ps(w, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1))));
+    }
+    window_stereo_scalar(src + n * 2, window + n, out_l + n, out_r + n, count - n);
+}
+
+__attribute__((target("sse2")))
+static void window_mono_sse2(const cava_real *src, const cava_real *window, cava_real *out,
+                             int count) {
+    int n = 0;
+    for (; n + 4 <= count; n += 4)
+        _mm_storeu_ps(out + n, _mm_mul_ps(_mm_loadu_ps(window + n), _mm_loadu_ps(src + n)));
+    window_mono_scalar(src + n, window + n, out + n, count - n);
+}
+
+static const struct spectrum_kernels kernels_sse2 = {
+    .name = "sse2",
+    .magnitude = magnitude_sse2,
+    .window_stereo = window_stereo_sse2,
+    .window_mono = window_mono_sse2,
+};
+
+// AVX2 (float): eight bins / eight frames per iteration.
+// shuffle_ps works per 128-bit lane, leaving 64-bit pairs in 0,2,1,3 order
+
+__attribute__((target("avx2")))
+static inline __m256 fix_lanes(__m256 v) {
+    return _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(v), 0xD8));
+}
+
+__attribute__((target("avx2")))
+static void magnitude_avx2(const cava_complex *in, cava_real *mag, int count) {
+    const float *p = (const float *)in;
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 a = _mm256_loadu_ps(p + i * 2);
+        __m256 b = _mm256_loadu_ps(p + i * 2 + 8);
+        a = _mm256_mul_ps(a, a);
+        b = _mm256_mul_ps(b, b);
+        __m256 re = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        __m256 im = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        _mm256_storeu_ps(mag + i, _mm256_sqrt_ps(fix_lanes(_mm256_add_ps(re, im))));
+    }
+    magnitude_scalar(in + i, mag + i, count - i);
+}
+
+__attribute__((target("avx2")))
+static void window_stereo_avx2(const cava_real *src, const cava_real *window, cava_real *out_l,
+                               cava_real *out_r, int count) {
+    int n = 0;
+    for (; n + 8 <= count; n += 8) {
+        __m256 a = _mm256_loadu_ps(src + n * 2);
+        __m256 b = _mm256_loadu_ps(src + n * 2 + 8);
+        __m256 w = _mm256_loadu_ps(window + n);
+        __m256 l = fix_lanes(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+        __m256 r = fix_lanes(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+        _mm256_storeu_ps(out_l + n, _mm256_mul_ps(w, l));
+        _mm256_storeu_ps(out_r + n, _mm256_mul_ps(w, r));
+    }
+    window_stereo_scalar(src + n * 2, window + n, out_l + n, out_r + n, count - n);
+}
+
+__attribute__((target("avx2")))
+static void window_mono_avx2(const cava_real *src, const cava_real *window, cava_real *out,
+                             int count) {
+    int n = 0;
+    for (; n + 8 <= count; n += 8)
+        _mm256_storeu_ps(out + n,
+                         _mm256_mul_ps(_mm256_loadu_ps(window + n), _mm256_loadu_ps(src + n)));
+    window_mono_scalar(src + n, window + n, out + n, count - n);
+}
+
+static const struct spectrum_kernels kernels_avx2 = {
+    .name = "avx2",
+    .magnitude = magnitude_avx2,
+    .window_stereo = window_stereo_avx2,
+    .window_mono = window_mono_avx2,
+};
+
+#endif // SPECTRUM_X86
+
+const struct spectrum_kernels *spectrum_kernels_get(enum spectrum_isa isa) {
+    switch (isa) {
+    case SPECTRUM_ISA_SCALAR:
+        return &kernels_scalar;
+#ifdef SPECTRUM_X86
+    case SPECTRUM_ISA_SSE2:
+        return __builtin_cpu_supports("sse2") ? &kernels_sse2 : NULL;
+    case SPECTRUM_ISA_AVX2:
+        return __builtin_cpu_supports("avx2") ? &kernels_avx2 : NULL;
+#endif
+    default:
+        return NULL;
+    }
+}
+
+const struct spectrum_kernels *spectrum_kernels_select(void) {
+    for (int isa = SPECTRUM_ISA_COUNT - 1; isa > SPECTRUM_ISA_SCALAR; isa--) {
+        const struct spectrum_kernels *k = spectrum_kernels_get((enum spectrum_isa)isa);
+        if (k)
+            return k;
+    }
+    return &kernels_scalar;
+}
@@ -0,0 +1,39 @@
+// Vectorized spectrum kernels for cavacore
+// SSE2/AVX2 implementations with a scalar reference, selected at runtime
+
+#pragma once
+
+#include "precision.h"
+
+enum spectrum_isa {
+    SPECTRUM_ISA_SCALAR,
+    SPECTRUM_ISA_SSE2,
+    SPECTRUM_ISA_AVX2,
+    SPECTRUM_ISA_COUNT
+};
+
+// Kernel table. All kernels produce the same results as the scalar versions
+// up to floating point rounding: magnitudes use sqrt(re*re + im*im) instead
+// of hypot(), which agrees to within 1e-12 relative for audio-range values
+// (1e-6 in CAVA_SINGLE_PRECISION builds).
+struct spectrum_kernels {
+    const char *name;
+
+    // mag[i] = |in[i]| for i in [0, count)
+    void (*magnitude)(const cava_complex *in, cava_real *mag, int count);
+
+    // De-interleave stereo src and apply window:
+    // out_l[n] = window[n] * src[2n], out_r[n] = window[n] * src[2n + 1]
+    void (*window_stereo)(const cava_real *src, const cava_real *window, cava_real *out_l,
+                          cava_real *out_r, int count);
+
+    // out[n] = window[n] * src[n]
+    void (*window_mono)(const cava_real *src, const cava_real *window, cava_real *out,
+                        int count);
+};
+
+// Best kernel set supported by the running CPU
+const struct spectrum_kernels *spectrum_kernels_select(void);
+
+// Specific kernel set, or NULL if not compiled in / not supported by this CPU
+const struct spectrum_kernels *spectrum_kernels_get(enum spectrum_isa isa);
@@ -24,6 +24,7 @@
 // v3.0 modules
 #include "audio/bpm_tracker.h"
 #include "audio/energy_analyzer.h"
+#include "audio/analysis.h"
 #include "effects/background_fx.h"
 
 // v3.0+ modules
@@ -31,6 +32,7 @@
 #include "audio/audio_picker.h"
 #include "ui/term_caps.h"
 #include "ui/profiler.h"
+#include "ui/frame_scheduler.h"
 
 // Default configuration
 #define DEFAULT_RATE 44100
@@ -52,10 +54,15 @@ static void print_usage(const char *name) {
     printf("Usage: %s [options]\n\n", name);
     printf("Options:\n");
     printf("  -s, --source <name>   Audio source (default: auto)\n");
+    printf("  -i, --file <path>     Play a WAV or raw PCM file (raw: 44.1kHz stereo s16le)\n");
+    printf("      --loop            Loop the input file instead of quitting at the end\n");
+    printf("      --analyze         With --file: run the analysis pipeline headless,\n");
+    printf("                        unpaced, and print throughput statistics\n");
 #ifdef PIPEWIRE
     printf("  -p, --pulse           Use PulseAudio instead of PipeWire\n");
 #endif
     printf("  -f, --fps <n>         Target framerate (default: %d)\n", cfg.target_fps);
+    printf("      --adaptive        Lower effect quality while frames run over budget\n");
     printf("  -t, --theme <name>    Color theme (13 available, press t to cycle)\n");
     printf("  -c, --config <file>   Config file path (default: ~/.config/braille-boogie/config.ini)\n");
     printf("      --no-ground       Disable ground line\n");
@@ -63,6 +70,8 @@ static void print_usage(const char *name) {
     printf("      --pick-source     Show audio source picker menu\n");
     printf("      --show-caps       Display terminal capabilities\n");
     printf("      --demo            Demo mode: all visual effects enabled\n");
+    printf("      --poses <file>    Dance a pose pack instead of the built-in poses\n");
+    printf("      --seed <n>        Effects seed, for repeatable renders (default: new each run)\n");
     printf("  -h, --help            Show this help\n");
     printf("\n");
     printf("Controls:\n");
@@ -86,9 +95,29 @@ static void print_usage(const char *name) {
     }
 }
 
-static void cycle_theme(void) {
+// Hand the renderer's current color pairs to the recorder
+static void record_palette(FrameRecorder *recorder) {
+    int16_t fg[FRAME_RECORDER_PAIRS], bg[FRAME_RECORDER_PAIRS];
+    int pairs = render_get_palette(fg, bg, FRAME_RECORDER_PAIRS);
+    frame_recorder_set_palette(recorder, fg, bg, pairs);
+}
+
+static void cycle_theme(FrameRecorder *recorder) {
     cfg.theme = (cfg.theme + 1) % THEME_COUNT;
     render_set_theme(cfg.theme);
+    // A recording in progress gets the new colors from the next frame on
+    if (recorder && frame_recorder_is_recording(recorder)) {
+        record_palette(recorder);
+    }
+}
+
+// auto_scale: size the dancer's canvas to the terminal. Allocates, so it
+// runs at startup and on resize only.
+static void fit_dancer_to_terminal(void) {
+    if (!cfg.auto_scale) return;
+    int cells_w, cells_h;
+    render_get_dancer_size(&cells_w, &cells_h);
+    dancer_set_canvas_size(cells_w, cells_h);
 }
 
 static double get_time_ms(void) {
@@ -97,6 +126,139 @@ static double get_time_ms(void) {
     return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
 }
 
+// Unpaced offline analysis: push a file through the full update pipeline
+// (cava, rhythm, BPM, energy, dancer) as fast as the CPU allows. Each frame
+// consumes exactly rate/fps frames of audio, so runs are reproducible.
+static int run_file_analysis(const char *path, int target_fps) {
+    struct audio_file file;
+
+    memset(&audio, 0, sizeof(audio));
+    audio.rate = DEFAULT_RATE;
+    audio.channels = DEFAULT_CHANNELS;
+    audio.format = DEFAULT_FORMAT;
+    audio.cava_buffer_size = 16384;
+
+    if (audio_file_open(&file, path, &audio) != 0) {
+        fprintf(stderr, "%s\n", audio.error_message);
+        return 1;
+    }
+
+    // The whole hop has to fit in the ring, or the feed would drop the
+    // start of it (a 5 fps hop of stereo 44.1 kHz is 17640 samples)
+    int hop = (int)(audio.rate / target_fps);
+    if (hop * (int)audio.channels > audio.cava_buffer_size) {
+        audio.cava_buffer_size = hop * (int)audio.channels;
+    }
+    if (audio_ring_init(&audio.ring, audio.cava_buffer_size) != 0) {
+        fprintf(stderr, "Failed to allocate audio ring buffer\n");
+        audio_file_close(&file);
+        return 1;
+    }
+
+    struct cava_plan *plan = cava_init(NUM_BARS, audio.rate, audio.channels, 1,
+                                       0.77, 50, 10000);
+    if (!plan || plan->status != 0) {
+        fprintf(stderr, "FFT init error: %s\n", plan ? plan->error_message : "out of memory");
+        free(plan);
+        audio_ring_free(&audio.ring);
+        audio_file_close(&file);
+        return 1;
+    }
+
+    double *cava_in = (double *)calloc(audio.cava_buffer_size, sizeof(double));
+    if (!cava_in) {
+        fprintf(stderr, "Failed to allocate FFT input buffer\n");
+        cava_destroy(plan);
+        audio_ring_free(&audio.ring);
+        audio_file_close(&file);
+        return 1;
+    }
+    double cava_out[NUM_BARS];
+    float spectrum[NUM_BARS];
+    struct dancer_state dancer;
+    dancer_init(&dancer);
+    RhythmState *rhythm = rhythm_init();
+    BPMTracker *bpm_tracker = bpm_tracker_create();
+    EnergyAnalyzer *energy = energy_analyzer_create();
+
+    float dt = (float)hop / audio.rate;
+    dancer_set_frame_dt(dt);
+    double elapsed = 0.0;
+    long frames = 0;
+    long onsets = 0;
+    double fft_ms = 0.0;
+
+    double start = get_time_ms();
+    while (audio_file_feed(&file, &audio, hop) > 0) {
+        int samples = (int)audio_ring_read(&audio.ring, cava_in, audio.cava_buffer_size);
+        double fft_start = get_time_ms();
+        cava_execute(cava_in, samples, cava_out, plan);
+        fft_ms += get_time_ms() - fft_start;
+
+        for (int i = 0; i < NUM_BARS; i++) {
+            cava_out[i] *= cfg.sensitivity;
+            if (cava_out[i] > 1.0) cava_out[i] = 1.0;
+            spectrum[i] = (float)cava_out[i];
+        }
+
+        rhythm_update(rhythm, spectrum, NUM_BARS, dt);
+
+        double bass, mid, treble;
+        calculate_bands(cava_out, NUM_BARS, &bass, &mid, &treble);
+
+        elapsed += dt;
+        if (rhythm_onset_detected(rhythm)) {
+            bpm_tracker_tap(bpm_tracker, elapsed);
+            onsets++;
+        }
+        bpm_tracker_update(bpm_tracker, dt);
+
+        energy_analyzer_update_bands(energy,
+            (float)bass * 0.5f, (float)bass,
+            (float)(bass + mid) * 0.5f, (float)mid,
+            (float)(mid + treble) * 0.5f, (float)treble);
+        energy_analyzer_update_pace(energy,
+            bpm_tracker_get_bpm(bpm_tracker),
+            rhythm_get_onset_strength(rhythm),
+            rhythm_onset_detected(rhythm) ? 1.0f : 0.0f);
+
+        dancer_update_with_rhythm(&dancer, bass, mid, treble,
+                                  rhythm_get_phase(rhythm),
+                                  rhythm_get_bpm(rhythm),
+                                  rhythm_onset_detected(rhythm),
+                                  rhythm_get_onset_strength(rhythm));
+        frames++;
+    }
+    double wall_ms = get_time_ms() - start;
+
+    double audio_s = audio_file_duration(&file, &audio);
+    printf("File:        %s\n", path);
+    printf("Format:      %u Hz, %u ch, %d-bit%s\n", audio.rate, audio.channels, audio.format,
+           audio.IEEE_FLOAT ? " float" : "");
+    printf("Audio:       %.2f s (%ld frames at %d fps)\n", audio_s, frames, target_fps);
+    printf("Wall time:   %.2f ms (%.2f us/frame, %.1fx realtime)\n", wall_ms,
+           frames ? wall_ms * 1000.0 / frames : 0.0,
+           wall_ms > 0 ? audio_s * 1000.0 / wall_ms : 0.0);
+    printf("FFT plans:   %.2f ms (%s, %s precision)\n", plan->plan_time_ms,
+           plan->wisdom_hit ? "cached wisdom" : "planned",
+           sizeof(cava_real) == sizeof(float) ? "single" : "double");
+    printf("cavacore:    %.2f us/frame\n", frames ? fft_ms * 1000.0 / frames : 0.0);
+    printf("Onsets:      %ld\n", onsets);
+    printf("BPM:         %.1f (confidence %d%%)\n", bpm_tracker_get_bpm(bpm_tracker),
+           (int)(bpm_tracker_get_confidence(bpm_tracker) * 100));
+    printf("Energy zone: %s\n", energy_analyzer_get_zone_name(energy));
+
+    energy_analyzer_destroy(energy);
+    bpm_tracker_destroy(bpm_tracker);
+    rhythm_destroy(rhythm);
+    dancer_cleanup();
+    free(cava_in);
+    cava_destroy(plan);
+    audio_ring_free(&audio.ring);
+    audio_file_close(&file);
+    return 0;
+}
+
 int main(int argc, char *argv[]) {
     // Initialize config with defaults
     config_init(&cfg);
@@ -117,8 +279,12 @@ int main(int argc, char *argv[]) {
     // Parse command line
     static struct option long_options[] = {
         {"source",      required_argument, 0, 's'},
+        {"file",        required_argument, 0, 'i'},
+        {"loop",        no_argument,       0, 'L'},
+        {"analyze",     no_argument,       0, 'A'},
         {"pulse",       no_argument,       0, 'p'},
         {"fps",         required_argument, 0, 'f'},
+        {"adaptive",    no_argument,       0, 'Q'},
         {"theme",       required_argument, 0, 't'},
         {"config",      required_argument, 0, 'c'},
         {"no-ground",   no_argument,       0, 'G'},
@@ -126,21 +292,35 @@ int main(int argc, char *argv[]) {
         {"pick-source", no_argument,       0, 'P'},
         {"show-caps",   no_argument,       0, 'C'},
         {"demo",        no_argument,       0, 'D'},
+        {"poses",       required_argument, 0, 'K'},
+        {"seed",        required_argument, 0, 'R'},
         {"help",        no_argument,       0, 'h'},
         {0, 0, 0, 0}
     };
 
+    const char *input_path = NULL;
+    int file_loop = 0;
+    int analyze = 0;
     int show_picker = 0;
     int show_caps = 0;
     int demo_mode = 0;
 
     int opt;
-    while ((opt = getopt_long(argc, argv, "s:pf:t:c:h", long_options, NULL)) != -1) {
+    while ((opt = getopt_long(argc, argv, "s:i:pf:t:c:h", long_options, NULL)) != -1) {
         switch (opt) {
         case 's':
             source = optarg;
             strncpy(cfg.audio_source, source, sizeof(cfg.audio_source) - 1);
             break;
+        case 'i':
+            input_path = optarg;
+            break;
+        case 'L':
+            file_loop = 1;
+            break;
+        case 'A':
+            analyze = 1;
+            break;
         case 'p':
             use_pulse = 1;
             break;
@@ -152,6 +332,9 @@ int main(int argc, char *argv[]) {
             }
             cfg.target_fps = target_fps;
             break;
+        case 'Q':
+            cfg.adaptive_quality = 1;
+            break;
         case 't':
             cfg.theme = config_theme_from_name(optarg);
             break;
@@ -171,6 +354,12 @@ int main(int argc, char *argv[]) {
         case 'D':
             demo_mode = 1;
             break;
+        case 'K':
+            strncpy(cfg.pose_pack, optarg, sizeof(cfg.pose_pack) - 1);
+            break;
+        case 'R':
+            cfg.seed = strtoull(optarg, NULL, 0);
+            break;
         case 'S':
             show_shadow = 0;
             cfg.show_shadow = 0;
@@ -184,10 +373,33 @@ int main(int argc, char *argv[]) {
         }
     }
 
-    // Check for audio backend availability
-#if !defined(PIPEWIRE) && !defined(PULSE)
-    fprintf(stderr, "Error: No audio backend compiled in. Install libpipewire or libpulse dev packages.\n");
-    return 1;
+    // A fixed seed replays the same effects for the same audio
+    uint64_t seed = cfg.seed ? cfg.seed : (uint64_t)time(NULL);
+    dancer_set_seed(seed);
+    dancer_set_particle_pool(cfg.particle_pool);
+    if (cfg.pose_pack[0]) {
+        const char *error = NULL;
+        if (dancer_set_pose_pack(cfg.pose_pack, &error) != 0) {
+            fprintf(stderr, "%s: %s\n", cfg.pose_pack, error);
+            return 1;
+        }
+    }
+
+    if (analyze) {
+        if (!input_path) {
+            fprintf(stderr, "--analyze requires --file <path>\n");
+            return 1;
+        }
+        cava_set_planner((enum cava_planner)cfg.fft_planner);
+        return run_file_analysis(input_path, target_fps);
+    }
+
+    // Check for audio backend availability (file input always works)
+#if !defined(PIPEWIRE) && !defined(PULSE) && !defined(__APPLE__)
+    if (!input_path) {
+        fprintf(stderr, "Error: No audio backend compiled in. Install libpipewire or libpulse dev packages.\n");
+        return 1;
+    }
 #endif
 
     // Show terminal capabilities if requested
@@ -216,14 +428,14 @@ int main(int argc, char *argv[]) {
     }
 
 #ifndef PIPEWIRE
-    if (!use_pulse) {
+    if (!use_pulse && !input_path) {
         fprintf(stderr, "PipeWire not available, using PulseAudio\n");
         use_pulse = 1;
     }
 #endif
 
 #ifndef PULSE
-    if (use_pulse) {
+    if (use_pulse && !input_path) {
         fprintf(stderr, "PulseAudio not available\n");
         return 1;
     }
@@ -235,13 +447,17 @@ int main(int argc, char *argv[]) {
 
     // Initialize audio data structure
     memset(&audio, 0, sizeof(audio));
-    audio.source = strdup(source);
+    audio.source = strdup(input_path ? input_path : source);
     audio.rate = DEFAULT_RATE;
     audio.channels = DEFAULT_CHANNELS;
     audio.format = DEFAULT_FORMAT;
     audio.input_buffer_size = BUFFER_SIZE * audio.channels;
     audio.cava_buffer_size = 16384;
-    audio.cava_in = (double *)calloc(audio.cava_buffer_size, sizeof(double));
+    if (audio_ring_init(&audio.ring, audio.cava_buffer_size) != 0) {
+        fprintf(stderr, "Failed to allocate audio ring buffer\n");
+        free(audio.source);
+        return 1;
+    }
     audio.terminate = 0;
     audio.threadparams = 0;
     audio.active = 1;
@@ -254,31 +470,39 @@ int main(int argc, char *argv[]) {
     pthread_t audio_thread;
     int thread_result = -1;
 
+    if (input_path) {
+        // File thread reports the real rate/channels once the header is parsed
+        audio.im = INPUT_FILE;
+        audio.file_loop = file_loop;
+        audio.threadparams = 1;
+        thread_result = pthread_create(&audio_thread, NULL, input_file, (void *)&audio);
+    } else {
 #ifdef __APPLE__
-    // macOS uses CoreAudio
-    thread_result = pthread_create(&audio_thread, NULL, input_coreaudio, (void *)&audio);
+        // macOS uses CoreAudio
+        thread_result = pthread_create(&audio_thread, NULL, input_coreaudio, (void *)&audio);
 #else
-    // Linux audio backends
+        // Linux audio backends
 #ifdef PULSE
-    if (use_pulse) {
-        if (strcmp(audio.source, "auto") == 0) {
-            getPulseDefaultSink((void *)&audio);
+        if (use_pulse) {
+            if (strcmp(audio.source, "auto") == 0) {
+                getPulseDefaultSink((void *)&audio);
+            }
+            thread_result = pthread_create(&audio_thread, NULL, input_pulse, (void *)&audio);
         }
-        thread_result = pthread_create(&audio_thread, NULL, input_pulse, (void *)&audio);
-    }
 #endif
 
 #ifdef PIPEWIRE
-    if (!use_pulse) {
-        thread_result = pthread_create(&audio_thread, NULL, input_pipewire, (void *)&audio);
-    }
+        if (!use_pulse) {
+            thread_result = pthread_create(&audio_thread, NULL, input_pipewire, (void *)&audio);
+        }
 #endif
 #endif // __APPLE__
+    }
 
     if (thread_result != 0) {
         fprintf(stderr, "Failed to start audio thread\n");
         free(audio.source);
-        free(audio.cava_in);
+        audio_ring_free(&audio.ring);
         return 1;
     }
 
@@ -294,11 +518,12 @@ int main(int argc, char *argv[]) {
         fprintf(stderr, "Audio thread error: %s\n", audio.error_message);
         pthread_join(audio_thread, NULL);
         free(audio.source);
-        free(audio.cava_in);
+        audio_ring_free(&audio.ring);
         return 1;
     }
 
-    // Initialize FFT processing
+    // Initialize FFT processing (plans come from cached FFTW wisdom when possible)
+    cava_set_planner((enum cava_planner)cfg.fft_planner);
     struct cava_plan *plan = cava_init(NUM_BARS, audio.rate, audio.channels, 1,
                                        0.77, 50, 10000);
     if (plan->status != 0) {
@@ -306,32 +531,40 @@ int main(int argc, char *argv[]) {
         audio.terminate = 1;
         pthread_join(audio_thread, NULL);
         free(audio.source);
-        free(audio.cava_in);
+        audio_ring_free(&audio.ring);
         free(plan);
         return 1;
     }
 
-    // Allocate output buffer
-    double *cava_out = (double *)calloc(NUM_BARS, sizeof(double));
+    // Analysis runs on its own thread at a fixed audio hop (v3.2+);
+    // the render loop only reads the latest published snapshot
+    AnalysisThread *analysis = analysis_create(&audio, plan, NUM_BARS,
+                                               cfg.analysis_hop, cfg.sensitivity);
+    if (!analysis || analysis_start(analysis) != 0) {
+        fprintf(stderr, "Failed to start analysis thread\n");
+        analysis_destroy(analysis);
+        audio.terminate = 1;
+        pthread_join(audio_thread, NULL);
+        cava_destroy(plan);
+        free(audio.source);
+        audio_ring_free(&audio.ring);
+        return 1;
+    }
+    unsigned long last_onset_count = 0;
 
     // Initialize dancer state
     struct dancer_state dancer;
     dancer_init(&dancer);
 
-    // Initialize rhythm detection (v2.3)
-    RhythmState *rhythm = rhythm_init();
-    float spectrum[NUM_BARS];  // Spectrum buffer for rhythm analysis
+    float spectrum[NUM_BARS];  // Spectrum buffer for the visualizer
 
     // Initialize help overlay (v2.4+)
     HelpOverlay *help = help_overlay_create();
 
-    // Initialize v3.0 modules
-    BPMTracker *bpm_tracker = bpm_tracker_create();
-    EnergyAnalyzer *energy = energy_analyzer_create();
-    
     // Background FX needs particle system - get from dancer
     ParticleSystem *particles = dancer_get_particle_system();
     BackgroundFX *bg_fx = background_fx_create(particles);
+    background_fx_seed(bg_fx, seed);
     BackgroundFXType current_bg_effect = BG_AMBIENT_FIELD;  // Match bg_fx default
     bool bg_fx_enabled = false;
 
@@ -340,17 +573,17 @@ int main(int argc, char *argv[]) {
     bool recording = false;
     Profiler *profiler = NULL;
     bool show_profiler = false;
-    double audio_start = 0, update_start = 0, render_start = 0;
+    double update_start = 0, render_start = 0;
 
     // Initialize ncurses with 256-color support
     if (render_init() != 0) {
         fprintf(stderr, "Failed to initialize ncurses\n");
+        analysis_destroy(analysis);
         audio.terminate = 1;
         pthread_join(audio_thread, NULL);
         cava_destroy(plan);
-        free(cava_out);
         free(audio.source);
-        free(audio.cava_in);
+        audio_ring_free(&audio.ring);
         return 1;
     }
 
@@ -358,8 +591,10 @@ int main(int argc, char *argv[]) {
     render_set_theme(cfg.theme);
     render_set_ground(show_ground);
     render_set_shadow(show_shadow);
+    render_set_diff_output(cfg.diff_output);
     dancer_set_ground(show_ground);   // Braille dancer ground
     dancer_set_shadow(show_shadow);   // Braille dancer shadow
+    fit_dancer_to_terminal();
 
     // Demo mode: enable all visual effects for maximum wow
     if (demo_mode) {
@@ -376,14 +611,13 @@ int main(int argc, char *argv[]) {
     // Initialize v3.0+ modules (needs ncurses for screen size)
     int sw, sh;
     getmaxyx(stdscr, sh, sw);
-    recorder = frame_recorder_create(sw, sh, NULL);  // NULL = use timestamp dir
+    recorder = frame_recorder_create(sw, sh, NULL);  // NULL = default directory
+    frame_recorder_set_asciicast(recorder, cfg.record_asciicast);
     profiler = profiler_create();
 
-    // Main loop timing
-    struct timespec frame_time = {
-        .tv_sec = 0,
-        .tv_nsec = 1000000000 / target_fps
-    };
+    // Main loop timing: absolute deadlines, measured dt
+    FrameScheduler sched;
+    frame_scheduler_init(&sched, target_fps, cfg.adaptive_quality);
 
     double sensitivity = cfg.sensitivity;
     char info_text[256];
@@ -395,6 +629,9 @@ int main(int argc, char *argv[]) {
         "aurora", "sunset", "ocean", "candy", "vapor", "ember"
     };
     
+    // Adaptive quality indicator (FRAME_QUALITY_* levels)
+    const char *quality_tags[] = { "", "[Q1]", "[Q2]", "[Q3]" };
+
     // Effect names for display
     const char *effect_names[] = {
         "None", "Ambient", "Waves", "Aura", "Burst", "Ribbons", "Rain", "Vortex"
@@ -402,79 +639,51 @@ int main(int argc, char *argv[]) {
 
     // Main loop
     while (running && !audio.terminate) {
+        // Simulation always advances by the real time since the last frame;
+        // drawing is skipped when the loop has fallen behind
+        float dt = frame_scheduler_begin(&sched);
+        int quality = frame_scheduler_get_quality(&sched);
+        dancer_set_frame_dt(dt);
+        dancer_set_quality(quality);
+
+        // SIGWINCH: refit the dancer before this frame's update
+        if (render_check_resize()) {
+            fit_dancer_to_terminal();
+        }
+
         // Start profiler frame timing
         if (show_profiler) {
             profiler_frame_start(profiler);
-            audio_start = get_time_ms();
-        }
-
-        // Process audio
-        pthread_mutex_lock(&audio.lock);
-        int samples_available = audio.samples_counter;
-        if (samples_available > 0) {
-            cava_execute(audio.cava_in, audio.samples_counter, cava_out, plan);
-            audio.samples_counter = 0;
         }
-        pthread_mutex_unlock(&audio.lock);
 
-        // Apply sensitivity
-        for (int i = 0; i < NUM_BARS; i++) {
-            cava_out[i] *= sensitivity;
-            if (cava_out[i] > 1.0) cava_out[i] = 1.0;
-        }
+        // Latest analysis snapshot. Onsets are counted by the analysis
+        // thread, so one that lands between two frames is still seen once.
+        const AnalysisSnapshot *snap = analysis_latest(analysis);
+        bool onset = snap->onset_count != last_onset_count;
+        last_onset_count = snap->onset_count;
 
-        // Convert to float spectrum for rhythm analysis
         for (int i = 0; i < NUM_BARS; i++) {
-            spectrum[i] = (float)cava_out[i];
+            spectrum[i] = (float)snap->bars[i];
         }
         
         // Update visualizer with raw spectrum (cava-style)
         dancer_update_spectrum(spectrum, NUM_BARS);
 
-        // Mark audio time
+        double bass = snap->bass, mid = snap->mid, treble = snap->treble;
+
+        // Audio time is now the analysis cost of the last hop (off-thread)
         if (show_profiler) {
-            profiler_mark_audio(profiler, get_time_ms() - audio_start);
+            profiler_mark_audio(profiler, snap->process_ms);
             update_start = get_time_ms();
         }
 
-        // Update rhythm detection (v2.3)
-        rhythm_update(rhythm, spectrum, NUM_BARS, 1.0 / target_fps);
-
-        // Calculate frequency bands
-        double bass, mid, treble;
-        calculate_bands(cava_out, NUM_BARS, &bass, &mid, &treble);
-
-        // v3.0: Update BPM tracker on detected onsets
-        float dt = 1.0f / target_fps;
-        if (rhythm_onset_detected(rhythm)) {
-            static double elapsed_time = 0.0;
-            elapsed_time += dt;
-            bpm_tracker_tap(bpm_tracker, elapsed_time);
-        }
-        bpm_tracker_update(bpm_tracker, dt);
-
-        // v3.0: Update energy analyzer with frequency bands
-        energy_analyzer_update_bands(energy, 
-            (float)bass * 0.5f,   // sub_bass estimate
-            (float)bass,
-            (float)(bass + mid) * 0.5f,  // low_mid
-            (float)mid,
-            (float)(mid + treble) * 0.5f,  // high_mid
-            (float)treble);
-        
-        // Update pace based on BPM and onset strength
-        energy_analyzer_update_pace(energy,
-            bpm_tracker_get_bpm(bpm_tracker),
-            rhythm_get_onset_strength(rhythm),
-            rhythm_onset_detected(rhythm) ? 1.0f : 0.0f);
-
         // v3.0: Update background effects
-        if (bg_fx_enabled && bg_fx) {
+        if (bg_fx_enabled && bg_fx && quality < FRAME_QUALITY_NO_BGFX) {
             background_fx_update(bg_fx, dt);
             background_fx_update_audio(bg_fx,
-                energy_analyzer_get_smoothed(energy),
+                snap->energy,
                 (float)bass, (float)mid, (float)treble,
-                rhythm_onset_detected(rhythm));
+                onset);
             background_fx_update_bands(bg_fx,
                 (float)bass * 0.5f, (float)bass,
                 (float)(bass + mid) * 0.5f, (float)mid,
@@ -484,10 +693,10 @@ int main(int argc, char *argv[]) {
         // Update dancer animation
         // Update dancer with rhythm info (v2.3)
         dancer_update_with_rhythm(&dancer, bass, mid, treble,
-                                  rhythm_get_phase(rhythm),
-                                  rhythm_get_bpm(rhythm),
-                                  rhythm_onset_detected(rhythm),
-                                  rhythm_get_onset_strength(rhythm));
+                                  analysis_phase_at(snap, get_time_ms() / 1000.0),
+                                  snap->rhythm_bpm,
+                                  onset,
+                                  snap->onset_strength);
 
         // Mark update time
         if (show_profiler) {
@@ -495,65 +704,103 @@ int main(int argc, char *argv[]) {
             render_start = get_time_ms();
         }
 
-        // Render
-        render_clear();
-        render_dancer(&dancer);
-        render_bars(bass, mid, treble);
-
-        // Update and render help overlay
-        help_overlay_update(help, 1.0f / target_fps);
-        if (help_overlay_is_active(help)) {
-            int help_sw, help_sh;
-            getmaxyx(stdscr, help_sh, help_sw);
-            help_overlay_render(help, help_sw, help_sh,
-                              theme_names[cfg.theme],
-                              bpm_tracker_get_bpm(bpm_tracker), sensitivity,
-                              show_ground, show_shadow,
-                              dancer_get_particles(), dancer_get_trails(),
-                              dancer_get_breathing());
-        }
+        // Help overlay animates even on frames that are not drawn
+        help_overlay_update(help, dt);
+
+        // Render (skipped while catching up with the frame deadline)
+        if (frame_scheduler_should_render(&sched)) {
+            // Rasterize once; the dancer, its shadow and the recorder all
+            // read this frame
+            double raster_start = get_time_ms();
+            dancer_render_frame(&dancer);
+            double raster_ms = get_time_ms() - raster_start;
+
+            render_clear();
+            render_dancer(&dancer);
+            render_bars(bass, mid, treble);
+
+            // Render help overlay
+            if (help_overlay_is_active(help)) {
+                int help_sw, help_sh;
+                getmaxyx(stdscr, help_sh, help_sw);
+                help_overlay_render(help, help_sw, help_sh,
+                                  theme_names[cfg.theme],
+                                  snap->bpm, sensitivity,
+                                  show_ground, show_shadow,
+                                  dancer_get_particles(), dancer_get_trails(),
+                                  dancer_get_breathing());
+            }
 
-        // v3.0: Enhanced info display with confidence and energy zone
-        const char *zone_name = energy_analyzer_get_zone_name(energy);
-        float bpm_conf = bpm_tracker_get_confidence(bpm_tracker);
-        float energy_ovr = dancer_get_energy_override();
-        bool energy_locked = dancer_is_energy_locked();
-        snprintf(info_text, sizeof(info_text),
-                 "%.0fbpm(%d%%) %s %s%s%s%s%s%s%s%s%s%s p:%d",
-                 bpm_tracker_get_bpm(bpm_tracker),
-                 (int)(bpm_conf * 100),
-                 zone_name,
-                 theme_names[cfg.theme],
-                 show_ground ? "[G]" : "",
-                 show_shadow ? "[R]" : "",
-                 dancer_get_particles() ? "[P]" : "",
-                 dancer_get_trails() ? "[M]" : "",
-                 dancer_get_breathing() ? "[B]" : "",
-                 bg_fx_enabled ? "[FX]" : "",
-                 bg_fx_enabled ? effect_names[current_bg_effect] : "",
-                 recording ? "[REC]" : "",
-                 energy_locked ? "[LOCK]" : (fabsf(energy_ovr) > 0.05f ? 
-                     (energy_ovr > 0 ? "[+E]" : "[-E]") : ""),
-                 dancer_get_particle_count());
-        render_info(info_text);
-        
-        // Mark render time
-        if (show_profiler) {
-            profiler_mark_render(profiler, get_time_ms() - render_start);
-            profiler_frame_end(profiler);
-            
-            // Update counts and render
-            int particle_count = dancer_get_particle_count();
-            int trail_count = dancer_get_trails() ? 100 : 0;
-            profiler_set_counts(profiler, particle_count, trail_count);
-            profiler_render(profiler);
-        }
-        
-        render_refresh();
+            // v3.0: Enhanced info display with confidence and energy zone
+            const char *zone_name = snap->energy_zone;
+            float bpm_conf = snap->bpm_confidence;
+            float energy_ovr = dancer_get_energy_override();
+            bool energy_locked = dancer_is_energy_locked();
+            snprintf(info_text, sizeof(info_text),
+                     "%.0fbpm(%d%%) %s %s%s%s%s%s%s%s%s%s%s%s p:%d",
+                     snap->bpm,
+                     (int)(bpm_conf * 100),
+                     zone_name,
+                     theme_names[cfg.theme],
+                     show_ground ? "[G]" : "",
+                     show_shadow ? "[R]" : "",
+                     dancer_get_particles() ? "[P]" : "",
+                     dancer_get_trails() ? "[M]" : "",
+                     dancer_get_breathing() ? "[B]" : "",
+                     bg_fx_enabled ? "[FX]" : "",
+                     bg_fx_enabled ? effect_names[current_bg_effect] : "",
+                     recording ? "[REC]" : "",
+                     energy_locked ? "[LOCK]" : (fabsf(energy_ovr) > 0.05f ? 
+                         (energy_ovr > 0 ? "[+E]" : "[-E]") : ""),
+                     quality_tags[quality],
+                     dancer_get_particle_count());
+            render_info(info_text);
+
+            // Mark render time
+            if (show_profiler) {
+                profiler_mark_render(profiler, get_time_ms() - render_start);
+                profiler_frame_end(profiler);
+
+                // Update counts and render
+                int particle_count = dancer_get_particle_count();
+                int trail_count = dancer_get_trails() ? 100 : 0;
+                profiler_set_counts(profiler, particle_count, trail_count);
+                if (particles) {
+                    profiler_set_particle_budget(profiler, particles->pool_size,
+                        particles_get_budget(particles, PARTICLE_OWNER_DANCER)->dropped,
+                        particles_get_budget(particles, PARTICLE_OWNER_BACKGROUND)->dropped);
+                }
+                profiler_set_schedule(profiler, frame_scheduler_budget_ms(&sched),
+                                      sched.skipped_renders, quality);
+                long out_bytes, out_full;
+                int out_cells;
+                render_get_output_stats(&out_bytes, &out_full, &out_cells);
+                profiler_set_output(profiler, out_bytes, out_full, out_cells);
+                // The shadow used to compose the whole frame a second time;
+                // the saving is estimated as one more raster, not measured
+                profiler_set_raster(profiler, raster_ms, show_shadow ? raster_ms : 0.0);
+                const DancerFrame *finalized = dancer_get_frame();
+                if (finalized) profiler_set_finalizes(profiler, finalized->double_finalizes);
+                profiler_render(profiler);
+            }
 
-        // v3.0+: Capture frame if recording
-        if (recording && recorder) {
-            frame_recorder_capture(recorder);
+            render_refresh();
+
+            // v3.0+: Capture frame if recording. The composed region is
+            // copied into the recorder's ring; its writer thread does the rest
+            if (recording && recorder) {
+                int region_w, region_h;
+                const Cell *region = render_get_region(&region_w, &region_h);
+                const DancerFrame *frame = dancer_get_frame();
+                if (region) {
+                    frame_recorder_capture(recorder, region, region_w, region_h,
+                                           (uint64_t)sched.frame_start_ns);
+                } else if (frame) {
+                    frame_recorder_capture_cells(recorder, frame->cells,
+                                                 frame->width, frame->height,
+                                                 (uint64_t)sched.frame_start_ns);
+                }
+            }
         }
 
         // Handle input
@@ -591,7 +838,7 @@ int main(int argc, char *argv[]) {
             break;
         case 't':
         case 'T':
-            cycle_theme();
+            cycle_theme(recorder);
             break;
         case 'g':
         case 'G':
@@ -643,8 +890,8 @@ int main(int argc, char *argv[]) {
                     frame_recorder_stop(recorder);
                     recording = false;
                 } else {
-                    frame_recorder_start(recorder);
-                    recording = true;
+                    record_palette(recorder);
+                    recording = frame_recorder_start(recorder) == 0;
                 }
             }
             break;
@@ -668,8 +915,8 @@ int main(int argc, char *argv[]) {
             break;
         }
 
-        // Wait for next frame
-        nanosleep(&frame_time, NULL);
+        // Sleep until the next frame deadline
+        frame_scheduler_end(&sched);
     }
 
     // v3.0+ cleanup
@@ -682,23 +929,21 @@ int main(int argc, char *argv[]) {
     // Cleanup
     render_cleanup();
 
+    // Analysis reads the ring and the plan: stop it before either goes away
+    analysis_destroy(analysis);
     audio.terminate = 1;
     pthread_join(audio_thread, NULL);
     pthread_mutex_destroy(&audio.lock);
 
     cava_destroy(plan);
     dancer_cleanup();
-    rhythm_destroy(rhythm);
     help_overlay_destroy(help);
     
     // v3.0 cleanup
-    bpm_tracker_destroy(bpm_tracker);
-    energy_analyzer_destroy(energy);
     background_fx_destroy(bg_fx);
     
-    free(cava_out);
     free(audio.source);
-    free(audio.cava_in);
+    audio_ring_free(&audio.ring);
 
     printf("Goodbye!\n");
     return 0;
@@ -0,0 +1,274 @@
+/*
+ * Cell Buffer Implementation
+ */
+
+#include "cell_buffer.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Unchanged cells bridged inside a run instead of moving the cursor;
+ * a braille cell is 3 bytes, a cursor move 6-8 */
+#define GAP_BRIDGE 2
+
+/* Typical SGR for a color pair plus bold/dim ("\033[0;1;38;5;NNNm") */
+#define SGR_BYTES 14
+
+static void fill_unknown(Cell *cells, int count) {
+    for (int i = 0; i < count; i++) {
+        cells[i].ch = CELL_UNKNOWN;
+        cells[i].pair = 0;
+        cells[i].attr = 0;
+    }
+}
+
+CellBuffer* cell_buffer_create(int width, int height) {
+    CellBuffer *cb = calloc(1, sizeof(CellBuffer));
+    if (!cb) return NULL;
+
+    if (cell_buffer_resize(cb, width, height) != 0) {
+        free(cb);
+        return NULL;
+    }
+    return cb;
+}
+
+void cell_buffer_destroy(CellBuffer *cb) {
+    if (!cb) return;
+    free(cb->front);
+    free(cb->back);
+    free(cb);
+}
+
+int cell_buffer_resize(CellBuffer *cb, int width, int height) {
+    if (!cb || width < 1 || height < 1) return -1;
+
+    size_t count = (size_t)width * height;
+    Cell *front = malloc(count * sizeof(Cell));
+    Cell *back = calloc(count, sizeof(Cell));
+    if (!front || !back) {
+        free(front);
+        free(back);
+        return -1;
+    }
+
+    free(cb->front);
+    free(cb->back);
+    cb->front = front;
+    cb->back = back;
+    cb->width = width;
+    cb->height = height;
+    fill_unknown(cb->front, (int)count);
+    return 0;
+}
+
+bool cell_buffer_set_origin(CellBuffer *cb, int row, int col) {
+    if (cb->origin_row == row && cb->origin_col == col) return false;
+    cb->origin_row = row;
+    cb->origin_col = col;
+    cell_buffer_invalidate(cb);
+    return true;
+}
+
+void cell_buffer_invalidate(CellBuffer *cb) {
+    if (cb) fill_unknown(cb->front, cb->width * cb->height);
+}
+
+void cell_buffer_begin(CellBuffer *cb) {
+    memset(cb->back, 0, (size_t)cb->width * cb->height * sizeof(Cell));
+}
+
+/* Decode one UTF-8 sequence; returns bytes consumed (at least 1) */
+static int utf8_decode(const unsigned char *s, wchar_t *out) {
+    if (s[0] < 0x80) {
+        *out = s[0];
+        return 1;
+    }
+
+    int len;
+    wchar_t ch;
+    if ((s[0] & 0xE0) == 0xC0)      { len = 2; ch = s[0] & 0x1F; }
+    else if ((s[0] & 0xF0) == 0xE0) { len = 3; ch = s[0] & 0x0F; }
+    else if ((s[0] & 0xF8) == 0xF0) { len = 4; ch = s[0] & 0x07; }
+    else { *out = L'?'; return 1; }
+
+    for (int i = 1; i < len; i++) {
+        if ((s[i] & 0xC0) != 0x80) { *out = L'?'; return i; }
+        ch = (ch << 6) | (s[i] & 0x3F);
+    }
+    *out = ch;
+    return len;
+}
+
+static int utf8_bytes(wchar_t ch) {
+    if (ch < 0x80) return 1;
+    if (ch < 0x800) return 2;
+    if (ch < 0x10000) return 3;
+    return 4;
+}
+
+int cell_buffer_put_utf8(CellBuffer *cb, int row, int col, const char *text,
+                         int16_t pair, uint16_t attr) {
+    if (row < 0 || row >= cb->height || col < 0) return 0;
+
+    const unsigned char *s = (const unsigned char *)text;
+    Cell *cells = cb->back + (size_t)row * cb->width;
+    int x = col;
+
+    while (*s && *s != '\n' && x < cb->width) {
+        wchar_t ch;
+        s += utf8_decode(s, &ch);
+        cells[x].ch = ch;
+        cells[x].pair = pair;
+        cells[x].attr = attr;
+        x++;
+    }
+    return x - col;
+}
+
+int cell_buffer_put_wcs(CellBuffer *cb, int row, int col, const wchar_t *text, int len,
+                        int16_t pair, uint16_t attr) {
+    if (row < 0 || row >= cb->height || col < 0) return 0;
+    if (len > cb->width - col) len = cb->width - col;
+
+    Cell *cells = cb->back + (size_t)row * cb->width + col;
+    for (int i = 0; i < len; i++) {
+        cells[i].ch = text[i];
+        cells[i].pair = pair;
+        cells[i].attr = attr;
+    }
+    return len > 0 ? len : 0;
+}
+
+const Cell* cell_buffer_back(const CellBuffer *cb, int row, int col) {
+    if (row < 0 || row >= cb->height || col < 0 || col >= cb->width) return NULL;
+    return &cb->back[(size_t)row * cb->width + col];
+}
+
+const Cell* cell_buffer_front(const CellBuffer *cb, int row, int col) {
+    if (row < 0 || row >= cb->height || col < 0 || col >= cb->width) return NULL;
+    return &cb->front[(size_t)row * cb->width + col];
+}
+
+void cell_buffer_forget(CellBuffer *cb, int row, int col) {
+    if (row < 0 || row >= cb->height || col < 0 || col >= cb->width) return;
+    cb->front[(size_t)row * cb->width + col].ch = CELL_UNKNOWN;
+}
+
+/* ============ Diff ============ */
+
+static inline bool needs_update(const Cell *b, const Cell *f) {
+    return memcmp(b, f, sizeof(Cell)) != 0;
+}
+
+static inline bool same_style(const Cell *c, int16_t pair, uint16_t attr) {
+    return c->pair == pair && c->attr == attr;
+}
+
+/* "\033[row;colH", 1-based */
+static int cup_bytes(int row, int col) {
+    int n = 4;
+    for (int v = row + 1; v; v /= 10) n++;
+    for (int v = col + 1; v; v /= 10) n++;
+    return n;
+}
+
+/* What redrawing a whole row would cost, as the line-per-mvprintw path did */
+static long full_row_bytes(const CellBuffer *cb, const Cell *row, int y) {
+    long bytes = 0;
+    int last_pair = -1, last_attr = -1;
+    bool started = false;
+
+    for (int x = 0; x < cb->width; x++) {
+        if (row[x].ch == CELL_EMPTY) {
+            if (started) bytes++;
+            continue;
+        }
+        if (!started) {
+            bytes += cup_bytes(cb->origin_row + y, cb->origin_col + x);
+            started = true;
+        }
+        if (row[x].pair != last_pair || row[x].attr != last_attr) {
+            bytes += SGR_BYTES;
+            last_pair = row[x].pair;
+            last_attr = row[x].attr;
+        }
+        bytes += utf8_bytes(row[x].ch);
+    }
+    return bytes;
+}
+
+int cell_buffer_diff(CellBuffer *cb, CellRunFunc emit, void *user) {
+    CellStats *st = &cb->stats;
+    memset(st, 0, sizeof(*st));
+
+    int w = cb->width;
+    int last_pair = -1, last_attr = -1;   /* Terminal style is unknown at start */
+    wchar_t text[CELL_MAX_RUN];
+
+    for (int y = 0; y < cb->height; y++) {
+        Cell *b = cb->back + (size_t)y * w;
+        Cell *f = cb->front + (size_t)y * w;
+
+        st->full_bytes += full_row_bytes(cb, b, y);
+        if (memcmp(b, f, (size_t)w * sizeof(Cell)) == 0) continue;
+
+        int cursor = -1;    /* Column the terminal cursor sits at on this row */
+        int x = 0;
+        while (x < w) {
+            if (!needs_update(&b[x], &f[x])) {
+                x++;
+                continue;
+            }
+
+            CellRun run = { .row = y, .col = x, .len = 0,
+                            .pair = b[x].pair, .attr = b[x].attr, .text = text };
+
+            while (x < w && run.len < CELL_MAX_RUN &&
+                   same_style(&b[x], run.pair, run.attr)) {
+                if (!needs_update(&b[x], &f[x])) {
+                    /* Bridge a short unchanged gap if another change follows */
+                    int g = x;
+                    while (g < w && g - x < GAP_BRIDGE &&
+                           !needs_update(&b[g], &f[g]) &&
+                           same_style(&b[g], run.pair, run.attr)) {
+                        g++;
+                    }
+                    if (g == x || g >= w || !needs_update(&b[g], &f[g]) ||
+                        run.len + (g - x) >= CELL_MAX_RUN) {
+                        break;
+                    }
+                    while (x < g) {
+                        text[run.len++] = b[x].ch == CELL_EMPTY ? L' ' : b[x].ch;
+                        x++;
+                    }
+                    continue;
+                }
+
+                text[run.len++] = b[x].ch == CELL_EMPTY ? L' ' : b[x].ch;
+                f[x] = b[x];
+                st->changed_cells++;
+                x++;
+            }
+
+            /* Estimated bytes: cursor move, style change, then the text */
+            if (cursor != run.col) {
+                st->bytes += cup_bytes(cb->origin_row + y, cb->origin_col + run.col);
+            }
+            if (run.pair != last_pair || run.attr != last_attr) {
+                st->bytes += SGR_BYTES;
+                last_pair = run.pair;
+                last_attr = run.attr;
+            }
+            for (int i = 0; i < run.len; i++) {
+                st->bytes += utf8_bytes(text[i]);
+            }
+            cursor = run.col + run.len;
+
+            emit(&run, user);
+            st->runs++;
+        }
+    }
+
+    cb->total_bytes += st->bytes;
+    return st->runs;
+}
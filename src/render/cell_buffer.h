@@ -0,0 +1,109 @@
+/*
+ * Cell Buffer - ASCII Dancer v3.2+
+ *
+ * Front/back buffer of terminal cells for a screen region. A frame is
+ * built into the back buffer, compared with what was last drawn, and only
+ * runs of changed cells are handed to an output callback. Also estimates
+ * the bytes a terminal would receive for those runs, against the cost of
+ * redrawing the whole region, so bandwidth savings can be shown.
+ */
+
+#ifndef CELL_BUFFER_H
+#define CELL_BUFFER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <wchar.h>
+
+/* Special code points (never valid characters) */
+#define CELL_EMPTY   0          /* Not drawn this frame; shown as a blank */
+#define CELL_UNKNOWN 0x7fffffff /* Front only: screen content not known */
+
+/* Cell attributes */
+#define CELL_ATTR_BOLD 0x01
+#define CELL_ATTR_DIM  0x02
+
+#define CELL_MAX_RUN 256        /* Longest run handed to the callback */
+
+typedef struct {
+    wchar_t ch;
+    int16_t pair;               /* Color pair */
+    uint16_t attr;              /* CELL_ATTR_* */
+} Cell;
+
+/* A horizontal run of cells in one style, relative to the buffer origin */
+typedef struct {
+    int row;
+    int col;
+    int len;
+    int16_t pair;
+    uint16_t attr;
+    const wchar_t *text;        /* len characters, not terminated */
+} CellRun;
+
+typedef void (*CellRunFunc)(const CellRun *run, void *user);
+
+/* Output of the last diff */
+typedef struct {
+    int changed_cells;
+    int runs;
+    long bytes;                 /* Estimated terminal bytes for the runs */
+    long full_bytes;            /* Estimated bytes for a full redraw */
+} CellStats;
+
+typedef struct {
+    int width;
+    int height;
+    int origin_row;             /* Screen position of cell (0, 0) */
+    int origin_col;
+
+    Cell *front;                /* What is on screen */
+    Cell *back;                 /* Frame being built */
+
+    CellStats stats;
+    long total_bytes;
+} CellBuffer;
+
+/* ============ Lifecycle ============ */
+
+CellBuffer* cell_buffer_create(int width, int height);
+void cell_buffer_destroy(CellBuffer *cb);
+
+/* Change size; contents are lost and the front becomes unknown */
+int cell_buffer_resize(CellBuffer *cb, int width, int height);
+
+/* Move the region; returns true (and invalidates) if it changed */
+bool cell_buffer_set_origin(CellBuffer *cb, int row, int col);
+
+/* Forget what is on screen so the next diff redraws everything */
+void cell_buffer_invalidate(CellBuffer *cb);
+
+/* ============ Building a frame ============ */
+
+/* Clear the back buffer to CELL_EMPTY */
+void cell_buffer_begin(CellBuffer *cb);
+
+/* Decode one line of UTF-8 (up to '\0' or '\n') into row starting at col.
+ * Returns the number of cells written. */
+int cell_buffer_put_utf8(CellBuffer *cb, int row, int col, const char *text,
+                         int16_t pair, uint16_t attr);
+
+/* Copy len wide characters into row starting at col. Returns cells written. */
+int cell_buffer_put_wcs(CellBuffer *cb, int row, int col, const wchar_t *text, int len,
+                        int16_t pair, uint16_t attr);
+
+/* Back and front cells, or NULL when out of range */
+const Cell* cell_buffer_back(const CellBuffer *cb, int row, int col);
+const Cell* cell_buffer_front(const CellBuffer *cb, int row, int col);
+
+/* Mark a front cell unknown (something else drew over it) */
+void cell_buffer_forget(CellBuffer *cb, int row, int col);
+
+/* ============ Output ============ */
+
+/* Emit runs of cells that differ from the front and update the front.
+ * Returns the number of runs. */
+int cell_buffer_diff(CellBuffer *cb, CellRunFunc emit, void *user);
+
+#endif /* CELL_BUFFER_H */
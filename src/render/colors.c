@@ -352,23 +352,27 @@ int colors_init(void) {
     return 0;
 }
 
-void colors_apply_theme(ColorTheme theme) {
-    /* Set up theme colors */
+void colors_get_theme(ColorTheme theme, ThemeColors *out) {
     switch (theme) {
-        case THEME_FIRE:      setup_theme_fire(&current_theme);      break;
-        case THEME_ICE:       setup_theme_ice(&current_theme);       break;
-        case THEME_NEON:      setup_theme_neon(&current_theme);      break;
-        case THEME_MATRIX:    setup_theme_matrix(&current_theme);    break;
-        case THEME_SYNTHWAVE: setup_theme_synthwave(&current_theme); break;
-        case THEME_MONO:      setup_theme_mono(&current_theme);      break;
-        case THEME_AURORA:    setup_theme_aurora(&current_theme);    break;
-        case THEME_SUNSET:    setup_theme_sunset(&current_theme);    break;
-        case THEME_OCEAN:     setup_theme_ocean(&current_theme);     break;
-        case THEME_CANDY:     setup_theme_candy(&current_theme);     break;
-        case THEME_VAPOR:     setup_theme_vapor(&current_theme);     break;
-        case THEME_EMBER:     setup_theme_ember(&current_theme);     break;
-        default:              setup_theme_default(&current_theme);   break;
+        case THEME_FIRE:      setup_theme_fire(out);      break;
+        case THEME_ICE:       setup_theme_ice(out);       break;
+        case THEME_NEON:      setup_theme_neon(out);      break;
+        case THEME_MATRIX:    setup_theme_matrix(out);    break;
+        case THEME_SYNTHWAVE: setup_theme_synthwave(out); break;
+        case THEME_MONO:      setup_theme_mono(out);      break;
+        case THEME_AURORA:    setup_theme_aurora(out);    break;
+        case THEME_SUNSET:    setup_theme_sunset(out);    break;
+        case THEME_OCEAN:     setup_theme_ocean(out);     break;
+        case THEME_CANDY:     setup_theme_candy(out);     break;
+        case THEME_VAPOR:     setup_theme_vapor(out);     break;
+        case THEME_EMBER:     setup_theme_ember(out);     break;
+        default:              setup_theme_default(out);   break;
     }
+}
+
+void colors_apply_theme(ColorTheme theme) {
+    /* Set up theme colors */
+    colors_get_theme(theme, &current_theme);
     
     /* Initialize color pairs */
     short bg = current_theme.background;
@@ -55,6 +55,9 @@ int colors_init(void);
 /* Apply a color theme */
 void colors_apply_theme(ColorTheme theme);
 
+/* Get a theme's colors without applying it (no ncurses calls) */
+void colors_get_theme(ColorTheme theme, ThemeColors *out);
+
 /* Get color pair for dancer based on energy level (0.0-1.0) */
 int colors_get_dancer_pair(float energy);
 
@@ -3,6 +3,7 @@
 
 #include "../dancer/dancer.h"
 #include "../config/config.h"
+#include "cell_buffer.h"
 
 // Initialize rendering (includes 256-color setup)
 int render_init(void);
@@ -19,6 +20,9 @@ void render_set_ground(int enabled);
 // Enable/disable shadow/reflection
 void render_set_shadow(int enabled);
 
+// Diff the dancer region cell by cell (default) or reprint it every frame
+void render_set_diff_output(int enabled);
+
 // Clear the screen (handles terminal resize)
 void render_clear(void);
 
@@ -43,8 +47,24 @@ int render_getch(void);
 // Get terminal dimensions
 void render_get_size(int *rows, int *cols);
 
-// Check if terminal was resized (returns 1 if resize occurred)
+// Check if terminal was resized (returns 1 if resize occurred); on a resize
+// the screen is reset and the new size is read
 int render_check_resize(void);
 
+// Largest dancer canvas (cells) that leaves room for the ground, shadow and
+// bars in the current terminal; at least FRAME_WIDTH x FRAME_HEIGHT
+void render_get_dancer_size(int *cells_w, int *cells_h);
+
+// Estimated terminal bytes of the last dancer frame vs a full redraw,
+// and the number of cells that changed
+void render_get_output_stats(long *bytes, long *full_bytes, int *changed_cells);
+
+// Dancer region (dancer and shadow) as composed for the last frame, for the
+// recorder; NULL when the region was drawn line by line
+const Cell* render_get_region(int *width, int *height);
+
+// Foreground/background of color pairs [0, count); returns pairs filled
+int render_get_palette(int16_t *fg, int16_t *bg, int count);
+
 // Check for 256-color support
 int render_has_256_colors(void);
@@ -1,8 +1,12 @@
 // ncurses rendering implementation with UTF-8, 256-color, ground/shadow support
 // v2.1 features: themes, ground line, shadow/reflection, terminal resize
+// v3.2+: dancer region is diffed cell by cell instead of reprinted each frame
+
+#define NCURSES_WIDECHAR 1  // mvaddnwstr / cchar_t
 
 #include "render.h"
 #include "colors.h"
+#include "cell_buffer.h"
 #include "../dancer/dancer.h"
 #include <ncurses.h>
 #include <string.h>
@@ -17,6 +21,19 @@ static int show_ground = 1;
 static int show_shadow = 1;
 static float current_energy = 0.0f;
 
+// Dancer + ground + shadow rows kept in stdscr between frames; only the
+// cells that change are written again
+#define SHADOW_ROWS 4
+
+// Rows below the dancer's region for the bars, energy meter and info line,
+// and columns kept free at each side
+#define DANCER_ROWS_RESERVED 14
+#define DANCER_MARGIN_COLS 2
+static CellBuffer *cells = NULL;
+static int diff_output = 1;
+static int cells_drawn = 0;   // Region was drawn this frame
+static int cells_composed = 0; // Back buffer holds the last dancer frame
+
 /* SIGWINCH handler for terminal resize */
 static void handle_resize(int sig) {
     (void)sig;
@@ -50,6 +67,8 @@ int render_init(void) {
 void render_cleanup(void) {
     signal(SIGWINCH, SIG_DFL);
     endwin();
+    cell_buffer_destroy(cells);
+    cells = NULL;
 }
 
 void render_set_theme(ColorTheme theme) {
@@ -64,28 +83,142 @@ void render_set_shadow(int enabled) {
     show_shadow = enabled;
 }
 
+void render_set_diff_output(int enabled) {
+    diff_output = enabled;
+    if (cells) cell_buffer_invalidate(cells);
+}
+
+// Cell the dancer drew last frame that is still on screen
+static int cell_kept(const Cell *c) {
+    return c->ch != CELL_EMPTY && c->ch != CELL_UNKNOWN;
+}
+
+// erase() everything except the cells kept from the last frame
+static void erase_around_cells(void) {
+    int rows, cols;
+    getmaxyx(stdscr, rows, cols);
+    attrset(A_NORMAL);
+
+    for (int y = 0; y < rows; y++) {
+        int ry = y - cells->origin_row;
+        int x = 0;
+
+        if (ry >= 0 && ry < cells->height) {
+            for (int cx = 0; cx < cells->width; cx++) {
+                if (!cell_kept(cell_buffer_front(cells, ry, cx))) continue;
+                int sx = cells->origin_col + cx;
+                if (sx > x) mvhline(y, x, ' ', sx - x);
+                x = sx + 1;
+            }
+        }
+        if (x < cols) {
+            move(y, x);
+            clrtoeol();
+        }
+    }
+}
+
 void render_clear(void) {
-    // Handle pending resize
-    if (resize_pending) {
-        resize_pending = 0;
-        endwin();
-        refresh();
-        clear();
+    if (diff_output && cells) {
+        erase_around_cells();
+    } else {
+        erase();
     }
-    
-    erase();
     getmaxyx(stdscr, term_rows, term_cols);
 }
 
+// Blank the kept cells before the region moves or changes size
+static void release_cells(void) {
+    attrset(A_NORMAL);
+    for (int ry = 0; ry < cells->height; ry++) {
+        for (int cx = 0; cx < cells->width; cx++) {
+            if (cell_kept(cell_buffer_front(cells, ry, cx))) {
+                mvaddch(cells->origin_row + ry, cells->origin_col + cx, ' ');
+            }
+        }
+    }
+    cell_buffer_invalidate(cells);
+}
+
+// Start a frame of the dancer region; returns 0 to use the line path instead
+static int begin_cells(int start_row, int start_col, int frame_w, int frame_h) {
+    int width = frame_w;
+    int height = frame_h + 1 + SHADOW_ROWS;
+    if (start_col + width > term_cols) width = term_cols - start_col;
+    if (start_row + height > term_rows) height = term_rows - start_row;
+    if (width < 1 || height < 1) return 0;
+
+    if (!cells) {
+        cells = cell_buffer_create(width, height);
+        if (!cells) return 0;
+    } else if (cells->width != width || cells->height != height ||
+               cells->origin_row != start_row || cells->origin_col != start_col) {
+        release_cells();
+        if (cell_buffer_resize(cells, width, height) != 0) {
+            cell_buffer_destroy(cells);
+            cells = NULL;
+            return 0;
+        }
+    }
+    cell_buffer_set_origin(cells, start_row, start_col);
+    cell_buffer_begin(cells);
+    cells_drawn = 1;
+    return 1;
+}
+
+static void emit_run(const CellRun *run, void *user) {
+    (void)user;
+    attr_t attrs = A_NORMAL;
+    if (run->attr & CELL_ATTR_BOLD) attrs |= A_BOLD;
+    if (run->attr & CELL_ATTR_DIM) attrs |= A_DIM;
+
+    attr_set(attrs, run->pair, NULL);
+    mvaddnwstr(cells->origin_row + run->row, cells->origin_col + run->col,
+               run->text, run->len);
+}
+
+// Cells drawn over by later UI (help, profiler, bars) are forgotten so the
+// next frame redraws them
+static void check_overdraw(void) {
+    cchar_t line[CELL_MAX_RUN + 1];
+    wchar_t wch[CCHARW_MAX];
+    attr_t attrs;
+    short pair;
+
+    // Rows are read back CELL_MAX_RUN cells at a time
+    for (int ry = 0; ry < cells->height; ry++) {
+        for (int x0 = 0; x0 < cells->width; x0 += CELL_MAX_RUN) {
+            int len = cells->width - x0 < CELL_MAX_RUN ? cells->width - x0 : CELL_MAX_RUN;
+            int n = mvin_wchnstr(cells->origin_row + ry, cells->origin_col + x0, line, len);
+            if (n == ERR) continue;
+
+            for (int i = 0; i < len; i++) {
+                const Cell *c = cell_buffer_front(cells, ry, x0 + i);
+                if (!cell_kept(c)) continue;
+
+                attr_t want = A_NORMAL;
+                if (c->attr & CELL_ATTR_BOLD) want |= A_BOLD;
+                if (c->attr & CELL_ATTR_DIM) want |= A_DIM;
+
+                getcchar(&line[i], wch, &attrs, &pair, NULL);
+                if (wch[0] != c->ch || pair != c->pair ||
+                    (attrs & (A_ATTRIBUTES & ~A_COLOR)) != want) {
+                    cell_buffer_forget(cells, ry, x0 + i);
+                }
+            }
+        }
+    }
+}
+
 /* Draw a horizontal ground line */
-static void render_ground_line(int ground_row) {
+static void render_ground_line(int ground_row, int frame_w) {
     if (!show_ground || ground_row >= term_rows - 4) return;
     
     attron(COLOR_PAIR(colors_get_ground_pair()) | A_DIM);
     
-    // Draw ground line using Unicode box drawing
-    int start = (term_cols - FRAME_WIDTH * 2) / 2;
-    int end = start + FRAME_WIDTH * 2;
+    // Draw ground line using Unicode box drawing, twice the dancer's width
+    int start = (term_cols - frame_w * 2) / 2;
+    int end = start + frame_w * 2;
     if (start < 2) start = 2;
     if (end > term_cols - 2) end = term_cols - 2;
     
@@ -100,58 +233,42 @@ static void render_ground_line(int ground_row) {
 }
 
 /* Draw shadow/reflection below ground line */
-static void render_shadow(struct dancer_state *state, int start_row, int start_col) {
+static void render_shadow(const DancerFrame *frame, int start_row, int start_col) {
     if (!show_shadow) return;
-    
-    // Get the frame
-    char frame[FRAME_WIDTH * FRAME_HEIGHT * 4 + FRAME_HEIGHT + 1];
-    dancer_compose_frame(state, frame);
+    int shadow_pair = colors_get_shadow_pair(current_energy);
     
     // Calculate shadow position (mirrored, below ground)
-    int ground_row = start_row + FRAME_HEIGHT;
+    int ground_row = start_row + frame->height;
     int shadow_start = ground_row + 1;
     
     if (shadow_start >= term_rows - 4) return;
     
-    attron(COLOR_PAIR(colors_get_shadow_pair(current_energy)) | A_DIM);
-    
-    // Draw upside-down (mirrored) version, only partial
-    char *lines[FRAME_HEIGHT];
-    int line_count = 0;
-    char *line = frame;
-    
-    while (*line && line_count < FRAME_HEIGHT) {
-        lines[line_count] = line;
-        char *newline = strchr(line, '\n');
-        if (newline) {
-            *newline = '\0';
-            line = newline + 1;
-        } else {
-            break;
-        }
-        line_count++;
-    }
+    attron(COLOR_PAIR(shadow_pair) | A_DIM);
     
-    // Draw shadow (inverted, only top 3-4 rows of shadow visible, fading)
-    int shadow_rows = (FRAME_HEIGHT < 4) ? FRAME_HEIGHT : 4;
+    // Draw shadow (inverted, only top 3-4 rows of shadow visible, fading),
+    // mirrored straight from the dancer's retained frame
+    int shadow_rows = (frame->height < SHADOW_ROWS) ? frame->height : SHADOW_ROWS;
     for (int i = 0; i < shadow_rows && (shadow_start + i) < term_rows - 4; i++) {
-        int src_row = FRAME_HEIGHT - 1 - i;
-        if (src_row >= 0 && src_row < line_count) {
-            mvprintw(shadow_start + i, start_col, "%s", lines[src_row]);
+        const wchar_t *row = dancer_frame_row(frame, frame->height - 1 - i);
+        if (cells_drawn) {
+            cell_buffer_put_wcs(cells, frame->height + 1 + i, 0, row, frame->width,
+                                (int16_t)shadow_pair, CELL_ATTR_DIM);
+        } else {
+            mvaddnwstr(shadow_start + i, start_col, row, frame->width);
         }
     }
     
-    attroff(COLOR_PAIR(colors_get_shadow_pair(current_energy)) | A_DIM);
+    attroff(COLOR_PAIR(shadow_pair) | A_DIM);
 }
 
+// Draws the frame last rasterized by dancer_render_frame()
 void render_dancer(struct dancer_state *state) {
-    // Buffer for braille output (4 bytes per char + newlines + null)
-    char frame[FRAME_WIDTH * FRAME_HEIGHT * 4 + FRAME_HEIGHT + 1];
-    dancer_compose_frame(state, frame);
+    const DancerFrame *frame = dancer_get_frame();
+    if (!frame) return;
 
     // Calculate center position
-    int start_row = (term_rows - FRAME_HEIGHT) / 2 - 4;
-    int start_col = (term_cols - FRAME_WIDTH) / 2;
+    int start_row = (term_rows - frame->height) / 2 - 4;
+    int start_col = (term_cols - frame->width) / 2;
 
     if (start_row < 0) start_row = 0;
     if (start_col < 0) start_col = 0;
@@ -159,36 +276,42 @@ void render_dancer(struct dancer_state *state) {
     // Calculate energy for color
     current_energy = (state->bass_intensity + state->mid_intensity + state->treble_intensity) / 3.0f;
     
-    // Draw ground line first
-    int ground_row = start_row + FRAME_HEIGHT;
-    render_ground_line(ground_row);
-    
-    // Draw shadow (reflection) below ground
-    render_shadow(state, start_row, start_col);
+    int ground_row = start_row + frame->height;
 
     // Get color pair based on energy
     int color_pair = colors_get_dancer_pair(current_energy);
-    
-    // Draw dancer with energy-based color
-    attron(COLOR_PAIR(color_pair) | A_BOLD);
-
-    char *line = frame;
-    int row = 0;
-    while (*line && row < FRAME_HEIGHT) {
-        char *newline = strchr(line, '\n');
-        if (newline) *newline = '\0';
 
-        // Use mvprintw which handles UTF-8 with proper locale
-        mvprintw(start_row + row, start_col, "%s", line);
-
-        if (newline) {
-            line = newline + 1;
-        } else {
-            break;
+    // Diffed path: build the region's cells, write only what changed.
+    // The ground row is not part of the cells, so it is drawn afterwards.
+    if (diff_output && begin_cells(start_row, start_col, frame->width, frame->height)) {
+        for (int row = 0; row < frame->height; row++) {
+            cell_buffer_put_wcs(cells, row, 0, dancer_frame_row(frame, row), frame->width,
+                                (int16_t)color_pair, CELL_ATTR_BOLD);
         }
-        row++;
+        render_shadow(frame, start_row, start_col);
+
+        cell_buffer_diff(cells, emit_run, NULL);
+        cells_composed = 1;
+        attr_set(A_NORMAL, 0, NULL);
+        render_ground_line(ground_row, frame->width);
+        return;
     }
 
+    // Line path repaints the whole region, so nothing kept is known any more
+    if (cells) cell_buffer_invalidate(cells);
+    cells_composed = 0;
+
+    // Draw ground line first
+    render_ground_line(ground_row, frame->width);
+    
+    // Draw shadow (reflection) below ground
+    render_shadow(frame, start_row, start_col);
+
+    // Draw dancer with energy-based color
+    attron(COLOR_PAIR(color_pair) | A_BOLD);
+    for (int row = 0; row < frame->height; row++) {
+        mvaddnwstr(start_row + row, start_col, dancer_frame_row(frame, row), frame->width);
+    }
     attroff(COLOR_PAIR(color_pair) | A_BOLD);
 }
 
@@ -286,6 +409,10 @@ void render_frame_info(struct dancer_state *state) {
 }
 
 void render_refresh(void) {
+    if (cells_drawn) {
+        check_overdraw();
+        cells_drawn = 0;
+    }
     refresh();
 }
 
@@ -305,14 +432,53 @@ void render_get_size(int *rows, int *cols) {
     if (cols) *cols = term_cols;
 }
 
-/* Check if terminal was resized */
+/* Check if terminal was resized; the only reader of resize_pending, so a
+ * SIGWINCH always reaches the caller. Lets ncurses re-read the terminal
+ * size and forgets everything on screen. */
 int render_check_resize(void) {
-    if (resize_pending) {
-        resize_pending = 0;
-        getmaxyx(stdscr, term_rows, term_cols);
-        return 1;
+    if (!resize_pending) return 0;
+    resize_pending = 0;
+    endwin();
+    refresh();
+    clear();
+    if (cells) cell_buffer_invalidate(cells);
+    getmaxyx(stdscr, term_rows, term_cols);
+    return 1;
+}
+
+void render_get_dancer_size(int *cells_w, int *cells_h) {
+    // render_dancer centers the region 4 rows above the middle; the ground
+    // and shadow rows below it must end above the bars
+    int w = term_cols - DANCER_MARGIN_COLS * 2;
+    int h = term_rows - DANCER_ROWS_RESERVED;
+    if (cells_w) *cells_w = w > FRAME_WIDTH ? w : FRAME_WIDTH;
+    if (cells_h) *cells_h = h > FRAME_HEIGHT ? h : FRAME_HEIGHT;
+}
+
+/* Output estimate of the last diffed dancer frame (zeros on the line path) */
+void render_get_output_stats(long *bytes, long *full_bytes, int *changed_cells) {
+    const CellStats *st = (diff_output && cells) ? &cells->stats : NULL;
+    if (bytes) *bytes = st ? st->bytes : 0;
+    if (full_bytes) *full_bytes = st ? st->full_bytes : 0;
+    if (changed_cells) *changed_cells = st ? st->changed_cells : 0;
+}
+
+const Cell* render_get_region(int *width, int *height) {
+    if (!cells || !cells_composed) return NULL;
+    *width = cells->width;
+    *height = cells->height;
+    return cells->back;
+}
+
+int render_get_palette(int16_t *fg, int16_t *bg, int count) {
+    if (count > COLOR_PAIRS) count = COLOR_PAIRS;
+    for (int p = 0; p < count; p++) {
+        short f = -1, b = -1;
+        if (p > 0 && pair_content((short)p, &f, &b) == ERR) f = b = -1;
+        fg[p] = f;
+        bg[p] = b;
     }
-    return 0;
+    return count;
 }
 
 /* Get 256-color support status */
@@ -0,0 +1,259 @@
+/*
+ * Pose Pack Compiler - ASCII Dancer v3.2+
+ *
+ * Compiles pose text into a binary pose pack (src/braille/pose_pack.h) that
+ * the dancer maps at startup, and dumps packs back to text. The built-in
+ * poses in the same text form come from `pose_gen --text`.
+ *
+ * Pose text is whitespace separated; '#' starts a comment. Each pose is
+ *
+ *   pose <name> <category> <energy_min> <energy_max>
+ *        <bass_affinity> <treble_affinity> <facing> <dip>
+ *        <x y> x 15            joints in JointID order, head to foot_r
+ *
+ * Category is a name ("groove", "bass_hit", ...) or a number. Coordinates
+ * are normalized (0-1, y down) like the built-in poses; facing is radians.
+ * Pose order is kept, so the first pose is the one the dancer starts in.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <getopt.h>
+
+#include "braille/pose_pack.h"
+#include "braille/pose_index.h"
+
+#define TOKEN_MAX 64
+
+typedef struct {
+    FILE *f;
+    const char *path;
+    int line;
+    int eof;                    /* Input ran out; token is empty */
+    char token[TOKEN_MAX];
+} Lexer;
+
+/* Next whitespace-separated token; returns 0 at end of input */
+static int next_token(Lexer *lx) {
+    int c;
+    for (;;) {
+        c = fgetc(lx->f);
+        if (c == '#') {
+            while (c != EOF && c != '\n') c = fgetc(lx->f);
+        }
+        if (c == EOF) {
+            lx->eof = 1;
+            lx->token[0] = '\0';
+            return 0;
+        }
+        if (c == '\n') lx->line++;
+        if (!isspace(c)) break;
+    }
+
+    int n = 0;
+    while (c != EOF && !isspace(c) && c != '#') {
+        if (n < TOKEN_MAX - 1) lx->token[n++] = (char)c;
+        c = fgetc(lx->f);
+    }
+    if (c != EOF) ungetc(c, lx->f);
+    lx->token[n] = '\0';
+    return 1;
+}
+
+static int parse_error(const Lexer *lx, const char *what) {
+    if (lx->eof) {
+        fprintf(stderr, "%s:%d: unexpected end of file (%s)\n", lx->path, lx->line, what);
+    } else {
+        fprintf(stderr, "%s:%d: %s (got \"%s\")\n", lx->path, lx->line, what, lx->token);
+    }
+    return -1;
+}
+
+static int read_float(Lexer *lx, const char *what, float *out) {
+    if (!next_token(lx)) return parse_error(lx, what);
+    char *end;
+    float v = strtof(lx->token, &end);
+    if (*end != '\0' || !isfinite(v)) return parse_error(lx, what);
+    *out = v;
+    return 0;
+}
+
+static int read_pose(Lexer *lx, Pose *p) {
+    memset(p, 0, sizeof(*p));
+    p->num_joints = JOINT_COUNT;
+
+    if (!next_token(lx)) return parse_error(lx, "expected pose name");
+    if (strlen(lx->token) >= sizeof(p->name)) return parse_error(lx, "pose name too long");
+    strcpy(p->name, lx->token);
+
+    if (!next_token(lx)) return parse_error(lx, "expected category");
+    int cat = pose_category_from_name(lx->token);
+    if (cat < 0) {
+        char *end;
+        long v = strtol(lx->token, &end, 10);
+        if (*end != '\0' || v < 0 || v >= POSE_CAT_COUNT) {
+            return parse_error(lx, "unknown category");
+        }
+        cat = (int)v;
+    }
+    p->category = (PoseCategory)cat;
+
+    if (read_float(lx, "expected energy_min", &p->energy_min) ||
+        read_float(lx, "expected energy_max", &p->energy_max) ||
+        read_float(lx, "expected bass_affinity", &p->bass_affinity) ||
+        read_float(lx, "expected treble_affinity", &p->treble_affinity) ||
+        read_float(lx, "expected facing", &p->facing) ||
+        read_float(lx, "expected dip", &p->dip_amount)) {
+        return -1;
+    }
+    for (int j = 0; j < JOINT_COUNT; j++) {
+        if (read_float(lx, "expected joint x", &p->joints[j].x) ||
+            read_float(lx, "expected joint y", &p->joints[j].y)) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* Read every pose in a text file; returns the count or -1 */
+static int read_poses(const char *path, Pose **out) {
+    Lexer lx = { .path = path, .line = 1 };
+    lx.f = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+    if (!lx.f) {
+        fprintf(stderr, "Cannot open %s\n", path);
+        return -1;
+    }
+
+    Pose *poses = NULL;
+    int count = 0, cap = 0;
+    int result = 0;
+
+    while (next_token(&lx)) {
+        if (strcmp(lx.token, "pose") != 0) {
+            result = parse_error(&lx, "expected \"pose\"");
+            break;
+        }
+        if (count == cap) {
+            cap = cap ? cap * 2 : 1024;
+            Pose *grown = realloc(poses, (size_t)cap * sizeof(Pose));
+            if (!grown) {
+                fprintf(stderr, "Out of memory\n");
+                result = -1;
+                break;
+            }
+            poses = grown;
+        }
+        if (read_pose(&lx, &poses[count]) != 0) {
+            result = -1;
+            break;
+        }
+        count++;
+    }
+
+    if (lx.f != stdin) fclose(lx.f);
+    if (result != 0) {
+        free(poses);
+        return -1;
+    }
+    *out = poses;
+    return count;
+}
+
+static int compile(const char *in_path, const char *out_path) {
+    Pose *poses = NULL;
+    int count = read_poses(in_path, &poses);
+    if (count < 0) return 1;
+    if (count == 0) {
+        fprintf(stderr, "%s: no poses\n", in_path);
+        return 1;
+    }
+
+    /* Category index, laid out for nearest-pose queries at build time */
+    PoseLibrary lib = { .poses = poses, .num_poses = count };
+    uint32_t *index = malloc((size_t)count * sizeof(uint32_t));
+    PoseFeatures *features = malloc((size_t)count * sizeof(PoseFeatures));
+    if (!index || !features) {
+        fprintf(stderr, "Out of memory\n");
+        free(index);
+        free(features);
+        free(poses);
+        return 1;
+    }
+    pose_index_build(poses, count, index, features, lib.category_start);
+    lib.by_category = index;
+    lib.features = features;
+
+    int rc = pose_pack_write(&lib, out_path);
+    if (rc != 0) {
+        fprintf(stderr, "Cannot write %s\n", out_path);
+    } else {
+        fprintf(stderr, "%s: %d poses\n", out_path, count);
+    }
+    free(index);
+    free(features);
+    free(poses);
+    return rc != 0;
+}
+
+static int dump(const char *path) {
+    const char *error = NULL;
+    PosePack *pack = pose_pack_open(path, &error);
+    if (!pack) {
+        fprintf(stderr, "%s: %s\n", path, error);
+        return 1;
+    }
+    for (int i = 0; i < pack->library.num_poses; i++) {
+        pose_pack_print_pose(stdout, &pack->library.poses[i]);
+    }
+    pose_pack_close(pack);
+    return 0;
+}
+
+static void print_usage(const char *name) {
+    printf("Usage: %s [-o out.pack] <poses.txt|->\n", name);
+    printf("       %s --dump <file.pack>\n\n", name);
+    printf("Compile pose text into a pose pack, or print a pack as pose text\n\n");
+    printf("Options:\n");
+    printf("  -o, --output <path>   Pack to write (default: poses.pack)\n");
+    printf("  -d, --dump            Print the poses of a pack as text\n");
+    printf("  -h, --help            Show this help\n");
+}
+
+int main(int argc, char *argv[]) {
+    static struct option long_options[] = {
+        {"output", required_argument, 0, 'o'},
+        {"dump",   no_argument,       0, 'd'},
+        {"help",   no_argument,       0, 'h'},
+        {0, 0, 0, 0}
+    };
+
+    const char *out_path = "poses.pack";
+    int dump_mode = 0;
+
+    int opt;
+    while ((opt = getopt_long(argc, argv, "o:dh", long_options, NULL)) != -1) {
+        switch (opt) {
+            case 'o':
+                out_path = optarg;
+                break;
+            case 'd':
+                dump_mode = 1;
+                break;
+            case 'h':
+                print_usage(argv[0]);
+                return 0;
+            default:
+                print_usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (optind != argc - 1) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    return dump_mode ? dump(argv[optind]) : compile(argv[optind], out_path);
+}
@@ -0,0 +1,140 @@
+/*
+ * Frame Scheduler Implementation
+ */
+
+#include "frame_scheduler.h"
+#include <errno.h>
+#include <string.h>
+
+#define NS_PER_SEC 1000000000LL
+
+#define MAX_DT 0.1f                /* Clamp dt after stalls (suspend, debugger) */
+#define MAX_CONSECUTIVE_SKIPS 4    /* Draw at least every 5th frame */
+#define RESYNC_PERIODS 4           /* Drop the backlog when this far behind */
+
+/* Adaptive quality: step down after sustained overload, recover slowly */
+#define WORK_SMOOTHING 0.1         /* EMA factor for work time */
+#define HIGH_MARK 0.9              /* Fraction of budget that counts as overload */
+#define LOW_MARK 0.5               /* Fraction of budget that counts as headroom */
+#define DEGRADE_FRAMES 30
+#define RECOVER_FRAMES 180
+
+static int64_t ts_to_ns(const struct timespec *ts) {
+    return (int64_t)ts->tv_sec * NS_PER_SEC + ts->tv_nsec;
+}
+
+static void ns_to_ts(int64_t ns, struct timespec *ts) {
+    ts->tv_sec = (time_t)(ns / NS_PER_SEC);
+    ts->tv_nsec = (long)(ns % NS_PER_SEC);
+}
+
+static int64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts_to_ns(&ts);
+}
+
+/* Sleep until an absolute CLOCK_MONOTONIC deadline */
+static void sleep_until(const struct timespec *deadline) {
+#ifdef __APPLE__
+    int64_t rel = ts_to_ns(deadline) - now_ns();
+    if (rel > 0) {
+        struct timespec ts;
+        ns_to_ts(rel, &ts);
+        nanosleep(&ts, NULL);
+    }
+#else
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, deadline, NULL) == EINTR)
+        ;
+#endif
+}
+
+void frame_scheduler_init(FrameScheduler *fs, int target_fps, bool adaptive) {
+    memset(fs, 0, sizeof(*fs));
+    if (target_fps < 1) target_fps = 1;
+
+    fs->period_ns = NS_PER_SEC / target_fps;
+    fs->adaptive = adaptive;
+    fs->quality = FRAME_QUALITY_FULL;
+    fs->render = true;
+    fs->dt = (float)fs->period_ns / NS_PER_SEC;
+
+    int64_t now = now_ns();
+    fs->last_start_ns = now - fs->period_ns;
+    ns_to_ts(now, &fs->deadline);
+}
+
+float frame_scheduler_begin(FrameScheduler *fs) {
+    int64_t now = now_ns();
+    fs->frame_start_ns = now;
+
+    fs->dt = (float)(now - fs->last_start_ns) / NS_PER_SEC;
+    if (fs->dt <= 0.0f) fs->dt = (float)fs->period_ns / NS_PER_SEC;
+    if (fs->dt > MAX_DT) fs->dt = MAX_DT;
+    fs->last_start_ns = now;
+
+    /* More than a whole period late: simulate, but don't spend time drawing */
+    int64_t lateness = now - ts_to_ns(&fs->deadline);
+    if (lateness > fs->period_ns && fs->consecutive_skips < MAX_CONSECUTIVE_SKIPS) {
+        fs->render = false;
+        fs->consecutive_skips++;
+        fs->skipped_renders++;
+    } else {
+        fs->render = true;
+        fs->consecutive_skips = 0;
+    }
+
+    return fs->dt;
+}
+
+bool frame_scheduler_should_render(const FrameScheduler *fs) {
+    return fs->render;
+}
+
+static void adapt_quality(FrameScheduler *fs) {
+    double budget_ms = frame_scheduler_budget_ms(fs);
+
+    if (fs->work_avg_ms > budget_ms * HIGH_MARK) {
+        fs->under_budget = 0;
+        if (++fs->over_budget >= DEGRADE_FRAMES && fs->quality < FRAME_QUALITY_MINIMAL) {
+            fs->quality++;
+            fs->over_budget = 0;
+        }
+    } else if (fs->work_avg_ms < budget_ms * LOW_MARK) {
+        fs->over_budget = 0;
+        if (++fs->under_budget >= RECOVER_FRAMES && fs->quality > FRAME_QUALITY_FULL) {
+            fs->quality--;
+            fs->under_budget = 0;
+        }
+    } else {
+        fs->over_budget = 0;
+        fs->under_budget = 0;
+    }
+}
+
+void frame_scheduler_end(FrameScheduler *fs) {
+    int64_t now = now_ns();
+    double work_ms = (double)(now - fs->frame_start_ns) / 1e6;
+    fs->work_avg_ms += (work_ms - fs->work_avg_ms) * WORK_SMOOTHING;
+
+    if (fs->adaptive) {
+        adapt_quality(fs);
+    }
+
+    /* Absolute deadlines: sleep only for what is left of the period */
+    int64_t deadline = ts_to_ns(&fs->deadline) + fs->period_ns;
+    if (now - deadline > RESYNC_PERIODS * fs->period_ns) {
+        deadline = now;
+    }
+    ns_to_ts(deadline, &fs->deadline);
+
+    sleep_until(&fs->deadline);
+}
+
+int frame_scheduler_get_quality(const FrameScheduler *fs) {
+    return fs->adaptive ? fs->quality : FRAME_QUALITY_FULL;
+}
+
+double frame_scheduler_budget_ms(const FrameScheduler *fs) {
+    return (double)fs->period_ns / 1e6;
+}
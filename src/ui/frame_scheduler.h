@@ -0,0 +1,63 @@
+/*
+ * Frame Scheduler - ASCII Dancer v3.2+
+ *
+ * Paces the main loop against absolute deadlines, so frame time is the
+ * frame period rather than work time plus a fixed sleep. Reports the
+ * measured dt for simulation, skips rendering (never simulation) when the
+ * loop falls behind, and optionally steps effect quality down while the
+ * frame budget is being exceeded.
+ */
+
+#ifndef FRAME_SCHEDULER_H
+#define FRAME_SCHEDULER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+/* Adaptive quality levels; each level includes the savings of the ones above */
+#define FRAME_QUALITY_FULL       0   /* Everything the user enabled */
+#define FRAME_QUALITY_NO_BGFX    1   /* Background effects paused */
+#define FRAME_QUALITY_NO_TRAILS  2   /* Motion trails and shadow not drawn */
+#define FRAME_QUALITY_MINIMAL    3   /* No new particles spawned */
+
+typedef struct {
+    /* Pacing */
+    int64_t period_ns;
+    struct timespec deadline;   /* Absolute CLOCK_MONOTONIC start of next frame */
+    int64_t frame_start_ns;
+    int64_t last_start_ns;
+    float dt;                   /* Measured seconds since previous frame */
+
+    /* Render skipping */
+    bool render;                /* False when this frame should not be drawn */
+    int consecutive_skips;
+    long skipped_renders;       /* Total */
+
+    /* Adaptive quality */
+    bool adaptive;
+    int quality;                /* FRAME_QUALITY_* */
+    double work_avg_ms;         /* Smoothed work time per frame */
+    int over_budget;            /* Consecutive frames above the high mark */
+    int under_budget;           /* Consecutive frames below the low mark */
+} FrameScheduler;
+
+/* Initialize for a target frame rate; the first deadline is one period from now */
+void frame_scheduler_init(FrameScheduler *fs, int target_fps, bool adaptive);
+
+/* Start a frame: measures dt and decides whether to render. Returns dt. */
+float frame_scheduler_begin(FrameScheduler *fs);
+
+/* Whether the current frame should be rendered */
+bool frame_scheduler_should_render(const FrameScheduler *fs);
+
+/* End a frame: records work time, adapts quality, sleeps until the deadline */
+void frame_scheduler_end(FrameScheduler *fs);
+
+/* Current adaptive quality level (FRAME_QUALITY_FULL when not adaptive) */
+int frame_scheduler_get_quality(const FrameScheduler *fs);
+
+/* Frame budget in milliseconds */
+double frame_scheduler_budget_ms(const FrameScheduler *fs);
+
+#endif /* FRAME_SCHEDULER_H */
@@ -22,6 +22,7 @@ Profiler* profiler_create(void) {
     
     prof->fps_min = 999999.0;
     prof->fps_max = 0.0;
+    prof->budget_ms = 16.67;
     prof->x = 2;
     prof->y = 2;
     prof->enabled = false;
@@ -95,6 +96,39 @@ void profiler_set_counts(Profiler *prof, int particles, int trails) {
     prof->trail_segments = trails;
 }
 
+void profiler_set_particle_budget(Profiler *prof, int pool, long dropped_dancer,
+                                  long dropped_background) {
+    if (!prof) return;
+    prof->particle_pool = pool;
+    prof->dropped_dancer = dropped_dancer;
+    prof->dropped_background = dropped_background;
+}
+
+void profiler_set_schedule(Profiler *prof, double budget_ms, long skipped, int quality) {
+    if (!prof) return;
+    prof->budget_ms = budget_ms;
+    prof->skipped_renders = skipped;
+    prof->quality_level = quality;
+}
+
+void profiler_set_output(Profiler *prof, long bytes, long full_bytes, int cells) {
+    if (!prof) return;
+    prof->output_bytes = bytes;
+    prof->output_full_bytes = full_bytes;
+    prof->output_cells = cells;
+}
+
+void profiler_set_raster(Profiler *prof, double ms, double saved_ms) {
+    if (!prof) return;
+    prof->raster_ms = ms;
+    prof->raster_saved_ms = saved_ms;
+}
+
+void profiler_set_finalizes(Profiler *prof, unsigned long double_finalizes) {
+    if (!prof) return;
+    prof->double_finalizes = double_finalizes;
+}
+
 void profiler_toggle(Profiler *prof) {
     if (prof) prof->enabled = !prof->enabled;
 }
@@ -132,16 +166,39 @@ void profiler_render(Profiler *prof) {
     
     /* Object counts */
     mvprintw(y + 10, x, "╟───────────────────────────╢");
-    mvprintw(y + 11, x, "║ Particles: %4d/256     ║", prof->active_particles);
-    mvprintw(y + 12, x, "║ Trails:    %4d          ║", prof->trail_segments);
+    mvprintw(y + 11, x, "║ Particles: %5d/%-5d   ║", prof->active_particles, prof->particle_pool);
+    mvprintw(y + 12, x, "║ Dropped: %4ld + %4ld bg  ║",
+             prof->dropped_dancer, prof->dropped_background);
+    mvprintw(y + 13, x, "║ Trails:    %4d          ║", prof->trail_segments);
     
-    /* Performance bar (60fps = 16.67ms target) */
-    float perf_ratio = prof->frame_time_ms / 16.67f;
+    /* Performance bar against the scheduler's frame budget */
+    float perf_ratio = (float)(prof->frame_time_ms / prof->budget_ms);
     int bar_len = (int)(perf_ratio * 20);
     if (bar_len > 20) bar_len = 20;
     
-    mvprintw(y + 13, x, "╟───────────────────────────╢");
-    mvprintw(y + 14, x, "║ ");
+    mvprintw(y + 14, x, "║ Skipped:   %4ld  Q%d      ║",
+             prof->skipped_renders, prof->quality_level);
+    
+    /* Dancer output: diffed bytes against a full redraw */
+    mvprintw(y + 15, x, "║ Output: %5ldB of %5ldB  ║",
+             prof->output_bytes, prof->output_full_bytes);
+    mvprintw(y + 16, x, "║ Cells:  %4d changed      ║", prof->output_cells);
+    
+    /* Dancer rasterized once and reused by shadow/recorder; the saving is
+     * an estimate (one more raster per reuse), not a measurement */
+    mvprintw(y + 17, x, "║ Raster: %5.2fms once      ║", prof->raster_ms);
+    mvprintw(y + 18, x, "║ Reuse (est): %5.2fms     ║", prof->raster_saved_ms);
+    
+    /* A layer finalizing the canvas itself shows up here in red */
+    if (prof->double_finalizes) attron(COLOR_PAIR(1) | A_BOLD);
+    mvprintw(y + 19, x, "║ Finalize x2: %4lu         ║", prof->double_finalizes);
+    if (prof->double_finalizes) {
+        attroff(COLOR_PAIR(1) | A_BOLD);
+        attron(COLOR_PAIR(7));
+    }
+    
+    mvprintw(y + 20, x, "╟───────────────────────────╢");
+    mvprintw(y + 21, x, "║ ");
     
     if (perf_ratio < 0.8) {
         attron(COLOR_PAIR(2)); /* Green */
@@ -153,20 +210,20 @@ void profiler_render(Profiler *prof) {
     
     for (int i = 0; i < 20; i++) {
         if (i < bar_len) {
-            mvaddstr(y + 14, x + 2 + i, "#");
+            mvaddstr(y + 21, x + 2 + i, "#");
         } else {
-            mvaddstr(y + 14, x + 2 + i, ".");
+            mvaddstr(y + 21, x + 2 + i, ".");
         }
     }
     
     attroff(COLOR_PAIR(1) | COLOR_PAIR(2) | COLOR_PAIR(3));
-    mvprintw(y + 14, x + 23, " %3d%% ║", (int)(perf_ratio * 100));
+    mvprintw(y + 21, x + 23, " %3d%% ║", (int)(perf_ratio * 100));
     
-    mvprintw(y + 15, x, "╚═══════════════════════════╝");
+    mvprintw(y + 22, x, "╚═══════════════════════════╝");
     attroff(COLOR_PAIR(7));
     
     /* Instructions */
-    mvprintw(y + 16, x, " Press I to hide");
+    mvprintw(y + 23, x, " Press I to hide");
 }
 
 void profiler_get_stats(const Profiler *prof, double *fps, double *frame_ms) {
@@ -33,8 +33,26 @@ typedef struct {
     
     /* Memory */
     int active_particles;
+    int particle_pool;
+    long dropped_dancer;    /* Spawns lost to the dancer's budget */
+    long dropped_background;
     int trail_segments;
     
+    /* Frame scheduling (v3.2+) */
+    double budget_ms;       /* Frame period the perf bar is measured against */
+    long skipped_renders;
+    int quality_level;      /* Adaptive quality level, 0 = full */
+    
+    /* Terminal output of the dancer region (v3.2+) */
+    long output_bytes;      /* Estimated bytes sent last frame */
+    long output_full_bytes; /* Same frame as a full redraw */
+    int output_cells;       /* Cells that changed */
+    
+    /* Dancer rasterization, done once per frame (v3.2+) */
+    double raster_ms;
+    double raster_saved_ms; /* Estimated repeat rasterization avoided */
+    unsigned long double_finalizes; /* Canvas finalized twice in a frame */
+    
     /* Display */
     bool enabled;
     int x, y;  /* Display position */
@@ -59,6 +77,23 @@ void profiler_mark_render(Profiler *prof, double ms);
 /* Update particle/trail counts */
 void profiler_set_counts(Profiler *prof, int particles, int trails);
 
+/* Update particle pool size and dropped spawns per budget */
+void profiler_set_particle_budget(Profiler *prof, int pool, long dropped_dancer,
+                                  long dropped_background);
+
+/* Update frame budget, skipped render count and adaptive quality level */
+void profiler_set_schedule(Profiler *prof, double budget_ms, long skipped, int quality);
+
+/* Update terminal output bytes (diffed vs full redraw) and changed cells */
+void profiler_set_output(Profiler *prof, long bytes, long full_bytes, int cells);
+
+/* Update dancer rasterization time and the estimated time saved by reusing
+ * the frame (the caller passes one raster per reader that would redo it) */
+void profiler_set_raster(Profiler *prof, double ms, double saved_ms);
+
+/* Update the count of canvas double finalizations (flagged when nonzero) */
+void profiler_set_finalizes(Profiler *prof, unsigned long double_finalizes);
+
 /* Toggle display */
 void profiler_toggle(Profiler *prof);
 bool profiler_is_enabled(Profiler *prof);